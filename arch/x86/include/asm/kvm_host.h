@@ -1625,6 +1625,7 @@ struct kvm_vcpu_stat {
 	u64 preemption_other;
 	u64 guest_mode;
 	u64 notify_window_exits;
+	u64 posted_timer_irqs;
 };
 
 struct x86_instruction_info;
@@ -5,6 +5,11 @@
 #define tlb_flush tlb_flush
 static inline void tlb_flush(struct mmu_gather *tlb);
 
+#ifdef CONFIG_SMP
+#define tlb_flush_deferred tlb_flush_deferred
+static inline bool tlb_flush_deferred(struct mmu_gather *tlb);
+#endif
+
 #include <asm-generic/tlb.h>
 #include <linux/kernel.h>
 #include <vdso/bits.h>
@@ -23,6 +28,15 @@ static inline void tlb_flush(struct mmu_gather *tlb)
 	flush_tlb_mm_range(tlb->mm, start, end, stride_shift, tlb->freed_tables);
 }
 
+#ifdef CONFIG_SMP
+/* Flush the gathered range, remotely only if needed, see mm/mmu_gather.c */
+static inline bool tlb_flush_deferred(struct mmu_gather *tlb)
+{
+	return flush_tlb_mm_range_local(tlb->mm, tlb->start, tlb->end,
+					tlb_get_unmap_shift(tlb));
+}
+#endif
+
 static inline void invlpg(unsigned long addr)
 {
 	asm volatile("invlpg (%0)" ::"r" (addr) : "memory");
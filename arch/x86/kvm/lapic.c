@@ -1929,6 +1929,7 @@ static void apic_timer_expired(struct kvm_lapic *apic, bool from_timer_fn)
 		    vcpu->arch.apic->lapic_timer.timer_advance_ns)
 			__kvm_wait_lapic_expire(vcpu);
 		kvm_apic_inject_pending_timer_irqs(apic);
+		++vcpu->stat.posted_timer_irqs;
 		return;
 	}
 
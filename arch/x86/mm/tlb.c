@@ -1376,6 +1376,69 @@ void flush_tlb_mm_range(struct mm_struct *mm, unsigned long start,
 	mmu_notifier_arch_invalidate_secondary_tlbs(mm, start, end);
 }
 
+/* Whether any CPU other than @cpu is running @mm outside of lazy TLB mode */
+static bool mm_active_elsewhere(struct mm_struct *mm, int cpu)
+{
+	int other;
+
+	for_each_cpu(other, mm_cpumask(mm)) {
+		if (other == cpu)
+			continue;
+		if (!per_cpu(cpu_tlbstate_shared.is_lazy, other) &&
+		    per_cpu(cpu_tlbstate.loaded_mm, other) == mm)
+			return true;
+	}
+	return false;
+}
+
+/*
+ * Flush [start, end) of @mm for mms that opted into deferred TLB shootdown.
+ * If another CPU is actively running @mm this is a regular shootdown, so
+ * that no thread can keep using a stale entry once munmap() returns.
+ * Otherwise only this CPU is flushed: the tlb_gen bump makes the lazy and
+ * switched-away CPUs left in mm_cpumask() catch up in switch_mm_irqs_off()
+ * before they run @mm again, and the generic code issues a flush_tlb_mm()
+ * later to trim them.  Returns true only in the latter case.
+ */
+bool flush_tlb_mm_range_local(struct mm_struct *mm, unsigned long start,
+			      unsigned long end, unsigned int stride_shift)
+{
+	struct flush_tlb_info *info;
+	int cpu = get_cpu();
+	bool deferred = false;
+	u64 new_tlb_gen;
+
+	/*
+	 * This is also a barrier that synchronizes with switch_mm(), so a CPU
+	 * that leaves lazy mode after mm_active_elsewhere() looked at it
+	 * observes the new tlb_gen.
+	 */
+	new_tlb_gen = inc_mm_tlb_gen(mm);
+
+	info = get_flush_tlb_info(mm, start, end, stride_shift, false,
+				  new_tlb_gen);
+
+	if (mm_global_asid(mm)) {
+		broadcast_tlb_flush(info);
+	} else if (mm_active_elsewhere(mm, cpu)) {
+		info->trim_cpumask = should_trim_cpumask(mm);
+		flush_tlb_multi(mm_cpumask(mm), info);
+		consider_global_asid(mm);
+	} else {
+		deferred = cpumask_any_but(mm_cpumask(mm), cpu) < nr_cpu_ids;
+		if (mm == this_cpu_read(cpu_tlbstate.loaded_mm)) {
+			lockdep_assert_irqs_enabled();
+			local_irq_disable();
+			flush_tlb_func(info);
+			local_irq_enable();
+		}
+	}
+
+	put_flush_tlb_info();
+	put_cpu();
+	return deferred;
+}
+
 static void do_flush_tlb_all(void *info)
 {
 	count_vm_tlb_event(NR_TLB_REMOTE_FLUSH_RECEIVED);
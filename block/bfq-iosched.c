@@ -2458,6 +2458,17 @@ static bool bfq_bio_merge(struct request_queue *q, struct bio *bio,
 {
 	struct bfq_data *bfqd = q->elevator->elevator_data;
 	struct request *free = NULL;
+	struct bfq_io_cq *bic;
+	bool ret;
+
+	/*
+	 * Avoiding lock: only queued requests are merge candidates, and a
+	 * race on bfqd->queued should cause at most a missed merge. The
+	 * cgroup info of the bic is brought uptodate in bfq_init_rq().
+	 */
+	if (!READ_ONCE(bfqd->queued))
+		return false;
+
 	/*
 	 * bfq_bic_lookup grabs the queue_lock: invoke it now and
 	 * store its return value for later use, to avoid nesting
@@ -2465,8 +2476,7 @@ static bool bfq_bio_merge(struct request_queue *q, struct bio *bio,
 	 * returned by bfq_bic_lookup does not go away before
 	 * bfqd->lock is taken.
 	 */
-	struct bfq_io_cq *bic = bfq_bic_lookup(q);
-	bool ret;
+	bic = bfq_bic_lookup(q);
 
 	spin_lock_irq(&bfqd->lock);
 
@@ -180,10 +180,13 @@ static int __init blk_integrity_auto_init(void)
 
 	/*
 	 * kintegrityd won't block much but may burn a lot of CPU cycles.
-	 * Make it highpri CPU intensive wq with max concurrency of 1.
+	 * Make it a highpri unbound wq, so that verification is spread over
+	 * the CPUs sharing a cache with the completing one instead of piling
+	 * up behind the I/O completions of that CPU.  WQ_SYSFS allows moving
+	 * it off dedicated completion CPUs entirely through its cpumask.
 	 */
 	kintegrityd_wq = alloc_workqueue("kintegrityd", WQ_MEM_RECLAIM |
-					 WQ_HIGHPRI | WQ_CPU_INTENSIVE, 1);
+					 WQ_HIGHPRI | WQ_UNBOUND | WQ_SYSFS, 0);
 	if (!kintegrityd_wq)
 		panic("Failed to create kintegrityd\n");
 	return 0;
@@ -50,6 +50,9 @@ struct bio_fallback_crypt_ctx {
 		struct {
 			struct work_struct work;
 			struct bio *bio;
+			/* ctx that ends @bio once all its chunks are done */
+			struct bio_fallback_crypt_ctx *parent;
+			atomic_t pending;
 		};
 		struct {
 			void *bi_private_orig;
@@ -370,9 +373,65 @@ static bool blk_crypto_fallback_encrypt_bio(struct bio **bio_ptr)
 	return ret;
 }
 
+/* Reads larger than this are split up and decrypted by several workers */
+#define BLK_CRYPTO_FALLBACK_DECRYPT_CHUNK	(128U * 1024)
+
+static void blk_crypto_fallback_decrypt_bio(struct work_struct *work);
+
+static void
+blk_crypto_fallback_decrypt_done(struct bio_fallback_crypt_ctx *f_ctx)
+{
+	struct bio_fallback_crypt_ctx *parent = f_ctx->parent;
+	struct bio *bio = f_ctx->bio;
+
+	if (f_ctx != parent)
+		mempool_free(f_ctx, bio_fallback_crypt_ctx_pool);
+	if (atomic_dec_and_test(&parent->pending)) {
+		mempool_free(parent, bio_fallback_crypt_ctx_pool);
+		bio_endio(bio);
+	}
+}
+
+/*
+ * Queue all but the last chunk of a large bio as separate work items, so that
+ * they are decrypted in parallel on other CPUs.  Chunks are multiples of the
+ * data unit size.  If a ctx cannot be allocated, the remainder of the bio is
+ * simply left to @f_ctx.
+ */
+static void
+blk_crypto_fallback_split_decrypt(struct bio_fallback_crypt_ctx *f_ctx)
+{
+	const unsigned int data_unit_size =
+		f_ctx->crypt_ctx.bc_key->crypto_cfg.data_unit_size;
+	const unsigned int chunk = max(BLK_CRYPTO_FALLBACK_DECRYPT_CHUNK,
+				       data_unit_size);
+	struct bio_fallback_crypt_ctx *child;
+
+	while (f_ctx->crypt_iter.bi_size > chunk) {
+		child = kmem_cache_alloc(bio_fallback_crypt_ctx_cache,
+					 GFP_NOIO | __GFP_NOWARN);
+		if (!child)
+			break;
+		child->crypt_ctx = f_ctx->crypt_ctx;
+		child->crypt_iter = f_ctx->crypt_iter;
+		child->crypt_iter.bi_size = chunk;
+		child->bio = f_ctx->bio;
+		child->parent = f_ctx;
+		atomic_inc(&f_ctx->pending);
+		INIT_WORK(&child->work, blk_crypto_fallback_decrypt_bio);
+		queue_work(blk_crypto_wq, &child->work);
+
+		bvec_iter_advance(f_ctx->bio->bi_io_vec, &f_ctx->crypt_iter,
+				  chunk);
+		bio_crypt_dun_increment(f_ctx->crypt_ctx.bc_dun,
+					chunk / data_unit_size);
+	}
+}
+
 /*
  * The crypto API fallback's main decryption routine.
- * Decrypts input bio in place, and calls bio_endio on the bio.
+ * Decrypts input bio (or one chunk of it) in place, and calls bio_endio on
+ * the bio once all of it has been decrypted.
  */
 static void blk_crypto_fallback_decrypt_bio(struct work_struct *work)
 {
@@ -392,6 +451,9 @@ static void blk_crypto_fallback_decrypt_bio(struct work_struct *work)
 	unsigned int i;
 	blk_status_t blk_st;
 
+	if (f_ctx->parent == f_ctx)
+		blk_crypto_fallback_split_decrypt(f_ctx);
+
 	/*
 	 * Get a blk-crypto-fallback keyslot that contains a crypto_skcipher for
 	 * this bio's algorithm and key.
@@ -437,8 +499,7 @@ static void blk_crypto_fallback_decrypt_bio(struct work_struct *work)
 	skcipher_request_free(ciph_req);
 	blk_crypto_put_keyslot(slot);
 out_no_keyslot:
-	mempool_free(f_ctx, bio_fallback_crypt_ctx_pool);
-	bio_endio(bio);
+	blk_crypto_fallback_decrypt_done(f_ctx);
 }
 
 /**
@@ -465,6 +526,8 @@ static void blk_crypto_fallback_decrypt_endio(struct bio *bio)
 
 	INIT_WORK(&f_ctx->work, blk_crypto_fallback_decrypt_bio);
 	f_ctx->bio = bio;
+	f_ctx->parent = f_ctx;
+	atomic_set(&f_ctx->pending, 1);
 	queue_work(blk_crypto_wq, &f_ctx->work);
 }
 
@@ -88,6 +88,7 @@ struct rq_wb {
 	unsigned long last_issue;		/* last non-throttled issue */
 	unsigned long last_comp;		/* last non-throttled comp */
 	unsigned long min_lat_nsec;
+	u64 read_lat_base;			/* learned read latency */
 	struct rq_qos rqos;
 	struct rq_wait rq_wait[WBT_NUM_RWQ];
 	struct rq_depth rq_depth;
@@ -141,6 +142,12 @@ enum {
 	 * (step == 0).
 	 */
 	RWB_UNKNOWN_BUMP	= 5,
+
+	/*
+	 * With the default latency target, throttle at this multiple of the
+	 * read latency learned while the device is not writing.
+	 */
+	RWB_LAT_BASE_MULT	= 4,
 };
 
 static inline bool rwb_enabled(struct rq_wb *rwb)
@@ -419,6 +426,31 @@ static void rwb_arm_timer(struct rq_wb *rwb)
 	blk_stat_activate_nsecs(rwb->cb, rwb->cur_win_nsec);
 }
 
+/*
+ * Track the best-case read latency of the device from windows without any
+ * writes.  It follows drops immediately and rises slowly, so a few slow
+ * windows don't move it much.  Unless the target was set manually, use a
+ * multiple of it, but never less than the default, as the target.
+ */
+static void wbt_learn_read_lat(struct rq_wb *rwb, struct blk_rq_stat *stat)
+{
+	u64 lat = stat[READ].min;
+
+	if (!stat[READ].nr_samples || stat[WRITE].nr_samples ||
+	    wbt_inflight(rwb))
+		return;
+
+	if (!rwb->read_lat_base || lat < rwb->read_lat_base)
+		rwb->read_lat_base = lat;
+	else
+		rwb->read_lat_base += (lat - rwb->read_lat_base) >> 6;
+
+	if (rwb->enable_state != WBT_STATE_ON_DEFAULT)
+		return;
+	rwb->min_lat_nsec = max(rwb->read_lat_base * RWB_LAT_BASE_MULT,
+				wbt_default_latency_nsec(rwb->rqos.disk->queue));
+}
+
 static void wb_timer_fn(struct blk_stat_callback *cb)
 {
 	struct rq_wb *rwb = cb->data;
@@ -429,6 +461,7 @@ static void wb_timer_fn(struct blk_stat_callback *cb)
 	if (!rwb->rqos.disk)
 		return;
 
+	wbt_learn_read_lat(rwb, cb->stat);
 	status = latency_exceeded(rwb, cb->stat);
 
 	trace_wbt_timer(rwb->rqos.disk->bdi, status, rqd->scale_step, inflight);
@@ -830,6 +863,15 @@ static int wbt_min_lat_nsec_show(void *data, struct seq_file *m)
 	return 0;
 }
 
+static int wbt_read_lat_base_nsec_show(void *data, struct seq_file *m)
+{
+	struct rq_qos *rqos = data;
+	struct rq_wb *rwb = RQWB(rqos);
+
+	seq_printf(m, "%llu\n", rwb->read_lat_base);
+	return 0;
+}
+
 static int wbt_unknown_cnt_show(void *data, struct seq_file *m)
 {
 	struct rq_qos *rqos = data;
@@ -863,6 +905,7 @@ static const struct blk_mq_debugfs_attr wbt_debugfs_attrs[] = {
 	{"id", 0400, wbt_id_show},
 	{"inflight", 0400, wbt_inflight_show},
 	{"min_lat_nsec", 0400, wbt_min_lat_nsec_show},
+	{"read_lat_base_nsec", 0400, wbt_read_lat_base_nsec_show},
 	{"unknown_cnt", 0400, wbt_unknown_cnt_show},
 	{"wb_normal", 0400, wbt_normal_show},
 	{"wb_background", 0400, wbt_background_show},
@@ -646,6 +646,25 @@ static int dd_request_merge(struct request_queue *q, struct request **rq,
 	return ELEVATOR_NO_MERGE;
 }
 
+/*
+ * Only requests on the fifo lists are in the merge hash and the sort
+ * trees. Racy, but missing a merge now and then is harmless.
+ */
+static bool dd_has_merge_candidates(struct deadline_data *dd)
+{
+	enum dd_prio prio;
+
+	for (prio = 0; prio <= DD_PRIO_MAX; prio++) {
+		struct dd_per_prio *per_prio = &dd->per_prio[prio];
+
+		if (!list_empty_careful(&per_prio->fifo_list[DD_READ]) ||
+		    !list_empty_careful(&per_prio->fifo_list[DD_WRITE]))
+			return true;
+	}
+
+	return false;
+}
+
 /*
  * Attempt to merge a bio into an existing request. This function is called
  * before @bio is associated with a request.
@@ -657,6 +676,13 @@ static bool dd_bio_merge(struct request_queue *q, struct bio *bio,
 	struct request *free = NULL;
 	bool ret;
 
+	/*
+	 * On fast devices requests rarely wait in the scheduler, don't take
+	 * dd->lock for every bio just to find nothing to merge with.
+	 */
+	if (!dd_has_merge_candidates(dd))
+		return false;
+
 	spin_lock(&dd->lock);
 	ret = blk_mq_sched_try_merge(q, bio, nr_segs, &free);
 	spin_unlock(&dd->lock);
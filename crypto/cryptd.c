@@ -27,6 +27,9 @@
 #include <linux/slab.h>
 #include <linux/workqueue.h>
 
+/* Maximum number of requests handled per run of the queue worker */
+#define CRYPTD_WORK_BATCH	16
+
 static unsigned int cryptd_max_cpu_qlen = 1000;
 module_param(cryptd_max_cpu_qlen, uint, 0);
 MODULE_PARM_DESC(cryptd_max_cpu_qlen, "Set cryptd Max queue depth");
@@ -163,22 +166,29 @@ static void cryptd_queue_worker(struct work_struct *work)
 {
 	struct cryptd_cpu_queue *cpu_queue;
 	struct crypto_async_request *req, *backlog;
+	int i;
 
 	cpu_queue = container_of(work, struct cryptd_cpu_queue, work);
 	/*
-	 * Only handle one request at a time to avoid hogging crypto workqueue.
+	 * Handle a bounded number of requests per run to amortize the
+	 * requeueing, but stop early to avoid hogging the crypto workqueue.
 	 */
-	local_bh_disable();
-	backlog = crypto_get_backlog(&cpu_queue->queue);
-	req = crypto_dequeue_request(&cpu_queue->queue);
-	local_bh_enable();
+	for (i = 0; i < CRYPTD_WORK_BATCH; i++) {
+		local_bh_disable();
+		backlog = crypto_get_backlog(&cpu_queue->queue);
+		req = crypto_dequeue_request(&cpu_queue->queue);
+		local_bh_enable();
 
-	if (!req)
-		return;
+		if (!req)
+			return;
 
-	if (backlog)
-		crypto_request_complete(backlog, -EINPROGRESS);
-	crypto_request_complete(req, 0);
+		if (backlog)
+			crypto_request_complete(backlog, -EINPROGRESS);
+		crypto_request_complete(req, 0);
+
+		if (need_resched())
+			break;
+	}
 
 	if (cpu_queue->queue.qlen)
 		queue_work(cryptd_wq, &cpu_queue->work);
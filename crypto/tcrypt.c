@@ -28,6 +28,7 @@
 #include <linux/interrupt.h>
 #include <linux/jiffies.h>
 #include <linux/kernel.h>
+#include <linux/ktime.h>
 #include <linux/module.h>
 #include <linux/moduleparam.h>
 #include <linux/scatterlist.h>
@@ -176,6 +177,7 @@ static int test_mb_aead_jiffies(struct test_mb_aead_data *data, int enc,
 				int blen, int secs, u32 num_mb)
 {
 	unsigned long start, end;
+	u64 t, max_ns = 0;
 	int bcount;
 	int ret = 0;
 	int *rc;
@@ -186,13 +188,17 @@ static int test_mb_aead_jiffies(struct test_mb_aead_data *data, int enc,
 
 	for (start = jiffies, end = start + secs * HZ, bcount = 0;
 	     time_before(jiffies, end); bcount++) {
+		t = ktime_get_ns();
 		ret = do_mult_aead_op(data, enc, num_mb, rc);
 		if (ret)
 			goto out;
+		max_ns = max(max_ns, ktime_get_ns() - t);
 	}
 
 	pr_cont("%d operations in %d seconds (%llu bytes)\n",
 		bcount * num_mb, secs, (u64)bcount * blen * num_mb);
+	pr_info("max latency of %u concurrent operations: %llu ns\n",
+		num_mb, max_ns);
 
 out:
 	kfree(rc);
@@ -1194,6 +1200,7 @@ static int test_mb_acipher_jiffies(struct test_mb_skcipher_data *data, int enc,
 				int blen, int secs, u32 num_mb)
 {
 	unsigned long start, end;
+	u64 t, max_ns = 0;
 	int bcount;
 	int ret = 0;
 	int *rc;
@@ -1204,13 +1211,17 @@ static int test_mb_acipher_jiffies(struct test_mb_skcipher_data *data, int enc,
 
 	for (start = jiffies, end = start + secs * HZ, bcount = 0;
 	     time_before(jiffies, end); bcount++) {
+		t = ktime_get_ns();
 		ret = do_mult_acipher_op(data, enc, num_mb, rc);
 		if (ret)
 			goto out;
+		max_ns = max(max_ns, ktime_get_ns() - t);
 	}
 
 	pr_cont("%d operations in %d seconds (%llu bytes)\n",
 		bcount * num_mb, secs, (u64)bcount * blen * num_mb);
+	pr_info("max latency of %u concurrent operations: %llu ns\n",
+		num_mb, max_ns);
 
 out:
 	kfree(rc);
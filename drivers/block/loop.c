@@ -372,6 +372,9 @@ static void lo_complete_rq(struct request *rq)
 	}
 }
 
+static void loop_queue_work(struct loop_device *lo, struct loop_cmd *cmd);
+static void loop_set_cmd_css(struct loop_cmd *cmd, struct request *rq);
+
 static void lo_rw_aio_do_completion(struct loop_cmd *cmd)
 {
 	struct request *rq = blk_mq_rq_from_pdu(cmd);
@@ -380,6 +383,18 @@ static void lo_rw_aio_do_completion(struct loop_cmd *cmd)
 		return;
 	kfree(cmd->bvec);
 	cmd->bvec = NULL;
+
+	/*
+	 * A NOWAIT attempt from loop_queue_rq() that would have blocked,
+	 * either right away or through ->ki_complete. Let a worker redo it.
+	 */
+	if (cmd->ret == -EAGAIN && (cmd->iocb.ki_flags & IOCB_NOWAIT)) {
+		cmd->ret = 0;
+		loop_set_cmd_css(cmd, rq);
+		loop_queue_work(rq->q->queuedata, cmd);
+		return;
+	}
+
 	if (likely(!blk_should_fake_timeout(rq->q)))
 		blk_mq_complete_request(rq);
 }
@@ -393,7 +408,7 @@ static void lo_rw_aio_complete(struct kiocb *iocb, long ret)
 }
 
 static int lo_rw_aio(struct loop_device *lo, struct loop_cmd *cmd,
-		     loff_t pos, int rw)
+		     loff_t pos, int rw, bool nowait)
 {
 	struct iov_iter iter;
 	struct req_iterator rq_iter;
@@ -447,6 +462,8 @@ static int lo_rw_aio(struct loop_device *lo, struct loop_cmd *cmd,
 	cmd->iocb.ki_filp = file;
 	cmd->iocb.ki_complete = lo_rw_aio_complete;
 	cmd->iocb.ki_flags = IOCB_DIRECT;
+	if (nowait)
+		cmd->iocb.ki_flags |= IOCB_NOWAIT;
 	cmd->iocb.ki_ioprio = IOPRIO_PRIO_VALUE(IOPRIO_CLASS_NONE, 0);
 
 	if (rw == ITER_SOURCE)
@@ -491,12 +508,12 @@ static int do_req_filebacked(struct loop_device *lo, struct request *rq)
 		return lo_fallocate(lo, rq, pos, FALLOC_FL_PUNCH_HOLE);
 	case REQ_OP_WRITE:
 		if (cmd->use_aio)
-			return lo_rw_aio(lo, cmd, pos, ITER_SOURCE);
+			return lo_rw_aio(lo, cmd, pos, ITER_SOURCE, false);
 		else
 			return lo_write_simple(lo, rq, pos);
 	case REQ_OP_READ:
 		if (cmd->use_aio)
-			return lo_rw_aio(lo, cmd, pos, ITER_DEST);
+			return lo_rw_aio(lo, cmd, pos, ITER_DEST, false);
 		else
 			return lo_read_simple(lo, rq, pos);
 	default:
@@ -847,8 +864,10 @@ static void loop_queue_work(struct loop_device *lo, struct loop_cmd *cmd)
 	struct loop_worker *cur_worker, *worker = NULL;
 	struct work_struct *work;
 	struct list_head *cmd_list;
+	unsigned long flags;
 
-	spin_lock_irq(&lo->lo_work_lock);
+	/* may be called from ->ki_complete, see lo_rw_aio_do_completion() */
+	spin_lock_irqsave(&lo->lo_work_lock, flags);
 
 	if (queue_on_root_worker(cmd->blkcg_css))
 		goto queue_work;
@@ -908,7 +927,7 @@ static void loop_queue_work(struct loop_device *lo, struct loop_cmd *cmd)
 	}
 	list_add_tail(&cmd->list_entry, cmd_list);
 	queue_work(lo->workqueue, work);
-	spin_unlock_irq(&lo->lo_work_lock);
+	spin_unlock_irqrestore(&lo->lo_work_lock, flags);
 }
 
 static void loop_set_timer(struct loop_device *lo)
@@ -1869,6 +1888,52 @@ MODULE_DESCRIPTION("Loopback device support");
 MODULE_LICENSE("GPL");
 MODULE_ALIAS_BLOCKDEV_MAJOR(LOOP_MAJOR);
 
+static void loop_set_cmd_css(struct loop_cmd *cmd, struct request *rq)
+{
+	/* always use the first bio's css */
+	cmd->blkcg_css = NULL;
+	cmd->memcg_css = NULL;
+#ifdef CONFIG_BLK_CGROUP
+	if (rq->bio) {
+		cmd->blkcg_css = bio_blkcg_css(rq->bio);
+#ifdef CONFIG_MEMCG
+		if (cmd->blkcg_css) {
+			cmd->memcg_css =
+				cgroup_get_e_css(cmd->blkcg_css->cgroup,
+						&memory_cgrp_subsys);
+		}
+#endif
+	}
+#endif
+}
+
+/*
+ * Direct I/O that the backing file can start without blocking is issued
+ * right from the submitter, skipping the handoff to a loop worker.  Kernel
+ * threads (writeback, kblockd) still go through the workers, which issue
+ * the I/O on behalf of the cgroup that owns it.
+ */
+static bool loop_try_nowait(struct loop_device *lo, struct request *rq)
+{
+	struct loop_cmd *cmd = blk_mq_rq_to_pdu(rq);
+	loff_t pos = ((loff_t) blk_rq_pos(rq) << 9) + lo->lo_offset;
+	bool write = op_is_write(req_op(rq));
+	unsigned int noio_flag;
+	int ret;
+
+	if (!cmd->use_aio || (current->flags & PF_KTHREAD) ||
+	    !(lo->lo_backing_file->f_mode & FMODE_NOWAIT) ||
+	    (write && (lo->lo_flags & LO_FLAGS_READ_ONLY)))
+		return false;
+
+	cmd->blkcg_css = NULL;
+	cmd->memcg_css = NULL;
+	noio_flag = memalloc_noio_save();
+	ret = lo_rw_aio(lo, cmd, pos, write ? ITER_SOURCE : ITER_DEST, true);
+	memalloc_noio_restore(noio_flag);
+	return !ret;
+}
+
 static blk_status_t loop_queue_rq(struct blk_mq_hw_ctx *hctx,
 		const struct blk_mq_queue_data *bd)
 {
@@ -1892,21 +1957,10 @@ static blk_status_t loop_queue_rq(struct blk_mq_hw_ctx *hctx,
 		break;
 	}
 
-	/* always use the first bio's css */
-	cmd->blkcg_css = NULL;
-	cmd->memcg_css = NULL;
-#ifdef CONFIG_BLK_CGROUP
-	if (rq->bio) {
-		cmd->blkcg_css = bio_blkcg_css(rq->bio);
-#ifdef CONFIG_MEMCG
-		if (cmd->blkcg_css) {
-			cmd->memcg_css =
-				cgroup_get_e_css(cmd->blkcg_css->cgroup,
-						&memory_cgrp_subsys);
-		}
-#endif
-	}
-#endif
+	if (loop_try_nowait(lo, rq))
+		return BLK_STS_OK;
+
+	loop_set_cmd_css(cmd, rq);
 	loop_queue_work(lo, cmd);
 
 	return BLK_STS_OK;
@@ -2057,7 +2111,9 @@ static int loop_add(int i)
 	lo->tag_set.queue_depth = hw_queue_depth;
 	lo->tag_set.numa_node = NUMA_NO_NODE;
 	lo->tag_set.cmd_size = sizeof(struct loop_cmd);
-	lo->tag_set.flags = BLK_MQ_F_STACKING | BLK_MQ_F_NO_SCHED_BY_DEFAULT;
+	/* ->queue_rq() may issue I/O to the backing file, see loop_try_nowait() */
+	lo->tag_set.flags = BLK_MQ_F_STACKING | BLK_MQ_F_NO_SCHED_BY_DEFAULT |
+			    BLK_MQ_F_BLOCKING;
 	lo->tag_set.driver_data = lo;
 
 	err = blk_mq_alloc_tag_set(&lo->tag_set);
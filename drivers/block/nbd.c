@@ -744,6 +744,14 @@ static blk_status_t nbd_send_cmd(struct nbd_device *nbd, struct nbd_cmd *cmd,
 			bool is_last = !next && bio_iter_last(bvec, iter);
 			int flags = is_last ? 0 : MSG_MORE;
 
+			/*
+			 * Let the socket reference the payload pages instead of
+			 * copying them. The request only completes once the
+			 * server has replied, i.e. after all of it was received.
+			 */
+			if (sendpage_ok(bvec.bv_page))
+				flags |= MSG_SPLICE_PAGES;
+
 			dev_dbg(nbd_to_dev(nbd), "request %p: sending %d bytes data\n",
 				req, bvec.bv_len);
 			iov_iter_bvec(&from, ITER_SOURCE, &bvec, 1, bvec.bv_len);
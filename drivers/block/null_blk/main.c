@@ -205,6 +205,22 @@ static unsigned long g_completion_nsec = 10000;
 module_param_named(completion_nsec, g_completion_nsec, ulong, 0444);
 MODULE_PARM_DESC(completion_nsec, "Time in ns to complete a request in hardware. Default: 10,000ns");
 
+static unsigned long g_completion_jitter_nsec;
+module_param_named(completion_jitter_nsec, g_completion_jitter_nsec, ulong, 0444);
+MODULE_PARM_DESC(completion_jitter_nsec, "Uniformly random extra time in ns to complete a request with irqmode=2. Default: 0");
+
+static unsigned long g_completion_tail_nsec;
+module_param_named(completion_tail_nsec, g_completion_tail_nsec, ulong, 0444);
+MODULE_PARM_DESC(completion_tail_nsec, "Time in ns to complete a tail request with irqmode=2. Default: 0");
+
+static unsigned int g_completion_tail_ppm;
+module_param_named(completion_tail_ppm, g_completion_tail_ppm, uint, 0444);
+MODULE_PARM_DESC(completion_tail_ppm, "Tail requests per million requests. Default: 0");
+
+static unsigned long g_completion_seed;
+module_param_named(completion_seed, g_completion_seed, ulong, 0444);
+MODULE_PARM_DESC(completion_seed, "Seed of the completion time randomization, 0 for a random one. Default: 0");
+
 static int g_hw_queue_depth = 64;
 module_param_named(hw_queue_depth, g_hw_queue_depth, int, 0444);
 MODULE_PARM_DESC(hw_queue_depth, "Queue depth for each hardware queue. Default: 64");
@@ -444,6 +460,10 @@ static int nullb_apply_poll_queues(struct nullb_device *dev,
 
 NULLB_DEVICE_ATTR(size, ulong, NULL);
 NULLB_DEVICE_ATTR(completion_nsec, ulong, NULL);
+NULLB_DEVICE_ATTR(completion_jitter_nsec, ulong, NULL);
+NULLB_DEVICE_ATTR(completion_tail_nsec, ulong, NULL);
+NULLB_DEVICE_ATTR(completion_tail_ppm, uint, NULL);
+NULLB_DEVICE_ATTR(completion_seed, ulong, NULL);
 NULLB_DEVICE_ATTR(submit_queues, uint, nullb_apply_submit_queues);
 NULLB_DEVICE_ATTR(poll_queues, uint, nullb_apply_poll_queues);
 NULLB_DEVICE_ATTR(home_node, uint, NULL);
@@ -600,7 +620,11 @@ static struct configfs_attribute *nullb_device_attrs[] = {
 	&nullb_device_attr_blocking,
 	&nullb_device_attr_blocksize,
 	&nullb_device_attr_cache_size,
+	&nullb_device_attr_completion_jitter_nsec,
 	&nullb_device_attr_completion_nsec,
+	&nullb_device_attr_completion_seed,
+	&nullb_device_attr_completion_tail_nsec,
+	&nullb_device_attr_completion_tail_ppm,
 	&nullb_device_attr_discard,
 	&nullb_device_attr_fua,
 	&nullb_device_attr_home_node,
@@ -787,6 +811,10 @@ static struct nullb_device *null_alloc_dev(void)
 
 	dev->size = g_gb * 1024;
 	dev->completion_nsec = g_completion_nsec;
+	dev->completion_jitter_nsec = g_completion_jitter_nsec;
+	dev->completion_tail_nsec = g_completion_tail_nsec;
+	dev->completion_tail_ppm = g_completion_tail_ppm;
+	dev->completion_seed = g_completion_seed;
 	dev->submit_queues = g_submit_queues;
 	dev->prev_submit_queues = g_submit_queues;
 	dev->poll_queues = g_poll_queues;
@@ -839,9 +867,30 @@ static enum hrtimer_restart null_cmd_timer_expired(struct hrtimer *timer)
 	return HRTIMER_NORESTART;
 }
 
+/*
+ * Completion time of a request: completion_nsec plus up to
+ * completion_jitter_nsec, or completion_tail_nsec for completion_tail_ppm
+ * of the requests.  The state is per queue and not locked, so only a queue
+ * submitted to by one CPU at a time gives a reproducible sequence.
+ */
+static u64 null_cmd_latency(struct nullb_queue *nq)
+{
+	struct nullb_device *dev = nq->dev;
+	u64 lat = dev->completion_nsec;
+
+	if (dev->completion_tail_ppm &&
+	    prandom_u32_state(&nq->lat_rnd) % 1000000 <
+	    dev->completion_tail_ppm)
+		return dev->completion_tail_nsec;
+	if (dev->completion_jitter_nsec)
+		lat += mul_u64_u32_shr(dev->completion_jitter_nsec,
+				       prandom_u32_state(&nq->lat_rnd), 32);
+	return lat;
+}
+
 static void null_cmd_end_timer(struct nullb_cmd *cmd)
 {
-	ktime_t kt = cmd->nq->dev->completion_nsec;
+	ktime_t kt = null_cmd_latency(cmd->nq);
 
 	hrtimer_start(&cmd->timer, kt, HRTIMER_MODE_REL);
 }
@@ -1714,9 +1763,12 @@ static void null_queue_rqs(struct rq_list *rqlist)
 
 static void null_init_queue(struct nullb *nullb, struct nullb_queue *nq)
 {
+	u64 seed = nullb->dev->completion_seed ?: get_random_u64();
+
 	nq->dev = nullb->dev;
 	INIT_LIST_HEAD(&nq->poll_list);
 	spin_lock_init(&nq->poll_lock);
+	prandom_seed_state(&nq->lat_rnd, seed + (nq - nullb->queues));
 }
 
 static int null_init_hctx(struct blk_mq_hw_ctx *hctx, void *driver_data,
@@ -1897,6 +1949,8 @@ static int null_validate_conf(struct nullb_device *dev)
 		dev->poll_queues = g_poll_queues;
 	dev->prev_poll_queues = dev->poll_queues;
 	dev->irqmode = min_t(unsigned int, dev->irqmode, NULL_IRQ_TIMER);
+	dev->completion_tail_ppm = min_t(unsigned int, 1000000,
+					 dev->completion_tail_ppm);
 
 	/* Do memory allocation, so set blocking */
 	if (dev->memory_backed)
@@ -14,6 +14,7 @@
 #include <linux/fault-inject.h>
 #include <linux/spinlock.h>
 #include <linux/mutex.h>
+#include <linux/prandom.h>
 
 struct nullb_cmd {
 	blk_status_t error;
@@ -28,6 +29,8 @@ struct nullb_queue {
 
 	struct list_head poll_list;
 	spinlock_t poll_lock;
+
+	struct rnd_state lat_rnd; /* completion latency emulation */
 };
 
 struct nullb_zone {
@@ -78,6 +81,10 @@ struct nullb_device {
 
 	unsigned long size; /* device size in MB */
 	unsigned long completion_nsec; /* time in ns to complete a request */
+	unsigned long completion_jitter_nsec; /* random extra completion time */
+	unsigned long completion_tail_nsec; /* completion time of tail requests */
+	unsigned int completion_tail_ppm; /* tail requests per million */
+	unsigned long completion_seed; /* seed of the latency emulation */
 	unsigned long cache_size; /* disk cache size in MB */
 	unsigned long zone_size; /* zone size in MB if device is zoned */
 	unsigned long zone_capacity; /* zone capacity in MB if device is zoned */
@@ -1392,6 +1392,15 @@ static int virtnet_add_recvbuf_xsk(struct virtnet_info *vi, struct receive_queue
 	xsk_buffs = rq->xsk_buffs;
 
 	num = xsk_buff_alloc_batch(pool, xsk_buffs, rq->vq->num_free);
+	if (xsk_uses_need_wakeup(pool)) {
+		/* Let the application kick us once the fill ring is refilled,
+		 * rather than relying on the refill work.
+		 */
+		if (!num)
+			xsk_set_rx_need_wakeup(pool);
+		else
+			xsk_clear_rx_need_wakeup(pool);
+	}
 	if (!num)
 		return -ENOMEM;
 
@@ -1526,16 +1535,22 @@ static bool virtnet_xsk_xmit(struct send_queue *sq, struct xsk_buff_pool *pool,
 	return sent;
 }
 
-static void xsk_wakeup(struct send_queue *sq)
+static void virtnet_xsk_napi_wakeup(struct napi_struct *napi,
+				    struct virtqueue *vq)
 {
-	if (napi_if_scheduled_mark_missed(&sq->napi))
+	if (napi_if_scheduled_mark_missed(napi))
 		return;
 
 	local_bh_disable();
-	virtqueue_napi_schedule(&sq->napi, sq->vq);
+	virtqueue_napi_schedule(napi, vq);
 	local_bh_enable();
 }
 
+static void xsk_wakeup(struct send_queue *sq)
+{
+	virtnet_xsk_napi_wakeup(&sq->napi, sq->vq);
+}
+
 static int virtnet_xsk_wakeup(struct net_device *dev, u32 qid, u32 flag)
 {
 	struct virtnet_info *vi = netdev_priv(dev);
@@ -1549,6 +1564,13 @@ static int virtnet_xsk_wakeup(struct net_device *dev, u32 qid, u32 flag)
 
 	sq = &vi->sq[qid];
 
+	if (flag & XDP_WAKEUP_RX) {
+		struct receive_queue *rq = &vi->rq[qid];
+
+		if (rq->xsk_pool)
+			virtnet_xsk_napi_wakeup(&rq->napi, rq->vq);
+	}
+
 	xsk_wakeup(sq);
 	return 0;
 }
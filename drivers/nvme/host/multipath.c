@@ -18,6 +18,7 @@ static const char *nvme_iopolicy_names[] = {
 	[NVME_IOPOLICY_NUMA]	= "numa",
 	[NVME_IOPOLICY_RR]	= "round-robin",
 	[NVME_IOPOLICY_QD]      = "queue-depth",
+	[NVME_IOPOLICY_LAT]	= "latency",
 };
 
 static int iopolicy = NVME_IOPOLICY_NUMA;
@@ -32,6 +33,8 @@ static int nvme_set_iopolicy(const char *val, const struct kernel_param *kp)
 		iopolicy = NVME_IOPOLICY_RR;
 	else if (!strncmp(val, "queue-depth", 11))
 		iopolicy = NVME_IOPOLICY_QD;
+	else if (!strncmp(val, "latency", 7))
+		iopolicy = NVME_IOPOLICY_LAT;
 	else
 		return -EINVAL;
 
@@ -46,7 +49,7 @@ static int nvme_get_iopolicy(char *buf, const struct kernel_param *kp)
 module_param_call(iopolicy, nvme_set_iopolicy, nvme_get_iopolicy,
 	&iopolicy, 0644);
 MODULE_PARM_DESC(iopolicy,
-	"Default multipath I/O policy; 'numa' (default), 'round-robin' or 'queue-depth'");
+	"Default multipath I/O policy; 'numa' (default), 'round-robin', 'queue-depth' or 'latency'");
 
 void nvme_mpath_default_iopolicy(struct nvme_subsystem *subsys)
 {
@@ -130,12 +133,18 @@ void nvme_mpath_start_request(struct request *rq)
 {
 	struct nvme_ns *ns = rq->q->queuedata;
 	struct gendisk *disk = ns->head->disk;
+	int policy = READ_ONCE(ns->head->subsys->iopolicy);
 
-	if (READ_ONCE(ns->head->subsys->iopolicy) == NVME_IOPOLICY_QD) {
+	if (policy == NVME_IOPOLICY_QD || policy == NVME_IOPOLICY_LAT) {
 		atomic_inc(&ns->ctrl->nr_active);
 		nvme_req(rq)->flags |= NVME_MPATH_CNT_ACTIVE;
 	}
 
+	if (policy == NVME_IOPOLICY_LAT && !blk_rq_is_passthrough(rq)) {
+		nvme_req(rq)->lat_start = ktime_get_ns();
+		nvme_req(rq)->flags |= NVME_MPATH_CNT_LAT;
+	}
+
 	if (!blk_queue_io_stat(disk->queue) || blk_rq_is_passthrough(rq))
 		return;
 
@@ -152,6 +161,19 @@ void nvme_mpath_end_request(struct request *rq)
 	if (nvme_req(rq)->flags & NVME_MPATH_CNT_ACTIVE)
 		atomic_dec_if_positive(&ns->ctrl->nr_active);
 
+	/*
+	 * Racy updates from concurrent completions are fine, the average
+	 * only needs to be roughly right. Weight 1/8 smooths out single slow
+	 * completions so that paths don't flap.
+	 */
+	if (nvme_req(rq)->flags & NVME_MPATH_CNT_LAT) {
+		s64 lat = ktime_get_ns() - nvme_req(rq)->lat_start;
+		s64 ewma = READ_ONCE(ns->lat_ewma);
+
+		WRITE_ONCE(ns->lat_ewma, ewma ? ewma + (lat - ewma) / 8 : lat);
+		WRITE_ONCE(ns->lat_stamp, jiffies);
+	}
+
 	if (!(nvme_req(rq)->flags & NVME_MPATH_IO_STATS))
 		return;
 	bdev_end_io_acct(ns->head->disk->part0, req_op(rq),
@@ -204,6 +226,12 @@ bool nvme_mpath_clear_current_path(struct nvme_ns *ns)
 	return changed;
 }
 
+/* Forget a path's latency average, the next completions start it over */
+static void nvme_mpath_reset_latency(struct nvme_ns *ns)
+{
+	WRITE_ONCE(ns->lat_ewma, 0);
+}
+
 void nvme_mpath_clear_ctrl_paths(struct nvme_ctrl *ctrl)
 {
 	struct nvme_ns *ns;
@@ -213,6 +241,7 @@ void nvme_mpath_clear_ctrl_paths(struct nvme_ctrl *ctrl)
 	list_for_each_entry_srcu(ns, &ctrl->namespaces, list,
 				 srcu_read_lock_held(&ctrl->srcu)) {
 		nvme_mpath_clear_current_path(ns);
+		nvme_mpath_reset_latency(ns);
 		kblockd_schedule_work(&ns->head->requeue_work);
 	}
 	srcu_read_unlock(&ctrl->srcu, srcu_idx);
@@ -391,6 +420,59 @@ static struct nvme_ns *nvme_queue_depth_path(struct nvme_ns_head *head)
 	return best_opt ? best_opt : best_nonopt;
 }
 
+/*
+ * The average of a path that got no completions for this long is halved,
+ * so that a path left alone after a latency spike is eventually probed
+ * again instead of never getting a new sample.
+ */
+#define NVME_LAT_DECAY_INTERVAL	(HZ / 4)
+
+/*
+ * Send I/O to the path with the lowest expected completion time, estimated
+ * as its average completion latency times the number of requests it will
+ * have in flight.  Paths without samples yet are tried first.
+ */
+static struct nvme_ns *nvme_latency_path(struct nvme_ns_head *head)
+{
+	struct nvme_ns *best_opt = NULL, *best_nonopt = NULL, *ns;
+	u64 min_cost_opt = U64_MAX, min_cost_nonopt = U64_MAX;
+	unsigned long idle;
+	u64 cost;
+
+	list_for_each_entry_srcu(ns, &head->list, siblings,
+				 srcu_read_lock_held(&head->srcu)) {
+		if (nvme_path_is_disabled(ns))
+			continue;
+
+		idle = (jiffies - READ_ONCE(ns->lat_stamp)) /
+			NVME_LAT_DECAY_INTERVAL;
+		cost = READ_ONCE(ns->lat_ewma) >> min(idle, 63UL);
+		cost *= atomic_read(&ns->ctrl->nr_active) + 1;
+
+		switch (ns->ana_state) {
+		case NVME_ANA_OPTIMIZED:
+			if (cost < min_cost_opt) {
+				min_cost_opt = cost;
+				best_opt = ns;
+			}
+			break;
+		case NVME_ANA_NONOPTIMIZED:
+			if (cost < min_cost_nonopt) {
+				min_cost_nonopt = cost;
+				best_nonopt = ns;
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (min_cost_opt == 0)
+			return best_opt;
+	}
+
+	return best_opt ? best_opt : best_nonopt;
+}
+
 static inline bool nvme_path_is_optimized(struct nvme_ns *ns)
 {
 	return nvme_ctrl_state(ns->ctrl) == NVME_CTRL_LIVE &&
@@ -415,6 +497,8 @@ inline struct nvme_ns *nvme_find_path(struct nvme_ns_head *head)
 	switch (READ_ONCE(head->subsys->iopolicy)) {
 	case NVME_IOPOLICY_QD:
 		return nvme_queue_depth_path(head);
+	case NVME_IOPOLICY_LAT:
+		return nvme_latency_path(head);
 	case NVME_IOPOLICY_RR:
 		return nvme_round_robin_path(head);
 	default:
@@ -755,6 +839,10 @@ static inline bool nvme_state_is_live(enum nvme_ana_state state)
 static void nvme_update_ns_ana_state(struct nvme_ana_group_desc *desc,
 		struct nvme_ns *ns)
 {
+	/* The path's latency may have changed along with its state */
+	if (ns->ana_state != desc->state)
+		nvme_mpath_reset_latency(ns);
+
 	ns->ana_grpid = le32_to_cpu(desc->grpid);
 	ns->ana_state = desc->state;
 	clear_bit(NVME_NS_ANA_PENDING, &ns->flags);
@@ -879,6 +967,15 @@ static void nvme_ana_work(struct work_struct *work)
 void nvme_mpath_update(struct nvme_ctrl *ctrl)
 {
 	u32 nr_change_groups = 0;
+	struct nvme_ns *ns;
+	int srcu_idx;
+
+	/* Latencies measured before a reconnect say nothing about it */
+	srcu_idx = srcu_read_lock(&ctrl->srcu);
+	list_for_each_entry_srcu(ns, &ctrl->namespaces, list,
+				 srcu_read_lock_held(&ctrl->srcu))
+		nvme_mpath_reset_latency(ns);
+	srcu_read_unlock(&ctrl->srcu, srcu_idx);
 
 	if (!ctrl->ana_log_buf)
 		return;
@@ -988,6 +1085,18 @@ static ssize_t queue_depth_show(struct device *dev,
 }
 DEVICE_ATTR_RO(queue_depth);
 
+static ssize_t latency_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct nvme_ns *ns = nvme_get_ns_from_dev(dev);
+
+	if (ns->head->subsys->iopolicy != NVME_IOPOLICY_LAT)
+		return 0;
+
+	return sysfs_emit(buf, "%llu\n", READ_ONCE(ns->lat_ewma));
+}
+DEVICE_ATTR_RO(latency);
+
 static ssize_t numa_nodes_show(struct device *dev, struct device_attribute *attr,
 		char *buf)
 {
@@ -193,6 +193,7 @@ struct nvme_request {
 	u16			status;
 #ifdef CONFIG_NVME_MULTIPATH
 	unsigned long		start_time;
+	u64			lat_start;	/* ns, for the latency iopolicy */
 #endif
 	struct nvme_ctrl	*ctrl;
 };
@@ -207,6 +208,7 @@ enum {
 	NVME_REQ_USERCMD		= (1 << 1),
 	NVME_MPATH_IO_STATS		= (1 << 2),
 	NVME_MPATH_CNT_ACTIVE		= (1 << 3),
+	NVME_MPATH_CNT_LAT		= (1 << 4),
 };
 
 static inline struct nvme_request *nvme_req(struct request *req)
@@ -421,6 +423,7 @@ enum nvme_iopolicy {
 	NVME_IOPOLICY_NUMA,
 	NVME_IOPOLICY_RR,
 	NVME_IOPOLICY_QD,
+	NVME_IOPOLICY_LAT,
 };
 
 struct nvme_subsystem {
@@ -528,6 +531,8 @@ struct nvme_ns {
 #ifdef CONFIG_NVME_MULTIPATH
 	enum nvme_ana_state ana_state;
 	u32 ana_grpid;
+	u64 lat_ewma; /* completion latency in ns, for the latency iopolicy */
+	unsigned long lat_stamp; /* jiffies of the last lat_ewma sample */
 #endif
 	struct list_head siblings;
 	struct kref kref;
@@ -985,6 +990,7 @@ extern bool multipath;
 extern struct device_attribute dev_attr_ana_grpid;
 extern struct device_attribute dev_attr_ana_state;
 extern struct device_attribute dev_attr_queue_depth;
+extern struct device_attribute dev_attr_latency;
 extern struct device_attribute dev_attr_numa_nodes;
 extern struct device_attribute subsys_attr_iopolicy;
 
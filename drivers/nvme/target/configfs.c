@@ -745,6 +745,27 @@ static ssize_t nvmet_ns_buffered_io_store(struct config_item *item,
 
 CONFIGFS_ATTR(nvmet_ns_, buffered_io);
 
+static ssize_t nvmet_ns_direct_io_min_show(struct config_item *item,
+		char *page)
+{
+	return sysfs_emit(page, "%u\n", to_nvmet_ns(item)->direct_io_min);
+}
+
+static ssize_t nvmet_ns_direct_io_min_store(struct config_item *item,
+		const char *page, size_t count)
+{
+	struct nvmet_ns *ns = to_nvmet_ns(item);
+	u32 val;
+
+	if (kstrtou32(page, 0, &val))
+		return -EINVAL;
+
+	WRITE_ONCE(ns->direct_io_min, val);
+	return count;
+}
+
+CONFIGFS_ATTR(nvmet_ns_, direct_io_min);
+
 static ssize_t nvmet_ns_revalidate_size_store(struct config_item *item,
 		const char *page, size_t count)
 {
@@ -804,6 +825,7 @@ static struct configfs_attribute *nvmet_ns_attrs[] = {
 	&nvmet_ns_attr_ana_grpid,
 	&nvmet_ns_attr_enable,
 	&nvmet_ns_attr_buffered_io,
+	&nvmet_ns_attr_direct_io_min,
 	&nvmet_ns_attr_revalidate_size,
 	&nvmet_ns_attr_resv_enable,
 #ifdef CONFIG_PCI_P2PDMA
@@ -6,6 +6,7 @@
  */
 #define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
 #include <linux/uio.h>
+#include <linux/blkdev.h>
 #include <linux/falloc.h>
 #include <linux/file.h>
 #include <linux/fs.h>
@@ -215,6 +216,35 @@ static void nvmet_file_submit_buffered_io(struct nvmet_req *req)
 	queue_work(buffered_io_wq, &req->f.work);
 }
 
+/*
+ * Namespaces in buffered mode still send transfers of at least direct_io_min
+ * bytes straight to the backing device when they are suitably aligned, so
+ * that large streaming I/O neither pollutes the page cache nor bounces
+ * through buffered_io_wq.  Smaller I/O keeps the inline IOCB_NOWAIT attempt,
+ * which completes page cache hits without queuing work.
+ */
+static bool nvmet_file_use_direct_io(struct nvmet_req *req)
+{
+	struct file *file = req->ns->file;
+	struct block_device *bdev = file_inode(file)->i_sb->s_bdev;
+	u32 min = READ_ONCE(req->ns->direct_io_min);
+	unsigned int mask;
+	struct scatterlist *sg;
+	int i;
+
+	if (!min || req->transfer_len < min ||
+	    !(file->f_mode & FMODE_CAN_ODIRECT) || !bdev)
+		return false;
+
+	mask = bdev_logical_block_size(bdev) - 1;
+	if ((le64_to_cpu(req->cmd->rw.slba) << req->ns->blksize_shift) & mask)
+		return false;
+	for_each_sg(req->sg, sg, req->sg_cnt, i)
+		if ((sg->offset | sg->length) & mask)
+			return false;
+	return true;
+}
+
 static void nvmet_file_execute_rw(struct nvmet_req *req)
 {
 	ssize_t nr_bvec = req->sg_cnt;
@@ -241,6 +271,10 @@ static void nvmet_file_execute_rw(struct nvmet_req *req)
 		req->f.mpool_alloc = false;
 
 	if (req->ns->buffered_io) {
+		if (nvmet_file_use_direct_io(req)) {
+			nvmet_file_execute_io(req, IOCB_DIRECT);
+			return;
+		}
 		if (likely(!req->f.mpool_alloc) &&
 		    (req->ns->file->f_mode & FMODE_NOWAIT) &&
 		    nvmet_file_execute_io(req, IOCB_NOWAIT))
@@ -111,6 +111,7 @@ struct nvmet_ns {
 	u32			anagrpid;
 
 	bool			buffered_io;
+	u32			direct_io_min;
 	bool			enabled;
 	struct nvmet_subsys	*subsys;
 	const char		*device_path;
@@ -588,6 +588,45 @@ static int vaddr_get_pfns(struct mm_struct *mm, unsigned long vaddr,
 	return ret;
 }
 
+/*
+ * Number of pages at the head of the batch that are consecutive pages of the
+ * same folio.  They are physically contiguous and share reserved state, so
+ * they can be accounted in one go.
+ */
+static long vfio_batch_folio_run(struct vfio_batch *batch)
+{
+	struct page **pages = &batch->pages[batch->offset];
+	struct folio *folio = page_folio(pages[0]);
+	unsigned long pfn = page_to_pfn(pages[0]);
+	long i;
+
+	if (!folio_test_large(folio))
+		return 1;
+
+	for (i = 1; i < batch->size; i++) {
+		if (page_folio(pages[i]) != folio ||
+		    page_to_pfn(pages[i]) != pfn + i)
+			break;
+	}
+
+	return i;
+}
+
+/* Number of pages in [iova, iova + npage) already tracked in pfn_list */
+static long vfio_vpfn_count(struct vfio_dma *dma, dma_addr_t iova, long npage)
+{
+	long i, count = 0;
+
+	if (RB_EMPTY_ROOT(&dma->pfn_list))
+		return 0;
+
+	for (i = 0; i < npage; i++, iova += PAGE_SIZE)
+		if (vfio_find_vpfn(dma, iova))
+			count++;
+
+	return count;
+}
+
 /*
  * Attempt to pin pages.  We really don't want to track all the pfns and
  * the iommu can only map chunks of consecutive pfns anyway, so get the
@@ -600,6 +639,7 @@ static long vfio_pin_pages_remote(struct vfio_dma *dma, unsigned long vaddr,
 	unsigned long pfn;
 	struct mm_struct *mm = current->mm;
 	long ret, pinned = 0, lock_acct = 0;
+	long nr_pages, acct_pages;
 	bool rsvd;
 	dma_addr_t iova = vaddr - dma->vaddr + dma->iova;
 
@@ -648,28 +688,39 @@ static long vfio_pin_pages_remote(struct vfio_dma *dma, unsigned long vaddr,
 			    rsvd != is_invalid_reserved_pfn(pfn))
 				goto out;
 
+			/*
+			 * A VM_PFNMAP pfn comes alone in the batch, anything
+			 * else has a valid page and can be consumed together
+			 * with the rest of its folio.
+			 */
+			nr_pages = 1;
+			if (batch->size > 1)
+				nr_pages = vfio_batch_folio_run(batch);
+
 			/*
 			 * Reserved pages aren't counted against the user,
 			 * externally pinned pages are already counted against
 			 * the user.
 			 */
-			if (!rsvd && !vfio_find_vpfn(dma, iova)) {
+			if (!rsvd) {
+				acct_pages = nr_pages -
+					     vfio_vpfn_count(dma, iova, nr_pages);
 				if (!dma->lock_cap &&
-				    mm->locked_vm + lock_acct + 1 > limit) {
+				    mm->locked_vm + lock_acct + acct_pages > limit) {
 					pr_warn("%s: RLIMIT_MEMLOCK (%ld) exceeded\n",
 						__func__, limit << PAGE_SHIFT);
 					ret = -ENOMEM;
 					goto unpin_out;
 				}
-				lock_acct++;
+				lock_acct += acct_pages;
 			}
 
-			pinned++;
-			npage--;
-			vaddr += PAGE_SIZE;
-			iova += PAGE_SIZE;
-			batch->offset++;
-			batch->size--;
+			pinned += nr_pages;
+			npage -= nr_pages;
+			vaddr += nr_pages << PAGE_SHIFT;
+			iova += nr_pages << PAGE_SHIFT;
+			batch->offset += nr_pages;
+			batch->size -= nr_pages;
 
 			if (!batch->size)
 				break;
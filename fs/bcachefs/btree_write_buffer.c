@@ -112,6 +112,48 @@ static noinline void wb_sort(struct wb_key_ref *base, size_t num)
 	}
 }
 
+/*
+ * The btree id is the most significant part of a wb_key_ref, so instead of
+ * sorting every key in one pass, first distribute keys to their btree with a
+ * counting sort and then sort each btree's keys on their own: with heavy
+ * backpointer and LRU traffic that's several much smaller sorts over ranges
+ * that stay in cache.
+ */
+static void wb_sort_by_btree(struct btree_write_buffer *wb)
+{
+	u32 *start = wb->sorted_btree_start;
+	size_t nr = wb->flushing.keys.nr;
+	u32 pos = 0;
+
+	memset(start, 0, sizeof(wb->sorted_btree_start));
+
+	darray_for_each(wb->flushing.keys, k)
+		start[k->btree]++;
+
+	for (unsigned i = 0; i < ARRAY_SIZE(wb->sorted_btree_start); i++) {
+		u32 n = start[i];
+
+		start[i] = pos;
+		pos += n;
+	}
+
+	for (size_t i = 0; i < nr; i++) {
+		struct btree_write_buffered_key *k = &wb->flushing.keys.data[i];
+		struct wb_key_ref *r = &wb->sorted.data[start[k->btree]++];
+
+		r->idx = i;
+		r->btree = k->btree;
+		memcpy(&r->pos, &k->k.k.p, sizeof(struct bpos));
+	}
+	wb->sorted.nr = nr;
+
+	/* start[i] now points to the end of btree i's keys: */
+	for (unsigned i = 0, prev = 0; i < ARRAY_SIZE(wb->sorted_btree_start); i++) {
+		wb_sort(wb->sorted.data + prev, start[i] - prev);
+		prev = start[i];
+	}
+}
+
 static noinline int wb_flush_one_slowpath(struct btree_trans *trans,
 					  struct btree_iter *iter,
 					  struct btree_write_buffered_key *wb)
@@ -302,13 +344,6 @@ static int bch2_btree_write_buffer_flush_locked(struct btree_trans *trans)
 	move_keys_from_inc_to_flushing(wb);
 	mutex_unlock(&wb->inc.lock);
 
-	for (size_t i = 0; i < wb->flushing.keys.nr; i++) {
-		wb->sorted.data[i].idx = i;
-		wb->sorted.data[i].btree = wb->flushing.keys.data[i].btree;
-		memcpy(&wb->sorted.data[i].pos, &wb->flushing.keys.data[i].k.k.p, sizeof(struct bpos));
-	}
-	wb->sorted.nr = wb->flushing.keys.nr;
-
 	/*
 	 * We first sort so that we can detect and skip redundant updates, and
 	 * then we attempt to flush in sorted btree order, as this is most
@@ -323,7 +358,7 @@ static int bch2_btree_write_buffer_flush_locked(struct btree_trans *trans)
 	 * If that happens, simply skip the key so we can optimistically insert
 	 * as many keys as possible in the fast path.
 	 */
-	wb_sort(wb->sorted.data, wb->sorted.nr);
+	wb_sort_by_btree(wb);
 
 	darray_for_each(wb->sorted, i) {
 		struct btree_write_buffered_key *k = &wb->flushing.keys.data[i->idx];
@@ -49,6 +49,8 @@ struct btree_write_buffer_keys {
 
 struct btree_write_buffer {
 	DARRAY(struct wb_key_ref)	sorted;
+	/* start of each btree's keys in @sorted, see wb_sort_by_btree(): */
+	u32				sorted_btree_start[1U << 8];
 	struct btree_write_buffer_keys	inc;
 	struct btree_write_buffer_keys	flushing;
 	struct work_struct		flush_work;
@@ -55,9 +55,10 @@ static void raid5_recov(unsigned disks, unsigned failed_idx,
 
 static void raid_gen(int nd, int np, size_t size, void **v)
 {
-	if (np >= 1)
+	/* gen_syndrome() computes P as well as Q: */
+	if (np == 1)
 		raid5_recov(nd + np, nd, size, v);
-	if (np >= 2)
+	if (np == 2)
 		raid6_call.gen_syndrome(nd + np, size, v);
 	BUG_ON(np > 2);
 }
@@ -657,13 +658,28 @@ static void ec_validate_checksums(struct bch_fs *c, struct ec_stripe_buf *buf)
 
 /* Erasure coding: */
 
+/*
+ * Generate parity a chunk at a time, so that the data blocks of a chunk are
+ * still in cache for every pass the raid code makes over them, instead of
+ * streaming whole buckets from memory for each pass:
+ */
+#define EC_GEN_CHUNK_BYTES	(64U << 10)
+
 static void ec_generate_ec(struct ec_stripe_buf *buf)
 {
 	struct bch_stripe *v = &bkey_i_to_stripe(&buf->key)->v;
 	unsigned nr_data = v->nr_blocks - v->nr_redundant;
 	unsigned bytes = le16_to_cpu(v->sectors) << 9;
+	void *data[BCH_BKEY_PTRS_MAX];
 
-	raid_gen(nr_data, v->nr_redundant, bytes, buf->data);
+	for (unsigned offset = 0; offset < bytes; offset += EC_GEN_CHUNK_BYTES) {
+		unsigned len = min(bytes - offset, EC_GEN_CHUNK_BYTES);
+
+		for (unsigned i = 0; i < v->nr_blocks; i++)
+			data[i] = buf->data[i] + offset;
+
+		raid_gen(nr_data, v->nr_redundant, len, data);
+	}
 }
 
 static unsigned ec_nr_failed(struct ec_stripe_buf *buf)
@@ -2,8 +2,12 @@
 #ifndef _EYTZINGER_H
 #define _EYTZINGER_H
 
+#include <linux/align.h>
 #include <linux/bitops.h>
+#include <linux/cache.h>
 #include <linux/log2.h>
+#include <linux/minmax.h>
+#include <linux/prefetch.h>
 
 #ifdef EYTZINGER_DEBUG
 #include <linux/bug.h>
@@ -239,6 +243,26 @@ static inline unsigned inorder_to_eytzinger0(unsigned i, unsigned size)
 	     (_i) != -1;				\
 	     (_i) = eytzinger0_prev((_i), (_size)))
 
+/*
+ * Start fetching the grandchildren of node @n (one based) while we're still
+ * comparing against @n: they're adjacent, and whichever way the next two
+ * comparisons go one of them is visited.  They may span more than one
+ * cacheline, so fetch every line they touch.
+ */
+static inline void eytzinger1_prefetch(void *base1, size_t nr, size_t size,
+				       size_t n)
+{
+	unsigned long p, end;
+
+	if (unlikely((n << 2) > nr))
+		return;
+
+	p = (unsigned long) base1 + (n << 2) * size;
+	end = p + min_t(size_t, 4, nr + 1 - (n << 2)) * size;
+	for (p = ALIGN_DOWN(p, L1_CACHE_BYTES); p < end; p += L1_CACHE_BYTES)
+		prefetch((void *) p);
+}
+
 /* return greatest node <= @search, or -1 if not found */
 static inline int eytzinger0_find_le(void *base, size_t nr, size_t size,
 				     cmp_func_t cmp, const void *search)
@@ -246,8 +270,10 @@ static inline int eytzinger0_find_le(void *base, size_t nr, size_t size,
 	void *base1 = base - size;
 	unsigned n = 1;
 
-	while (n <= nr)
+	while (n <= nr) {
+		eytzinger1_prefetch(base1, nr, size, n);
 		n = eytzinger1_child(n, cmp(base1 + n * size, search) <= 0);
+	}
 	n >>= __ffs(n) + 1;
 	return n - 1;
 }
@@ -259,8 +285,10 @@ static inline int eytzinger0_find_gt(void *base, size_t nr, size_t size,
 	void *base1 = base - size;
 	unsigned n = 1;
 
-	while (n <= nr)
+	while (n <= nr) {
+		eytzinger1_prefetch(base1, nr, size, n);
 		n = eytzinger1_child(n, cmp(base1 + n * size, search) <= 0);
+	}
 	n >>= __ffs(n + 1) + 1;
 	return n - 1;
 }
@@ -272,8 +300,10 @@ static inline int eytzinger0_find_ge(void *base, size_t nr, size_t size,
 	void *base1 = base - size;
 	unsigned n = 1;
 
-	while (n <= nr)
+	while (n <= nr) {
+		eytzinger1_prefetch(base1, nr, size, n);
 		n = eytzinger1_child(n, cmp(base1 + n * size, search) < 0);
+	}
 	n >>= __ffs(n + 1) + 1;
 	return n - 1;
 }
@@ -288,7 +318,8 @@ static inline int eytzinger0_find_ge(void *base, size_t nr, size_t size,
 	int _res;							\
 									\
 	while (_i <= _nr &&						\
-	       (_res = _cmp(_search, _base1 + _i * _size)))		\
+	       (eytzinger1_prefetch(_base1, _nr, _size, _i),		\
+		_res = _cmp(_search, _base1 + _i * _size)))		\
 		_i = eytzinger1_child(_i, _res > 0);			\
 	_i - 1;								\
 })
@@ -50,6 +50,32 @@ static int __init init_dax_wait_table(void)
 }
 fs_initcall(init_dax_wait_table);
 
+/*
+ * Writes of at least this many bytes through dax_iomap_rw() use
+ * cache-bypassing stores, so large sequential writes don't flush the LLC.
+ * 0 disables.
+ */
+static unsigned long dax_nt_threshold __read_mostly = PMD_SIZE;
+
+#ifdef CONFIG_SYSCTL
+static const struct ctl_table dax_sysctls[] = {
+	{
+		.procname	= "dax_nt_threshold",
+		.data		= &dax_nt_threshold,
+		.maxlen		= sizeof(dax_nt_threshold),
+		.mode		= 0644,
+		.proc_handler	= proc_doulongvec_minmax,
+	},
+};
+
+static int __init init_dax_sysctls(void)
+{
+	register_sysctl_init("fs", dax_sysctls);
+	return 0;
+}
+fs_initcall(init_dax_sysctls);
+#endif
+
 /*
  * DAX pagecache entries use XArray value entries so they can't be mistaken
  * for pages.  We use one bit for locking, one bit for the entry size (PMD)
@@ -1442,6 +1468,9 @@ static int dax_iomap_iter(struct iomap_iter *iomi, struct iov_iter *iter)
 	loff_t end = pos + length, done = 0;
 	bool write = iov_iter_rw(iter) == WRITE;
 	bool cow = write && iomap->flags & IOMAP_F_SHARED;
+	unsigned long nt_threshold = READ_ONCE(dax_nt_threshold);
+	struct super_block *sb = iomi->inode->i_sb;
+	bool nt;
 	ssize_t ret = 0;
 	size_t xfer;
 	int id;
@@ -1486,6 +1515,12 @@ static int dax_iomap_iter(struct iomap_iter *iomi, struct iov_iter *iter)
 					      (end - 1) >> PAGE_SHIFT);
 	}
 
+	/*
+	 * The flushcache variant is what pmem needs for durability anyway, and
+	 * harmless for cache coherent memory, so it can be used for any device.
+	 */
+	nt = write && nt_threshold && iov_iter_count(iter) >= nt_threshold;
+
 	id = dax_read_lock();
 	while ((pos = iomi->pos) < end) {
 		unsigned offset = pos & (PAGE_SIZE - 1);
@@ -1527,15 +1562,21 @@ static int dax_iomap_iter(struct iomap_iter *iomi, struct iov_iter *iter)
 		if (map_len > end - pos)
 			map_len = end - pos;
 
-		if (recovery)
+		if (recovery) {
 			xfer = dax_recovery_write(dax_dev, pgoff, kaddr,
 					map_len, iter);
-		else if (write)
+		} else if (nt) {
+			xfer = _copy_from_iter_flushcache(kaddr, map_len, iter);
+			atomic64_add(xfer, &sb->s_dax_nt_bytes);
+		} else if (write) {
 			xfer = dax_copy_from_iter(dax_dev, pgoff, kaddr,
 					map_len, iter);
-		else
+			atomic64_add(xfer, &sb->s_dax_cached_bytes);
+		} else {
 			xfer = dax_copy_to_iter(dax_dev, pgoff, kaddr,
 					map_len, iter);
+			atomic64_add(xfer, &sb->s_dax_cached_bytes);
+		}
 
 		length = xfer;
 		ret = iomap_iter_advance(iomi, &length);
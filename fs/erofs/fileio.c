@@ -3,6 +3,7 @@
  * Copyright (C) 2024, Alibaba Cloud
  */
 #include "internal.h"
+#include <linux/blkdev.h>
 #include <trace/events/erofs.h>
 
 struct erofs_fileio_rq {
@@ -43,6 +44,25 @@ static void erofs_fileio_ki_complete(struct kiocb *iocb, long ret)
 	kfree(rq);
 }
 
+/*
+ * Direct I/O only pays off if the backing filesystem can take it as is;
+ * fall back to buffered reads for requests it would reject with -EINVAL.
+ */
+static bool erofs_fileio_can_dio(struct erofs_fileio_rq *rq,
+				 struct iov_iter *iter)
+{
+	struct super_block *bsb = file_inode(rq->iocb.ki_filp)->i_sb;
+	unsigned int mask;
+
+	if (!test_opt(&EROFS_SB(rq->sb)->opt, DIRECT_IO) ||
+	    !(rq->iocb.ki_filp->f_mode & FMODE_CAN_ODIRECT))
+		return false;
+	mask = (bsb->s_bdev ? bdev_logical_block_size(bsb->s_bdev) :
+				bsb->s_blocksize) - 1;
+	return !(rq->iocb.ki_pos & mask) &&
+		iov_iter_is_aligned(iter, mask, mask);
+}
+
 static void erofs_fileio_rq_submit(struct erofs_fileio_rq *rq)
 {
 	struct iov_iter iter;
@@ -53,11 +73,10 @@ static void erofs_fileio_rq_submit(struct erofs_fileio_rq *rq)
 	rq->iocb.ki_pos = rq->bio.bi_iter.bi_sector << SECTOR_SHIFT;
 	rq->iocb.ki_ioprio = get_current_ioprio();
 	rq->iocb.ki_complete = erofs_fileio_ki_complete;
-	if (test_opt(&EROFS_SB(rq->sb)->opt, DIRECT_IO) &&
-	    rq->iocb.ki_filp->f_mode & FMODE_CAN_ODIRECT)
-		rq->iocb.ki_flags = IOCB_DIRECT;
 	iov_iter_bvec(&iter, ITER_DEST, rq->bvecs, rq->bio.bi_vcnt,
 		      rq->bio.bi_iter.bi_size);
+	if (erofs_fileio_can_dio(rq, &iter))
+		rq->iocb.ki_flags = IOCB_DIRECT;
 	ret = vfs_iocb_iter_read(rq->iocb.ki_filp, &rq->iocb, &iter);
 	if (ret != -EIOCBQUEUED)
 		erofs_fileio_ki_complete(&rq->iocb, ret);
@@ -1384,6 +1384,43 @@ static int z_erofs_decompress_queue(const struct z_erofs_decompressqueue *io,
 	return err;
 }
 
+/* max pclusters decompressed by one async work before fanning out */
+#define Z_EROFS_SPLIT_NR_PCLUSTERS	8
+
+static void z_erofs_decompressqueue_work(struct work_struct *work);
+
+/*
+ * Pclusters of a chain are independent of each other, so hand everything
+ * past the first batch to another unbound work and let other CPUs pick it
+ * up instead of decompressing a long readahead chain serially.
+ */
+static void z_erofs_split_queue(struct z_erofs_decompressqueue *bgq)
+{
+	struct z_erofs_decompressqueue *q;
+	struct z_erofs_pcluster *pcl = bgq->head, *next;
+	unsigned int i;
+
+	for (i = 1; i < Z_EROFS_SPLIT_NR_PCLUSTERS; ++i) {
+		pcl = READ_ONCE(pcl->next);
+		if (pcl == Z_EROFS_PCLUSTER_TAIL)
+			return;
+	}
+	next = READ_ONCE(pcl->next);
+	if (next == Z_EROFS_PCLUSTER_TAIL)
+		return;
+
+	q = kvzalloc(sizeof(*q), GFP_KERNEL | __GFP_NOWARN);
+	if (!q)
+		return;
+	q->sb = bgq->sb;
+	q->head = next;
+	q->eio = bgq->eio;
+	INIT_WORK(&q->u.work, z_erofs_decompressqueue_work);
+	/* still owned by this chain, just no longer followed by @next */
+	WRITE_ONCE(pcl->next, Z_EROFS_PCLUSTER_TAIL);
+	queue_work(z_erofs_workqueue, &q->u.work);
+}
+
 static void z_erofs_decompressqueue_work(struct work_struct *work)
 {
 	struct z_erofs_decompressqueue *bgq =
@@ -1391,6 +1428,7 @@ static void z_erofs_decompressqueue_work(struct work_struct *work)
 	struct page *pagepool = NULL;
 
 	DBG_BUGON(bgq->head == Z_EROFS_PCLUSTER_TAIL);
+	z_erofs_split_queue(bgq);
 	z_erofs_decompress_queue(bgq, &pagepool);
 	erofs_release_pages(&pagepool);
 	kvfree(bgq);
@@ -38,6 +38,8 @@
 #include <linux/compat.h>
 #include <linux/rculist.h>
 #include <linux/capability.h>
+#include <linux/llist.h>
+#include <linux/percpu.h>
 #include <net/busy_poll.h>
 
 /*
@@ -141,9 +143,13 @@ struct epitem {
 
 	/*
 	 * Works together "struct eventpoll"->ovflist in keeping the
-	 * single linked chain of items.
+	 * single linked chain of items, or links the item on a per-CPU
+	 * ready list.  Either way, EP_UNACTIVE_PTR means not chained.
 	 */
-	struct epitem *next;
+	union {
+		struct epitem *next;
+		struct llist_node pcpu_llink;
+	};
 
 	/* The file descriptor information this item refers to */
 	struct epoll_filefd ffd;
@@ -171,6 +177,19 @@ struct epitem {
 	struct epoll_event event;
 };
 
+/*
+ * Per-CPU ready list, see EPIOCSPERCPU.  ep_poll_callback() queues items
+ * here without taking ep->lock, and they move to ep->rdllist in batches
+ * when the ready list is scanned.
+ */
+struct ep_pcpu {
+	struct llist_head rdllist;
+#ifdef CONFIG_NET_RX_BUSY_POLL
+	/* NAPI ID last seen by the callback on this CPU */
+	unsigned int napi_id;
+#endif
+};
+
 /*
  * This structure is stored inside the "private_data" member of the file
  * structure and represents the main data structure for the eventpoll
@@ -210,6 +229,13 @@ struct eventpoll {
 	/* wakeup_source used when ep_send_events or __ep_eventpoll_poll is running */
 	struct wakeup_source *ws;
 
+	/*
+	 * Per-CPU ready lists and a hint of which may be non-empty, NULL
+	 * unless enabled by EPIOCSPERCPU.  Never changes once items exist.
+	 */
+	struct ep_pcpu __percpu *pcpu;
+	cpumask_var_t pcpu_mask;
+
 	/* The user that created the eventpoll descriptor */
 	struct user_struct *user;
 
@@ -389,7 +415,8 @@ static inline struct epitem *ep_item_from_wait(wait_queue_entry_t *p)
 static inline int ep_events_available(struct eventpoll *ep)
 {
 	return !list_empty_careful(&ep->rdllist) ||
-		READ_ONCE(ep->ovflist) != EP_UNACTIVE_PTR;
+		READ_ONCE(ep->ovflist) != EP_UNACTIVE_PTR ||
+		(READ_ONCE(ep->pcpu) && !cpumask_empty(ep->pcpu_mask));
 }
 
 #ifdef CONFIG_NET_RX_BUSY_POLL
@@ -438,6 +465,51 @@ static bool ep_busy_loop_end(void *p, unsigned long start_time)
  *
  * we must do our busy polling with irqs enabled
  */
+/* Distinct NAPI IDs busy polled at most per round in per-CPU mode */
+#define EP_PCPU_MAX_NAPI	8
+
+/*
+ * In per-CPU mode, busy poll each distinct NAPI ID collected by the
+ * callbacks in turn, until events show up.
+ */
+static bool ep_busy_loop_pcpu(struct eventpoll *ep, u16 budget,
+			      bool prefer_busy_poll)
+{
+	unsigned int ids[EP_PCPU_MAX_NAPI];
+	int cpu, i, nr = 0;
+
+	for_each_possible_cpu(cpu) {
+		unsigned int napi_id;
+
+		napi_id = READ_ONCE(per_cpu_ptr(ep->pcpu, cpu)->napi_id);
+		if (!napi_id_valid(napi_id))
+			continue;
+		for (i = 0; i < nr && ids[i] != napi_id; i++)
+			;
+		if (i == nr)
+			ids[nr++] = napi_id;
+		if (nr == EP_PCPU_MAX_NAPI)
+			break;
+	}
+
+	for (i = 0; i < nr; i++) {
+		/* For ep_suspend/resume_napi_irqs() */
+		WRITE_ONCE(ep->napi_id, ids[i]);
+		napi_busy_loop(ids[i], ep_busy_loop_end, ep,
+			       prefer_busy_poll, budget);
+		if (ep_events_available(ep))
+			return true;
+		if (prefer_busy_poll)
+			napi_resume_irqs(ids[i]);
+	}
+
+	/* As below, forget the IDs until sockets report them again */
+	for_each_possible_cpu(cpu)
+		WRITE_ONCE(per_cpu_ptr(ep->pcpu, cpu)->napi_id, 0);
+	WRITE_ONCE(ep->napi_id, 0);
+	return false;
+}
+
 static bool ep_busy_loop(struct eventpoll *ep)
 {
 	unsigned int napi_id = READ_ONCE(ep->napi_id);
@@ -447,6 +519,9 @@ static bool ep_busy_loop(struct eventpoll *ep)
 	if (!budget)
 		budget = BUSY_POLL_BUDGET;
 
+	if (READ_ONCE(ep->pcpu) && ep_busy_loop_on(ep))
+		return ep_busy_loop_pcpu(ep, budget, prefer_busy_poll);
+
 	if (napi_id_valid(napi_id) && ep_busy_loop_on(ep)) {
 		napi_busy_loop(napi_id, ep_busy_loop_end,
 			       ep, prefer_busy_poll, budget);
@@ -488,6 +563,15 @@ static inline void ep_set_busy_poll_napi_id(struct epitem *epi)
 
 	napi_id = READ_ONCE(sk->sk_napi_id);
 
+	/* Keep the shared cacheline out of the per-CPU callbacks */
+	if (ep->pcpu) {
+		struct ep_pcpu *pcpu = raw_cpu_ptr(ep->pcpu);
+
+		if (napi_id_valid(napi_id) && napi_id != pcpu->napi_id)
+			WRITE_ONCE(pcpu->napi_id, napi_id);
+		return;
+	}
+
 	/* Non-NAPI IDs can be rejected
 	 *	or
 	 * Nothing to do if we already have this ID
@@ -725,6 +809,48 @@ static inline void ep_pm_stay_awake_rcu(struct epitem *epi)
 }
 
 
+/*
+ * Move the items queued by ep_poll_callback_pcpu() to ->rdllist, in one
+ * batch per CPU, and release them for queueing again.
+ */
+static void ep_harvest_pcpu(struct eventpoll *ep)
+{
+	struct llist_node *node, *next;
+	struct epitem *epi;
+	int cpu;
+
+	lockdep_assert_held_write(&ep->lock);
+
+	for_each_cpu(cpu, ep->pcpu_mask) {
+		struct ep_pcpu *pcpu = per_cpu_ptr(ep->pcpu, cpu);
+
+		/* Before emptying the list, pairs with ep_queue_pcpu() */
+		cpumask_clear_cpu(cpu, ep->pcpu_mask);
+		smp_mb__after_atomic();
+
+		node = llist_reverse_order(llist_del_all(&pcpu->rdllist));
+		for (; node; node = next) {
+			next = node->next;
+			epi = llist_entry(node, struct epitem, pcpu_llink);
+			smp_store_release(&epi->next, EP_UNACTIVE_PTR);
+			if (!ep_is_linked(epi))
+				list_add_tail(&epi->rdllink, &ep->rdllist);
+		}
+	}
+}
+
+/*
+ * Whether anyone waits on ep->wq.  ep->lock does not serialize against
+ * waiters in per-CPU mode (see ep_wq_lock()), so a barrier is needed
+ * there to pair with the one in ep_poll().
+ */
+static bool ep_wq_active(struct eventpoll *ep)
+{
+	if (ep->pcpu)
+		return wq_has_sleeper(&ep->wq);
+	return waitqueue_active(&ep->wq);
+}
+
 /*
  * ep->mutex needs to be held because we could be hit by
  * eventpoll_release_file() and epoll_ctl().
@@ -741,6 +867,8 @@ static void ep_start_scan(struct eventpoll *ep, struct list_head *txlist)
 	 */
 	lockdep_assert_irqs_enabled();
 	write_lock_irq(&ep->lock);
+	if (ep->pcpu)
+		ep_harvest_pcpu(ep);
 	list_splice_init(&ep->rdllist, txlist);
 	WRITE_ONCE(ep->ovflist, NULL);
 	write_unlock_irq(&ep->lock);
@@ -788,7 +916,7 @@ static void ep_done_scan(struct eventpoll *ep,
 	__pm_relax(ep->ws);
 
 	if (!list_empty(&ep->rdllist)) {
-		if (waitqueue_active(&ep->wq))
+		if (ep_wq_active(ep))
 			wake_up(&ep->wq);
 	}
 
@@ -815,6 +943,10 @@ static bool ep_refcount_dec_and_test(struct eventpoll *ep)
 static void ep_free(struct eventpoll *ep)
 {
 	ep_resume_napi_irqs(ep);
+	if (ep->pcpu) {
+		free_percpu(ep->pcpu);
+		free_cpumask_var(ep->pcpu_mask);
+	}
 	mutex_destroy(&ep->mtx);
 	free_uid(ep->user);
 	wakeup_source_unregister(ep->ws);
@@ -868,6 +1000,9 @@ static bool __ep_remove(struct eventpoll *ep, struct epitem *epi, bool force)
 	rb_erase_cached(&epi->rbn, &ep->rbr);
 
 	write_lock_irq(&ep->lock);
+	/* Still on a per-CPU list, the callbacks are gone by now */
+	if (ep->pcpu && READ_ONCE(epi->next) != EP_UNACTIVE_PTR)
+		ep_harvest_pcpu(ep);
 	if (ep_is_linked(epi))
 		list_del_init(&epi->rdllink);
 	write_unlock_irq(&ep->lock);
@@ -938,6 +1073,39 @@ static void ep_clear_and_put(struct eventpoll *ep)
 		ep_free(ep);
 }
 
+/*
+ * Switch to per-CPU ready lists.  Only allowed while no file is watched,
+ * so that no callback can run concurrently, and not reversible.
+ */
+static long ep_set_pcpu(struct eventpoll *ep)
+{
+	struct ep_pcpu __percpu *pcpu;
+	long ret = 0;
+
+	mutex_lock(&ep->mtx);
+	if (ep->pcpu)
+		goto out;
+
+	ret = -EBUSY;
+	if (!RB_EMPTY_ROOT(&ep->rbr.rb_root))
+		goto out;
+
+	ret = -ENOMEM;
+	if (!zalloc_cpumask_var(&ep->pcpu_mask, GFP_KERNEL))
+		goto out;
+	pcpu = alloc_percpu(struct ep_pcpu);
+	if (!pcpu) {
+		free_cpumask_var(ep->pcpu_mask);
+		goto out;
+	}
+
+	smp_store_release(&ep->pcpu, pcpu);
+	ret = 0;
+out:
+	mutex_unlock(&ep->mtx);
+	return ret;
+}
+
 static long ep_eventpoll_ioctl(struct file *file, unsigned int cmd,
 			       unsigned long arg)
 {
@@ -951,6 +1119,9 @@ static long ep_eventpoll_ioctl(struct file *file, unsigned int cmd,
 	case EPIOCGPARAMS:
 		ret = ep_eventpoll_bp_ioctl(file, cmd, arg);
 		break;
+	case EPIOCSPERCPU:
+		ret = ep_set_pcpu(file->private_data);
+		break;
 	default:
 		ret = -EINVAL;
 		break;
@@ -1335,6 +1506,109 @@ static inline bool chain_epi_lockless(struct epitem *epi)
  * queues are used should be detected accordingly.  This is detected using
  * cmpxchg() operation.
  */
+static int ep_exclusive_ewake(struct epitem *epi, __poll_t pollflags)
+{
+	if ((epi->event.events & EPOLLEXCLUSIVE) && !(pollflags & POLLFREE)) {
+		switch (pollflags & EPOLLINOUT_BITS) {
+		case EPOLLIN:
+			return !!(epi->event.events & EPOLLIN);
+		case EPOLLOUT:
+			return !!(epi->event.events & EPOLLOUT);
+		case 0:
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int ep_poll_callback_done(wait_queue_entry_t *wait, struct epitem *epi,
+				 __poll_t pollflags, int ewake)
+{
+	if (!(epi->event.events & EPOLLEXCLUSIVE))
+		ewake = 1;
+
+	if (pollflags & POLLFREE) {
+		/*
+		 * If we race with ep_remove_wait_queue() it can miss
+		 * ->whead = NULL and do another remove_wait_queue() after
+		 * us, so we can't use __remove_wait_queue().
+		 */
+		list_del_init(&wait->entry);
+		/*
+		 * ->whead != NULL protects us from the race with
+		 * ep_clear_and_put() or ep_remove(), ep_remove_wait_queue()
+		 * takes whead->lock held by the caller. Once we nullify it,
+		 * nothing protects ep/epi or even wait.
+		 */
+		smp_store_release(&ep_pwq_from_wait(wait)->whead, NULL);
+	}
+
+	return ewake;
+}
+
+/*
+ * Queue @epi on this CPU's ready list, unless already queued somewhere.
+ * Returns true if the list was empty: only then do the waiters need a
+ * wakeup, the harvest that empties the list takes all the others along.
+ */
+static bool ep_queue_pcpu(struct eventpoll *ep, struct epitem *epi)
+{
+	struct ep_pcpu *pcpu;
+	int cpu;
+
+	/* Fast preliminary check */
+	if (READ_ONCE(epi->next) != EP_UNACTIVE_PTR)
+		return false;
+	if (cmpxchg(&epi->next, EP_UNACTIVE_PTR, NULL) != EP_UNACTIVE_PTR)
+		return false;
+
+	ep_pm_stay_awake_rcu(epi);
+
+	/* Migrating away after the lookup is harmless, just less local */
+	cpu = raw_smp_processor_id();
+	pcpu = per_cpu_ptr(ep->pcpu, cpu);
+	if (!llist_add(&epi->pcpu_llink, &pcpu->rdllist))
+		return false;
+
+	if (!cpumask_test_cpu(cpu, ep->pcpu_mask))
+		cpumask_set_cpu(cpu, ep->pcpu_mask);
+	return true;
+}
+
+/*
+ * ep_poll_callback() in per-CPU mode: no ep->lock, and the waiters are
+ * woken only when this CPU's ready list goes from empty to non-empty.
+ */
+static int ep_poll_callback_pcpu(wait_queue_entry_t *wait, struct epitem *epi,
+				 __poll_t pollflags, int sync)
+{
+	struct eventpoll *ep = epi->ep;
+	int ewake = 0;
+
+	ep_set_busy_poll_napi_id(epi);
+
+	if (!(epi->event.events & ~EP_PRIVATE_BITS))
+		goto out;
+	if (pollflags && !(pollflags & epi->event.events))
+		goto out;
+
+	if (!ep_queue_pcpu(ep, epi))
+		goto out;
+
+	/* Full barrier, pairs with the one in ep_poll() */
+	if (wq_has_sleeper(&ep->wq)) {
+		ewake = ep_exclusive_ewake(epi, pollflags);
+		if (sync)
+			wake_up_sync(&ep->wq);
+		else
+			wake_up(&ep->wq);
+	}
+	if (waitqueue_active(&ep->poll_wait))
+		ep_poll_safewake(ep, epi, pollflags & EPOLL_URING_WAKE);
+out:
+	return ep_poll_callback_done(wait, epi, pollflags, ewake);
+}
+
 static int ep_poll_callback(wait_queue_entry_t *wait, unsigned mode, int sync, void *key)
 {
 	int pwake = 0;
@@ -1344,6 +1618,9 @@ static int ep_poll_callback(wait_queue_entry_t *wait, unsigned mode, int sync, v
 	unsigned long flags;
 	int ewake = 0;
 
+	if (ep->pcpu)
+		return ep_poll_callback_pcpu(wait, epi, pollflags, sync);
+
 	read_lock_irqsave(&ep->lock, flags);
 
 	ep_set_busy_poll_napi_id(epi);
@@ -1386,22 +1663,7 @@ static int ep_poll_callback(wait_queue_entry_t *wait, unsigned mode, int sync, v
 	 * wait list.
 	 */
 	if (waitqueue_active(&ep->wq)) {
-		if ((epi->event.events & EPOLLEXCLUSIVE) &&
-					!(pollflags & POLLFREE)) {
-			switch (pollflags & EPOLLINOUT_BITS) {
-			case EPOLLIN:
-				if (epi->event.events & EPOLLIN)
-					ewake = 1;
-				break;
-			case EPOLLOUT:
-				if (epi->event.events & EPOLLOUT)
-					ewake = 1;
-				break;
-			case 0:
-				ewake = 1;
-				break;
-			}
-		}
+		ewake = ep_exclusive_ewake(epi, pollflags);
 		if (sync)
 			wake_up_sync(&ep->wq);
 		else
@@ -1417,26 +1679,7 @@ static int ep_poll_callback(wait_queue_entry_t *wait, unsigned mode, int sync, v
 	if (pwake)
 		ep_poll_safewake(ep, epi, pollflags & EPOLL_URING_WAKE);
 
-	if (!(epi->event.events & EPOLLEXCLUSIVE))
-		ewake = 1;
-
-	if (pollflags & POLLFREE) {
-		/*
-		 * If we race with ep_remove_wait_queue() it can miss
-		 * ->whead = NULL and do another remove_wait_queue() after
-		 * us, so we can't use __remove_wait_queue().
-		 */
-		list_del_init(&wait->entry);
-		/*
-		 * ->whead != NULL protects us from the race with
-		 * ep_clear_and_put() or ep_remove(), ep_remove_wait_queue()
-		 * takes whead->lock held by the caller. Once we nullify it,
-		 * nothing protects ep/epi or even wait.
-		 */
-		smp_store_release(&ep_pwq_from_wait(wait)->whead, NULL);
-	}
-
-	return ewake;
+	return ep_poll_callback_done(wait, epi, pollflags, ewake);
 }
 
 /*
@@ -1757,7 +2000,7 @@ static int ep_insert(struct eventpoll *ep, const struct epoll_event *event,
 		ep_pm_stay_awake(epi);
 
 		/* Notify waiting tasks that events are available */
-		if (waitqueue_active(&ep->wq))
+		if (ep_wq_active(ep))
 			wake_up(&ep->wq);
 		if (waitqueue_active(&ep->poll_wait))
 			pwake++;
@@ -1833,7 +2076,7 @@ static int ep_modify(struct eventpoll *ep, struct epitem *epi,
 			ep_pm_stay_awake(epi);
 
 			/* Notify waiting tasks that events are available */
-			if (waitqueue_active(&ep->wq))
+			if (ep_wq_active(ep))
 				wake_up(&ep->wq);
 			if (waitqueue_active(&ep->poll_wait))
 				pwake++;
@@ -2013,6 +2256,27 @@ static int ep_try_send_events(struct eventpoll *ep,
  * Return: the number of ready events which have been fetched, or an
  *          error code, in case of error.
  */
+/*
+ * ep->wq waiters are serialized against ep_poll_callback() by ep->lock,
+ * except in per-CPU mode, where the callback does not take it and the
+ * waitqueue's own lock is used instead.
+ */
+static void ep_wq_lock(struct eventpoll *ep)
+{
+	if (ep->pcpu)
+		spin_lock_irq(&ep->wq.lock);
+	else
+		write_lock_irq(&ep->lock);
+}
+
+static void ep_wq_unlock(struct eventpoll *ep)
+{
+	if (ep->pcpu)
+		spin_unlock_irq(&ep->wq.lock);
+	else
+		write_unlock_irq(&ep->lock);
+}
+
 static int ep_poll(struct eventpoll *ep, struct epoll_event __user *events,
 		   int maxevents, struct timespec64 *timeout)
 {
@@ -2082,26 +2346,41 @@ static int ep_poll(struct eventpoll *ep, struct epoll_event __user *events,
 		init_wait(&wait);
 		wait.func = ep_autoremove_wake_function;
 
-		write_lock_irq(&ep->lock);
+		ep_wq_lock(ep);
 		/*
 		 * Barrierless variant, waitqueue_active() is called under
 		 * the same lock on wakeup ep_poll_callback() side, so it
-		 * is safe to avoid an explicit barrier.
+		 * is safe to avoid an explicit barrier.  In per-CPU mode
+		 * the wakers do not take that lock and the barrier is
+		 * explicit, below.
 		 */
 		__set_current_state(TASK_INTERRUPTIBLE);
 
-		/*
-		 * Do the final check under the lock. ep_start/done_scan()
-		 * plays with two lists (->rdllist and ->ovflist) and there
-		 * is always a race when both lists are empty for short
-		 * period of time although events are pending, so lock is
-		 * important.
-		 */
-		eavail = ep_events_available(ep);
-		if (!eavail)
+		if (ep->pcpu) {
+			/*
+			 * The per-CPU wakers do not take ep->wq.lock: queue
+			 * first and check after a barrier, pairing with the
+			 * one in wq_has_sleeper(), see ep_wq_active().
+			 */
 			__add_wait_queue_exclusive(&ep->wq, &wait);
+			smp_mb();
+			eavail = ep_events_available(ep);
+			if (eavail)
+				__remove_wait_queue(&ep->wq, &wait);
+		} else {
+			/*
+			 * Do the final check under the lock.
+			 * ep_start/done_scan() plays with two lists (->rdllist
+			 * and ->ovflist) and there is always a race when both
+			 * lists are empty for short period of time although
+			 * events are pending, so lock is important.
+			 */
+			eavail = ep_events_available(ep);
+			if (!eavail)
+				__add_wait_queue_exclusive(&ep->wq, &wait);
+		}
 
-		write_unlock_irq(&ep->lock);
+		ep_wq_unlock(ep);
 
 		if (!eavail)
 			timed_out = !schedule_hrtimeout_range(to, slack,
@@ -2116,7 +2395,7 @@ static int ep_poll(struct eventpoll *ep, struct epoll_event __user *events,
 		eavail = 1;
 
 		if (!list_empty_careful(&wait.entry)) {
-			write_lock_irq(&ep->lock);
+			ep_wq_lock(ep);
 			/*
 			 * If the thread timed out and is not on the wait queue,
 			 * it means that the thread was woken up after its
@@ -2127,7 +2406,7 @@ static int ep_poll(struct eventpoll *ep, struct epoll_event __user *events,
 			if (timed_out)
 				eavail = list_empty(&wait.entry);
 			__remove_wait_queue(&ep->wq, &wait);
-			write_unlock_irq(&ep->lock);
+			ep_wq_unlock(ep);
 		}
 	}
 }
@@ -382,6 +382,8 @@ struct files_struct *dup_fd(struct files_struct *oldf, struct fd_range *punch_ho
 	newf->resize_in_progress = false;
 	init_waitqueue_head(&newf->resize_wait);
 	newf->next_fd = 0;
+	newf->fd_batch = 0;
+	newf->fd_cache = NULL;
 	new_fdt = &newf->fdtab;
 	new_fdt->max_fds = NR_OPEN_DEFAULT;
 	new_fdt->close_on_exec = newf->close_on_exec_init;
@@ -496,6 +498,7 @@ void put_files_struct(struct files_struct *files)
 		/* free the arrays if they are not embedded */
 		if (fdt != &files->fdtab)
 			__free_fdtable(fdt);
+		free_percpu(files->fd_cache);
 		kmem_cache_free(files_cachep, files);
 	}
 }
@@ -549,17 +552,25 @@ static unsigned int find_next_fd(struct fdtable *fdt, unsigned int start)
 	return find_next_zero_bit(fdt->open_fds, maxfd, start);
 }
 
+static void __put_unused_fd(struct files_struct *files, unsigned int fd)
+{
+	struct fdtable *fdt = files_fdtable(files);
+	__clear_open_fd(fd, fdt);
+	if (fd < files->next_fd)
+		files->next_fd = fd;
+}
+
 /*
  * allocate a file descriptor, mark it busy.
+ * Called with files->file_lock held, which expand_files() may drop.
  */
-static int alloc_fd(unsigned start, unsigned end, unsigned flags)
+static int alloc_fd_locked(struct files_struct *files, unsigned start,
+			   unsigned end, unsigned flags)
 {
-	struct files_struct *files = current->files;
 	unsigned int fd;
 	int error;
 	struct fdtable *fdt;
 
-	spin_lock(&files->file_lock);
 repeat:
 	fdt = files_fdtable(files);
 	fd = start;
@@ -575,12 +586,12 @@ static int alloc_fd(unsigned start, unsigned end, unsigned flags)
 	 */
 	error = -EMFILE;
 	if (unlikely(fd >= end))
-		goto out;
+		return error;
 
 	if (unlikely(fd >= fdt->max_fds)) {
 		error = expand_files(files, fd);
 		if (error < 0)
-			goto out;
+			return error;
 
 		goto repeat;
 	}
@@ -589,12 +600,194 @@ static int alloc_fd(unsigned start, unsigned end, unsigned flags)
 		files->next_fd = fd + 1;
 
 	__set_open_fd(fd, fdt, flags & O_CLOEXEC);
-	error = fd;
 	VFS_BUG_ON(rcu_access_pointer(fdt->fd[fd]) != NULL);
+	return fd;
+}
 
-out:
+/*
+ * Per-CPU caches of reserved descriptors, for processes that gave up on
+ * getting the lowest available descriptor with PR_SET_FD_RESERVE.  A cached
+ * descriptor is marked open with no file installed, just like one between
+ * get_unused_fd_flags() and fd_install(), and already has the close-on-exec
+ * bit of the cache it sits in.
+ */
+#define FD_CACHE_MAX	64
+
+struct fd_cache {
+	spinlock_t lock;
+	unsigned int nr[2];
+	unsigned int fd[2][FD_CACHE_MAX];
+};
+
+static void fd_cache_put(struct files_struct *files, unsigned int *fds,
+			 unsigned int nr, bool cloexec)
+{
+	struct fd_cache *c = raw_cpu_ptr(files->fd_cache);
+
+	spin_lock(&c->lock);
+	/* checked under c->lock, see fd_cache_drain() */
+	if (READ_ONCE(files->fd_batch)) {
+		while (nr && c->nr[cloexec] < FD_CACHE_MAX)
+			c->fd[cloexec][c->nr[cloexec]++] = fds[--nr];
+	}
+	spin_unlock(&c->lock);
+
+	if (nr) {
+		spin_lock(&files->file_lock);
+		while (nr)
+			__put_unused_fd(files, fds[--nr]);
+		spin_unlock(&files->file_lock);
+	}
+}
+
+/* Hand the descriptors of all per-CPU caches back to the file table */
+static void fd_cache_flush(struct files_struct *files)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct fd_cache *c = per_cpu_ptr(files->fd_cache, cpu);
+
+		spin_lock(&c->lock);
+		spin_lock(&files->file_lock);
+		while (c->nr[0])
+			__put_unused_fd(files, c->fd[0][--c->nr[0]]);
+		while (c->nr[1])
+			__put_unused_fd(files, c->fd[1][--c->nr[1]]);
+		spin_unlock(&files->file_lock);
+		spin_unlock(&c->lock);
+	}
+}
+
+/* Give all cached descriptors back, new ones are no longer cached */
+static void fd_cache_drain(struct files_struct *files)
+{
+	WRITE_ONCE(files->fd_batch, 0);
+	fd_cache_flush(files);
+}
+
+static int fd_cache_alloc(struct files_struct *files, unsigned end,
+			  unsigned flags)
+{
+	unsigned int batch = READ_ONCE(files->fd_batch);
+	bool cloexec = flags & O_CLOEXEC;
+	unsigned int fds[FD_CACHE_MAX];
+	struct fd_cache *c;
+	int fd = -1, n;
+
+	c = raw_cpu_ptr(files->fd_cache);
+	spin_lock(&c->lock);
+	if (c->nr[cloexec])
+		fd = c->fd[cloexec][--c->nr[cloexec]];
+	spin_unlock(&c->lock);
+
+	if (fd >= 0) {
+		bool stale;
+
+		if (unlikely(fd >= end)) {
+			/* RLIMIT_NOFILE went down */
+			put_unused_fd(fd);
+			goto slow;
+		}
+		/* close_range(CLOSE_RANGE_CLOEXEC) sets it on reserved fds too */
+		if (cloexec)
+			return fd;
+		rcu_read_lock();
+		stale = test_bit(fd, files_fdtable(files)->close_on_exec);
+		rcu_read_unlock();
+		if (unlikely(stale)) {
+			spin_lock(&files->file_lock);
+			__set_close_on_exec(fd, files_fdtable(files), false);
+			spin_unlock(&files->file_lock);
+		}
+		return fd;
+	}
+
+	/* Refill: the caller gets the lowest of a batch, the rest is cached */
+	spin_lock(&files->file_lock);
+	for (n = 0; n < batch; n++) {
+		fd = alloc_fd_locked(files, 0, end, flags);
+		if (fd < 0)
+			break;
+		fds[n] = fd;
+	}
 	spin_unlock(&files->file_lock);
-	return error;
+	if (!n)
+		goto reclaim;
+	/* pushed from the top, so they are handed out in ascending order */
+	if (n > 1)
+		fd_cache_put(files, fds + 1, n - 1, cloexec);
+	return fds[0];
+
+slow:
+	spin_lock(&files->file_lock);
+	fd = alloc_fd_locked(files, 0, end, flags);
+	spin_unlock(&files->file_lock);
+reclaim:
+	if (fd != -EMFILE)
+		return fd;
+
+	/* The free descriptors may all sit in other CPUs' caches */
+	fd_cache_flush(files);
+	spin_lock(&files->file_lock);
+	fd = alloc_fd_locked(files, 0, end, flags);
+	spin_unlock(&files->file_lock);
+	return fd;
+}
+
+/**
+ * files_set_fd_reserve - switch a file table to per-CPU fd allocation
+ * @batch: descriptors to reserve per CPU at a time, 0 to switch back
+ *
+ * Backs PR_SET_FD_RESERVE.  While enabled, allocations starting from 0 are
+ * served from per-CPU caches of reserved descriptors without taking
+ * ->file_lock, so they are no longer guaranteed to get the lowest available
+ * descriptor.  Not inherited over fork() and reset by execve().
+ */
+int files_set_fd_reserve(unsigned long batch)
+{
+	struct files_struct *files = current->files;
+	struct fd_cache __percpu *pcp;
+	int cpu;
+
+	if (batch > FD_CACHE_MAX)
+		return -EINVAL;
+	if (!batch) {
+		if (files->fd_cache)
+			fd_cache_drain(files);
+		return 0;
+	}
+
+	if (!files->fd_cache) {
+		pcp = alloc_percpu(struct fd_cache);
+		if (!pcp)
+			return -ENOMEM;
+		for_each_possible_cpu(cpu)
+			spin_lock_init(&per_cpu_ptr(pcp, cpu)->lock);
+		if (cmpxchg(&files->fd_cache, NULL, pcp))
+			free_percpu(pcp);
+	}
+	WRITE_ONCE(files->fd_batch, batch);
+	return 0;
+}
+
+int files_get_fd_reserve(void)
+{
+	return READ_ONCE(current->files->fd_batch);
+}
+
+static int alloc_fd(unsigned start, unsigned end, unsigned flags)
+{
+	struct files_struct *files = current->files;
+	int fd;
+
+	if (!start && READ_ONCE(files->fd_batch) && READ_ONCE(files->fd_cache))
+		return fd_cache_alloc(files, end, flags);
+
+	spin_lock(&files->file_lock);
+	fd = alloc_fd_locked(files, start, end, flags);
+	spin_unlock(&files->file_lock);
+	return fd;
 }
 
 int __get_unused_fd_flags(unsigned flags, unsigned long nofile)
@@ -608,14 +801,6 @@ int get_unused_fd_flags(unsigned flags)
 }
 EXPORT_SYMBOL(get_unused_fd_flags);
 
-static void __put_unused_fd(struct files_struct *files, unsigned int fd)
-{
-	struct fdtable *fdt = files_fdtable(files);
-	__clear_open_fd(fd, fdt);
-	if (fd < files->next_fd)
-		files->next_fd = fd;
-}
-
 void put_unused_fd(unsigned int fd)
 {
 	struct files_struct *files = current->files;
@@ -850,6 +1035,8 @@ void do_close_on_exec(struct files_struct *files)
 	struct fdtable *fdt;
 
 	/* exec unshares first */
+	if (files->fd_cache)
+		fd_cache_drain(files);
 	spin_lock(&files->file_lock);
 	for (i = 0; ; i++) {
 		unsigned long set;
@@ -516,6 +516,9 @@ static void __fput_deferred(struct file *file)
 {
 	struct task_struct *task = current;
 
+	/* f_ra shares its space with f_task_work and f_llist */
+	file_ra_state_release(&file->f_ra);
+
 	if (unlikely(!(file->f_mode & (FMODE_BACKING | FMODE_OPENED)))) {
 		file_free(file);
 		return;
@@ -553,8 +556,10 @@ EXPORT_SYMBOL(fput);
  */
 void __fput_sync(struct file *file)
 {
-	if (file_ref_put(&file->f_ref))
+	if (file_ref_put(&file->f_ref)) {
+		file_ra_state_release(&file->f_ra);
 		__fput(file);
+	}
 }
 EXPORT_SYMBOL(__fput_sync);
 
@@ -566,8 +571,10 @@ EXPORT_SYMBOL(__fput_sync);
  */
 void fput_close_sync(struct file *file)
 {
-	if (likely(file_ref_put_close(&file->f_ref)))
+	if (likely(file_ref_put_close(&file->f_ref))) {
+		file_ra_state_release(&file->f_ra);
 		__fput(file);
+	}
 }
 
 /*
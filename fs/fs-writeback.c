@@ -2096,11 +2096,11 @@ static long writeback_inodes_wb(struct bdi_writeback *wb, long nr_pages,
  * dirtied_before takes precedence over nr_to_write.  So we'll only write back
  * all dirty pages if they are all attached to "old" mappings.
  */
-static long wb_writeback(struct bdi_writeback *wb,
-			 struct wb_writeback_work *work)
+static long __wb_writeback(struct bdi_writeback *wb,
+			   struct wb_writeback_work *work,
+			   unsigned long dirtied_before)
 {
 	long nr_pages = work->nr_pages;
-	unsigned long dirtied_before = jiffies;
 	struct inode *inode;
 	long progress;
 	struct blk_plug plug;
@@ -2196,6 +2196,80 @@ static long wb_writeback(struct bdi_writeback *wb,
 	return nr_pages - work->nr_pages;
 }
 
+struct wb_writeback_helper {
+	struct work_struct work;
+	struct bdi_writeback *wb;
+	struct wb_writeback_work wwork;
+	unsigned long dirtied_before;
+	long wrote;
+};
+
+static void wb_writeback_helper_fn(struct work_struct *work)
+{
+	struct wb_writeback_helper *h =
+		container_of(work, struct wb_writeback_helper, work);
+
+	h->wrote = __wb_writeback(h->wb, &h->wwork, h->dirtied_before);
+}
+
+/*
+ * A single flusher walking inodes can be the bottleneck on devices with a
+ * lot of parallelism, so with bdi->wb_workers > 1 large works are shared
+ * by that many flushers.  They all feed off the same b_io/b_more_io lists
+ * under list_lock, and I_SYNC keeps them from writing the same inode at
+ * the same time, exactly like with concurrent sync_inode() callers.  Each
+ * helper gets an equal share of the page budget and the cutoff time taken
+ * here, so livelock avoidance for sync works the same.  We wait for all of
+ * them before returning, so completion of the work still means what it
+ * did.
+ */
+static long wb_writeback(struct bdi_writeback *wb,
+			 struct wb_writeback_work *work)
+{
+	unsigned int nr = READ_ONCE(wb->bdi->wb_workers);
+	unsigned long dirtied_before = jiffies;
+	struct wb_writeback_helper *helpers;
+	long share, wrote;
+	int i;
+
+	if (nr <= 1 || work->nr_pages < nr * MIN_WRITEBACK_PAGES)
+		return __wb_writeback(wb, work, dirtied_before);
+
+	nr = min_t(unsigned int, nr, BDI_MAX_WB_WORKERS);
+	helpers = kcalloc(nr - 1, sizeof(*helpers), GFP_NOFS | __GFP_NOWARN);
+	if (!helpers)
+		return __wb_writeback(wb, work, dirtied_before);
+
+	share = work->nr_pages / nr;
+	for (i = 0; i < nr - 1; i++) {
+		struct wb_writeback_helper *h = &helpers[i];
+
+		h->wb = wb;
+		h->wwork = *work;
+		h->wwork.nr_pages = share;
+		h->wwork.auto_free = 0;
+		h->wwork.done = NULL;
+		h->dirtied_before = dirtied_before;
+		INIT_WORK(&h->work, wb_writeback_helper_fn);
+		/*
+		 * Not bdi_wq: we are running from it and waiting on the
+		 * helpers there could starve them of workers or of the
+		 * rescuer.  bdi_helper_wq has its own rescuer.
+		 */
+		queue_work(bdi_helper_wq, &h->work);
+	}
+	work->nr_pages -= share * (nr - 1);
+
+	wrote = __wb_writeback(wb, work, dirtied_before);
+	for (i = 0; i < nr - 1; i++) {
+		flush_work(&helpers[i].work);
+		wrote += helpers[i].wrote;
+	}
+	kfree(helpers);
+
+	return wrote;
+}
+
 /*
  * Return the next wb_writeback_work struct that hasn't been processed yet.
  */
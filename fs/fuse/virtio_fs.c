@@ -826,11 +826,11 @@ static void virtio_fs_requests_done_work(struct work_struct *work)
 	do {
 		virtqueue_disable_cb(vq);
 
-		while ((req = virtqueue_get_buf(vq, &len)) != NULL) {
-			spin_lock(&fpq->lock);
+		/* Take the processing list lock once per batch, not per req */
+		spin_lock(&fpq->lock);
+		while ((req = virtqueue_get_buf(vq, &len)) != NULL)
 			list_move_tail(&req->list, &reqs);
-			spin_unlock(&fpq->lock);
-		}
+		spin_unlock(&fpq->lock);
 	} while (!virtqueue_enable_cb(vq));
 	spin_unlock(&fsvq->lock);
 
@@ -1099,6 +1099,7 @@ static int sysctl_protected_symlinks __read_mostly;
 static int sysctl_protected_hardlinks __read_mostly;
 static int sysctl_protected_fifos __read_mostly;
 static int sysctl_protected_regular __read_mostly;
+static int sysctl_path_prefix_cache __read_mostly;
 
 #ifdef CONFIG_SYSCTL
 static const struct ctl_table namei_sysctls[] = {
@@ -1138,6 +1139,15 @@ static const struct ctl_table namei_sysctls[] = {
 		.extra1		= SYSCTL_ZERO,
 		.extra2		= SYSCTL_TWO,
 	},
+	{
+		.procname	= "path_prefix_cache",
+		.data		= &sysctl_path_prefix_cache,
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= SYSCTL_ZERO,
+		.extra2		= SYSCTL_ONE,
+	},
 };
 
 static int __init init_fs_namei_sysctls(void)
@@ -2407,6 +2417,320 @@ static inline const char *hash_name(struct nameidata *nd, const char *name, unsi
   #define LAST_WORD_IS_DOTDOT	0x2e2e
 #endif
 
+/*
+ * Path prefix cache.
+ *
+ * Deep, repeatedly resolved paths spend most of the walk looking up the same
+ * leading directories over and over.  With fs.path_prefix_cache set, each
+ * superblock keeps a small direct-mapped cache of "everything up to the last
+ * slash" prefixes seen by RCU walks, keyed on the starting dentry and the
+ * prefix string, which maps to the chain of directory dentries it resolved
+ * to.  A hit lets link_path_walk() jump straight to the parent of the last
+ * component.
+ *
+ * Entries pin their dentries but are purely a hint: on a hit the d_seq of
+ * every dentry of the chain is revalidated and MAY_EXEC is still checked on
+ * every directory searched, so renames, unlinks, mounts and permission
+ * changes are all noticed and simply make the walk fall back to the slow
+ * path.  Chains that cross mounts or symlinks, contain "." or "..", or go
+ * through dentries with ->d_revalidate(), ->d_hash() or ->d_compare() are
+ * never cached.
+ */
+#define PREFIX_CACHE_SLOTS	256
+#define PREFIX_CACHE_MIN_DEPTH	4
+#define PREFIX_CACHE_MAX_DEPTH	16
+#define PREFIX_CACHE_MAX_LEN	256
+#define PREFIX_CACHE_DEAD	((struct path_prefix_cache *)1UL)
+
+#define PREFIX_CACHE_BAD_FLAGS	(LOOKUP_IS_SCOPED | LOOKUP_NO_XDEV | \
+				 LOOKUP_NO_SYMLINKS)
+
+struct prefix_entry {
+	struct dentry *base;
+	u32 hash;
+	unsigned int depth;
+	struct dentry *dentry[PREFIX_CACHE_MAX_DEPTH];
+	unsigned int seq[PREFIX_CACHE_MAX_DEPTH];
+	struct path_prefix_cache *cache;
+	struct rcu_work rwork;
+	unsigned int len;
+	char name[];
+};
+
+struct path_prefix_cache {
+	/* fills in progress and entries waiting to be freed */
+	atomic_t users;
+	struct rcu_head rcu;
+	/* recently missed prefixes, a prefix is only cached on its second miss */
+	u32 hint[PREFIX_CACHE_SLOTS];
+	struct prefix_entry __rcu *slot[PREFIX_CACHE_SLOTS];
+};
+
+static void prefix_entry_free_work(struct work_struct *work)
+{
+	struct prefix_entry *e = container_of(to_rcu_work(work),
+					      struct prefix_entry, rwork);
+	struct path_prefix_cache *cache = e->cache;
+	int i;
+
+	for (i = 0; i < PREFIX_CACHE_MAX_DEPTH; i++)
+		dput(e->dentry[i]);
+	dput(e->base);
+	kfree(e);
+	if (atomic_dec_and_test(&cache->users))
+		wake_up_var(&cache->users);
+}
+
+/* Entries may still be in use by RCU walkers, and dput() may sleep */
+static void prefix_entry_evict(struct path_prefix_cache *cache,
+			       struct prefix_entry *e)
+{
+	atomic_inc(&cache->users);
+	e->cache = cache;
+	INIT_RCU_WORK(&e->rwork, prefix_entry_free_work);
+	queue_rcu_work(system_wq, &e->rwork);
+}
+
+/*
+ * Returns where link_path_walk() should carry on from: just past the last
+ * slash of @name on a hit, with nd->path and nd->inode set to the directory
+ * the prefix resolves to, or @name itself on a miss.
+ */
+static const char *prefix_cache_lookup(struct nameidata *nd, const char *name)
+{
+	struct path_prefix_cache *cache;
+	struct mnt_idmap *idmap;
+	struct prefix_entry *e;
+	struct dentry *d = NULL;
+	struct inode *inode;
+	const char *last;
+	unsigned int i;
+	u32 hash;
+
+	if (nd->flags & PREFIX_CACHE_BAD_FLAGS)
+		return name;
+	cache = READ_ONCE(nd->path.dentry->d_sb->s_prefix_cache);
+	if (!cache || cache == PREFIX_CACHE_DEAD)
+		return name;
+	last = strrchr(name, '/');
+	if (!last || !last[1] || last - name > PREFIX_CACHE_MAX_LEN)
+		return name;
+
+	hash = full_name_hash(nd->path.dentry, name, last - name);
+	e = rcu_dereference(cache->slot[hash % PREFIX_CACHE_SLOTS]);
+	if (!e || e->base != nd->path.dentry || e->hash != hash ||
+	    e->len != last - name || memcmp(e->name, name, e->len))
+		return name;
+
+	idmap = mnt_idmap(nd->path.mnt);
+	inode = nd->inode;
+	for (i = 0; i < e->depth; i++) {
+		if (inode_permission(idmap, inode, MAY_EXEC | MAY_NOT_BLOCK))
+			return name;
+		d = e->dentry[i];
+		if (unlikely(READ_ONCE(d->d_flags) & DCACHE_MANAGED_DENTRY))
+			return name;
+		inode = READ_ONCE(d->d_inode);
+		if (read_seqcount_retry(&d->d_seq, e->seq[i]))
+			return name;
+	}
+
+	nd->path.dentry = d;
+	nd->inode = inode;
+	nd->seq = e->seq[e->depth - 1];
+	return last + 1;
+}
+
+static struct path_prefix_cache *prefix_cache_get(struct super_block *sb)
+{
+	struct path_prefix_cache *cache, *old;
+
+	cache = READ_ONCE(sb->s_prefix_cache);
+	if (cache)
+		return cache == PREFIX_CACHE_DEAD ? NULL : cache;
+	if (!(sb->s_flags & SB_ACTIVE))
+		return NULL;
+	cache = kzalloc(sizeof(*cache), GFP_NOWAIT | __GFP_NOWARN);
+	if (!cache)
+		return NULL;
+	old = cmpxchg(&sb->s_prefix_cache, NULL, cache);
+	if (old) {
+		kfree(cache);
+		return old == PREFIX_CACHE_DEAD ? NULL : old;
+	}
+	return cache;
+}
+
+/*
+ * Called in RCU mode once the walk of @name has reached its last component
+ * without following symlinks; the first @len bytes of @name, walked from
+ * @base, resolved to nd->path.dentry.  Rather than trusting how the walk
+ * got there, rebuild the chain from the d_parent links and check it against
+ * the names.
+ */
+static void prefix_cache_fill(struct nameidata *nd, struct dentry *base,
+			      const char *name, unsigned int len)
+{
+	struct super_block *sb = base->d_sb;
+	struct path_prefix_cache *cache;
+	struct prefix_entry *e, *old;
+	struct dentry *d = nd->path.dentry;
+	const char *end = name + len;
+	unsigned int depth = 0, slot;
+	const char *p;
+	u32 hash;
+	int i;
+
+	if (len > PREFIX_CACHE_MAX_LEN || d->d_sb != sb)
+		return;
+	for (p = name; p < end; ) {
+		while (p < end && *p == '/')
+			p++;
+		if (p == end)
+			break;
+		depth++;
+		while (p < end && *p != '/')
+			p++;
+	}
+	if (depth < PREFIX_CACHE_MIN_DEPTH || depth > PREFIX_CACHE_MAX_DEPTH)
+		return;
+
+	cache = prefix_cache_get(sb);
+	if (!cache)
+		return;
+	hash = full_name_hash(base, name, len);
+	slot = hash % PREFIX_CACHE_SLOTS;
+	if (READ_ONCE(cache->hint[slot]) != hash) {
+		WRITE_ONCE(cache->hint[slot], hash);
+		return;
+	}
+
+	atomic_inc(&cache->users);
+	smp_mb__after_atomic();
+	if (READ_ONCE(sb->s_prefix_cache) != cache)
+		goto out;
+
+	e = kzalloc(struct_size(e, name, len), GFP_NOWAIT | __GFP_NOWARN);
+	if (!e)
+		goto out;
+	e->hash = hash;
+	e->depth = depth;
+	e->len = len;
+	memcpy(e->name, name, len);
+
+	for (i = depth - 1; i >= 0; i--) {
+		struct dentry *parent;
+		unsigned int seq;
+
+		while (end > name && end[-1] == '/')
+			end--;
+		for (p = end; p > name && p[-1] != '/'; p--)
+			;
+		seq = raw_read_seqcount(&d->d_seq);
+		if (seq & 1)
+			goto fail;
+		if (READ_ONCE(d->d_flags) & (DCACHE_MANAGED_DENTRY |
+					     DCACHE_OP_REVALIDATE |
+					     DCACHE_OP_WEAK_REVALIDATE))
+			goto fail;
+		if (!d_can_lookup(d))
+			goto fail;
+		parent = READ_ONCE(d->d_parent);
+		if (READ_ONCE(parent->d_flags) & (DCACHE_OP_HASH |
+						  DCACHE_OP_COMPARE))
+			goto fail;
+		if (READ_ONCE(d->d_name.len) != end - p ||
+		    memcmp(READ_ONCE(d->d_name.name), p, end - p))
+			goto fail;
+		if (!lockref_get_not_dead(&d->d_lockref))
+			goto fail;
+		e->dentry[i] = d;
+		e->seq[i] = seq;
+		if (read_seqcount_retry(&d->d_seq, seq))
+			goto fail;
+		d = parent;
+		end = p;
+	}
+	if (d != base || !lockref_get_not_dead(&base->d_lockref))
+		goto fail;
+	e->base = base;
+
+	old = unrcu_pointer(xchg(&cache->slot[slot], RCU_INITIALIZER(e)));
+	if (old)
+		prefix_entry_evict(cache, old);
+	goto out;
+fail:
+	prefix_entry_evict(cache, e);
+out:
+	if (atomic_dec_and_test(&cache->users))
+		wake_up_var(&cache->users);
+}
+
+static bool prefix_entry_pins(struct prefix_entry *e, struct dentry *dentry)
+{
+	int i;
+
+	if (e->base == dentry)
+		return true;
+	for (i = 0; i < e->depth; i++) {
+		if (e->dentry[i] == dentry)
+			return true;
+	}
+	return false;
+}
+
+/*
+ * @dentry is gone for good, don't keep its inode pinned.  That goes for
+ * entries starting at @dentry as well as those walking through it; the
+ * eviction drops the references to the base and to the whole chain.
+ */
+static void prefix_cache_forget(struct dentry *dentry)
+{
+	struct path_prefix_cache *cache = READ_ONCE(dentry->d_sb->s_prefix_cache);
+	struct prefix_entry *e;
+	int i;
+
+	if (!cache || cache == PREFIX_CACHE_DEAD)
+		return;
+	rcu_read_lock();
+	for (i = 0; i < PREFIX_CACHE_SLOTS; i++) {
+		e = rcu_dereference(cache->slot[i]);
+		if (!e || !prefix_entry_pins(e, dentry))
+			continue;
+		if (unrcu_pointer(cmpxchg(&cache->slot[i],
+				RCU_INITIALIZER(e), NULL)) == e)
+			prefix_entry_evict(cache, e);
+	}
+	rcu_read_unlock();
+}
+
+/**
+ * prefix_cache_shutdown - drop the path prefix cache of a dying superblock
+ * @sb: superblock being shut down
+ *
+ * Must be called before shrink_dcache_for_umount(), as the cache pins
+ * dentries of @sb.
+ */
+void prefix_cache_shutdown(struct super_block *sb)
+{
+	struct path_prefix_cache *cache;
+	struct prefix_entry *e;
+	int i;
+
+	cache = xchg(&sb->s_prefix_cache, PREFIX_CACHE_DEAD);
+	if (!cache)
+		return;
+	/* no new fills from here on, wait for the ones in flight */
+	wait_var_event(&cache->users, !atomic_read(&cache->users));
+	for (i = 0; i < PREFIX_CACHE_SLOTS; i++) {
+		e = unrcu_pointer(xchg(&cache->slot[i], NULL));
+		if (e)
+			prefix_entry_evict(cache, e);
+	}
+	wait_var_event(&cache->users, !atomic_read(&cache->users));
+	kfree_rcu(cache, rcu);
+}
+
 /*
  * Name resolution.
  * This is the basic name resolution function, turning a pathname into
@@ -2418,6 +2742,8 @@ static inline const char *hash_name(struct nameidata *nd, const char *name, unsi
 static int link_path_walk(const char *name, struct nameidata *nd)
 {
 	int depth = 0; // depth <= nd->depth
+	struct dentry *base = NULL;
+	const char *start = NULL;
 	int err;
 
 	nd->last_type = LAST_ROOT;
@@ -2430,6 +2756,15 @@ static int link_path_walk(const char *name, struct nameidata *nd)
 		nd->dir_mode = 0; // short-circuit the 'hardening' idiocy
 		return 0;
 	}
+	if ((nd->flags & LOOKUP_RCU) && READ_ONCE(sysctl_path_prefix_cache)) {
+		const char *rest = prefix_cache_lookup(nd, name);
+
+		if (rest == name) {
+			base = nd->path.dentry;
+			start = name;
+		}
+		name = rest;
+	}
 
 	/* At this point we know we have a real path component. */
 	for(;;) {
@@ -2480,6 +2815,12 @@ static int link_path_walk(const char *name, struct nameidata *nd)
 OK:
 			/* pathname or trailing symlink, done */
 			if (!depth) {
+				if (start && !nd->total_link_count &&
+				    (nd->flags & LOOKUP_RCU) &&
+				    nd->last_type == LAST_NORM &&
+				    name[-1] != '/' && nd->last.name > start)
+					prefix_cache_fill(nd, base, start,
+							  nd->last.name - 1 - start);
 				nd->dir_vfsuid = i_uid_into_vfsuid(idmap, nd->inode);
 				nd->dir_mode = nd->inode->i_mode;
 				nd->flags &= ~LOOKUP_PARENT;
@@ -4421,6 +4762,7 @@ int vfs_rmdir(struct mnt_idmap *idmap, struct inode *dir,
 		goto out;
 
 	shrink_dcache_parent(dentry);
+	prefix_cache_forget(dentry);
 	dentry->d_inode->i_flags |= S_DEAD;
 	dont_mount(dentry);
 	detach_mounts(dentry);
@@ -5091,6 +5433,7 @@ int vfs_rename(struct renamedata *rd)
 	if (!(flags & RENAME_EXCHANGE) && target) {
 		if (is_dir) {
 			shrink_dcache_parent(new_dentry);
+			prefix_cache_forget(new_dentry);
 			target->i_flags |= S_DEAD;
 		}
 		dont_mount(new_dentry);
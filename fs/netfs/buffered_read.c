@@ -5,7 +5,10 @@
  * Written by David Howells (dhowells@redhat.com)
  */
 
+#include <linux/backing-dev.h>
 #include <linux/export.h>
+#include <linux/fadvise.h>
+#include <linux/file.h>
 #include <linux/task_io_accounting_ops.h>
 #include "internal.h"
 
@@ -834,3 +837,85 @@ ssize_t netfs_file_read_iter(struct kiocb *iocb, struct iov_iter *iter)
 	return netfs_buffered_read_iter(iocb, iter);
 }
 EXPORT_SYMBOL(netfs_file_read_iter);
+
+/* Amount of the file that a cache prefill reads ahead at a time. */
+#define NETFS_PREFILL_CHUNK	(8 * 1024 * 1024)
+
+struct netfs_prefill {
+	struct work_struct	work;
+	struct file		*file;
+	loff_t			pos;
+	loff_t			end;
+};
+
+static void netfs_prefill_worker(struct work_struct *work)
+{
+	struct netfs_prefill *pf = container_of(work, struct netfs_prefill, work);
+	struct inode *inode = file_inode(pf->file);
+	loff_t step;
+
+	/*
+	 * Each WILLNEED only reads ahead up to the readahead window, so don't
+	 * step over more than that or we would leave holes.
+	 */
+	step = max_t(unsigned long, inode_to_bdi(inode)->io_pages,
+		     pf->file->f_ra.ra_pages);
+	step = min_t(loff_t, step << PAGE_SHIFT, NETFS_PREFILL_CHUNK);
+
+	while (step && pf->pos < pf->end && pf->pos < i_size_read(inode)) {
+		loff_t len = min_t(loff_t, pf->end - pf->pos, step);
+
+		if (generic_fadvise(pf->file, pf->pos, len, POSIX_FADV_WILLNEED) < 0)
+			break;
+		pf->pos += len;
+		cond_resched();
+	}
+
+	clear_bit_unlock(NETFS_ICTX_PREFILL, &netfs_inode(inode)->flags);
+	fput(pf->file);
+	kfree(pf);
+}
+
+/**
+ * netfs_fadvise - Handle fadvise() on a network filesystem file
+ * @file: The file the advice applies to
+ * @offset: Start of the range
+ * @len: Length of the range, or 0 for the rest of the file
+ * @advice: The POSIX_FADV_* advice
+ *
+ * If the inode is backed by a local cache, POSIX_FADV_WILLNEED kicks off
+ * readahead of the range from a workqueue and returns immediately.  The data
+ * read in goes to the cache as well as the pagecache, so the cache can be
+ * warmed from a list of files ahead of the application reading them.  Only
+ * one prefill per inode is in flight at a time; further WILLNEED advice on
+ * the inode meanwhile is handled synchronously.  All other advice is
+ * handled by generic_fadvise().
+ */
+int netfs_fadvise(struct file *file, loff_t offset, loff_t len, int advice)
+{
+	struct netfs_inode *ictx = netfs_inode(file_inode(file));
+	struct netfs_prefill *pf;
+
+	if (advice != POSIX_FADV_WILLNEED ||
+	    !fscache_cookie_enabled(netfs_i_cookie(ictx)) ||
+	    offset < 0 || len < 0)
+		return generic_fadvise(file, offset, len, advice);
+
+	if (test_and_set_bit_lock(NETFS_ICTX_PREFILL, &ictx->flags))
+		return generic_fadvise(file, offset, len, advice);
+
+	pf = kmalloc(sizeof(*pf), GFP_KERNEL);
+	if (!pf) {
+		clear_bit_unlock(NETFS_ICTX_PREFILL, &ictx->flags);
+		return generic_fadvise(file, offset, len, advice);
+	}
+
+	INIT_WORK(&pf->work, netfs_prefill_worker);
+	pf->file = get_file(file);
+	pf->pos = offset;
+	if (!len || check_add_overflow(offset, len, &pf->end))
+		pf->end = LLONG_MAX;
+	queue_work(system_unbound_wq, &pf->work);
+	return 0;
+}
+EXPORT_SYMBOL(netfs_fadvise);
@@ -8,6 +8,7 @@
 #include <linux/export.h>
 #include <linux/fs.h>
 #include <linux/mm.h>
+#include <linux/moduleparam.h>
 #include <linux/pagemap.h>
 #include <linux/slab.h>
 #include <linux/uio.h>
@@ -16,6 +17,34 @@
 #include <linux/netfs.h>
 #include "internal.h"
 
+/*
+ * A read that fits in a single rsize-sized subrequest is otherwise sent to the
+ * server as one RPC, which can then only use one connection or channel.  Split
+ * unbuffered reads into at least this many subrequests, none smaller than
+ * NETFS_DIO_SPREAD_MIN, so that they can be in flight in parallel.
+ */
+static unsigned int netfs_dio_read_spread __read_mostly = 1;
+module_param_named(dio_read_spread, netfs_dio_read_spread, uint, 0644);
+MODULE_PARM_DESC(dio_read_spread,
+		 "Minimum number of subrequests to split unbuffered reads into");
+
+#define NETFS_DIO_SPREAD_MIN	(256 * 1024)
+
+static size_t netfs_dio_read_slice(struct netfs_io_request *rreq)
+{
+	unsigned int spread = READ_ONCE(netfs_dio_read_spread);
+	size_t slice;
+
+	if (spread <= 1 || rreq->len < 2 * NETFS_DIO_SPREAD_MIN)
+		return rreq->len;
+
+	slice = round_up(DIV_ROUND_UP(rreq->len, spread), PAGE_SIZE);
+	slice = max_t(size_t, slice, NETFS_DIO_SPREAD_MIN);
+	if (slice < rreq->len)
+		netfs_stat(&netfs_n_rh_dio_spread);
+	return slice;
+}
+
 static void netfs_prepare_dio_read_iterator(struct netfs_io_subrequest *subreq)
 {
 	struct netfs_io_request *rreq = subreq->rreq;
@@ -50,6 +79,7 @@ static int netfs_dispatch_unbuffered_reads(struct netfs_io_request *rreq)
 	struct netfs_io_stream *stream = &rreq->io_streams[0];
 	unsigned long long start = rreq->start;
 	ssize_t size = rreq->len;
+	size_t max_slice = netfs_dio_read_slice(rreq);
 	int ret = 0;
 
 	do {
@@ -64,7 +94,7 @@ static int netfs_dispatch_unbuffered_reads(struct netfs_io_request *rreq)
 
 		subreq->source	= NETFS_DOWNLOAD_FROM_SERVER;
 		subreq->start	= start;
-		subreq->len	= size;
+		subreq->len	= umin(size, max_slice);
 
 		__set_bit(NETFS_SREQ_IN_PROGRESS, &subreq->flags);
 
@@ -82,6 +112,7 @@ static int netfs_dispatch_unbuffered_reads(struct netfs_io_request *rreq)
 		spin_unlock(&rreq->lock);
 
 		netfs_stat(&netfs_n_rh_download);
+		netfs_stat(&netfs_n_rh_dio_sreq);
 		if (rreq->netfs_ops->prepare_read) {
 			ret = rreq->netfs_ops->prepare_read(subreq);
 			if (ret < 0) {
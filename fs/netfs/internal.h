@@ -116,6 +116,8 @@ void netfs_unlock_abandoned_read_pages(struct netfs_io_request *rreq);
  */
 #ifdef CONFIG_NETFS_STATS
 extern atomic_t netfs_n_rh_dio_read;
+extern atomic_t netfs_n_rh_dio_sreq;
+extern atomic_t netfs_n_rh_dio_spread;
 extern atomic_t netfs_n_rh_readahead;
 extern atomic_t netfs_n_rh_read_folio;
 extern atomic_t netfs_n_rh_read_single;
@@ -10,6 +10,8 @@
 #include "internal.h"
 
 atomic_t netfs_n_rh_dio_read;
+atomic_t netfs_n_rh_dio_sreq;
+atomic_t netfs_n_rh_dio_spread;
 atomic_t netfs_n_rh_readahead;
 atomic_t netfs_n_rh_read_folio;
 atomic_t netfs_n_rh_read_single;
@@ -58,6 +60,9 @@ int netfs_stats_show(struct seq_file *m, void *v)
 		   atomic_read(&netfs_n_rh_read_single),
 		   atomic_read(&netfs_n_rh_write_begin),
 		   atomic_read(&netfs_n_rh_write_zskip));
+	seq_printf(m, "DioRead: sq=%u sp=%u\n",
+		   atomic_read(&netfs_n_rh_dio_sreq),
+		   atomic_read(&netfs_n_rh_dio_spread));
 	seq_printf(m, "Writes : BW=%u WT=%u DW=%u WP=%u 2C=%u\n",
 		   atomic_read(&netfs_n_wh_buffered_write),
 		   atomic_read(&netfs_n_wh_writethrough),
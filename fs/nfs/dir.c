@@ -1063,6 +1063,91 @@ static int find_and_lock_cache_page(struct nfs_readdir_descriptor *desc)
 	return res;
 }
 
+struct nfs_readdir_prefetch {
+	struct work_struct	work;
+	struct file		*file;
+	u64			cookie;
+	unsigned int		dtsize;
+	bool			plus;
+};
+
+static void nfs_readdir_prefetch_work(struct work_struct *work)
+{
+	struct nfs_readdir_prefetch *p =
+		container_of(work, struct nfs_readdir_prefetch, work);
+	struct file *file = p->file;
+	struct nfs_open_dir_context *dir_ctx = file->private_data;
+	struct inode *inode = file_inode(file);
+	struct nfs_readdir_descriptor *desc;
+	__be32 verf[NFS_DIR_VERIFIER_SIZE];
+	struct folio *folio;
+
+	desc = kzalloc(sizeof(*desc), GFP_KERNEL);
+	if (!desc)
+		goto out;
+	desc->file = file;
+	desc->last_cookie = p->cookie;
+	desc->folio_index_max = -1;
+	desc->dtsize = p->dtsize;
+	desc->plus = p->plus;
+
+	folio = nfs_readdir_folio_get_locked(file->f_mapping, p->cookie,
+					     inode_peek_iversion_raw(inode));
+	if (folio) {
+		if (nfs_readdir_folio_needs_filling(folio)) {
+			trace_nfs_readdir_cache_fill(file, NFS_I(inode)->cookieverf,
+						     p->cookie, folio->index,
+						     desc->dtsize);
+			nfs_readdir_xdr_to_array(desc, NFS_I(inode)->cookieverf,
+						 verf, &folio, 1);
+		}
+		nfs_readdir_folio_unlock_and_put(folio);
+	}
+	kfree(desc);
+out:
+	atomic_set(&dir_ctx->prefetch_active, 0);
+	fput(file);
+	kfree(p);
+}
+
+/*
+ * Userspace has stopped consuming entries part way through a full cache
+ * folio: start filling the folio that follows it while the current one is
+ * being read, so that large directories don't pay for one serial READDIR
+ * round trip per folio.  There is at most one prefetch in flight per open
+ * directory, and whoever gets to the folio first fills it.
+ */
+static void nfs_readdir_start_prefetch(struct nfs_readdir_descriptor *desc)
+{
+	struct nfs_open_dir_context *dir_ctx = desc->file->private_data;
+	struct nfs_readdir_prefetch *p;
+	struct nfs_cache_array *array;
+	bool full;
+	u64 cookie;
+
+	array = kmap_local_folio(desc->folio, 0);
+	cookie = array->last_cookie;
+	full = array->folio_full && !array->folio_is_eof;
+	kunmap_local(array);
+	if (!full || !cookie)
+		return;
+
+	if (atomic_cmpxchg(&dir_ctx->prefetch_active, 0, 1))
+		return;
+
+	p = kmalloc(sizeof(*p), GFP_KERNEL);
+	if (!p) {
+		atomic_set(&dir_ctx->prefetch_active, 0);
+		return;
+	}
+	INIT_WORK(&p->work, nfs_readdir_prefetch_work);
+	p->file = get_file(desc->file);
+	p->cookie = cookie;
+	p->dtsize = desc->dtsize;
+	p->plus = desc->plus;
+	queue_work(nfsiod_workqueue, &p->work);
+}
+
 /* Search for desc->dir_cookie from the beginning of the page cache */
 static int readdir_search_pagecache(struct nfs_readdir_descriptor *desc)
 {
@@ -1298,6 +1383,8 @@ static int nfs_readdir(struct file *file, struct dir_context *ctx)
 			break;
 
 		nfs_do_filldir(desc, nfsi->cookieverf);
+		if (desc->eob)
+			nfs_readdir_start_prefetch(desc);
 		nfs_readdir_folio_unlock_and_put_cached(desc);
 		if (desc->folio_index == desc->folio_index_max)
 			desc->clear_cache = force_clear;
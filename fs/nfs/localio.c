@@ -19,6 +19,7 @@
 #include <linux/nfs_common.h>
 #include <linux/nfslocalio.h>
 #include <linux/bvec.h>
+#include <linux/blkdev.h>
 
 #include <linux/nfs.h>
 #include <linux/nfs_fs.h>
@@ -33,6 +34,7 @@
 struct nfs_local_kiocb {
 	struct kiocb		kiocb;
 	struct bio_vec		*bvec;
+	unsigned int		nr_bvec;
 	struct nfs_pgio_header	*hdr;
 	struct work_struct	work;
 	void (*aio_complete_work)(struct work_struct *);
@@ -49,10 +51,10 @@ struct nfs_local_fsync_ctx {
 static bool localio_enabled __read_mostly = true;
 module_param(localio_enabled, bool, 0644);
 
-static bool localio_O_DIRECT_semantics __read_mostly = false;
+static bool localio_O_DIRECT_semantics __read_mostly = true;
 module_param(localio_O_DIRECT_semantics, bool, 0644);
 MODULE_PARM_DESC(localio_O_DIRECT_semantics,
-		 "LOCALIO will use O_DIRECT semantics to filesystem.");
+		 "LOCALIO will use O_DIRECT semantics to filesystem for suitably aligned O_DIRECT IO.");
 
 static inline bool nfs_client_is_local(const struct nfs_client *clp)
 {
@@ -297,23 +299,54 @@ nfs_local_open_fh(struct nfs_client *clp, const struct cred *cred,
 }
 EXPORT_SYMBOL_GPL(nfs_local_open_fh);
 
+/*
+ * Pages of the same large folio that follow each other in @pagevec are
+ * merged into a single multi-page bvec, so the underlying filesystem sees
+ * the folios rather than a list of pages.
+ */
 static struct bio_vec *
 nfs_bvec_alloc_and_import_pagevec(struct page **pagevec,
-		unsigned int npages, gfp_t flags)
+		unsigned int npages, unsigned int *nr_bvec, gfp_t flags)
 {
 	struct bio_vec *bvec, *p;
 
 	bvec = kmalloc_array(npages, sizeof(*bvec), flags);
-	if (bvec != NULL) {
-		for (p = bvec; npages > 0; p++, pagevec++, npages--) {
-			p->bv_page = *pagevec;
-			p->bv_len = PAGE_SIZE;
-			p->bv_offset = 0;
+	if (bvec == NULL)
+		return NULL;
+
+	for (p = bvec; npages > 0; pagevec++, npages--) {
+		if (p != bvec &&
+		    page_folio(*pagevec) == page_folio(p[-1].bv_page) &&
+		    *pagevec == nth_page(p[-1].bv_page,
+					 p[-1].bv_len >> PAGE_SHIFT)) {
+			p[-1].bv_len += PAGE_SIZE;
+			continue;
 		}
+		p->bv_page = *pagevec;
+		p->bv_len = PAGE_SIZE;
+		p->bv_offset = 0;
+		p++;
 	}
+	*nr_bvec = p - bvec;
 	return bvec;
 }
 
+/*
+ * Only pass O_DIRECT through to the local filesystem when the request is
+ * aligned well enough for it; anything else goes through the page cache
+ * rather than failing with -EINVAL.
+ */
+static bool
+nfs_local_iocb_dio_aligned(struct nfs_pgio_header *hdr, struct file *file)
+{
+	struct super_block *sb = file_inode(file)->i_sb;
+	unsigned int align = sb->s_bdev ? bdev_logical_block_size(sb->s_bdev) :
+					  sb->s_blocksize;
+
+	return IS_ALIGNED(hdr->args.offset | hdr->args.count |
+			  hdr->args.pgbase, align);
+}
+
 static void
 nfs_local_iocb_free(struct nfs_local_kiocb *iocb)
 {
@@ -331,14 +364,15 @@ nfs_local_iocb_alloc(struct nfs_pgio_header *hdr,
 	if (iocb == NULL)
 		return NULL;
 	iocb->bvec = nfs_bvec_alloc_and_import_pagevec(hdr->page_array.pagevec,
-			hdr->page_array.npages, flags);
+			hdr->page_array.npages, &iocb->nr_bvec, flags);
 	if (iocb->bvec == NULL) {
 		kfree(iocb);
 		return NULL;
 	}
 
 	if (localio_O_DIRECT_semantics &&
-	    test_bit(NFS_IOHDR_ODIRECT, &hdr->flags)) {
+	    test_bit(NFS_IOHDR_ODIRECT, &hdr->flags) &&
+	    nfs_local_iocb_dio_aligned(hdr, file)) {
 		iocb->kiocb.ki_filp = file;
 		iocb->kiocb.ki_flags = IOCB_DIRECT;
 	} else
@@ -357,7 +391,7 @@ nfs_local_iter_init(struct iov_iter *i, struct nfs_local_kiocb *iocb, int dir)
 {
 	struct nfs_pgio_header *hdr = iocb->hdr;
 
-	iov_iter_bvec(i, dir, iocb->bvec, hdr->page_array.npages,
+	iov_iter_bvec(i, dir, iocb->bvec, iocb->nr_bvec,
 		      hdr->args.count + hdr->args.pgbase);
 	if (hdr->args.pgbase != 0)
 		iov_iter_advance(i, hdr->args.pgbase);
@@ -61,6 +61,8 @@ static DEFINE_PER_CPU(unsigned long, nfsd_file_allocations);
 static DEFINE_PER_CPU(unsigned long, nfsd_file_releases);
 static DEFINE_PER_CPU(unsigned long, nfsd_file_total_age);
 static DEFINE_PER_CPU(unsigned long, nfsd_file_evictions);
+static DEFINE_PER_CPU(unsigned long, nfsd_file_cons_waits);
+static DEFINE_PER_CPU(unsigned long, nfsd_file_cons_wait_us);
 
 struct nfsd_fcache_disposal {
 	spinlock_t lock;
@@ -362,8 +364,14 @@ nfsd_file_put(struct nfsd_file *nf)
 
 	if (test_bit(NFSD_FILE_GC, &nf->nf_flags) &&
 	    test_bit(NFSD_FILE_HASHED, &nf->nf_flags)) {
-		set_bit(NFSD_FILE_REFERENCED, &nf->nf_flags);
-		set_bit(NFSD_FILE_RECENT, &nf->nf_flags);
+		/*
+		 * Hot files are put from every nfsd thread; avoid dirtying
+		 * the cacheline when the bits are already set.
+		 */
+		if (!test_bit(NFSD_FILE_REFERENCED, &nf->nf_flags))
+			set_bit(NFSD_FILE_REFERENCED, &nf->nf_flags);
+		if (!test_bit(NFSD_FILE_RECENT, &nf->nf_flags))
+			set_bit(NFSD_FILE_RECENT, &nf->nf_flags);
 	}
 
 	if (refcount_dec_and_test(&nf->nf_ref))
@@ -1106,7 +1114,15 @@ nfsd_file_do_acquire(struct svc_rqst *rqstp, struct net *net,
 	goto construction_err;
 
 wait_for_construction:
-	wait_on_bit(&nf->nf_flags, NFSD_FILE_PENDING, TASK_UNINTERRUPTIBLE);
+	if (test_bit(NFSD_FILE_PENDING, &nf->nf_flags)) {
+		ktime_t start = ktime_get();
+
+		wait_on_bit(&nf->nf_flags, NFSD_FILE_PENDING,
+			    TASK_UNINTERRUPTIBLE);
+		this_cpu_inc(nfsd_file_cons_waits);
+		this_cpu_add(nfsd_file_cons_wait_us,
+			     ktime_us_delta(ktime_get(), start));
+	}
 
 	/* Did construction of this file fail? */
 	if (!test_bit(NFSD_FILE_HASHED, &nf->nf_flags)) {
@@ -1317,6 +1333,7 @@ int nfsd_file_cache_stats_show(struct seq_file *m, void *v)
 {
 	unsigned long allocations = 0, releases = 0, evictions = 0;
 	unsigned long hits = 0, acquisitions = 0;
+	unsigned long cons_waits = 0, cons_wait_us = 0;
 	unsigned int i, count = 0, buckets = 0;
 	unsigned long lru = 0, total_age = 0;
 
@@ -1344,6 +1361,8 @@ int nfsd_file_cache_stats_show(struct seq_file *m, void *v)
 		releases += per_cpu(nfsd_file_releases, i);
 		total_age += per_cpu(nfsd_file_total_age, i);
 		evictions += per_cpu(nfsd_file_evictions, i);
+		cons_waits += per_cpu(nfsd_file_cons_waits, i);
+		cons_wait_us += per_cpu(nfsd_file_cons_wait_us, i);
 	}
 
 	seq_printf(m, "total inodes:  %u\n", count);
@@ -1358,5 +1377,14 @@ int nfsd_file_cache_stats_show(struct seq_file *m, void *v)
 		seq_printf(m, "mean age (ms): %ld\n", total_age / releases);
 	else
 		seq_printf(m, "mean age (ms): -\n");
+	if (acquisitions)
+		seq_printf(m, "hit rate (%%):  %lu\n", hits * 100 / acquisitions);
+	else
+		seq_printf(m, "hit rate (%%):  -\n");
+	seq_printf(m, "open waits:    %lu\n", cons_waits);
+	if (cons_waits)
+		seq_printf(m, "mean wait (us): %lu\n", cons_wait_us / cons_waits);
+	else
+		seq_printf(m, "mean wait (us): -\n");
 	return 0;
 }
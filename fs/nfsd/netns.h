@@ -38,6 +38,7 @@ enum {
 	NFSD_STATS_FH_STALE,		/* FH stale error */
 	NFSD_STATS_IO_READ,		/* bytes returned to read requests */
 	NFSD_STATS_IO_WRITE,		/* bytes passed in write requests */
+	NFSD_STATS_IO_READ_SPLICE,	/* read bytes sent from the page cache */
 #ifdef CONFIG_NFSD_V4
 	NFSD_STATS_FIRST_NFS4_OP,	/* count of individual nfsv4 operations */
 	NFSD_STATS_LAST_NFS4_OP = NFSD_STATS_FIRST_NFS4_OP + LAST_NFS4_OP,
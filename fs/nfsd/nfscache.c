@@ -443,15 +443,20 @@ nfsd_cache_insert(struct nfsd_drc_bucket *b, struct nfsd_cacherep *key,
 	rb_link_node(&key->c_node, parent, p);
 	rb_insert_color(&key->c_node, &b->rb_head);
 out:
-	/* tally hash chain length stats */
-	if (entries > nn->longest_chain) {
+	/*
+	 * Tally hash chain length stats. These are shared by every bucket,
+	 * so only write them when they change, to keep inserts into
+	 * different buckets from bouncing the cacheline.
+	 */
+	if (unlikely(entries > READ_ONCE(nn->longest_chain))) {
 		nn->longest_chain = entries;
 		nn->longest_chain_cachesize = atomic_read(&nn->num_drc_entries);
-	} else if (entries == nn->longest_chain) {
+	} else if (entries == READ_ONCE(nn->longest_chain)) {
 		/* prefer to keep the smallest cachesize possible here */
-		nn->longest_chain_cachesize = min_t(unsigned int,
-				nn->longest_chain_cachesize,
-				atomic_read(&nn->num_drc_entries));
+		unsigned int size = atomic_read(&nn->num_drc_entries);
+
+		if (size < READ_ONCE(nn->longest_chain_cachesize))
+			nn->longest_chain_cachesize = size;
 	}
 
 	lru_put_end(b, ret);
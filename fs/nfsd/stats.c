@@ -31,6 +31,7 @@ static int nfsd_show(struct seq_file *seq, void *v)
 {
 	struct net *net = pde_data(file_inode(seq->file));
 	struct nfsd_net *nn = net_generic(net, nfsd_net_id);
+	s64 io_read, io_splice;
 	int i;
 
 	seq_printf(seq, "rc %lld %lld %lld\nfh %lld 0 0 0 0\nio %lld %lld\n",
@@ -68,6 +69,12 @@ static int nfsd_show(struct seq_file *seq, void *v)
 	seq_putc(seq, '\n');
 #endif
 
+	/* read bytes sent in place from the page cache, and copied */
+	io_read = percpu_counter_sum_positive(&nn->counter[NFSD_STATS_IO_READ]);
+	io_splice = percpu_counter_sum_positive(&nn->counter[NFSD_STATS_IO_READ_SPLICE]);
+	seq_printf(seq, "io_splice %lld %lld\n", io_splice,
+		   max_t(s64, io_read - io_splice, 0));
+
 	return 0;
 }
 
@@ -44,6 +44,12 @@ static inline void nfsd_stats_io_read_add(struct nfsd_net *nn,
 		percpu_counter_add(&exp->ex_stats->counter[EXP_STATS_IO_READ], amount);
 }
 
+static inline void nfsd_stats_io_read_splice_add(struct nfsd_net *nn,
+						 s64 amount)
+{
+	percpu_counter_add(&nn->counter[NFSD_STATS_IO_READ_SPLICE], amount);
+}
+
 static inline void nfsd_stats_io_write_add(struct nfsd_net *nn,
 					   struct svc_export *exp, s64 amount)
 {
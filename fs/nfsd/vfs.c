@@ -1055,6 +1055,10 @@ __be32 nfsd_splice_read(struct svc_rqst *rqstp, struct svc_fh *fhp,
 	if (!host_err)
 		host_err = splice_direct_to_actor(file, &sd,
 						  nfsd_direct_splice_actor);
+	if (host_err > 0)
+		nfsd_stats_io_read_splice_add(net_generic(SVC_NET(rqstp),
+							  nfsd_net_id),
+					      host_err);
 	return nfsd_finish_read(rqstp, fhp, file, offset, count, eof, host_err);
 }
 
@@ -59,6 +59,15 @@ static unsigned int pipe_max_size = 1048576;
 static unsigned long pipe_user_pages_hard;
 static unsigned long pipe_user_pages_soft = PIPE_DEF_BUFFERS * INR_OPEN_CUR;
 
+/*
+ * Largest folio order pipe_write() may use for a buffer, and that splice and
+ * vmsplice may fill a single buffer with.  0 keeps every buffer within a
+ * page.  Can be set by root in /proc/sys/fs/pipe-max-folio-order.
+ */
+#define PIPE_MAX_FOLIO_ORDER	8
+static unsigned int pipe_max_folio_order;
+static const unsigned int pipe_max_folio_order_max = PIPE_MAX_FOLIO_ORDER;
+
 /*
  * We use head and tail indices that aren't masked off, except at the point of
  * dereference, but rather they're allowed to wrap naturally.  This means there
@@ -112,8 +121,33 @@ void pipe_double_lock(struct pipe_inode_info *pipe1,
 	pipe_lock(pipe2);
 }
 
-static struct page *anon_pipe_get_page(struct pipe_inode_info *pipe)
+/**
+ * pipe_folio_order - largest folio order a pipe buffer may span
+ *
+ * Consumers kmap() buffers as a whole, so without HIGHMEM only.
+ */
+unsigned int pipe_folio_order(void)
+{
+	if (IS_ENABLED(CONFIG_HIGHMEM))
+		return 0;
+	return READ_ONCE(pipe_max_folio_order);
+}
+
+static struct page *anon_pipe_get_page(struct pipe_inode_info *pipe,
+				       size_t want)
 {
+	unsigned int order = pipe_folio_order();
+
+	if (order && want >= 2 * PAGE_SIZE) {
+		struct page *page;
+
+		order = min(order, ilog2(want >> PAGE_SHIFT));
+		page = alloc_pages(GFP_HIGHUSER | __GFP_ACCOUNT | __GFP_COMP |
+				   __GFP_NORETRY | __GFP_NOWARN, order);
+		if (page)
+			return page;
+	}
+
 	for (int i = 0; i < ARRAY_SIZE(pipe->tmp_page); i++) {
 		if (pipe->tmp_page[i]) {
 			struct page *page = pipe->tmp_page[i];
@@ -128,7 +162,7 @@ static struct page *anon_pipe_get_page(struct pipe_inode_info *pipe)
 static void anon_pipe_put_page(struct pipe_inode_info *pipe,
 			       struct page *page)
 {
-	if (page_count(page) == 1) {
+	if (page_count(page) == 1 && !PageCompound(page)) {
 		for (int i = 0; i < ARRAY_SIZE(pipe->tmp_page); i++) {
 			if (!pipe->tmp_page[i]) {
 				pipe->tmp_page[i] = page;
@@ -153,7 +187,8 @@ static bool anon_pipe_buf_try_steal(struct pipe_inode_info *pipe,
 {
 	struct page *page = buf->page;
 
-	if (page_count(page) != 1)
+	/* Stealers replace a single page */
+	if (PageCompound(page) || page_count(page) != 1)
 		return false;
 	memcg_kmem_uncharge_page(page, 0);
 	__SetPageLocked(page);
@@ -480,7 +515,7 @@ anon_pipe_write(struct kiocb *iocb, struct iov_iter *from)
 		int offset = buf->offset + buf->len;
 
 		if ((buf->flags & PIPE_BUF_FLAG_CAN_MERGE) &&
-		    offset + chars <= PAGE_SIZE) {
+		    offset + chars <= page_size(buf->page)) {
 			ret = pipe_buf_confirm(pipe, buf);
 			if (ret)
 				goto out;
@@ -509,17 +544,19 @@ anon_pipe_write(struct kiocb *iocb, struct iov_iter *from)
 		if (!pipe_full(head, pipe->tail, pipe->max_usage)) {
 			struct pipe_buffer *buf;
 			struct page *page;
+			size_t size;
 			int copied;
 
-			page = anon_pipe_get_page(pipe);
+			page = anon_pipe_get_page(pipe, iov_iter_count(from));
 			if (unlikely(!page)) {
 				if (!ret)
 					ret = -ENOMEM;
 				break;
 			}
 
-			copied = copy_page_from_iter(page, 0, PAGE_SIZE, from);
-			if (unlikely(copied < PAGE_SIZE && iov_iter_count(from))) {
+			size = page_size(page);
+			copied = copy_page_from_iter(page, 0, size, from);
+			if (unlikely(copied < size && iov_iter_count(from))) {
 				anon_pipe_put_page(pipe, page);
 				if (!ret)
 					ret = -EFAULT;
@@ -1527,6 +1564,15 @@ static const struct ctl_table fs_pipe_sysctls[] = {
 		.mode		= 0644,
 		.proc_handler	= proc_doulongvec_minmax,
 	},
+	{
+		.procname	= "pipe-max-folio-order",
+		.data		= &pipe_max_folio_order,
+		.maxlen		= sizeof(pipe_max_folio_order),
+		.mode		= 0644,
+		.proc_handler	= proc_douintvec_minmax,
+		.extra1		= SYSCTL_ZERO,
+		.extra2		= (void *)&pipe_max_folio_order_max,
+	},
 };
 #endif
 
@@ -92,6 +92,7 @@
 #include <linux/fs_struct.h>
 #include <linux/kthread.h>
 #include <linux/mmu_context.h>
+#include <uapi/linux/pidstats.h>
 
 #include <asm/processor.h>
 #include "internal.h"
@@ -668,6 +669,106 @@ static int do_task_stat(struct seq_file *m, struct pid_namespace *ns,
 	return 0;
 }
 
+/*
+ * Binary counterparts of the whole-process fields of do_task_stat() and
+ * proc_pid_status(), for /proc/pidstats.
+ */
+static void pidstats_fill_stat(struct pidstats_record *r,
+			       struct pid_namespace *ns,
+			       struct task_struct *task, struct mm_struct *mm)
+{
+	struct signal_struct *sig = task->signal;
+	unsigned long min_flt, maj_flt, nvcsw, nivcsw, flags;
+	unsigned int seq = 1;
+	u64 utime, stime;
+
+	if (lock_task_sighand(task, &flags)) {
+		if (sig->tty)
+			r->tty_nr = new_encode_dev(tty_devnum(sig->tty));
+		r->num_threads = get_nr_threads(task);
+		r->session = task_session_nr_ns(task, ns);
+		r->ppid = task_tgid_nr_ns(task->real_parent, ns);
+		r->pgrp = task_pgrp_nr_ns(task, ns);
+		unlock_task_sighand(task, &flags);
+	}
+
+	do {
+		struct task_struct *t;
+
+		seq++; /* 2 on the 1st/lockless path, otherwise odd */
+		flags = read_seqbegin_or_lock_irqsave(&sig->stats_lock, &seq);
+
+		min_flt = sig->min_flt;
+		maj_flt = sig->maj_flt;
+		nvcsw = sig->nvcsw;
+		nivcsw = sig->nivcsw;
+		rcu_read_lock();
+		__for_each_thread(sig, t) {
+			min_flt += t->min_flt;
+			maj_flt += t->maj_flt;
+			nvcsw += t->nvcsw;
+			nivcsw += t->nivcsw;
+		}
+		rcu_read_unlock();
+	} while (need_seqretry(&sig->stats_lock, seq));
+	done_seqretry_irqrestore(&sig->stats_lock, seq, flags);
+
+	thread_group_cputime_adjusted(task, &utime, &stime);
+
+	r->state = *get_task_state(task);
+	r->flags = task->flags;
+	r->priority = task_prio(task);
+	r->nice = task_nice(task);
+	r->processor = task_cpu(task);
+	r->minflt = min_flt;
+	r->majflt = maj_flt;
+	r->nvcsw = nvcsw;
+	r->nivcsw = nivcsw;
+	r->utime = utime;
+	r->stime = stime;
+	r->start_time = timens_add_boottime_ns(task->start_boottime);
+	if (mm) {
+		r->vsize = task_vsize(mm);
+		r->rss = get_mm_rss(mm) << PAGE_SHIFT;
+	}
+	r->mask |= PIDSTATS_STAT;
+}
+
+static void pidstats_fill_status(struct seq_file *m, struct pidstats_record *r,
+				 struct task_struct *task, struct mm_struct *mm)
+{
+	struct user_namespace *user_ns = seq_user_ns(m);
+	const struct cred *cred;
+
+	rcu_read_lock();
+	cred = __task_cred(task);
+	r->ruid = from_kuid_munged(user_ns, cred->uid);
+	r->euid = from_kuid_munged(user_ns, cred->euid);
+	r->rgid = from_kgid_munged(user_ns, cred->gid);
+	r->egid = from_kgid_munged(user_ns, cred->egid);
+	rcu_read_unlock();
+
+	if (mm)
+		task_mem_fill(r, mm);
+	r->mask |= PIDSTATS_STATUS;
+}
+
+void pidstats_fill(struct seq_file *m, struct pidstats_record *r,
+		   struct pid_namespace *ns, struct task_struct *task, u64 mask)
+{
+	struct mm_struct *mm = get_task_mm(task);
+
+	if (mask & PIDSTATS_STAT)
+		pidstats_fill_stat(r, ns, task, mm);
+	if (mask & PIDSTATS_STATUS)
+		pidstats_fill_status(m, r, task, mm);
+	if (mm) {
+		if ((mask & PIDSTATS_ROLLUP) && !smaps_rollup_fill(r, mm))
+			r->mask |= PIDSTATS_ROLLUP;
+		mmput(mm);
+	}
+}
+
 int proc_tid_stat(struct seq_file *m, struct pid_namespace *ns,
 			struct pid *pid, struct task_struct *task)
 {
@@ -356,6 +356,24 @@ extern unsigned long task_statm(struct mm_struct *,
 				unsigned long *, unsigned long *);
 extern void task_mem(struct seq_file *, struct mm_struct *);
 
+struct pidstats_record;
+void pidstats_fill(struct seq_file *, struct pidstats_record *,
+		   struct pid_namespace *, struct task_struct *, u64 mask);
+#ifdef CONFIG_MMU
+void task_mem_fill(struct pidstats_record *, struct mm_struct *);
+int smaps_rollup_fill(struct pidstats_record *, struct mm_struct *);
+#else
+static inline void task_mem_fill(struct pidstats_record *r,
+				 struct mm_struct *mm)
+{
+}
+static inline int smaps_rollup_fill(struct pidstats_record *r,
+				    struct mm_struct *mm)
+{
+	return -EOPNOTSUPP;
+}
+#endif
+
 extern const struct dentry_operations proc_net_dentry_ops;
 static inline void pde_force_lookup(struct proc_dir_entry *pde)
 {
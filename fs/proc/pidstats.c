@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * /proc/pidstats - fixed layout statistics of all processes in one read
+ *
+ * Monitoring agents otherwise open and parse /proc/<pid>/stat, status and
+ * smaps_rollup for every process.  See include/uapi/linux/pidstats.h for
+ * the format.
+ */
+#include <linux/init.h>
+#include <linux/pid_namespace.h>
+#include <linux/proc_fs.h>
+#include <linux/ptrace.h>
+#include <linux/sched/task.h>
+#include <linux/seq_file.h>
+#include <linux/uaccess.h>
+#include <uapi/linux/pidstats.h>
+
+#include "internal.h"
+
+#define PIDSTATS_ALL	(PIDSTATS_STAT | PIDSTATS_STATUS | PIDSTATS_ROLLUP)
+
+struct pidstats_iter {
+	u64 mask;
+	struct task_struct *task;
+};
+
+/* The position is the tgid to resume from */
+static void *pidstats_start(struct seq_file *m, loff_t *pos)
+{
+	struct pid_namespace *ns = proc_pid_ns(file_inode(m->file)->i_sb);
+	struct pidstats_iter *iter = m->private;
+	struct task_struct *task = NULL;
+	struct pid *pid;
+
+	if (*pos >= PID_MAX_LIMIT)
+		return NULL;
+
+	rcu_read_lock();
+	while ((pid = find_ge_pid(*pos, ns))) {
+		*pos = pid_nr_ns(pid, ns);
+		task = pid_task(pid, PIDTYPE_TGID);
+		if (task) {
+			get_task_struct(task);
+			break;
+		}
+		(*pos)++;
+	}
+	rcu_read_unlock();
+
+	iter->task = task;
+	return task;
+}
+
+static void *pidstats_next(struct seq_file *m, void *v, loff_t *pos)
+{
+	struct pidstats_iter *iter = m->private;
+
+	put_task_struct(iter->task);
+	iter->task = NULL;
+	(*pos)++;
+	return pidstats_start(m, pos);
+}
+
+static void pidstats_stop(struct seq_file *m, void *v)
+{
+	struct pidstats_iter *iter = m->private;
+
+	if (iter->task) {
+		put_task_struct(iter->task);
+		iter->task = NULL;
+	}
+}
+
+static int pidstats_show(struct seq_file *m, void *v)
+{
+	struct pid_namespace *ns = proc_pid_ns(file_inode(m->file)->i_sb);
+	struct pidstats_iter *iter = m->private;
+	struct pidstats_record r = { .size = sizeof(r) };
+	struct task_struct *task = v;
+
+	/* Same as for the per-pid files that expose memory layout */
+	if (!ptrace_may_access(task, PTRACE_MODE_READ_FSCREDS))
+		return 0;
+
+	r.tgid = task_tgid_nr_ns(task, ns);
+	pidstats_fill(m, &r, ns, task, iter->mask);
+	seq_write(m, &r, sizeof(r));
+	return 0;
+}
+
+static const struct seq_operations pidstats_seq_ops = {
+	.start	= pidstats_start,
+	.next	= pidstats_next,
+	.stop	= pidstats_stop,
+	.show	= pidstats_show,
+};
+
+static int pidstats_open(struct inode *inode, struct file *file)
+{
+	struct pidstats_iter *iter;
+
+	iter = __seq_open_private(file, &pidstats_seq_ops, sizeof(*iter));
+	if (!iter)
+		return -ENOMEM;
+	iter->mask = PIDSTATS_STAT | PIDSTATS_STATUS;
+	return 0;
+}
+
+static ssize_t pidstats_write(struct file *file, const char __user *buf,
+			      size_t count, loff_t *ppos)
+{
+	struct seq_file *m = file->private_data;
+	struct pidstats_iter *iter = m->private;
+	u64 mask;
+
+	if (count != sizeof(mask))
+		return -EINVAL;
+	if (copy_from_user(&mask, buf, sizeof(mask)))
+		return -EFAULT;
+
+	mutex_lock(&m->lock);
+	iter->mask = mask & PIDSTATS_ALL;
+	mutex_unlock(&m->lock);
+	return count;
+}
+
+static const struct proc_ops pidstats_proc_ops = {
+	.proc_flags	= PROC_ENTRY_PERMANENT,
+	.proc_open	= pidstats_open,
+	.proc_read_iter	= seq_read_iter,
+	.proc_write	= pidstats_write,
+	.proc_lseek	= seq_lseek,
+	.proc_release	= seq_release_private,
+};
+
+static int __init proc_pidstats_init(void)
+{
+	proc_create("pidstats", 0666, NULL, &pidstats_proc_ops);
+	return 0;
+}
+fs_initcall(proc_pidstats_init);
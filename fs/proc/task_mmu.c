@@ -27,6 +27,7 @@
 #include <asm/elf.h>
 #include <asm/tlb.h>
 #include <asm/tlbflush.h>
+#include <uapi/linux/pidstats.h>
 #include "internal.h"
 
 #define SEQ_PUT_DEC(str, val) \
@@ -80,9 +81,39 @@ void task_mem(struct seq_file *m, struct mm_struct *mm)
 	SEQ_PUT_DEC(" kB\nVmSwap:\t", swap);
 	seq_puts(m, " kB\n");
 	hugetlb_report_usage(m, mm);
+	tlb_defer_report(m, mm);
 }
 #undef SEQ_PUT_DEC
 
+/* Same as task_mem(), in bytes for /proc/pidstats */
+void task_mem_fill(struct pidstats_record *r, struct mm_struct *mm)
+{
+	unsigned long text, anon, file, shmem;
+
+	anon = get_mm_counter(mm, MM_ANONPAGES);
+	file = get_mm_counter(mm, MM_FILEPAGES);
+	shmem = get_mm_counter(mm, MM_SHMEMPAGES);
+
+	r->vm_size = (u64)mm->total_vm << PAGE_SHIFT;
+	r->vm_peak = (u64)max(mm->hiwater_vm, mm->total_vm) << PAGE_SHIFT;
+	r->vm_rss = (u64)(anon + file + shmem) << PAGE_SHIFT;
+	r->vm_hwm = max_t(u64, (u64)mm->hiwater_rss << PAGE_SHIFT, r->vm_rss);
+	r->vm_lck = (u64)mm->locked_vm << PAGE_SHIFT;
+	r->vm_pin = (u64)atomic64_read(&mm->pinned_vm) << PAGE_SHIFT;
+	r->rss_anon = (u64)anon << PAGE_SHIFT;
+	r->rss_file = (u64)file << PAGE_SHIFT;
+	r->rss_shmem = (u64)shmem << PAGE_SHIFT;
+	r->vm_data = (u64)mm->data_vm << PAGE_SHIFT;
+	r->vm_stk = (u64)mm->stack_vm << PAGE_SHIFT;
+
+	text = PAGE_ALIGN(mm->end_code) - (mm->start_code & PAGE_MASK);
+	text = min(text, mm->exec_vm << PAGE_SHIFT);
+	r->vm_exe = text;
+	r->vm_lib = (mm->exec_vm << PAGE_SHIFT) - text;
+	r->vm_pte = mm_pgtables_bytes(mm);
+	r->vm_swap = (u64)get_mm_counter(mm, MM_SWAPENTS) << PAGE_SHIFT;
+}
+
 unsigned long task_vsize(struct mm_struct *mm)
 {
 	return PAGE_SIZE * mm->total_vm;
@@ -1162,6 +1193,52 @@ static int show_smap(struct seq_file *m, void *v)
 	return 0;
 }
 
+/*
+ * smaps_rollup totals for /proc/pidstats.  As in show_smaps_rollup(),
+ * mmap_lock is dropped for waiting writers and the walk carries on after
+ * the last VMA seen.
+ */
+int smaps_rollup_fill(struct pidstats_record *r, struct mm_struct *mm)
+{
+	struct mem_size_stats mss = {};
+	struct vm_area_struct *vma;
+	VMA_ITERATOR(vmi, mm, 0);
+	int ret;
+
+	ret = mmap_read_lock_killable(mm);
+	if (ret)
+		return ret;
+	for_each_vma(vmi, vma) {
+		smap_gather_stats(vma, &mss, 0);
+		if (mmap_lock_is_contended(mm)) {
+			vma_iter_invalidate(&vmi);
+			mmap_read_unlock(mm);
+			ret = mmap_read_lock_killable(mm);
+			if (ret)
+				return ret;
+		}
+	}
+	mmap_read_unlock(mm);
+
+	r->pss = mss.pss >> PSS_SHIFT;
+	r->pss_dirty = mss.pss_dirty >> PSS_SHIFT;
+	r->pss_anon = mss.pss_anon >> PSS_SHIFT;
+	r->pss_file = mss.pss_file >> PSS_SHIFT;
+	r->pss_shmem = mss.pss_shmem >> PSS_SHIFT;
+	r->shared_clean = mss.shared_clean;
+	r->shared_dirty = mss.shared_dirty;
+	r->private_clean = mss.private_clean;
+	r->private_dirty = mss.private_dirty;
+	r->referenced = mss.referenced;
+	r->anonymous = mss.anonymous;
+	r->lazyfree = mss.lazyfree;
+	r->anon_huge = mss.anonymous_thp;
+	r->swap = mss.swap;
+	r->swap_pss = mss.swap_pss >> PSS_SHIFT;
+	r->locked = mss.pss_locked >> PSS_SHIFT;
+	return 0;
+}
+
 static int show_smaps_rollup(struct seq_file *m, void *v)
 {
 	struct proc_maps_private *priv = m->private;
@@ -224,6 +224,14 @@ static int show_vfsstat(struct seq_file *m, struct vfsmount *mnt)
 	seq_puts(m, "with fstype ");
 	show_type(m, sb);
 
+#ifdef CONFIG_FS_DAX
+	if (atomic64_read(&sb->s_dax_cached_bytes) ||
+	    atomic64_read(&sb->s_dax_nt_bytes))
+		seq_printf(m, " dax_cached_bytes=%lld dax_nt_bytes=%lld",
+			   atomic64_read(&sb->s_dax_cached_bytes),
+			   atomic64_read(&sb->s_dax_nt_bytes));
+#endif
+
 	/* optional statistics */
 	if (sb->s_op->show_stats) {
 		seq_putc(m, ' ');
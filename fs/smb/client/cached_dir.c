@@ -667,6 +667,8 @@ static void free_cached_dir(struct cached_fid *cfid)
 		kfree(dirent->name);
 		kfree(dirent);
 	}
+	atomic_long_sub(cfid->dirents.bytes, &dir_cache_bytes);
+	cfid->dirents.bytes = 0;
 
 	kfree(cfid->path);
 	cfid->path = NULL;
@@ -27,6 +27,7 @@ struct cached_dirents {
 				  */
 	struct mutex de_mutex;
 	int pos;		 /* Expected ctx->pos */
+	size_t bytes;		 /* Charged to dir_cache_bytes */
 	struct list_head entries;
 };
 
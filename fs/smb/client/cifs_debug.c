@@ -439,6 +439,9 @@ static int cifs_debug_data_proc_show(struct seq_file *m, void *v)
 		seq_printf(m, "\nMR mr_ready_count: %x mr_used_count: %x",
 			atomic_read(&server->smbd_conn->mr_ready_count),
 			atomic_read(&server->smbd_conn->mr_used_count));
+		seq_printf(m, "\nMR count_get_mr: %x count_get_mr_wait: %x",
+			server->smbd_conn->count_get_mr,
+			server->smbd_conn->count_get_mr_wait);
 skip_rdma:
 #endif
 		seq_printf(m, "\nNumber of credits: %d,%d,%d Dialect 0x%x",
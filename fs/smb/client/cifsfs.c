@@ -122,6 +122,12 @@ unsigned int dir_cache_timeout = 30;
 module_param(dir_cache_timeout, uint, 0644);
 MODULE_PARM_DESC(dir_cache_timeout, "Number of seconds to cache directory contents for which we have a lease. Default: 30 "
 				 "Range: 1 to 65000 seconds, 0 to disable caching dir contents");
+unsigned int dir_cache_max_kb = 64 * 1024;
+module_param(dir_cache_max_kb, uint, 0644);
+MODULE_PARM_DESC(dir_cache_max_kb, "Total memory in KiB that cached directory "
+				   "contents may use. Default: 65536 (64MiB), "
+				   "0 for no limit");
+atomic_long_t dir_cache_bytes;
 #ifdef CONFIG_CIFS_STATS2
 unsigned int slow_rsp_threshold = 1;
 module_param(slow_rsp_threshold, uint, 0644);
@@ -1534,6 +1540,7 @@ const struct file_operations cifs_file_ops = {
 	.remap_file_range = cifs_remap_file_range,
 	.setlease = cifs_setlease,
 	.fallocate = cifs_fallocate,
+	.fadvise = netfs_fadvise,
 };
 
 const struct file_operations cifs_file_strict_ops = {
@@ -1554,6 +1561,7 @@ const struct file_operations cifs_file_strict_ops = {
 	.remap_file_range = cifs_remap_file_range,
 	.setlease = cifs_setlease,
 	.fallocate = cifs_fallocate,
+	.fadvise = netfs_fadvise,
 };
 
 const struct file_operations cifs_file_direct_ops = {
@@ -1592,6 +1600,7 @@ const struct file_operations cifs_file_nobrl_ops = {
 	.remap_file_range = cifs_remap_file_range,
 	.setlease = cifs_setlease,
 	.fallocate = cifs_fallocate,
+	.fadvise = netfs_fadvise,
 };
 
 const struct file_operations cifs_file_strict_nobrl_ops = {
@@ -1610,6 +1619,7 @@ const struct file_operations cifs_file_strict_nobrl_ops = {
 	.remap_file_range = cifs_remap_file_range,
 	.setlease = cifs_setlease,
 	.fallocate = cifs_fallocate,
+	.fadvise = netfs_fadvise,
 };
 
 const struct file_operations cifs_file_direct_nobrl_ops = {
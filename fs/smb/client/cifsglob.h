@@ -2092,6 +2092,8 @@ extern unsigned int cifs_min_rcv;    /* min size of big ntwrk buf pool */
 extern unsigned int cifs_min_small;  /* min size of small buf pool */
 extern unsigned int cifs_max_pending; /* MAX requests at once to server*/
 extern unsigned int dir_cache_timeout; /* max time for directory lease caching of dir */
+extern unsigned int dir_cache_max_kb; /* memory cap for cached dir contents */
+extern atomic_long_t dir_cache_bytes; /* memory used by cached dir contents */
 extern bool disable_legacy_dialects;  /* forbid vers=1.0 and vers=2.0 mounts */
 extern atomic_t mid_count;
 
@@ -870,11 +870,31 @@ static void finished_cached_dirents_count(struct cached_dirents *cde,
 	cde->is_valid = 1;
 }
 
+/*
+ * A listing that could not be cached completely is never used, so give its
+ * memory back straight away rather than when the directory lease goes.
+ */
+static void fail_cached_dirents(struct cached_dirents *cde)
+{
+	struct cached_dirent *de, *q;
+
+	cde->is_failed = 1;
+	list_for_each_entry_safe(de, q, &cde->entries, entry) {
+		list_del(&de->entry);
+		kfree(de->name);
+		kfree(de);
+	}
+	atomic_long_sub(cde->bytes, &dir_cache_bytes);
+	cde->bytes = 0;
+}
+
 static void add_cached_dirent(struct cached_dirents *cde,
 			      struct dir_context *ctx,
 			      const char *name, int namelen,
 			      struct cifs_fattr *fattr)
 {
+	unsigned long max_bytes = (unsigned long)READ_ONCE(dir_cache_max_kb) << 10;
+	size_t size = sizeof(struct cached_dirent) + namelen + 1;
 	struct cached_dirent *de;
 
 	if (cde->ctx != ctx)
@@ -882,19 +902,26 @@ static void add_cached_dirent(struct cached_dirents *cde,
 	if (cde->is_valid || cde->is_failed)
 		return;
 	if (ctx->pos != cde->pos) {
-		cde->is_failed = 1;
+		fail_cached_dirents(cde);
+		return;
+	}
+	if (atomic_long_add_return(size, &dir_cache_bytes) > max_bytes &&
+	    max_bytes) {
+		atomic_long_sub(size, &dir_cache_bytes);
+		fail_cached_dirents(cde);
 		return;
 	}
+	cde->bytes += size;
 	de = kzalloc(sizeof(*de), GFP_ATOMIC);
 	if (de == NULL) {
-		cde->is_failed = 1;
+		fail_cached_dirents(cde);
 		return;
 	}
 	de->namelen = namelen;
 	de->name = kstrndup(name, namelen, GFP_ATOMIC);
 	if (de->name == NULL) {
 		kfree(de);
-		cde->is_failed = 1;
+		fail_cached_dirents(cde);
 		return;
 	}
 	de->pos = ctx->pos;
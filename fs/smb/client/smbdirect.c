@@ -2183,6 +2183,11 @@ static struct smbd_mr *get_mr(struct smbd_connection *info)
 {
 	struct smbd_mr *ret;
 	int rc;
+
+	info->count_get_mr++;
+	/* Count the I/Os that found the registered MR pool exhausted */
+	if (!atomic_read(&info->mr_ready_count))
+		info->count_get_mr_wait++;
 again:
 	rc = wait_event_interruptible(info->wait_mr,
 		atomic_read(&info->mr_ready_count) ||
@@ -170,6 +170,8 @@ struct smbd_connection {
 	unsigned int count_enqueue_reassembly_queue;
 	unsigned int count_dequeue_reassembly_queue;
 	unsigned int count_send_empty;
+	unsigned int count_get_mr;
+	unsigned int count_get_mr_wait;
 };
 
 enum smbd_message_type {
@@ -1012,16 +1012,24 @@ cifs_cancelled_callback(struct mid_q_entry *mid)
  */
 struct TCP_Server_Info *cifs_pick_channel(struct cifs_ses *ses)
 {
-	uint index = 0;
-	unsigned int min_in_flight = UINT_MAX, max_in_flight = 0;
+	uint index = 0, start;
+	unsigned int min_in_flight = UINT_MAX;
 	struct TCP_Server_Info *server = NULL;
-	int i;
+	int i, j;
 
 	if (!ses)
 		return NULL;
 
 	spin_lock(&ses->chan_lock);
-	for (i = 0; i < ses->chan_count; i++) {
+	/*
+	 * Rotate the starting point so that equally loaded channels are used
+	 * round-robin.  Always taking the first least loaded channel would
+	 * pile the subrequests of a large read or write onto the lower
+	 * numbered channels whenever some, but not all, channels tie.
+	 */
+	start = (uint)atomic_inc_return(&ses->chan_seq);
+	for (j = 0; j < ses->chan_count; j++) {
+		i = (start + j) % ses->chan_count;
 		server = ses->chans[i].server;
 		if (!server || server->terminate)
 			continue;
@@ -1041,14 +1049,6 @@ struct TCP_Server_Info *cifs_pick_channel(struct cifs_ses *ses)
 			min_in_flight = server->in_flight;
 			index = i;
 		}
-		if (server->in_flight > max_in_flight)
-			max_in_flight = server->in_flight;
-	}
-
-	/* if all channels are equally loaded, fall back to round-robin */
-	if (min_in_flight == max_in_flight) {
-		index = (uint)atomic_inc_return(&ses->chan_seq);
-		index %= ses->chan_count;
 	}
 
 	server = ses->chans[index].server;
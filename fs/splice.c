@@ -164,6 +164,9 @@ static bool user_page_pipe_buf_try_steal(struct pipe_inode_info *pipe,
 {
 	if (!(buf->flags & PIPE_BUF_FLAG_GIFT))
 		return false;
+	/* Stealers replace a single page */
+	if (buf->offset + buf->len > PAGE_SIZE)
+		return false;
 
 	buf->flags |= PIPE_BUF_FLAG_LRU;
 	return generic_pipe_buf_try_steal(pipe, buf);
@@ -1447,6 +1450,7 @@ static ssize_t iter_to_pipe(struct iov_iter *from,
 		.ops = &user_page_pipe_buf_ops,
 		.flags = flags
 	};
+	size_t max_len = PAGE_SIZE << pipe_folio_order();
 	size_t total = 0;
 	ssize_t ret = 0;
 
@@ -1468,6 +1472,17 @@ static ssize_t iter_to_pipe(struct iov_iter *from,
 
 			buf.page = pages[i];
 			buf.offset = start;
+			/*
+			 * Pages of one folio that follow each other go in a
+			 * single buffer, which keeps one of their references.
+			 */
+			while (i + 1 < n && size < left &&
+			       buf.offset + size + PAGE_SIZE <= max_len &&
+			       pages[i + 1] == pages[i] + 1 &&
+			       page_folio(pages[i + 1]) == page_folio(buf.page)) {
+				size += min_t(int, left - size, PAGE_SIZE);
+				put_page(pages[++i]);
+			}
 			buf.len = size;
 			ret = add_to_pipe(pipe, &buf);
 			if (unlikely(ret < 0)) {
@@ -1163,21 +1163,28 @@ static ssize_t userfaultfd_read_iter(struct kiocb *iocb, struct iov_iter *to)
 	}
 }
 
-static void __wake_userfault(struct userfaultfd_ctx *ctx,
-			     struct userfaultfd_wake_range *range)
+static void __wake_userfault_locked(struct userfaultfd_ctx *ctx,
+				    struct userfaultfd_wake_range *range)
 {
-	spin_lock_irq(&ctx->fault_pending_wqh.lock);
+	lockdep_assert_held(&ctx->fault_pending_wqh.lock);
+
 	/* wake all in the range and autoremove */
 	if (waitqueue_active(&ctx->fault_pending_wqh))
 		__wake_up_locked_key(&ctx->fault_pending_wqh, TASK_NORMAL,
 				     range);
 	if (waitqueue_active(&ctx->fault_wqh))
 		__wake_up(&ctx->fault_wqh, TASK_NORMAL, 1, range);
+}
+
+static void __wake_userfault(struct userfaultfd_ctx *ctx,
+			     struct userfaultfd_wake_range *range)
+{
+	spin_lock_irq(&ctx->fault_pending_wqh.lock);
+	__wake_userfault_locked(ctx, range);
 	spin_unlock_irq(&ctx->fault_pending_wqh.lock);
 }
 
-static __always_inline void wake_userfault(struct userfaultfd_ctx *ctx,
-					   struct userfaultfd_wake_range *range)
+static __always_inline bool userfaultfd_need_wakeup(struct userfaultfd_ctx *ctx)
 {
 	unsigned seq;
 	bool need_wakeup;
@@ -1203,10 +1210,50 @@ static __always_inline void wake_userfault(struct userfaultfd_ctx *ctx,
 			waitqueue_active(&ctx->fault_wqh);
 		cond_resched();
 	} while (read_seqcount_retry(&ctx->refile_seq, seq));
-	if (need_wakeup)
+
+	return need_wakeup;
+}
+
+static __always_inline void wake_userfault(struct userfaultfd_ctx *ctx,
+					   struct userfaultfd_wake_range *range)
+{
+	if (userfaultfd_need_wakeup(ctx))
 		__wake_userfault(ctx, range);
 }
 
+/*
+ * Like wake_userfault() for the first @nr ranges of @iov and the first
+ * @partial bytes of the one after, merging adjacent ranges and taking the
+ * waitqueue lock once.
+ */
+static void wake_userfault_vec(struct userfaultfd_ctx *ctx,
+			       const struct uffdio_iovec *iov,
+			       unsigned int nr, __u64 partial)
+{
+	struct userfaultfd_wake_range range = { .len = 0 };
+	unsigned int i;
+
+	if ((!nr && !partial) || !userfaultfd_need_wakeup(ctx))
+		return;
+
+	spin_lock_irq(&ctx->fault_pending_wqh.lock);
+	for (i = 0; i < nr + !!partial; i++) {
+		__u64 len = i < nr ? iov[i].len : partial;
+
+		if (range.len && range.start + range.len == iov[i].dst) {
+			range.len += len;
+			continue;
+		}
+		/* len == 0 would wake all */
+		if (range.len)
+			__wake_userfault_locked(ctx, &range);
+		range.start = iov[i].dst;
+		range.len = len;
+	}
+	__wake_userfault_locked(ctx, &range);
+	spin_unlock_irq(&ctx->fault_pending_wqh.lock);
+}
+
 static __always_inline int validate_unaligned_range(
 	struct mm_struct *mm, __u64 start, __u64 len)
 {
@@ -1394,9 +1441,10 @@ static int userfaultfd_register(struct userfaultfd_ctx *ctx,
 		if (!(uffdio_register.mode & UFFDIO_REGISTER_MODE_WP))
 			ioctls_out &= ~((__u64)1 << _UFFDIO_WRITEPROTECT);
 
-		/* CONTINUE ioctl is only supported for MINOR ranges. */
+		/* CONTINUE ioctls are only supported for MINOR ranges. */
 		if (!(uffdio_register.mode & UFFDIO_REGISTER_MODE_MINOR))
-			ioctls_out &= ~((__u64)1 << _UFFDIO_CONTINUE);
+			ioctls_out &= ~((__u64)1 << _UFFDIO_CONTINUE |
+					(__u64)1 << _UFFDIO_CONTINUE_VEC);
 
 		/*
 		 * Now that we scanned all vmas we can already tell
@@ -1792,6 +1840,114 @@ static int userfaultfd_continue(struct userfaultfd_ctx *ctx, unsigned long arg)
 	return ret;
 }
 
+/* Entries of a vectored fill copied in and resolved at a time */
+#define UFFDIO_VEC_BATCH	128
+
+/*
+ * UFFDIO_COPY_VEC and UFFDIO_CONTINUE_VEC: resolve an array of ranges,
+ * taking the vma lock once per run of entries within the same vma and
+ * batching the wakeups of each chunk of UFFDIO_VEC_BATCH entries.
+ */
+static int userfaultfd_vec(struct userfaultfd_ctx *ctx, unsigned long arg,
+			   bool cont)
+{
+	struct uffdio_vec uffdio_vec;
+	struct uffdio_vec __user *user_uffdio_vec;
+	struct uffdio_iovec __user *user_iov;
+	struct uffdio_iovec *iov;
+	__u64 mode_dontwake, mode_wp, nr_done = 0, i;
+	__s64 mapped = 0;
+	uffd_flags_t flags = 0;
+	int ret;
+
+	user_uffdio_vec = (struct uffdio_vec __user *)arg;
+
+	if (atomic_read(&ctx->mmap_changing))
+		return -EAGAIN;
+
+	if (copy_from_user(&uffdio_vec, user_uffdio_vec,
+			   /* don't copy the output fields */
+			   sizeof(uffdio_vec) - sizeof(__u64) - sizeof(__s64)))
+		return -EFAULT;
+
+	if (cont) {
+		mode_dontwake = UFFDIO_CONTINUE_MODE_DONTWAKE;
+		mode_wp = UFFDIO_CONTINUE_MODE_WP;
+	} else {
+		mode_dontwake = UFFDIO_COPY_MODE_DONTWAKE;
+		mode_wp = UFFDIO_COPY_MODE_WP;
+	}
+	if (uffdio_vec.mode & ~(mode_dontwake | mode_wp))
+		return -EINVAL;
+	if (uffdio_vec.mode & mode_wp)
+		flags |= MFILL_ATOMIC_WP;
+	flags = uffd_flags_set_mode(flags, cont ? MFILL_ATOMIC_CONTINUE :
+						  MFILL_ATOMIC_COPY);
+
+	user_iov = u64_to_user_ptr(uffdio_vec.iov);
+	iov = kmalloc_array(min_t(__u64, uffdio_vec.nr, UFFDIO_VEC_BATCH),
+			    sizeof(*iov), GFP_KERNEL);
+	if (uffdio_vec.nr && !iov)
+		return -ENOMEM;
+
+	if (!mmget_not_zero(ctx->mm)) {
+		kfree(iov);
+		return -ESRCH;
+	}
+
+	ret = 0;
+	for (i = 0; i < uffdio_vec.nr && !ret; ) {
+		unsigned int n = min_t(__u64, uffdio_vec.nr - i,
+				       UFFDIO_VEC_BATCH);
+		__u64 done = nr_done, partial = mapped;
+		unsigned int j;
+		int err;
+
+		if (copy_from_user(iov, user_iov + i, n * sizeof(*iov))) {
+			ret = -EFAULT;
+			break;
+		}
+
+		/* Resolve the valid ones before the first bad entry */
+		for (j = 0; j < n; j++) {
+			if (cont)
+				iov[j].src = 0;
+			else
+				ret = validate_unaligned_range(ctx->mm,
+						iov[j].src, iov[j].len);
+			if (!ret)
+				ret = validate_range(ctx->mm, iov[j].dst,
+						     iov[j].len);
+			if (ret) {
+				n = j;
+				break;
+			}
+		}
+
+		err = mfill_atomic_vec(ctx, iov, n, flags, &nr_done, &mapped);
+		if (err)
+			ret = err;
+
+		if (!(uffdio_vec.mode & mode_dontwake)) {
+			done = nr_done - done;
+			partial = mapped - partial;
+			for (j = 0; j < done; j++)
+				partial -= iov[j].len;
+			wake_userfault_vec(ctx, iov, done, partial);
+		}
+		i += n;
+	}
+
+	mmput(ctx->mm);
+	kfree(iov);
+
+	if (unlikely(put_user(nr_done, &user_uffdio_vec->nr_done)))
+		return -EFAULT;
+	if (unlikely(put_user(mapped ? mapped : ret, &user_uffdio_vec->mapped)))
+		return -EFAULT;
+	return ret;
+}
+
 static inline int userfaultfd_poison(struct userfaultfd_ctx *ctx, unsigned long arg)
 {
 	__s64 ret;
@@ -2030,6 +2186,12 @@ static long userfaultfd_ioctl(struct file *file, unsigned cmd,
 	case UFFDIO_POISON:
 		ret = userfaultfd_poison(ctx, arg);
 		break;
+	case UFFDIO_COPY_VEC:
+		ret = userfaultfd_vec(ctx, arg, false);
+		break;
+	case UFFDIO_CONTINUE_VEC:
+		ret = userfaultfd_vec(ctx, arg, true);
+		break;
 	}
 	return ret;
 }
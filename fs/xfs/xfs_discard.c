@@ -121,10 +121,38 @@ xfs_group_bdev(
 	return NULL;
 }
 
+static int
+xfs_discard_range(
+	struct xfs_mount	*mp,
+	struct xfs_group	*xg,
+	xfs_agblock_t		bno,
+	xfs_extlen_t		len,
+	struct bio		**biop)
+{
+	int			error;
+
+	trace_xfs_discard_extent(xg, bno, len);
+
+	error = __blkdev_issue_discard(xfs_group_bdev(xg),
+			xfs_gbno_to_daddr(xg, bno), XFS_FSB_TO_BB(mp, len),
+			GFP_KERNEL, biop);
+	if (error && error != -EOPNOTSUPP) {
+		xfs_info(mp,
+ "discard failed for extent [0x%llx,%u], error %d",
+			 (unsigned long long)bno, len, error);
+		return error;
+	}
+	return 0;
+}
+
 /*
  * Walk the discard list and issue discards on all the busy extents in the
  * list. We plug and chain the bios so that we only need a single completion
  * call to clear all the busy extents once the discards are complete.
+ *
+ * The list is sorted by group and block number, and extents freed by the same
+ * checkpoint are often adjacent, so merge contiguous extents into a single
+ * discard to send fewer and larger discards to the device.
  */
 int
 xfs_discard_extents(
@@ -132,28 +160,31 @@ xfs_discard_extents(
 	struct xfs_busy_extents	*extents)
 {
 	struct xfs_extent_busy	*busyp;
+	struct xfs_group	*xg = NULL;
+	xfs_agblock_t		bno = 0;
+	xfs_extlen_t		len = 0;
 	struct bio		*bio = NULL;
 	struct blk_plug		plug;
 	int			error = 0;
 
 	blk_start_plug(&plug);
 	list_for_each_entry(busyp, &extents->extent_list, list) {
-		trace_xfs_discard_extent(busyp->group, busyp->bno,
-				busyp->length);
-
-		error = __blkdev_issue_discard(xfs_group_bdev(busyp->group),
-				xfs_gbno_to_daddr(busyp->group, busyp->bno),
-				XFS_FSB_TO_BB(mp, busyp->length),
-				GFP_KERNEL, &bio);
-		if (error && error != -EOPNOTSUPP) {
-			xfs_info(mp,
-	 "discard failed for extent [0x%llx,%u], error %d",
-				 (unsigned long long)busyp->bno,
-				 busyp->length,
-				 error);
-			break;
+		if (busyp->group == xg && busyp->bno == bno + len &&
+		    len + busyp->length >= len) {
+			len += busyp->length;
+			continue;
+		}
+		if (len) {
+			error = xfs_discard_range(mp, xg, bno, len, &bio);
+			if (error)
+				break;
 		}
+		xg = busyp->group;
+		bno = busyp->bno;
+		len = busyp->length;
 	}
+	if (!error && len)
+		error = xfs_discard_range(mp, xg, bno, len, &bio);
 
 	if (bio) {
 		bio->bi_private = extents;
@@ -31,6 +31,79 @@ enum xfs_fstrm_alloc {
 	XFS_PICK_LOWSPACE = 2,
 };
 
+#define XFS_FSTRM_LOAD_INTERVAL	HZ
+
+static struct xfs_fstrm_load *
+xfs_fstrm_load_get(
+	struct xfs_mount	*mp,
+	xfs_agnumber_t		agno)
+{
+	struct xfs_fstrm_load	*load;
+	unsigned long		now = jiffies, stamp;
+
+	/* AGs added by growfs after mount are not tracked. */
+	if (agno >= mp->m_fstrm_load_nr)
+		return NULL;
+
+	load = &mp->m_fstrm_load[agno];
+	stamp = READ_ONCE(load->stamp);
+	if (time_before(now, stamp + XFS_FSTRM_LOAD_INTERVAL) ||
+	    cmpxchg(&load->stamp, stamp, now) != stamp)
+		return load;
+
+	/* We won the race to start a new interval. */
+	if (time_before(now, stamp + 2 * XFS_FSTRM_LOAD_INTERVAL))
+		atomic_long_set(&load->prev, atomic_long_xchg(&load->cur, 0));
+	else {
+		atomic_long_set(&load->prev, 0);
+		atomic_long_set(&load->cur, 0);
+	}
+	return load;
+}
+
+/*
+ * Return the number of blocks filestreams have recently asked to allocate
+ * from an AG.  This is a proxy for the write load the AG is seeing.
+ */
+unsigned long
+xfs_filestream_ag_load(
+	struct xfs_mount	*mp,
+	xfs_agnumber_t		agno)
+{
+	struct xfs_fstrm_load	*load = xfs_fstrm_load_get(mp, agno);
+
+	if (!load)
+		return 0;
+	return atomic_long_read(&load->prev) + atomic_long_read(&load->cur);
+}
+
+static void
+xfs_fstrm_load_add(
+	struct xfs_mount	*mp,
+	xfs_agnumber_t		agno,
+	xfs_extlen_t		len)
+{
+	struct xfs_fstrm_load	*load = xfs_fstrm_load_get(mp, agno);
+
+	if (load)
+		atomic_long_add(len, &load->cur);
+}
+
+/*
+ * Streams that share an AG also share its disks, so avoid starting a new
+ * stream in an AG that sees more than twice the average recent load.
+ */
+static bool
+xfs_fstrm_ag_busy(
+	struct xfs_mount	*mp,
+	xfs_agnumber_t		agno,
+	unsigned long		total_load)
+{
+	unsigned long		load = xfs_filestream_ag_load(mp, agno);
+
+	return load && load * mp->m_sb.sb_agcount > 2 * total_load;
+}
+
 static void
 xfs_fstrm_free_func(
 	void			*data,
@@ -66,11 +139,15 @@ xfs_filestream_pick_ag(
 	xfs_extlen_t		minlen = *longest;
 	xfs_extlen_t		minfree, maxfree = 0;
 	xfs_agnumber_t		agno;
+	unsigned long		total_load = 0;
 	bool			first_pass = true;
 
 	/* 2% of an AG's blocks must be free for it to be chosen. */
 	minfree = mp->m_sb.sb_agblocks / 50;
 
+	for (agno = 0; agno < mp->m_sb.sb_agcount; agno++)
+		total_load += xfs_filestream_ag_load(mp, agno);
+
 restart:
 	for_each_perag_wrap(mp, start_agno, agno, pag) {
 		int		err;
@@ -111,7 +188,9 @@ xfs_filestream_pick_ag(
 			     (!minlen && pag->pagf_freeblks >= minfree)) &&
 			    (!xfs_perag_prefers_metadata(pag) ||
 			     !(flags & XFS_PICK_USERDATA) ||
-			     (flags & XFS_PICK_LOWSPACE))) {
+			     (flags & XFS_PICK_LOWSPACE)) &&
+			    (!first_pass || (flags & XFS_PICK_LOWSPACE) ||
+			     !xfs_fstrm_ag_busy(mp, agno, total_load))) {
 				/* Break out, retaining the reference on the AG. */
 				if (max_pag)
 					xfs_perag_rele(max_pag);
@@ -370,6 +449,7 @@ xfs_filestream_select_ag(
 
 out_select:
 	ap->blkno = xfs_agbno_to_fsb(args->pag, 0);
+	xfs_fstrm_load_add(args->mp, pag_agno(args->pag), ap->length);
 	return 0;
 }
 
@@ -384,6 +464,8 @@ int
 xfs_filestream_mount(
 	xfs_mount_t	*mp)
 {
+	int		error;
+
 	/*
 	 * The filestream timer tunable is currently fixed within the range of
 	 * one second to four minutes, with five seconds being the default.  The
@@ -391,13 +473,29 @@ xfs_filestream_mount(
 	 * timer tunable to within about 10 percent.  This requires at least 10
 	 * groups.
 	 */
-	return xfs_mru_cache_create(&mp->m_filestream, mp,
+	mp->m_fstrm_load = kvcalloc(mp->m_sb.sb_agcount,
+			sizeof(*mp->m_fstrm_load), GFP_KERNEL);
+	if (!mp->m_fstrm_load)
+		return -ENOMEM;
+	mp->m_fstrm_load_nr = mp->m_sb.sb_agcount;
+
+	error = xfs_mru_cache_create(&mp->m_filestream, mp,
 			xfs_fstrm_centisecs * 10, 10, xfs_fstrm_free_func);
+	if (error) {
+		kvfree(mp->m_fstrm_load);
+		mp->m_fstrm_load = NULL;
+		mp->m_fstrm_load_nr = 0;
+	}
+	return error;
 }
 
 void
 xfs_filestream_unmount(
 	xfs_mount_t	*mp)
 {
+	/*
+	 * m_fstrm_load is read through sysfs until xfs_unmountfs() removes
+	 * the mount kobject, so it is only freed in xfs_mount_free().
+	 */
 	xfs_mru_cache_destroy(mp->m_filestream);
 }
@@ -11,11 +11,23 @@ struct xfs_inode;
 struct xfs_bmalloca;
 struct xfs_alloc_arg;
 
+/*
+ * Blocks requested by filestream allocations from an AG in the current and
+ * the previous XFS_FSTRM_LOAD_INTERVAL.
+ */
+struct xfs_fstrm_load {
+	unsigned long		stamp;
+	atomic_long_t		cur;
+	atomic_long_t		prev;
+};
+
 int xfs_filestream_mount(struct xfs_mount *mp);
 void xfs_filestream_unmount(struct xfs_mount *mp);
 void xfs_filestream_deassociate(struct xfs_inode *ip);
 int xfs_filestream_select_ag(struct xfs_bmalloca *ap,
 		struct xfs_alloc_arg *args, xfs_extlen_t *blen);
+unsigned long xfs_filestream_ag_load(struct xfs_mount *mp,
+		xfs_agnumber_t agno);
 
 static inline int
 xfs_inode_is_filestream(
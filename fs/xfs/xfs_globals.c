@@ -30,6 +30,9 @@ xfs_param_t xfs_params = {
 	.inherit_nodfrg	= {	0,		1,		1	},
 	.fstrm_timer	= {	1,		30*100,		3600*100},
 	.blockgc_timer	= {	1,		300,		3600*24},
+	.cil_push_depth	= {	1,		4,		32	},
+	.parallel_bulkstat = {	0,		0,		64	},
+	.ail_push_lead	= {	0,		0,		60*100	},
 };
 
 struct xfs_globals xfs_globals = {
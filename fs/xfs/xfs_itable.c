@@ -15,6 +15,7 @@
 #include "xfs_ialloc.h"
 #include "xfs_ialloc_btree.h"
 #include "xfs_iwalk.h"
+#include "xfs_pwork.h"
 #include "xfs_itable.h"
 #include "xfs_error.h"
 #include "xfs_icache.h"
@@ -300,6 +301,300 @@ xfs_bulkstat_already_done(
 	       startino != XFS_AGINO_TO_INO(mp, agno, agino);
 }
 
+/*
+ * Parallel Bulk Stat
+ * ==================
+ *
+ * Loading inodes dominates the cost of bulkstat on a cold cache, so if the
+ * administrator asks for it (the parallel_bulkstat sysctl), large requests
+ * are carved up and the inodes are loaded by several threads.
+ *
+ * Each round first walks the inobt records (which is cheap) from the cursor
+ * to find enough allocated inodes to fill the rest of the caller's buffer,
+ * and cuts that inode range into slices of about equal inode counts at chunk
+ * boundaries.  Every slice is then walked by xfs_pwork into a kernel buffer.
+ * Finally the slice buffers are passed to the caller's formatter in inode
+ * order, so userspace sees exactly what a serial walk would have returned.
+ *
+ * A slice that fills its buffer before reaching its end (because inodes were
+ * allocated since the inobt walk) or that hits an error ends the round, and
+ * the cursor is left where that slice stopped.
+ */
+#define XFS_PBULKSTAT_MAX_RECS	16384
+
+struct xfs_pbulkstat_slice {
+	struct xfs_pwork	pwork;
+	struct xfs_ibulk	breq;
+	xfs_ino_t		end;
+	struct xfs_bulkstat	*recs;
+	int			error;
+	bool			reached_end;
+};
+
+struct xfs_pbulkstat {
+	struct xfs_pbulkstat_slice *slices;
+	unsigned int		max_slices;
+	unsigned int		nr_slices;
+	unsigned int		share;
+	unsigned int		want;
+	unsigned int		seen;
+	xfs_ino_t		startino;
+	xfs_ino_t		end;
+};
+
+/* Carve the inodes that the next round is going to load into slices. */
+static int
+xfs_pbulkstat_inobt_walk(
+	struct xfs_mount		*mp,
+	struct xfs_trans		*tp,
+	xfs_agnumber_t			agno,
+	const struct xfs_inobt_rec_incore *irec,
+	void				*data)
+{
+	struct xfs_pbulkstat		*pb = data;
+	xfs_ino_t			ino;
+	unsigned int			inuse;
+
+	inuse = irec->ir_count - irec->ir_freecount;
+	if (!inuse)
+		return 0;
+
+	ino = XFS_AGINO_TO_INO(mp, agno, irec->ir_startino);
+	if (pb->seen >= pb->want) {
+		pb->end = ino;
+		return -ECANCELED;
+	}
+
+	if (!pb->nr_slices) {
+		pb->slices[0].breq.startino = pb->startino;
+		pb->nr_slices++;
+	} else if (pb->seen >= pb->nr_slices * pb->share &&
+		   pb->nr_slices < pb->max_slices) {
+		pb->slices[pb->nr_slices - 1].end = ino;
+		pb->slices[pb->nr_slices].breq.startino = ino;
+		pb->nr_slices++;
+	}
+
+	pb->slices[pb->nr_slices - 1].breq.icount += inuse;
+	pb->seen += inuse;
+	return 0;
+}
+
+/* Save one record of a slice in kernel memory. */
+static int
+xfs_pbulkstat_fmt(
+	struct xfs_ibulk		*breq,
+	const struct xfs_bulkstat	*bstat)
+{
+	struct xfs_pbulkstat_slice	*ps;
+
+	ps = container_of(breq, struct xfs_pbulkstat_slice, breq);
+	ps->recs[breq->ocount++] = *bstat;
+	return breq->ocount == breq->icount ? -ECANCELED : 0;
+}
+
+static int
+xfs_pbulkstat_iwalk(
+	struct xfs_mount	*mp,
+	struct xfs_trans	*tp,
+	xfs_ino_t		ino,
+	void			*data)
+{
+	struct xfs_bstat_chunk	*bc = data;
+	struct xfs_pbulkstat_slice *ps;
+
+	ps = container_of(bc->breq, struct xfs_pbulkstat_slice, breq);
+	if (ino >= ps->end) {
+		ps->reached_end = true;
+		return -ECANCELED;
+	}
+	return xfs_bulkstat_iwalk(mp, tp, ino, data);
+}
+
+/* Load the inodes of one slice. */
+static int
+xfs_pbulkstat_work(
+	struct xfs_mount	*mp,
+	struct xfs_pwork	*pwork)
+{
+	struct xfs_pbulkstat_slice *ps;
+	struct xfs_bstat_chunk	bc = {
+		.formatter	= xfs_pbulkstat_fmt,
+	};
+	struct xfs_trans	*tp;
+	unsigned int		iwalk_flags = 0;
+	int			error;
+
+	ps = container_of(pwork, struct xfs_pbulkstat_slice, pwork);
+	bc.breq = &ps->breq;
+	bc.buf = kzalloc(sizeof(struct xfs_bulkstat),
+			GFP_KERNEL | __GFP_RETRY_MAYFAIL);
+	if (!bc.buf) {
+		error = -ENOMEM;
+		goto out;
+	}
+
+	error = xfs_trans_alloc_empty(mp, &tp);
+	if (error)
+		goto out_buf;
+
+	if (ps->breq.flags & XFS_IBULK_SAME_AG)
+		iwalk_flags |= XFS_IWALK_SAME_AG;
+
+	error = xfs_iwalk(mp, tp, ps->breq.startino, iwalk_flags,
+			xfs_pbulkstat_iwalk, ps->breq.icount, &bc);
+	xfs_trans_cancel(tp);
+	if (error == -ECANCELED && ps->reached_end)
+		error = 0;
+out_buf:
+	kfree(bc.buf);
+out:
+	ps->error = error;
+	return 0;
+}
+
+/*
+ * Hand the slices to the caller's formatter in order.  Returns 1 if the walk
+ * reached the end of the filesystem (or AG), 0 if there is more to do.
+ */
+static int
+xfs_pbulkstat_merge(
+	struct xfs_ibulk	*breq,
+	struct xfs_pbulkstat	*pb,
+	bulkstat_one_fmt_pf	formatter)
+{
+	unsigned int		i, j;
+	int			error;
+
+	for (i = 0; i < pb->nr_slices; i++) {
+		struct xfs_pbulkstat_slice *ps = &pb->slices[i];
+
+		for (j = 0; j < ps->breq.ocount; j++) {
+			error = formatter(breq, &ps->recs[j]);
+			if (error == -ECANCELED) {
+				breq->startino = ps->recs[j].bs_ino + 1;
+				return 0;
+			}
+			if (error)
+				return error;
+			breq->startino = ps->recs[j].bs_ino + 1;
+		}
+
+		if (ps->error) {
+			/* Filled up early, or stopped at a bad inode. */
+			breq->startino = ps->breq.startino;
+			return ps->error == -ECANCELED ? 0 : ps->error;
+		}
+		if (!ps->reached_end && ps->end == NULLFSINO)
+			return 1;
+		breq->startino = ps->end;
+	}
+	return 0;
+}
+
+/* Run one round of parallel bulkstat. */
+static int
+xfs_pbulkstat_round(
+	struct xfs_ibulk	*breq,
+	bulkstat_one_fmt_pf	formatter,
+	struct xfs_pwork_ctl	*pctl,
+	unsigned int		threads)
+{
+	struct xfs_mount	*mp = breq->mp;
+	struct xfs_pbulkstat	pb = {
+		.max_slices	= threads,
+		.want		= min_t(unsigned int,
+					breq->icount - breq->ocount,
+					XFS_PBULKSTAT_MAX_RECS),
+		.startino	= breq->startino,
+		.end		= NULLFSINO,
+	};
+	struct xfs_trans	*tp;
+	unsigned int		iwalk_flags = 0, i;
+	int			error;
+
+	pb.share = DIV_ROUND_UP(pb.want, threads);
+	pb.slices = kcalloc(threads, sizeof(*pb.slices), GFP_KERNEL);
+	if (!pb.slices)
+		return -ENOMEM;
+
+	if (breq->flags & XFS_IBULK_SAME_AG)
+		iwalk_flags |= XFS_IWALK_SAME_AG;
+
+	error = xfs_trans_alloc_empty(mp, &tp);
+	if (error)
+		goto out_free;
+	error = xfs_inobt_walk(mp, tp, breq->startino, iwalk_flags,
+			xfs_pbulkstat_inobt_walk, 0, &pb);
+	xfs_trans_cancel(tp);
+	if (error && error != -ECANCELED)
+		goto out_free;
+	if (!pb.nr_slices) {
+		error = 1;
+		goto out_free;
+	}
+	pb.slices[pb.nr_slices - 1].end = pb.end;
+
+	for (i = 0; i < pb.nr_slices; i++) {
+		struct xfs_pbulkstat_slice *ps = &pb.slices[i];
+
+		/* Leave room for inodes allocated since the inobt walk. */
+		ps->breq.mp = mp;
+		ps->breq.idmap = breq->idmap;
+		ps->breq.flags = breq->flags;
+		ps->breq.icount += XFS_INODES_PER_CHUNK;
+		ps->recs = kvmalloc_array(ps->breq.icount, sizeof(*ps->recs),
+				GFP_KERNEL);
+		if (!ps->recs) {
+			error = -ENOMEM;
+			goto out_free;
+		}
+	}
+
+	for (i = 0; i < pb.nr_slices; i++)
+		xfs_pwork_queue(pctl, &pb.slices[i].pwork);
+	xfs_pwork_poll(pctl);
+
+	error = xfs_pbulkstat_merge(breq, &pb, formatter);
+out_free:
+	for (i = 0; i < pb.nr_slices; i++)
+		kvfree(pb.slices[i].recs);
+	kfree(pb.slices);
+	return error;
+}
+
+static int
+xfs_pbulkstat(
+	struct xfs_ibulk	*breq,
+	bulkstat_one_fmt_pf	formatter,
+	unsigned int		threads)
+{
+	struct xfs_pwork_ctl	pctl;
+	xfs_ino_t		startino;
+	int			error;
+
+	/* One set of workers for all rounds. */
+	error = xfs_pwork_init(breq->mp, &pctl, xfs_pbulkstat_work,
+			"xfs_bulkstat");
+	if (error)
+		return error;
+
+	do {
+		startino = breq->startino;
+		error = xfs_pbulkstat_round(breq, formatter, &pctl, threads);
+	} while (!error && breq->startino != startino &&
+		 breq->ocount < breq->icount &&
+		 !xfs_bulkstat_already_done(breq->mp, breq->startino) &&
+		 !fatal_signal_pending(current));
+
+	xfs_pwork_destroy(&pctl);
+
+	/* Same rules as xfs_bulkstat() for errors after returning inodes. */
+	if (error == 1 || breq->ocount > 0)
+		error = 0;
+	return error;
+}
+
 /* Return stat information in bulk (by-inode) for the filesystem. */
 int
 xfs_bulkstat(
@@ -312,6 +607,7 @@ xfs_bulkstat(
 	};
 	struct xfs_trans	*tp;
 	unsigned int		iwalk_flags = 0;
+	unsigned int		threads;
 	int			error;
 
 	if (breq->idmap != &nop_mnt_idmap) {
@@ -322,6 +618,10 @@ xfs_bulkstat(
 	if (xfs_bulkstat_already_done(breq->mp, breq->startino))
 		return 0;
 
+	threads = READ_ONCE(xfs_parallel_bulkstat);
+	if (threads > 1 && breq->icount >= 2 * threads * XFS_INODES_PER_CHUNK)
+		return xfs_pbulkstat(breq, formatter, threads);
+
 	bc.buf = kzalloc(sizeof(struct xfs_bulkstat),
 			GFP_KERNEL | __GFP_RETRY_MAYFAIL);
 	if (!bc.buf)
@@ -103,6 +103,9 @@ typedef __u32			xfs_nlink_t;
 #define xfs_inherit_nodefrag	xfs_params.inherit_nodfrg.val
 #define xfs_fstrm_centisecs	xfs_params.fstrm_timer.val
 #define xfs_blockgc_secs	xfs_params.blockgc_timer.val
+#define xfs_cil_push_depth	xfs_params.cil_push_depth.val
+#define xfs_parallel_bulkstat	xfs_params.parallel_bulkstat.val
+#define xfs_ail_push_lead	xfs_params.ail_push_lead.val
 
 #define current_cpu()		(raw_smp_processor_id())
 #define current_set_flags_nested(sp, f)		\
@@ -909,6 +909,7 @@ xlog_cil_committed(
 
 	spin_lock(&ctx->cil->xc_push_lock);
 	list_del(&ctx->committing);
+	ctx->cil->xc_committing_nr--;
 	spin_unlock(&ctx->cil->xc_push_lock);
 
 	xlog_cil_free_logvec(&ctx->lv_chain);
@@ -1023,6 +1024,7 @@ xlog_cil_order_write(
 	enum _record_type	record)
 {
 	struct xfs_cil_ctx	*ctx;
+	u64			stalled = 0;
 
 restart:
 	spin_lock(&cil->xc_push_lock);
@@ -1048,12 +1050,16 @@ xlog_cil_order_write(
 		switch (record) {
 		case _START_RECORD:
 			if (!ctx->start_lsn) {
+				if (!stalled)
+					stalled = ktime_get_ns();
 				xlog_wait(&cil->xc_start_wait, &cil->xc_push_lock);
 				goto restart;
 			}
 			break;
 		case _COMMIT_RECORD:
 			if (!ctx->commit_lsn) {
+				if (!stalled)
+					stalled = ktime_get_ns();
 				xlog_wait(&cil->xc_commit_wait, &cil->xc_push_lock);
 				goto restart;
 			}
@@ -1061,6 +1067,10 @@ xlog_cil_order_write(
 		}
 	}
 	spin_unlock(&cil->xc_push_lock);
+	if (stalled)
+		trace_xfs_cil_order_stall(cil->xc_log->l_mp, sequence,
+				record == _COMMIT_RECORD,
+				ktime_get_ns() - stalled);
 	return 0;
 }
 
@@ -1376,6 +1386,8 @@ xlog_cil_push_work(
 	 * on the commit sequence.
 	 */
 	list_add(&ctx->committing, &cil->xc_committing);
+	cil->xc_committing_nr++;
+	trace_xfs_cil_push(log->l_mp, ctx->sequence, cil->xc_committing_nr);
 	spin_unlock(&cil->xc_push_lock);
 
 	xlog_cil_build_lv_chain(ctx, &whiteouts, &num_iovecs, &num_bytes);
@@ -1928,12 +1940,13 @@ xlog_cil_init(
 	if (!cil)
 		return -ENOMEM;
 	/*
-	 * Limit the CIL pipeline depth to 4 concurrent works to bound the
-	 * concurrency the log spinlocks will be exposed to.
+	 * Limit the CIL pipeline depth to bound the concurrency the log
+	 * spinlocks will be exposed to.  The default of 4 concurrent works can
+	 * be raised through the cil_push_depth sysctl for fast log devices.
 	 */
 	cil->xc_push_wq = alloc_workqueue("xfs-cil/%s",
 			XFS_WQFLAGS(WQ_FREEZABLE | WQ_MEM_RECLAIM | WQ_UNBOUND),
-			4, log->l_mp->m_super->s_id);
+			xfs_cil_push_depth, log->l_mp->m_super->s_id);
 	if (!cil->xc_push_wq)
 		goto out_destroy_cil;
 
@@ -279,6 +279,7 @@ struct xfs_cil {
 	xfs_csn_t		xc_push_seq;
 	bool			xc_push_commit_stable;
 	struct list_head	xc_committing;
+	unsigned int		xc_committing_nr;
 	wait_queue_head_t	xc_commit_wait;
 	wait_queue_head_t	xc_start_wait;
 	xfs_csn_t		xc_current_sequence;
@@ -164,6 +164,8 @@ typedef struct xfs_mount {
 	struct xfs_buftarg	*m_rtdev_targp;	/* rt device */
 	void __percpu		*m_inodegc;	/* percpu inodegc structures */
 	struct xfs_mru_cache	*m_filestream;  /* per-mount filestream data */
+	struct xfs_fstrm_load	*m_fstrm_load;	/* per-AG filestream load */
+	xfs_agnumber_t		m_fstrm_load_nr;
 	struct workqueue_struct *m_buf_workqueue;
 	struct workqueue_struct	*m_unwritten_workqueue;
 	struct workqueue_struct	*m_reclaim_workqueue;
@@ -780,6 +780,7 @@ xfs_mount_free(
 		xfs_free_buftarg(mp->m_ddev_targp);
 
 	debugfs_remove(mp->m_debugfs);
+	kvfree(mp->m_fstrm_load);
 	kfree(mp->m_rtname);
 	kfree(mp->m_logname);
 	kfree(mp);
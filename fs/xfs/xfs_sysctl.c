@@ -194,6 +194,33 @@ static const struct ctl_table xfs_table[] = {
 		.extra1		= &xfs_params.blockgc_timer.min,
 		.extra2		= &xfs_params.blockgc_timer.max,
 	},
+	{
+		.procname	= "cil_push_depth",
+		.data		= &xfs_params.cil_push_depth.val,
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= &xfs_params.cil_push_depth.min,
+		.extra2		= &xfs_params.cil_push_depth.max,
+	},
+	{
+		.procname	= "parallel_bulkstat",
+		.data		= &xfs_params.parallel_bulkstat.val,
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= &xfs_params.parallel_bulkstat.min,
+		.extra2		= &xfs_params.parallel_bulkstat.max,
+	},
+	{
+		.procname	= "ail_push_lead_centisecs",
+		.data		= &xfs_params.ail_push_lead.val,
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= &xfs_params.ail_push_lead.min,
+		.extra2		= &xfs_params.ail_push_lead.max,
+	},
 	/* please keep this the last entry */
 #ifdef CONFIG_PROC_FS
 	{
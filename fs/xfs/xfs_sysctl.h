@@ -36,6 +36,9 @@ typedef struct xfs_param {
 	xfs_sysctl_val_t inherit_nodfrg;/* Inherit the "nodefrag" inode flag. */
 	xfs_sysctl_val_t fstrm_timer;	/* Filestream dir-AG assoc'n timeout. */
 	xfs_sysctl_val_t blockgc_timer;	/* Interval between blockgc scans */
+	xfs_sysctl_val_t cil_push_depth;/* Max concurrent CIL pushes per log */
+	xfs_sysctl_val_t parallel_bulkstat;/* Threads per bulkstat call */
+	xfs_sysctl_val_t ail_push_lead;	/* Log space to keep free, in time */
 } xfs_param_t;
 
 /*
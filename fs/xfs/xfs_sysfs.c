@@ -14,6 +14,7 @@
 #include "xfs_log_priv.h"
 #include "xfs_mount.h"
 #include "xfs_zones.h"
+#include "xfs_filestream.h"
 
 struct xfs_sysfs_attr {
 	struct attribute attr;
@@ -65,7 +66,34 @@ static const struct sysfs_ops xfs_sysfs_ops = {
 	.store = xfs_sysfs_object_store,
 };
 
+static inline struct xfs_mount *
+to_mp(struct kobject *kobject)
+{
+	struct xfs_kobj *kobj = to_kobj(kobject);
+
+	return container_of(kobj, struct xfs_mount, m_kobj);
+}
+
+/* Recent filestream allocation load of each AG, in blocks. */
+STATIC ssize_t
+filestream_ag_load_show(
+	struct kobject		*kobject,
+	char			*buf)
+{
+	struct xfs_mount	*mp = to_mp(kobject);
+	xfs_agnumber_t		agno;
+	ssize_t			len = 0;
+
+	for (agno = 0; agno < mp->m_sb.sb_agcount; agno++)
+		len += sysfs_emit_at(buf, len, "%s%lu", agno ? " " : "",
+				xfs_filestream_ag_load(mp, agno));
+	len += sysfs_emit_at(buf, len, "\n");
+	return len;
+}
+XFS_SYSFS_ATTR_RO(filestream_ag_load);
+
 static struct attribute *xfs_mp_attrs[] = {
+	ATTR_LIST(filestream_ag_load),
 	NULL,
 };
 ATTRIBUTE_GROUPS(xfs_mp);
@@ -1550,6 +1550,46 @@ TRACE_EVENT(xfs_log_force,
 		  __entry->lsn, (void *)__entry->caller_ip)
 )
 
+TRACE_EVENT(xfs_cil_push,
+	TP_PROTO(struct xfs_mount *mp, uint64_t sequence, unsigned int nr),
+	TP_ARGS(mp, sequence, nr),
+	TP_STRUCT__entry(
+		__field(dev_t, dev)
+		__field(uint64_t, sequence)
+		__field(unsigned int, nr)
+	),
+	TP_fast_assign(
+		__entry->dev = mp->m_super->s_dev;
+		__entry->sequence = sequence;
+		__entry->nr = nr;
+	),
+	TP_printk("dev %d:%d seq %llu committing %u",
+		  MAJOR(__entry->dev), MINOR(__entry->dev),
+		  __entry->sequence, __entry->nr)
+)
+
+TRACE_EVENT(xfs_cil_order_stall,
+	TP_PROTO(struct xfs_mount *mp, uint64_t sequence, bool commit,
+		 u64 delay_ns),
+	TP_ARGS(mp, sequence, commit, delay_ns),
+	TP_STRUCT__entry(
+		__field(dev_t, dev)
+		__field(uint64_t, sequence)
+		__field(bool, commit)
+		__field(u64, delay_ns)
+	),
+	TP_fast_assign(
+		__entry->dev = mp->m_super->s_dev;
+		__entry->sequence = sequence;
+		__entry->commit = commit;
+		__entry->delay_ns = delay_ns;
+	),
+	TP_printk("dev %d:%d seq %llu %s record delay %llu ns",
+		  MAJOR(__entry->dev), MINOR(__entry->dev),
+		  __entry->sequence, __entry->commit ? "commit" : "start",
+		  __entry->delay_ns)
+)
+
 #define DEFINE_LOG_ITEM_EVENT(name) \
 DEFINE_EVENT(xfs_log_item_class, name, \
 	TP_PROTO(struct xfs_log_item *lip), \
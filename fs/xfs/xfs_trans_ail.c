@@ -390,11 +390,66 @@ xfsaild_push_item(
 	return lip->li_ops->iop_push(lip, &ailp->ail_buf_list);
 }
 
+/*
+ * Estimate how fast log space is being consumed from the rate at which the
+ * highest LSN in the AIL moves forward, as a weighted average in bytes per
+ * second.
+ */
+static void
+xfs_ail_update_rate(
+	struct xfs_ail		*ailp,
+	xfs_lsn_t		max_lsn)
+{
+	struct xlog		*log = ailp->ail_log;
+	u64			now = ktime_get_ns();
+	u64			delta = now - ailp->ail_rate_stamp;
+	u64			bytes = 0;
+
+	if (delta < 10 * NSEC_PER_MSEC)
+		return;
+
+	if (ailp->ail_rate_lsn &&
+	    XFS_LSN_CMP(max_lsn, ailp->ail_rate_lsn) > 0) {
+		if (CYCLE_LSN(max_lsn) - CYCLE_LSN(ailp->ail_rate_lsn) > 1)
+			bytes = log->l_logsize;
+		else
+			bytes = xlog_lsn_sub(log, max_lsn, ailp->ail_rate_lsn);
+	}
+	ailp->ail_rate = (3 * ailp->ail_rate +
+			  div64_u64(bytes * NSEC_PER_SEC, delta)) / 4;
+	ailp->ail_rate_lsn = max_lsn;
+	ailp->ail_rate_stamp = now;
+}
+
+/*
+ * Work out how much of the log we want free.  By default this is 25%, but if
+ * the ail_push_lead sysctl is set, it is at least the log space we expect to
+ * be consumed within that time at the current rate, so that tail pushing
+ * starts early enough for bursts not to run the log out of space.
+ */
+static int64_t
+xfs_ail_want_free(
+	struct xfs_ail		*ailp)
+{
+	struct xlog		*log = ailp->ail_log;
+	int64_t			want = log->l_logsize >> 2;
+	unsigned int		lead = READ_ONCE(xfs_ail_push_lead);
+	u64			predicted;
+
+	if (!lead)
+		return want;
+
+	predicted = div_u64(ailp->ail_rate * lead, 100);
+	predicted = min_t(u64, predicted, (log->l_logsize >> 2) * 3);
+	return max_t(int64_t, want, predicted);
+}
+
 /*
  * Compute the LSN that we'd need to push the log tail towards in order to have
- * at least 25% of the log space free.  If the log free space already meets this
- * threshold, this function returns the lowest LSN in the AIL to slowly keep
- * writeback ticking over and the tail of the log moving forward.
+ * at least the space returned by xfs_ail_want_free() free.  If the log free
+ * space already meets this threshold, this function returns the lowest LSN in
+ * the AIL to slowly keep writeback ticking over and the tail of the log moving
+ * forward.
  */
 static xfs_lsn_t
 xfs_ail_calc_push_target(
@@ -406,6 +461,7 @@ xfs_ail_calc_push_target(
 	xfs_lsn_t		max_lsn;
 	xfs_lsn_t		min_lsn;
 	int32_t			free_bytes;
+	int64_t			want_free;
 	uint32_t		target_block;
 	uint32_t		target_cycle;
 
@@ -417,6 +473,7 @@ xfs_ail_calc_push_target(
 
 	max_lsn = lip->li_lsn;
 	min_lsn = __xfs_ail_min_lsn(ailp);
+	xfs_ail_update_rate(ailp, max_lsn);
 
 	/*
 	 * If we are supposed to push all the items in the AIL, we want to push
@@ -433,15 +490,16 @@ xfs_ail_calc_push_target(
 		return max_lsn;
 
 	/*
-	 * Background pushing - attempt to keep 25% of the log free and if we
-	 * have that much free retain the existing target.
+	 * Background pushing - attempt to keep the wanted amount of the log
+	 * free and if we have that much free retain the existing target.
 	 */
+	want_free = xfs_ail_want_free(ailp);
 	free_bytes = log->l_logsize - xlog_lsn_sub(log, max_lsn, min_lsn);
-	if (free_bytes >= log->l_logsize >> 2)
+	if (free_bytes >= want_free)
 		return ailp->ail_target;
 
 	target_cycle = CYCLE_LSN(min_lsn);
-	target_block = BLOCK_LSN(min_lsn) + (log->l_logBBsize >> 2);
+	target_block = BLOCK_LSN(min_lsn) + BTOBB(want_free);
 	if (target_block >= log->l_logBBsize) {
 		target_block -= log->l_logBBsize;
 		target_cycle += 1;
@@ -61,6 +61,11 @@ struct xfs_ail {
 	struct list_head	ail_buf_list;
 	wait_queue_head_t	ail_empty;
 	xfs_lsn_t		ail_target;
+
+	/* Rate of log space consumption, see xfs_ail_update_rate(). */
+	xfs_lsn_t		ail_rate_lsn;
+	u64			ail_rate_stamp;
+	u64			ail_rate;	/* bytes per second */
 };
 
 /* Push all items out of the AIL immediately. */
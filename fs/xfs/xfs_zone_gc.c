@@ -806,6 +806,13 @@ xfs_zone_gc_write_chunk(
 	bio_add_folio_nofail(&chunk->bio, chunk->scratch->folio, chunk->len,
 			folio_offset);
 
+	/*
+	 * Data that survived until GC is unlikely to be overwritten soon, so
+	 * let devices with data placement support keep it apart from freshly
+	 * written data as well.  Split bios inherit the hint.
+	 */
+	chunk->bio.bi_write_hint = WRITE_LIFE_EXTREME;
+
 	while ((split_chunk = xfs_zone_gc_split_write(data, chunk)))
 		xfs_zone_gc_submit_write(data, split_chunk);
 	xfs_zone_gc_submit_write(data, chunk);
@@ -853,6 +860,9 @@ xfs_zone_gc_finish_chunk(
 		chunk->new_daddr = chunk->bio.bi_iter.bi_sector;
 	error = xfs_zoned_end_io(ip, chunk->offset, chunk->len,
 			chunk->new_daddr, chunk->oz, chunk->old_startblock);
+	if (!error)
+		WRITE_ONCE(mp->m_zone_info->zi_gc_bytes,
+			   mp->m_zone_info->zi_gc_bytes + chunk->len);
 free:
 	if (error)
 		xfs_force_shutdown(mp, SHUTDOWN_META_IO_ERROR);
@@ -874,6 +884,7 @@ xfs_zone_gc_finish_reset(
 
 	xfs_group_set_mark(&rtg->rtg_group, XFS_RTG_FREE);
 	atomic_inc(&zi->zi_nr_free_zones);
+	WRITE_ONCE(zi->zi_gc_zones_reset, zi->zi_gc_zones_reset + 1);
 
 	xfs_zoned_add_available(mp, rtg_blocks(rtg));
 
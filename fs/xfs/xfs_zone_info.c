@@ -89,6 +89,10 @@ xfs_zoned_show_stats(
 		!list_empty_careful(&zi->zi_reclaim_reservations));
 	seq_printf(m, "\tRT GC required: %d\n",
 		xfs_zoned_need_gc(mp));
+	seq_printf(m, "\tRT GC relocated bytes: %llu\n",
+		READ_ONCE(zi->zi_gc_bytes));
+	seq_printf(m, "\tRT GC zones reset: %llu\n",
+		READ_ONCE(zi->zi_gc_zones_reset));
 
 	seq_printf(m, "\tfree zones: %d\n", atomic_read(&zi->zi_nr_free_zones));
 	seq_puts(m, "\topen zones:\n");
@@ -90,6 +90,13 @@ struct xfs_zone_info {
 	struct task_struct      *zi_gc_thread;
 	struct xfs_open_zone	*zi_open_gc_zone;
 
+	/*
+	 * Bytes relocated and zones reset by GC.  Only updated by the GC
+	 * thread.
+	 */
+	u64			zi_gc_bytes;
+	u64			zi_gc_zones_reset;
+
 	/*
 	 * List of zones that need a reset:
 	 */
@@ -160,6 +160,8 @@ struct bdi_writeback {
 #endif
 };
 
+#define BDI_MAX_WB_WORKERS	16
+
 struct backing_dev_info {
 	u64 id;
 	struct rb_node rb_node; /* keyed by ->id */
@@ -171,6 +173,7 @@ struct backing_dev_info {
 	unsigned int capabilities; /* Device capabilities */
 	unsigned int min_ratio;
 	unsigned int max_ratio, max_prop_frac;
+	unsigned int wb_workers; /* flushers per writeback work, see wb_writeback() */
 
 	/*
 	 * Sum of avg_write_bw of wbs with dirty inodes.  > 0 if there are
@@ -45,6 +45,7 @@ extern spinlock_t bdi_lock;
 extern struct list_head bdi_list;
 
 extern struct workqueue_struct *bdi_wq;
+extern struct workqueue_struct *bdi_helper_wq;
 
 static inline bool wb_has_dirty_io(struct bdi_writeback *wb)
 {
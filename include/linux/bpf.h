@@ -2535,6 +2535,8 @@ struct bpf_iter_aux_info {
 	struct {
 		enum bpf_iter_task_type	type;
 		u32 pid;
+		u32 tid_min;
+		u32 tid_max;
 	} task;
 };
 
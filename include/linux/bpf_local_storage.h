@@ -18,6 +18,11 @@
 
 #define BPF_LOCAL_STORAGE_CACHE_SIZE	16
 
+/* A cache slot that holds another map's data is only taken over when the
+ * slow path lookup had to skip at least this many elements.
+ */
+#define BPF_LOCAL_STORAGE_SHORT_WALK	4
+
 #define bpf_rcu_lock_held()                                                    \
 	(rcu_read_lock_held() || rcu_read_lock_trace_held() ||                 \
 	 rcu_read_lock_bh_held())
@@ -146,6 +151,7 @@ bpf_local_storage_lookup(struct bpf_local_storage *local_storage,
 {
 	struct bpf_local_storage_data *sdata;
 	struct bpf_local_storage_elem *selem;
+	unsigned int depth = 0;
 
 	/* Fast path (cache hit) */
 	sdata = rcu_dereference_check(local_storage->cache[smap->cache_idx],
@@ -155,13 +161,19 @@ bpf_local_storage_lookup(struct bpf_local_storage *local_storage,
 
 	/* Slow path (cache miss) */
 	hlist_for_each_entry_rcu(selem, &local_storage->list, snode,
-				  rcu_read_lock_trace_held())
+				  rcu_read_lock_trace_held()) {
 		if (rcu_access_pointer(SDATA(selem)->smap) == smap)
 			break;
+		depth++;
+	}
 
 	if (!selem)
 		return NULL;
-	if (cacheit_lockit)
+	/* With more maps than cache slots, two maps sharing a slot would
+	 * otherwise take the storage lock on every lookup just to evict
+	 * each other.  Leave the slot alone when the walk was cheap.
+	 */
+	if (cacheit_lockit && (!sdata || depth >= BPF_LOCAL_STORAGE_SHORT_WALK))
 		__bpf_local_storage_insert_cache(local_storage, smap, selem);
 	return SDATA(selem);
 }
@@ -107,14 +107,19 @@ struct damon_target {
  * @DAMOS_LRU_DEPRIO:	Deprioritize the region on its LRU lists.
  * @DAMOS_MIGRATE_HOT:  Migrate the regions prioritizing warmer regions.
  * @DAMOS_MIGRATE_COLD:	Migrate the regions prioritizing colder regions.
+ * @DAMOS_COLLAPSE_HINT: Ask khugepaged to collapse the regions first.
+ * @DAMOS_PROMOTE_HINT: Feed the regions to the memory tiering promotion.
  * @DAMOS_STAT:		Do nothing but count the stat.
  * @NR_DAMOS_ACTIONS:	Total number of DAMOS actions
  *
  * The support of each action is up to running &struct damon_operations.
  * &enum DAMON_OPS_VADDR and &enum DAMON_OPS_FVADDR supports all actions except
- * &enum DAMOS_LRU_PRIO and &enum DAMOS_LRU_DEPRIO.  &enum DAMON_OPS_PADDR
- * supports only &enum DAMOS_PAGEOUT, &enum DAMOS_LRU_PRIO, &enum
- * DAMOS_LRU_DEPRIO, and &DAMOS_STAT.
+ * &enum DAMOS_LRU_PRIO, &enum DAMOS_LRU_DEPRIO, &enum DAMOS_MIGRATE_HOT,
+ * &enum DAMOS_MIGRATE_COLD and &enum DAMOS_PROMOTE_HINT.  &enum
+ * DAMON_OPS_PADDR supports only &enum DAMOS_PAGEOUT, &enum DAMOS_LRU_PRIO, &enum
+ * DAMOS_LRU_DEPRIO, &enum DAMOS_MIGRATE_HOT, &enum DAMOS_MIGRATE_COLD, &enum
+ * DAMOS_PROMOTE_HINT and &DAMOS_STAT.  &enum DAMON_OPS_PADDR_PMU supports the
+ * same actions as &enum DAMON_OPS_PADDR.
  */
 enum damos_action {
 	DAMOS_WILLNEED,
@@ -126,6 +131,8 @@ enum damos_action {
 	DAMOS_LRU_DEPRIO,
 	DAMOS_MIGRATE_HOT,
 	DAMOS_MIGRATE_COLD,
+	DAMOS_COLLAPSE_HINT,
+	DAMOS_PROMOTE_HINT,
 	DAMOS_STAT,		/* Do nothing but only record the stat */
 	NR_DAMOS_ACTIONS,
 };
@@ -493,12 +500,15 @@ struct damos {
  * @DAMON_OPS_FVADDR:	Monitoring operations for only fixed ranges of virtual
  *			address spaces
  * @DAMON_OPS_PADDR:	Monitoring operations for the physical address space
+ * @DAMON_OPS_PADDR_PMU:	Monitoring operations for the physical address
+ *			space, based on PMU data address samples
  * @NR_DAMON_OPS:	Number of monitoring operations implementations
  */
 enum damon_ops_id {
 	DAMON_OPS_VADDR,
 	DAMON_OPS_FVADDR,
 	DAMON_OPS_PADDR,
+	DAMON_OPS_PADDR_PMU,
 	NR_DAMON_OPS,
 };
 
@@ -32,6 +32,8 @@ struct fdtable {
 	struct rcu_head rcu;
 };
 
+struct fd_cache;
+
 /*
  * Open file table structure
  */
@@ -44,6 +46,8 @@ struct files_struct {
 	wait_queue_head_t resize_wait;
 
 	struct fdtable __rcu *fdt;
+	unsigned int fd_batch;		/* PR_SET_FD_RESERVE */
+	struct fd_cache __percpu *fd_cache;
 	struct fdtable fdtab;
   /*
    * written part on a separate cache line in SMP
@@ -106,6 +110,8 @@ struct fd_range {
 };
 struct files_struct *dup_fd(struct files_struct *, struct fd_range *) __latent_entropy;
 void do_close_on_exec(struct files_struct *);
+int files_set_fd_reserve(unsigned long batch);
+int files_get_fd_reserve(void);
 int iterate_fd(struct files_struct *, unsigned,
 		int (*)(const void *, struct file *, unsigned),
 		const void *);
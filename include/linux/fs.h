@@ -63,6 +63,7 @@ struct iovec;
 struct kiocb;
 struct kobject;
 struct pipe_inode_info;
+struct path_prefix_cache;
 struct poll_table_struct;
 struct kstatfs;
 struct vm_area_struct;
@@ -1023,6 +1024,24 @@ struct fown_struct {
 	int signum;		/* posix.1b rt signal to be delivered on IO */
 };
 
+#define RA_NR_STREAMS	4
+
+/**
+ * struct file_ra_stream - Track one stream of reads on a file.
+ * @index: Where the most recent read of the stream started.
+ * @stride: Distance in pages to the read before it, 0 if unknown.
+ * @nr: Number of pages in the most recent read.
+ * @hits: How many reads in a row were @stride pages apart.
+ * @depth: Number of strides read ahead beyond @index.
+ */
+struct file_ra_stream {
+	pgoff_t index;
+	unsigned int stride;
+	unsigned short nr;
+	unsigned char hits;
+	unsigned char depth;
+};
+
 /**
  * struct file_ra_state - Track a file's readahead state.
  * @start: Where the most recent readahead started.
@@ -1033,6 +1052,9 @@ struct fown_struct {
  * @ra_pages: Maximum size of a readahead request, copied from the bdi.
  * @mmap_miss: How many mmap accesses missed in the page cache.
  * @prev_pos: The last byte in the most recent read request.
+ * @streams: Recent streams of reads that missed the page cache, an array
+ *      of RA_NR_STREAMS entries allocated on the first non-sequential miss
+ *      of a file's own f_ra.  NULL until then.
  *
  * When this structure is passed to ->readahead(), the "most recent"
  * readahead means the current readahead.
@@ -1044,6 +1066,7 @@ struct file_ra_state {
 	unsigned int ra_pages;
 	unsigned int mmap_miss;
 	loff_t prev_pos;
+	struct file_ra_stream *streams;
 };
 
 /*
@@ -1405,6 +1428,14 @@ struct super_block {
 
 	const struct dentry_operations *s_d_op; /* default d_op for dentries */
 
+	struct path_prefix_cache *s_prefix_cache; /* see fs/namei.c */
+
+#ifdef CONFIG_FS_DAX
+	/* bytes copied by dax_iomap_rw() through the cache and around it */
+	atomic64_t s_dax_cached_bytes;
+	atomic64_t s_dax_nt_bytes;
+#endif
+
 	struct shrinker *s_shrink;	/* per-sb shrinker handle */
 
 	/* Number of inodes with nlink == 0 but still referenced */
@@ -3380,6 +3411,7 @@ extern ssize_t iter_file_splice_write(struct pipe_inode_info *,
 
 extern void
 file_ra_state_init(struct file_ra_state *ra, struct address_space *mapping);
+extern void file_ra_state_release(struct file_ra_state *ra);
 extern loff_t noop_llseek(struct file *file, loff_t offset, int whence);
 extern loff_t vfs_setpos(struct file *file, loff_t offset, loff_t maxsize);
 extern loff_t generic_file_llseek(struct file *file, loff_t offset, int whence);
@@ -133,6 +133,8 @@ enum mthp_stat_item {
 	MTHP_STAT_SPLIT_DEFERRED,
 	MTHP_STAT_NR_ANON,
 	MTHP_STAT_NR_ANON_PARTIALLY_MAPPED,
+	MTHP_STAT_PCP_HIT,
+	MTHP_STAT_PCP_REFILL,
 	__MTHP_STAT_COUNT
 };
 
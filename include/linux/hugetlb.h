@@ -672,6 +672,9 @@ struct hstate {
 	unsigned int nr_huge_pages_node[MAX_NUMNODES];
 	unsigned int free_huge_pages_node[MAX_NUMNODES];
 	unsigned int surplus_huge_pages_node[MAX_NUMNODES];
+	atomic64_t alloc_time_ns;	/* spent growing the pool */
+	atomic64_t zero_time_ns;	/* spent zeroing gigantic folios */
+	atomic_long_t nr_zeroed;	/* gigantic folios zeroed */
 	char name[HSTATE_NAME_LEN];
 };
 
@@ -691,6 +694,7 @@ struct folio *alloc_hugetlb_folio_nodemask(struct hstate *h, int preferred_nid,
 struct folio *alloc_hugetlb_folio_reserve(struct hstate *h, int preferred_nid,
 					  nodemask_t *nmask, gfp_t gfp_mask);
 
+void hugetlb_zero_folio(struct folio *folio, unsigned long addr_hint);
 int hugetlb_add_to_page_cache(struct folio *folio, struct address_space *mapping,
 			pgoff_t idx);
 void restore_reserve_on_error(struct hstate *h, struct vm_area_struct *vma,
@@ -15,6 +15,8 @@ extern void khugepaged_enter_vma(struct vm_area_struct *vma,
 				 unsigned long vm_flags);
 extern void khugepaged_min_free_kbytes_update(void);
 extern bool current_is_khugepaged(void);
+extern int khugepaged_add_hint(struct mm_struct *mm, unsigned long start,
+			       unsigned long end, unsigned int score);
 #ifdef CONFIG_SHMEM
 extern int collapse_pte_mapped_thp(struct mm_struct *mm, unsigned long addr,
 				   bool install_pmd);
@@ -62,6 +64,12 @@ static inline bool current_is_khugepaged(void)
 {
 	return false;
 }
+
+static inline int khugepaged_add_hint(struct mm_struct *mm,
+		unsigned long start, unsigned long end, unsigned int score)
+{
+	return -EINVAL;
+}
 #endif /* CONFIG_TRANSPARENT_HUGEPAGE */
 
 #endif /* _LINUX_KHUGEPAGED_H */
@@ -56,6 +56,7 @@ void mt_put_memory_types(struct list_head *memory_types);
 int next_demotion_node(int node);
 void node_get_allowed_targets(pg_data_t *pgdat, nodemask_t *targets);
 bool node_is_toptier(int node);
+void memtier_record_access(unsigned long pfn, unsigned int weight);
 #else
 static inline int next_demotion_node(int node)
 {
@@ -71,6 +72,10 @@ static inline bool node_is_toptier(int node)
 {
 	return true;
 }
+
+static inline void memtier_record_access(unsigned long pfn, unsigned int weight)
+{
+}
 #endif
 
 #else
@@ -116,6 +121,10 @@ static inline bool node_is_toptier(int node)
 	return true;
 }
 
+static inline void memtier_record_access(unsigned long pfn, unsigned int weight)
+{
+}
+
 static inline int register_mt_adistance_algorithm(struct notifier_block *nb)
 {
 	return 0;
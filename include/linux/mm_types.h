@@ -778,6 +778,9 @@ struct vm_area_struct {
 #ifdef CONFIG_SWAP
 	atomic_long_t swap_readahead_info;
 #endif
+#ifdef CONFIG_MMU
+	atomic_long_t fault_around_info;	/* see do_fault_around() */
+#endif
 #ifndef CONFIG_MMU
 	struct vm_region *vm_region;	/* NOMMU mapping region */
 #endif
@@ -1028,6 +1031,10 @@ struct mm_struct {
 #ifdef CONFIG_ARCH_WANT_BATCHED_UNMAP_TLB_FLUSH
 		/* See flush_tlb_batched_pending() */
 		atomic_t tlb_flush_batched;
+#endif
+#ifdef CONFIG_MMU
+		/* Opt-in deferred TLB shootdown, see mm/mmu_gather.c */
+		struct tlb_defer *tlb_defer;
 #endif
 		struct uprobes_state uprobes_state;
 #ifdef CONFIG_PREEMPT_RT
@@ -1305,6 +1312,22 @@ extern void tlb_gather_mmu(struct mmu_gather *tlb, struct mm_struct *mm);
 extern void tlb_gather_mmu_fullmm(struct mmu_gather *tlb, struct mm_struct *mm);
 extern void tlb_finish_mmu(struct mmu_gather *tlb);
 
+struct seq_file;
+#ifdef CONFIG_MMU
+extern int tlb_defer_set(struct mm_struct *mm, bool enable);
+extern bool tlb_defer_get(struct mm_struct *mm);
+extern void tlb_defer_free(struct mm_struct *mm);
+extern void tlb_defer_report(struct seq_file *m, struct mm_struct *mm);
+#else
+static inline int tlb_defer_set(struct mm_struct *mm, bool enable)
+{
+	return -EOPNOTSUPP;
+}
+static inline bool tlb_defer_get(struct mm_struct *mm) { return false; }
+static inline void tlb_defer_free(struct mm_struct *mm) { }
+static inline void tlb_defer_report(struct seq_file *m, struct mm_struct *mm) { }
+#endif
+
 struct vm_fault;
 
 /**
@@ -220,6 +220,7 @@ enum node_stat_item {
 	PGDEMOTE_KSWAPD,
 	PGDEMOTE_DIRECT,
 	PGDEMOTE_KHUGEPAGED,
+	NR_KSWAPD_HELPERS,	/* kswapd helper threads currently reclaiming */
 #ifdef CONFIG_HUGETLB_PAGE
 	NR_HUGETLB,
 #endif
@@ -677,13 +678,18 @@ enum zone_watermarks {
 };
 
 /*
- * One per migratetype for each PAGE_ALLOC_COSTLY_ORDER. Two additional lists
- * are added for THP. One PCP list is used by GPF_MOVABLE, and the other PCP list
- * is used by GFP_UNMOVABLE and GFP_RECLAIMABLE.
+ * One per migratetype for each PAGE_ALLOC_COSTLY_ORDER. With THP, two
+ * additional lists are added for each mTHP order up to PCP_MAX_MTHP_ORDER,
+ * and two for the PMD order. One of those PCP lists is used by GFP_MOVABLE,
+ * and the other PCP list is used by GFP_UNMOVABLE and GFP_RECLAIMABLE.
  */
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
-#define NR_PCP_THP 2
+#define PCP_MAX_MTHP_ORDER (PAGE_ALLOC_COSTLY_ORDER + 5)
+#define NR_PCP_MTHP (2 * (PCP_MAX_MTHP_ORDER - PAGE_ALLOC_COSTLY_ORDER))
+#define NR_PCP_THP (NR_PCP_MTHP + 2)
 #else
+#define PCP_MAX_MTHP_ORDER PAGE_ALLOC_COSTLY_ORDER
+#define NR_PCP_MTHP 0
 #define NR_PCP_THP 0
 #endif
 #define NR_LOWORDER_PCP_LISTS (MIGRATE_PCPTYPES * (PAGE_ALLOC_COSTLY_ORDER + 1))
@@ -1314,6 +1320,9 @@ struct memory_failure_stats {
 };
 #endif
 
+/* Maximum number of kswapd helper threads per node */
+#define KSWAPD_MAX_HELPERS 15
+
 /*
  * On NUMA machines, each NUMA node would have a pg_data_t to describe
  * it's memory layout. On UMA machines there is a single pglist_data which
@@ -1382,6 +1391,18 @@ typedef struct pglist_data {
 
 	int kswapd_failures;		/* Number of 'reclaimed == 0' runs */
 
+	/*
+	 * Additional reclaim threads that kswapd activates when allocations
+	 * outpace it, see vm.kswapd_threads.
+	 */
+	struct task_struct *kswapd_helpers[KSWAPD_MAX_HELPERS]; /* Protected by kswapd_lock */
+	int nr_kswapd_helpers;		/* Protected by kswapd_lock */
+	int kswapd_helpers_active;	/* Helpers asked to reclaim */
+	int kswapd_helper_priority;	/* Reclaim parameters for helpers */
+	enum zone_type kswapd_helper_zoneidx;
+	wait_queue_head_t kswapd_helper_wait;
+	atomic_long_t nr_direct_reclaims; /* Direct reclaim passes on node */
+
 #ifdef CONFIG_COMPACTION
 	int kcompactd_max_order;
 	enum zone_type kcompactd_highest_zoneidx;
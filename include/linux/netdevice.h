@@ -367,6 +367,7 @@ struct gro_node {
 struct napi_config {
 	u64 gro_flush_timeout;
 	u64 irq_suspend_timeout;
+	u64 threaded_busy_poll_timeout;
 	u32 defer_hard_irqs;
 	cpumask_t affinity_mask;
 	unsigned int napi_id;
@@ -402,6 +403,7 @@ struct napi_struct {
 	struct task_struct	*thread;
 	unsigned long		gro_flush_timeout;
 	unsigned long		irq_suspend_timeout;
+	unsigned long		threaded_busy_poll_timeout;
 	u32			defer_hard_irqs;
 	/* control-path-only fields follow */
 	u32			napi_id;
@@ -1999,7 +2001,7 @@ enum netdev_reg_state {
  *			for hardware timestamping
  *	@sfp_bus:	attached &struct sfp_bus structure.
  *
- *	@qdisc_tx_busylock: lockdep class annotating Qdisc->busylock spinlock
+ *	@qdisc_tx_busylock: lockdep class annotating Qdisc->seqlock spinlock
  *
  *	@proto_down:	protocol port state information can be sent to the
  *			switch driver and used to set the phys state of the
@@ -126,6 +126,7 @@ struct nfs_open_dir_context {
 	__u64 last_cookie;
 	pgoff_t page_index;
 	unsigned int dtsize;
+	atomic_t prefetch_active;
 	bool force_clear;
 	bool eof;
 	struct rcu_head rcu_head;
@@ -344,5 +344,6 @@ struct pipe_inode_info *get_pipe_info(struct file *file, bool for_splice);
 
 int create_pipe_files(struct file **, int);
 unsigned int round_pipe_size(unsigned int size);
+unsigned int pipe_folio_order(void);
 
 #endif
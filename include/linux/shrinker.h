@@ -115,6 +115,11 @@ struct shrinker {
 #endif
 	/* objs pending delete, per node */
 	atomic_long_t *nr_deferred;
+	/* reclaim cost accounting, see do_shrink_slab() */
+	atomic_long_t nr_freed;
+	atomic64_t scan_time_ns;
+	unsigned long yield;	/* decayed objects freed per msec */
+	unsigned long yield_stamp;	/* jiffies of the last yield sample */
 };
 #define DEFAULT_SEEKS 2 /* A good number if you don't know better. */
 
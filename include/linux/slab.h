@@ -332,6 +332,20 @@ struct kmem_cache_args {
 	 * %NULL means no constructor.
 	 */
 	void (*ctor)(void *);
+	/**
+	 * @sheaf_capacity: Enable sheaves of given capacity for the cache.
+	 *
+	 * With a non-zero value, allocations and frees are served from
+	 * per-cpu arrays ("sheaves") of up to this many objects, which are
+	 * refilled and flushed in bulk. This helps caches with high
+	 * allocation rates and frees coming from other cpus, at the cost of
+	 * extra objects cached per cpu. Sheaves are not used for
+	 * allocations with a specific node requested, nor when the cache is
+	 * being debugged.
+	 *
+	 * %0 means no sheaves will be created.
+	 */
+	unsigned int sheaf_capacity;
 };
 
 struct kmem_cache *__kmem_cache_create_args(const char *name,
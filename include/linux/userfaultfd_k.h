@@ -130,6 +130,10 @@ extern ssize_t mfill_atomic_continue(struct userfaultfd_ctx *ctx, unsigned long
 				     unsigned long len, uffd_flags_t flags);
 extern ssize_t mfill_atomic_poison(struct userfaultfd_ctx *ctx, unsigned long start,
 				   unsigned long len, uffd_flags_t flags);
+extern ssize_t mfill_atomic_vec(struct userfaultfd_ctx *ctx,
+				const struct uffdio_iovec *iov, unsigned int nr,
+				uffd_flags_t flags, __u64 *nr_done,
+				__s64 *mapped);
 extern int mwriteprotect_range(struct userfaultfd_ctx *ctx, unsigned long start,
 			       unsigned long len, bool enable_wp);
 extern long uffd_wp_range(struct vm_area_struct *vma,
@@ -70,6 +70,11 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		THP_MIGRATION_SUCCESS,
 		THP_MIGRATION_FAIL,
 		THP_MIGRATION_SPLIT,
+		PGMIGRATE_COPY_CPU,
+		PGMIGRATE_COPY_MT,
+#ifdef CONFIG_NUMA
+		PGPROMOTE_SAMPLED_SUCCESS,
+#endif
 #endif
 #ifdef CONFIG_COMPACTION
 		COMPACTMIGRATE_SCANNED, COMPACTFREE_SCANNED,
@@ -131,6 +136,12 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		NR_TLB_LOCAL_FLUSH_ALL,
 		NR_TLB_LOCAL_FLUSH_ONE,
 #endif /* CONFIG_DEBUG_TLBFLUSH */
+		RA_STREAM_HIT,
+		RA_STREAM_MISS,
+		RA_STREAM_WASTED,
+		FAULT_AROUND_GROW,
+		FAULT_AROUND_SHRINK,
+		FAULT_AROUND_UNUSED,
 #ifdef CONFIG_SWAP
 		SWAP_RA,
 		SWAP_RA_HIT,
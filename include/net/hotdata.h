@@ -31,6 +31,7 @@ struct net_hotdata {
 	u32			rps_cpu_mask;
 #endif
 	int			gro_normal_batch;
+	int			gro_flow_limit;
 	int			netdev_budget;
 	int			netdev_budget_usecs;
 	int			tstamp_prequeue;
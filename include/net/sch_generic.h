@@ -123,7 +123,10 @@ struct Qdisc {
 	struct Qdisc            *next_sched;
 	struct sk_buff_head	skb_bad_txq;
 
-	spinlock_t		busylock ____cacheline_aligned_in_smp;
+	/* Producers of locked qdiscs stage skbs here, see __dev_xmit_skb() */
+	struct llist_head	defer_list ____cacheline_aligned_in_smp;
+	atomic_long_t		defer_count;
+
 	spinlock_t		seqlock;
 
 	struct rcu_head		rcu;
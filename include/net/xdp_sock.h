@@ -45,6 +45,8 @@ struct xsk_map {
 	struct xdp_sock __rcu *xsk_map[];
 };
 
+#define XSK_RX_CACHE_SIZE 64
+
 struct xdp_sock {
 	/* struct sock must be the first member of struct xdp_sock */
 	struct sock sk;
@@ -74,6 +76,12 @@ struct xdp_sock {
 	/* Protects generic receive. */
 	spinlock_t rx_lock;
 
+	/* Buffers allocated in bulk for copy mode receive from XDP_REDIRECT,
+	 * handed back to the pool on xsk_flush() at the end of the poll.
+	 */
+	struct xdp_buff *rx_cache[XSK_RX_CACHE_SIZE];
+	u32 rx_cache_cnt;
+
 	/* Statistics */
 	u64 rx_dropped;
 	u64 rx_queue_full;
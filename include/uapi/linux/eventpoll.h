@@ -98,4 +98,10 @@ struct epoll_params {
 #define EPIOCSPARAMS _IOW(EPOLL_IOC_TYPE, 0x01, struct epoll_params)
 #define EPIOCGPARAMS _IOR(EPOLL_IOC_TYPE, 0x02, struct epoll_params)
 
+/*
+ * Queue ready events on per-CPU lists rather than on a single shared one.
+ * Only allowed before the first file is added, and cannot be undone.
+ */
+#define EPIOCSPERCPU _IO(EPOLL_IOC_TYPE, 0x03)
+
 #endif /* _UAPI_LINUX_EVENTPOLL_H */
@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: GPL-2.0 WITH Linux-syscall-note */
+#ifndef _UAPI_LINUX_PIDSTATS_H
+#define _UAPI_LINUX_PIDSTATS_H
+
+#include <linux/types.h>
+
+/*
+ * Binary per-process statistics, read from /proc/pidstats.
+ *
+ * Writing a __u64 mask of PIDSTATS_* groups to the file selects what gets
+ * filled; reading from offset 0 then returns one struct pidstats_record
+ * for each thread group visible in the pid namespace of the proc mount
+ * that the reader may ptrace-read, in ascending tgid order.  Without a
+ * write, PIDSTATS_STAT | PIDSTATS_STATUS is filled.
+ *
+ * Records only ever grow: new fields are appended and ->size tells how
+ * large the records returned by the running kernel are.  ->mask has the
+ * groups that actually got filled, fields of other groups are zero.
+ */
+#define PIDSTATS_STAT		(1ULL << 0)	/* scheduling, faults, times */
+#define PIDSTATS_STATUS		(1ULL << 1)	/* credentials, memory counters */
+#define PIDSTATS_ROLLUP		(1ULL << 2)	/* smaps_rollup, walks page tables */
+
+struct pidstats_record {
+	__u32 size;
+	__u32 tgid;
+	__u64 mask;
+
+	/* PIDSTATS_STAT, as in /proc/<pid>/stat with times in ns */
+	__u32 ppid;
+	__u32 pgrp;
+	__u32 session;
+	__u32 tty_nr;
+	__u32 flags;
+	__u32 num_threads;
+	__s32 priority;
+	__s32 nice;
+	__u32 processor;
+	__u32 state;		/* state letter of /proc/<pid>/stat, e.g. 'R' */
+	__u64 minflt;
+	__u64 majflt;
+	__u64 utime;
+	__u64 stime;
+	__u64 start_time;
+	__u64 vsize;
+	__u64 rss;
+	__u64 nvcsw;
+	__u64 nivcsw;
+
+	/* PIDSTATS_STATUS, as in /proc/<pid>/status with sizes in bytes */
+	__u32 ruid;
+	__u32 euid;
+	__u32 rgid;
+	__u32 egid;
+	__u64 vm_peak;
+	__u64 vm_size;
+	__u64 vm_lck;
+	__u64 vm_pin;
+	__u64 vm_hwm;
+	__u64 vm_rss;
+	__u64 rss_anon;
+	__u64 rss_file;
+	__u64 rss_shmem;
+	__u64 vm_data;
+	__u64 vm_stk;
+	__u64 vm_exe;
+	__u64 vm_lib;
+	__u64 vm_pte;
+	__u64 vm_swap;
+
+	/* PIDSTATS_ROLLUP, as in /proc/<pid>/smaps_rollup in bytes */
+	__u64 pss;
+	__u64 pss_dirty;
+	__u64 pss_anon;
+	__u64 pss_file;
+	__u64 pss_shmem;
+	__u64 shared_clean;
+	__u64 shared_dirty;
+	__u64 private_clean;
+	__u64 private_dirty;
+	__u64 referenced;
+	__u64 anonymous;
+	__u64 lazyfree;
+	__u64 anon_huge;
+	__u64 swap;
+	__u64 swap_pss;
+	__u64 locked;
+};
+
+#endif /* _UAPI_LINUX_PIDSTATS_H */
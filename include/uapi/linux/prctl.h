@@ -364,4 +364,17 @@ struct prctl_mm_map {
 # define PR_TIMER_CREATE_RESTORE_IDS_ON		1
 # define PR_TIMER_CREATE_RESTORE_IDS_GET	2
 
+/* Defer and coalesce the TLB shootdowns of munmap() and madvise() */
+#define PR_SET_DEFERRED_TLB_FLUSH		78
+#define PR_GET_DEFERRED_TLB_FLUSH		79
+
+/*
+ * Allocate file descriptors from per-CPU reserved batches of arg2 (at most
+ * 64, 0 to disable) instead of always the lowest available one.  Reserved
+ * descriptors show up as busy to dup2().  Applies to the whole file table,
+ * is not inherited and is reset on execve().
+ */
+#define PR_SET_FD_RESERVE			80
+#define PR_GET_FD_RESERVE			81
+
 #endif /* _LINUX_PRCTL_H */
@@ -367,6 +367,8 @@ enum
 	LINUX_MIB_TLSTXREKEYOK,			/* TlsTxRekeyOk */
 	LINUX_MIB_TLSTXREKEYERROR,		/* TlsTxRekeyError */
 	LINUX_MIB_TLSRXREKEYRECEIVED,		/* TlsRxRekeyReceived */
+	LINUX_MIB_TLSTXASYNCENCRYPT,		/* TlsTxAsyncEncrypt */
+	LINUX_MIB_TLSRXSTRPCOPY,		/* TlsRxStrpCopy */
 	__LINUX_MIB_TLSMAX
 };
 
@@ -80,6 +80,23 @@ struct user_unreg {
 	__u64	disable_addr;
 } __attribute__((__packed__));
 
+/*
+ * Describes a batch of events to write with one call. This structure is
+ * passed to the DIAG_IOCSBATCH ioctl. The events buffer holds count records
+ * back to back, each a __u32 length followed by that many bytes laid out
+ * as for write(): the write_index, then the event payload.
+ */
+struct user_batch {
+	/* Input: Size of the user_batch structure being used */
+	__u32	size;
+
+	/* Input: Number of records in the events buffer */
+	__u32	count;
+
+	/* Input: Address of the events buffer */
+	__u64	events;
+} __attribute__((__packed__));
+
 #define DIAG_IOC_MAGIC '*'
 
 /* Request to register a user_event */
@@ -91,4 +108,7 @@ struct user_unreg {
 /* Requests to unregister a user_event */
 #define DIAG_IOCSUNREG _IOW(DIAG_IOC_MAGIC, 2, struct user_unreg*)
 
+/* Requests to write a batch of user_events */
+#define DIAG_IOCSBATCH _IOW(DIAG_IOC_MAGIC, 3, struct user_batch*)
+
 #endif /* _UAPI_LINUX_USER_EVENTS_H */
@@ -12,32 +12,62 @@
 #define BLOOM_CREATE_FLAG_MASK \
 	(BPF_F_NUMA_NODE | BPF_F_ZERO_SEED | BPF_F_ACCESS_MASK)
 
+#define BLOOM_BLOCK_BITS	(L1_CACHE_BYTES * BITS_PER_BYTE)
+
 struct bpf_bloom_filter {
 	struct bpf_map map;
 	u32 bitset_mask;
 	u32 hash_seed;
 	u32 nr_hash_funcs;
-	unsigned long bitset[];
+	bool blocked;
+	unsigned long bitset[] ____cacheline_aligned;
 };
 
+static u32 __hash(struct bpf_bloom_filter *bloom, void *value,
+		  u32 value_size, u32 index)
+{
+	if (likely(value_size % 4 == 0))
+		return jhash2(value, value_size / 4, bloom->hash_seed + index);
+
+	return jhash(value, value_size, bloom->hash_seed + index);
+}
+
 static u32 hash(struct bpf_bloom_filter *bloom, void *value,
 		u32 value_size, u32 index)
 {
-	u32 h;
+	return __hash(bloom, value, value_size, index) & bloom->bitset_mask;
+}
 
-	if (likely(value_size % 4 == 0))
-		h = jhash2(value, value_size / 4, bloom->hash_seed + index);
-	else
-		h = jhash(value, value_size, bloom->hash_seed + index);
+/* In the blocked layout a first hash picks the cache line of the bit
+ * array and a second one the start and odd stride of the probes within
+ * it, so each value costs two hashes and a single cache miss no matter
+ * how many hash functions are configured.
+ */
+static u32 bloom_block(struct bpf_bloom_filter *bloom, void *value,
+		       u32 value_size, u32 *pos, u32 *step)
+{
+	u32 h = __hash(bloom, value, value_size, 1);
 
-	return h & bloom->bitset_mask;
+	*pos = h;
+	*step = (h >> 16) | 1;
+	return hash(bloom, value, value_size, 0) & ~(BLOOM_BLOCK_BITS - 1);
 }
 
 static long bloom_map_peek_elem(struct bpf_map *map, void *value)
 {
 	struct bpf_bloom_filter *bloom =
 		container_of(map, struct bpf_bloom_filter, map);
-	u32 i, h;
+	u32 i, h, pos, step;
+
+	if (bloom->blocked) {
+		h = bloom_block(bloom, value, map->value_size, &pos, &step);
+		for (i = 0; i < bloom->nr_hash_funcs; i++, pos += step) {
+			if (!test_bit(h + (pos & (BLOOM_BLOCK_BITS - 1)),
+				      bloom->bitset))
+				return -ENOENT;
+		}
+		return 0;
+	}
 
 	for (i = 0; i < bloom->nr_hash_funcs; i++) {
 		h = hash(bloom, value, map->value_size, i);
@@ -52,11 +82,19 @@ static long bloom_map_push_elem(struct bpf_map *map, void *value, u64 flags)
 {
 	struct bpf_bloom_filter *bloom =
 		container_of(map, struct bpf_bloom_filter, map);
-	u32 i, h;
+	u32 i, h, pos, step;
 
 	if (flags != BPF_ANY)
 		return -EINVAL;
 
+	if (bloom->blocked) {
+		h = bloom_block(bloom, value, map->value_size, &pos, &step);
+		for (i = 0; i < bloom->nr_hash_funcs; i++, pos += step)
+			set_bit(h + (pos & (BLOOM_BLOCK_BITS - 1)),
+				bloom->bitset);
+		return 0;
+	}
+
 	for (i = 0; i < bloom->nr_hash_funcs; i++) {
 		h = hash(bloom, value, map->value_size, i);
 		set_bit(h, bloom->bitset);
@@ -97,6 +135,7 @@ static struct bpf_map *bloom_map_alloc(union bpf_attr *attr)
 	u32 bitset_bytes, bitset_mask, nr_hash_funcs, nr_bits;
 	int numa_node = bpf_map_attr_numa_node(attr);
 	struct bpf_bloom_filter *bloom;
+	bool blocked;
 
 	if (attr->key_size != 0 || attr->value_size == 0 ||
 	    attr->max_entries == 0 ||
@@ -105,10 +144,11 @@ static struct bpf_map *bloom_map_alloc(union bpf_attr *attr)
 	    /* The lower 4 bits of map_extra (0xF) specify the number
 	     * of hash functions
 	     */
-	    (attr->map_extra & ~0xF))
+	    (attr->map_extra & ~(0xF | BPF_F_BLOOM_BLOCKED)))
 		return ERR_PTR(-EINVAL);
 
-	nr_hash_funcs = attr->map_extra;
+	nr_hash_funcs = attr->map_extra & 0xF;
+	blocked = attr->map_extra & BPF_F_BLOOM_BLOCKED;
 	if (nr_hash_funcs == 0)
 		/* Default to using 5 hash functions if unspecified */
 		nr_hash_funcs = 5;
@@ -134,7 +174,9 @@ static struct bpf_map *bloom_map_alloc(union bpf_attr *attr)
 		bitset_bytes = BITS_TO_BYTES(U32_MAX);
 		bitset_mask = U32_MAX;
 	} else {
-		if (nr_bits <= BITS_PER_LONG)
+		if (blocked && nr_bits <= BLOOM_BLOCK_BITS)
+			nr_bits = BLOOM_BLOCK_BITS;
+		else if (nr_bits <= BITS_PER_LONG)
 			nr_bits = BITS_PER_LONG;
 		else
 			nr_bits = roundup_pow_of_two(nr_bits);
@@ -152,6 +194,7 @@ static struct bpf_map *bloom_map_alloc(union bpf_attr *attr)
 
 	bloom->nr_hash_funcs = nr_hash_funcs;
 	bloom->bitset_mask = bitset_mask;
+	bloom->blocked = blocked;
 
 	if (!(attr->map_flags & BPF_F_ZERO_SEED))
 		bloom->hash_seed = get_random_u32();
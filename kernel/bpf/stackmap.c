@@ -130,6 +130,12 @@ static int fetch_build_id(struct vm_area_struct *vma, unsigned char *build_id, b
 			 : build_id_parse_nofault(vma, build_id, NULL);
 }
 
+/* Number of recently resolved VMAs remembered while walking one stack, so
+ * that frames bouncing between a few objects (the binary, libc, ...) read
+ * each build ID only once.
+ */
+#define BUILD_ID_VMA_CACHE	4
+
 /*
  * Expects all id_offs[i].ip values to be set to correct initial IPs.
  * They will be subsequently:
@@ -143,11 +149,14 @@ static int fetch_build_id(struct vm_area_struct *vma, unsigned char *build_id, b
 static void stack_map_get_build_id_offset(struct bpf_stack_build_id *id_offs,
 					  u32 trace_nr, bool user, bool may_fault)
 {
-	int i;
+	int i, j, next = 0;
 	struct mmap_unlock_irq_work *work = NULL;
 	bool irq_work_busy = bpf_mmap_unlock_get_irq_work(&work);
-	struct vm_area_struct *vma, *prev_vma = NULL;
-	const char *prev_build_id;
+	struct {
+		struct vm_area_struct *vma;
+		const char *build_id;
+	} cache[BUILD_ID_VMA_CACHE] = {};
+	struct vm_area_struct *vma;
 
 	/* If the irq_work is in use, fall back to report ips. Same
 	 * fallback is used for kernel stack (!user) on a stackmap with
@@ -166,10 +175,13 @@ static void stack_map_get_build_id_offset(struct bpf_stack_build_id *id_offs,
 	for (i = 0; i < trace_nr; i++) {
 		u64 ip = READ_ONCE(id_offs[i].ip);
 
-		if (range_in_vma(prev_vma, ip, ip)) {
-			vma = prev_vma;
-			memcpy(id_offs[i].build_id, prev_build_id, BUILD_ID_SIZE_MAX);
-			goto build_id_valid;
+		for (j = 0; j < BUILD_ID_VMA_CACHE; j++) {
+			if (range_in_vma(cache[j].vma, ip, ip)) {
+				vma = cache[j].vma;
+				memcpy(id_offs[i].build_id, cache[j].build_id,
+				       BUILD_ID_SIZE_MAX);
+				goto build_id_valid;
+			}
 		}
 		vma = find_vma(current->mm, ip);
 		if (!vma || fetch_build_id(vma, id_offs[i].build_id, may_fault)) {
@@ -181,8 +193,11 @@ static void stack_map_get_build_id_offset(struct bpf_stack_build_id *id_offs,
 build_id_valid:
 		id_offs[i].offset = (vma->vm_pgoff << PAGE_SHIFT) + ip - vma->vm_start;
 		id_offs[i].status = BPF_STACK_BUILD_ID_VALID;
-		prev_vma = vma;
-		prev_build_id = id_offs[i].build_id;
+		if (j == BUILD_ID_VMA_CACHE) {
+			cache[next].vma = vma;
+			cache[next].build_id = id_offs[i].build_id;
+			next = (next + 1) % BUILD_ID_VMA_CACHE;
+		}
 	}
 	bpf_mmap_unlock_mm(work, current->mm);
 }
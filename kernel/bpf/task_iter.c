@@ -22,6 +22,8 @@ struct bpf_iter_seq_task_common {
 	enum bpf_iter_task_type	type;
 	u32 pid;
 	u32 pid_visiting;
+	u32 tid_min;
+	u32 tid_max;
 };
 
 struct bpf_iter_seq_task_info {
@@ -115,10 +117,16 @@ static struct task_struct *task_seq_get_next(struct bpf_iter_seq_task_common *co
 	}
 
 	rcu_read_lock();
+	if (*tid < common->tid_min)
+		*tid = common->tid_min;
 retry:
 	pid = find_ge_pid(*tid, common->ns);
 	if (pid) {
 		*tid = pid_nr_ns(pid, common->ns);
+		if (common->tid_max && *tid > common->tid_max) {
+			rcu_read_unlock();
+			return NULL;
+		}
 		task = get_pid_task(pid, PIDTYPE_PID);
 		if (!task) {
 			++*tid;
@@ -213,6 +221,15 @@ static int bpf_iter_attach_task(struct bpf_prog *prog,
 	if ((!!linfo->task.tid + !!linfo->task.pid + !!linfo->task.pid_fd) > 1)
 		return -EINVAL;
 
+	if (linfo->task.tid_min || linfo->task.tid_max) {
+		if (linfo->task.tid || linfo->task.pid || linfo->task.pid_fd)
+			return -EINVAL;
+		if (linfo->task.tid_max && linfo->task.tid_max < linfo->task.tid_min)
+			return -EINVAL;
+		aux->task.tid_min = linfo->task.tid_min;
+		aux->task.tid_max = linfo->task.tid_max;
+	}
+
 	aux->task.type = BPF_TASK_ITER_ALL;
 	if (linfo->task.tid != 0) {
 		aux->task.type = BPF_TASK_ITER_TID;
@@ -385,6 +402,8 @@ static int init_seq_pidns(void *priv_data, struct bpf_iter_aux_info *aux)
 	common->ns = get_pid_ns(task_active_pid_ns(current));
 	common->type = aux->task.type;
 	common->pid = aux->task.pid;
+	common->tid_min = aux->task.tid_min;
+	common->tid_max = aux->task.tid_max;
 
 	return 0;
 }
@@ -674,6 +693,8 @@ static int bpf_iter_fill_link_info(const struct bpf_iter_aux_info *aux, struct b
 		info->iter.task.pid = aux->task.pid;
 		break;
 	default:
+		info->iter.task.tid_min = aux->task.tid_min;
+		info->iter.task.tid_max = aux->task.tid_max;
 		break;
 	}
 	return 0;
@@ -686,6 +707,9 @@ static void bpf_iter_task_show_fdinfo(const struct bpf_iter_aux_info *aux, struc
 		seq_printf(seq, "tid:\t%u\n", aux->task.pid);
 	else if (aux->task.type == BPF_TASK_ITER_TGID)
 		seq_printf(seq, "pid:\t%u\n", aux->task.pid);
+	else if (aux->task.tid_min || aux->task.tid_max)
+		seq_printf(seq, "tid_range:\t%u-%u\n", aux->task.tid_min,
+			   aux->task.tid_max);
 }
 
 static struct bpf_iter_reg task_reg_info = {
@@ -22814,6 +22814,8 @@ static int do_check_subprogs(struct bpf_verifier_env *env)
 	struct bpf_prog_aux *aux = env->prog->aux;
 	struct bpf_func_info_aux *sub_aux;
 	int i, ret, new_cnt;
+	u32 insn_processed;
+	u64 start_time;
 
 	if (!aux->func_info)
 		return 0;
@@ -22834,6 +22836,8 @@ static int do_check_subprogs(struct bpf_verifier_env *env)
 
 		env->insn_idx = env->subprog_info[i].start;
 		WARN_ON_ONCE(env->insn_idx == 0);
+		insn_processed = env->insn_processed;
+		start_time = ktime_get_ns();
 		ret = do_check_common(env, i);
 		if (ret) {
 			return ret;
@@ -22841,6 +22845,11 @@ static int do_check_subprogs(struct bpf_verifier_env *env)
 			verbose(env, "Func#%d ('%s') is safe for any args that match its prototype\n",
 				i, subprog_name(env, i));
 		}
+		if (env->log.level & BPF_LOG_STATS)
+			verbose(env, "Func#%d ('%s') verification time %lld usec, processed %u insns\n",
+				i, subprog_name(env, i),
+				div_u64(ktime_get_ns() - start_time, 1000),
+				env->insn_processed - insn_processed);
 
 		/* We verified new global subprog, it might have called some
 		 * more global subprogs that we haven't verified yet, so we
@@ -39,6 +39,7 @@
 #include <linux/ptrace.h>
 #include <linux/fs_struct.h>
 #include <linux/file.h>
+#include <linux/fdtable.h>
 #include <linux/mount.h>
 #include <linux/gfp.h>
 #include <linux/syscore_ops.h>
@@ -2820,6 +2821,26 @@ SYSCALL_DEFINE5(prctl, int, option, unsigned long, arg2, unsigned long, arg3,
 			return -EINVAL;
 		error = posixtimer_create_prctl(arg2);
 		break;
+	case PR_SET_DEFERRED_TLB_FLUSH:
+		if (arg3 || arg4 || arg5)
+			return -EINVAL;
+		error = tlb_defer_set(me->mm, !!arg2);
+		break;
+	case PR_GET_DEFERRED_TLB_FLUSH:
+		if (arg2 || arg3 || arg4 || arg5)
+			return -EINVAL;
+		error = tlb_defer_get(me->mm);
+		break;
+	case PR_SET_FD_RESERVE:
+		if (arg3 || arg4 || arg5)
+			return -EINVAL;
+		error = files_set_fd_reserve(arg2);
+		break;
+	case PR_GET_FD_RESERVE:
+		if (arg2 || arg3 || arg4 || arg5)
+			return -EINVAL;
+		error = files_get_fd_reserve();
+		break;
 	default:
 		trace_task_prctl_unknown(option, arg2, arg3, arg4, arg5);
 		error = -EINVAL;
@@ -17,7 +17,11 @@
 
 #include "trace.h"
 
-#define FPROBE_IP_HASH_BITS 8
+/*
+ * Sized for fprobes spanning thousands of functions, such as kprobe_multi
+ * links, as every traced call walks the bucket of its address.
+ */
+#define FPROBE_IP_HASH_BITS 12
 #define FPROBE_IP_TABLE_SIZE (1 << FPROBE_IP_HASH_BITS)
 
 #define FPROBE_HASH_BITS 6
@@ -2672,6 +2672,79 @@ static long user_events_ioctl_unreg(unsigned long uarg)
 	return ret;
 }
 
+static long user_batch_get(struct user_batch __user *ubatch,
+			   struct user_batch *kbatch)
+{
+	u32 size;
+	long ret;
+
+	ret = get_user(size, &ubatch->size);
+
+	if (ret)
+		return ret;
+
+	if (size > PAGE_SIZE)
+		return -E2BIG;
+
+	if (size < offsetofend(struct user_batch, events))
+		return -EINVAL;
+
+	return copy_struct_from_user(kbatch, sizeof(*kbatch), ubatch, size);
+}
+
+/*
+ * Writes several framed events with one call. Records of events that are
+ * not enabled are skipped, the batch stops at the first other error.
+ * Returns the number of records consumed.
+ */
+static long user_events_ioctl_batch(struct file *file, unsigned long uarg)
+{
+	struct user_batch __user *ubatch = (struct user_batch __user *)uarg;
+	struct user_batch batch;
+	char __user *ptr;
+	struct iov_iter i;
+	u32 n, len;
+	long ret;
+
+	/* Same rule as write() on the file */
+	if (!(file->f_mode & FMODE_WRITE))
+		return -EBADF;
+
+	ret = user_batch_get(ubatch, &batch);
+
+	if (ret)
+		return ret;
+
+	if (batch.count > UIO_MAXIOV)
+		return -E2BIG;
+
+	ptr = u64_to_user_ptr(batch.events);
+
+	for (n = 0; n < batch.count; n++) {
+		if (get_user(len, (u32 __user *)ptr)) {
+			ret = -EFAULT;
+			break;
+		}
+
+		ptr += sizeof(len);
+
+		if (unlikely(import_ubuf(ITER_SOURCE, ptr, len, &i))) {
+			ret = -EFAULT;
+			break;
+		}
+
+		ret = user_events_write_core(file, &i);
+
+		if (ret < 0 && ret != -EBADF)
+			break;
+
+		ptr += len;
+		cond_resched();
+	}
+
+	return n ? n : ret;
+}
+
 /*
  * Handles the ioctl from user mode to register or alter operations.
  */
@@ -2700,6 +2773,10 @@ static long user_events_ioctl(struct file *file, unsigned int cmd,
 		ret = user_events_ioctl_unreg(uarg);
 		mutex_unlock(&group->reg_mutex);
 		break;
+
+	case DIAG_IOCSBATCH:
+		ret = user_events_ioctl_batch(file, uarg);
+		break;
 	}
 
 	return ret;
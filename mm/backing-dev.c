@@ -34,6 +34,8 @@ LIST_HEAD(bdi_list);
 
 /* bdi_wq serves all asynchronous writeback tasks */
 struct workqueue_struct *bdi_wq;
+/* helpers that wb_writeback() waits on from inside bdi_wq, see there */
+struct workqueue_struct *bdi_helper_wq;
 
 #ifdef CONFIG_DEBUG_FS
 #include <linux/debugfs.h>
@@ -456,6 +458,25 @@ static ssize_t strict_limit_show(struct device *dev,
 }
 static DEVICE_ATTR_RW(strict_limit);
 
+static ssize_t writeback_workers_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t count)
+{
+	struct backing_dev_info *bdi = dev_get_drvdata(dev);
+	unsigned int workers;
+	ssize_t ret;
+
+	ret = kstrtouint(buf, 10, &workers);
+	if (ret < 0)
+		return ret;
+	if (!workers || workers > BDI_MAX_WB_WORKERS)
+		return -EINVAL;
+
+	WRITE_ONCE(bdi->wb_workers, workers);
+
+	return count;
+}
+BDI_SHOW(writeback_workers, READ_ONCE(bdi->wb_workers))
+
 static struct attribute *bdi_dev_attrs[] = {
 	&dev_attr_read_ahead_kb.attr,
 	&dev_attr_min_ratio.attr,
@@ -466,6 +487,7 @@ static struct attribute *bdi_dev_attrs[] = {
 	&dev_attr_max_bytes.attr,
 	&dev_attr_stable_pages_required.attr,
 	&dev_attr_strict_limit.attr,
+	&dev_attr_writeback_workers.attr,
 	NULL,
 };
 ATTRIBUTE_GROUPS(bdi_dev);
@@ -495,6 +517,10 @@ static int __init default_bdi_init(void)
 				 WQ_SYSFS, 0);
 	if (!bdi_wq)
 		return -ENOMEM;
+	bdi_helper_wq = alloc_workqueue("writeback_helper", WQ_MEM_RECLAIM |
+					WQ_UNBOUND, 0);
+	if (!bdi_helper_wq)
+		return -ENOMEM;
 	return 0;
 }
 subsys_initcall(default_bdi_init);
@@ -1006,6 +1032,7 @@ int bdi_init(struct backing_dev_info *bdi)
 	bdi->min_ratio = 0;
 	bdi->max_ratio = 100 * BDI_RATIO_SCALE;
 	bdi->max_prop_frac = FPROP_FRAC_BASE;
+	bdi->wb_workers = 1;
 	INIT_LIST_HEAD(&bdi->bdi_list);
 	INIT_LIST_HEAD(&bdi->wb_list);
 	init_waitqueue_head(&bdi->wb_waitq);
@@ -524,7 +524,32 @@ static unsigned long damon_pa_stat(struct damon_region *r, struct damos *s,
 	return 0;
 }
 
-static unsigned long damon_pa_apply_scheme(struct damon_ctx *ctx,
+static unsigned long damon_pa_promote_hint(struct damon_region *r,
+		struct damos *s, unsigned long *sz_filter_passed)
+{
+	unsigned long addr, applied = 0;
+
+	addr = r->ar.start;
+	while (addr < r->ar.end) {
+		struct folio *folio = damon_get_folio(PHYS_PFN(addr));
+
+		if (!folio) {
+			addr += PAGE_SIZE;
+			continue;
+		}
+
+		if (!damos_pa_filter_out(s, folio)) {
+			*sz_filter_passed += folio_size(folio);
+			memtier_record_access(folio_pfn(folio), r->nr_accesses);
+			applied += folio_size(folio);
+		}
+		addr += folio_size(folio);
+		folio_put(folio);
+	}
+	return applied;
+}
+
+unsigned long damon_pa_apply_scheme(struct damon_ctx *ctx,
 		struct damon_target *t, struct damon_region *r,
 		struct damos *scheme, unsigned long *sz_filter_passed)
 {
@@ -538,6 +563,8 @@ static unsigned long damon_pa_apply_scheme(struct damon_ctx *ctx,
 	case DAMOS_MIGRATE_HOT:
 	case DAMOS_MIGRATE_COLD:
 		return damon_pa_migrate(r, scheme, sz_filter_passed);
+	case DAMOS_PROMOTE_HINT:
+		return damon_pa_promote_hint(r, scheme, sz_filter_passed);
 	case DAMOS_STAT:
 		return damon_pa_stat(r, scheme, sz_filter_passed);
 	default:
@@ -547,7 +574,7 @@ static unsigned long damon_pa_apply_scheme(struct damon_ctx *ctx,
 	return 0;
 }
 
-static int damon_pa_scheme_score(struct damon_ctx *context,
+int damon_pa_scheme_score(struct damon_ctx *context,
 		struct damon_target *t, struct damon_region *r,
 		struct damos *scheme)
 {
@@ -559,6 +586,7 @@ static int damon_pa_scheme_score(struct damon_ctx *context,
 	case DAMOS_LRU_DEPRIO:
 		return damon_cold_score(context, r, scheme);
 	case DAMOS_MIGRATE_HOT:
+	case DAMOS_PROMOTE_HINT:
 		return damon_hot_score(context, r, scheme);
 	case DAMOS_MIGRATE_COLD:
 		return damon_cold_score(context, r, scheme);
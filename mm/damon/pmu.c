@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * DAMON Primitives for The Physical Address Space, Based on PMU Samples
+ *
+ * Rather than clearing and re-reading accessed bits of each region's sampling
+ * address, attribute the data addresses of precise PMU load samples (e.g.
+ * Intel PEBS, AMD IBS, Arm SPE) to the regions they fall in.  Applying
+ * schemes is shared with the 'paddr' operations set.
+ */
+
+#define pr_fmt(fmt) "damon-pmu: " fmt
+
+#include <linux/bsearch.h>
+#include <linux/cpu.h>
+#include <linux/mm.h>
+#include <linux/module.h>
+#include <linux/mutex.h>
+#include <linux/perf_event.h>
+#include <linux/slab.h>
+
+#include "ops-common.h"
+
+#ifdef MODULE_PARAM_PREFIX
+#undef MODULE_PARAM_PREFIX
+#endif
+#define MODULE_PARAM_PREFIX "damon_pmu."
+
+/*
+ * Type and config of the perf event to sample loads with.  It has to be
+ * able to report data addresses, e.g. the raw encoding of a
+ * MEM_LOAD_RETIRED event on Intel.  Changes take effect on the next start
+ * of a DAMON context using the operations set.
+ */
+static unsigned int event_type __read_mostly = PERF_TYPE_HARDWARE;
+module_param(event_type, uint, 0600);
+
+static unsigned long long event_config __read_mostly =
+	PERF_COUNT_HW_CACHE_MISSES;
+module_param(event_config, ullong, 0600);
+
+/* Take one sample every this many events. */
+static unsigned long long sample_period __read_mostly = 10007;
+module_param(sample_period, ullong, 0600);
+
+/* Skid constraint, see perf_event_open(2). */
+static unsigned int precise_ip __read_mostly = 2;
+module_param(precise_ip, uint, 0600);
+
+/* Must be a power of two */
+#define DAMON_PMU_NR_SAMPLES	1024
+
+/*
+ * Per-CPU ring of sampled physical addresses.  @head is only advanced by
+ * the overflow handler of the CPU, @tail only by kdamond.  When kdamond
+ * falls behind, the oldest samples are overwritten.
+ */
+struct damon_pmu_buf {
+	unsigned long addrs[DAMON_PMU_NR_SAMPLES];
+	unsigned int head;
+	unsigned int tail;
+};
+
+static DEFINE_MUTEX(damon_pmu_lock);
+static struct damon_ctx *damon_pmu_owner;
+static struct perf_event **damon_pmu_events;
+static struct damon_pmu_buf __percpu *damon_pmu_bufs;
+
+/* Scratch space of damon_pmu_check_accesses(), only used by the owner */
+static struct damon_region **damon_pmu_regions;
+static unsigned long *damon_pmu_hit;
+static unsigned int damon_pmu_nr_regions;
+
+static void damon_pmu_overflow(struct perf_event *event,
+		struct perf_sample_data *data, struct pt_regs *regs)
+{
+	struct damon_pmu_buf *buf = this_cpu_ptr(damon_pmu_bufs);
+	unsigned int head;
+
+	perf_prepare_sample(data, event, regs);
+	if (!(data->sample_flags & PERF_SAMPLE_PHYS_ADDR) || !data->phys_addr)
+		return;
+
+	head = buf->head;
+	buf->addrs[head & (DAMON_PMU_NR_SAMPLES - 1)] = data->phys_addr;
+	smp_store_release(&buf->head, head + 1);
+}
+
+static void damon_pmu_release_events(void)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		if (damon_pmu_events && damon_pmu_events[cpu])
+			perf_event_release_kernel(damon_pmu_events[cpu]);
+	}
+	kfree(damon_pmu_events);
+	damon_pmu_events = NULL;
+	free_percpu(damon_pmu_bufs);
+	damon_pmu_bufs = NULL;
+	kfree(damon_pmu_regions);
+	damon_pmu_regions = NULL;
+	bitmap_free(damon_pmu_hit);
+	damon_pmu_hit = NULL;
+	damon_pmu_nr_regions = 0;
+}
+
+static void damon_pmu_init(struct damon_ctx *ctx)
+{
+	struct perf_event_attr attr = {
+		.type = READ_ONCE(event_type),
+		.size = sizeof(attr),
+		.config = READ_ONCE(event_config),
+		.sample_period = READ_ONCE(sample_period),
+		.sample_type = PERF_SAMPLE_ADDR | PERF_SAMPLE_PHYS_ADDR,
+		.precise_ip = min(READ_ONCE(precise_ip), 3U),
+		.exclude_hv = 1,
+	};
+	struct perf_event *event;
+	int cpu, nr_events = 0;
+
+	mutex_lock(&damon_pmu_lock);
+	if (damon_pmu_owner) {
+		pr_warn("only one context can use the PMU samples at a time\n");
+		goto unlock;
+	}
+
+	damon_pmu_events = kcalloc(nr_cpu_ids, sizeof(*damon_pmu_events),
+				   GFP_KERNEL);
+	damon_pmu_bufs = alloc_percpu(struct damon_pmu_buf);
+	if (!damon_pmu_events || !damon_pmu_bufs)
+		goto fail;
+
+	cpus_read_lock();
+	for_each_online_cpu(cpu) {
+		event = perf_event_create_kernel_counter(&attr, cpu, NULL,
+				damon_pmu_overflow, NULL);
+		if (IS_ERR(event)) {
+			pr_warn_once("cannot create sampling event on cpu %d: %ld\n",
+				     cpu, PTR_ERR(event));
+			continue;
+		}
+		damon_pmu_events[cpu] = event;
+		nr_events++;
+	}
+	cpus_read_unlock();
+
+	if (!nr_events)
+		goto fail;
+
+	damon_pmu_owner = ctx;
+	goto unlock;
+fail:
+	damon_pmu_release_events();
+unlock:
+	mutex_unlock(&damon_pmu_lock);
+}
+
+static void damon_pmu_cleanup(struct damon_ctx *ctx)
+{
+	mutex_lock(&damon_pmu_lock);
+	if (damon_pmu_owner == ctx) {
+		damon_pmu_release_events();
+		damon_pmu_owner = NULL;
+	}
+	mutex_unlock(&damon_pmu_lock);
+}
+
+static int damon_pmu_region_cmp(const void *key, const void *elt)
+{
+	unsigned long addr = *(const unsigned long *)key;
+	const struct damon_region *r = *(struct damon_region * const *)elt;
+
+	if (addr < r->ar.start)
+		return -1;
+	if (addr >= r->ar.end)
+		return 1;
+	return 0;
+}
+
+static bool damon_pmu_prepare_regions(struct damon_target *t)
+{
+	unsigned int nr = damon_nr_regions(t), i = 0;
+	struct damon_region *r;
+
+	if (nr > damon_pmu_nr_regions) {
+		struct damon_region **regions;
+		unsigned long *hit;
+
+		regions = kmalloc_array(nr, sizeof(*regions), GFP_KERNEL);
+		hit = bitmap_alloc(nr, GFP_KERNEL);
+		if (!regions || !hit) {
+			kfree(regions);
+			bitmap_free(hit);
+			return false;
+		}
+		kfree(damon_pmu_regions);
+		bitmap_free(damon_pmu_hit);
+		damon_pmu_regions = regions;
+		damon_pmu_hit = hit;
+		damon_pmu_nr_regions = nr;
+	}
+
+	damon_for_each_region(r, t)
+		damon_pmu_regions[i++] = r;
+	bitmap_zero(damon_pmu_hit, nr);
+	return true;
+}
+
+/*
+ * Like 'paddr', this operations set supports a single target only.  A region
+ * is accessed in a sampling interval if any sample fell in it.
+ */
+static unsigned int damon_pmu_check_accesses(struct damon_ctx *ctx)
+{
+	struct damon_target *t;
+	struct damon_region *r, **found;
+	unsigned int max_nr_accesses = 0, nr, i;
+	int cpu;
+
+	if (damon_pmu_owner != ctx || list_empty(&ctx->adaptive_targets))
+		return 0;
+
+	t = list_first_entry(&ctx->adaptive_targets, struct damon_target, list);
+	if (!damon_pmu_prepare_regions(t))
+		return 0;
+	nr = damon_nr_regions(t);
+
+	for_each_possible_cpu(cpu) {
+		struct damon_pmu_buf *buf = per_cpu_ptr(damon_pmu_bufs, cpu);
+		unsigned int head = smp_load_acquire(&buf->head);
+		unsigned int tail = buf->tail;
+
+		if (head - tail > DAMON_PMU_NR_SAMPLES)
+			tail = head - DAMON_PMU_NR_SAMPLES;
+		for (; tail != head; tail++) {
+			unsigned long addr = READ_ONCE(buf->addrs[tail &
+						(DAMON_PMU_NR_SAMPLES - 1)]);
+
+			found = bsearch(&addr, damon_pmu_regions, nr,
+					sizeof(*damon_pmu_regions),
+					damon_pmu_region_cmp);
+			if (found)
+				__set_bit(found - damon_pmu_regions,
+					  damon_pmu_hit);
+		}
+		buf->tail = tail;
+	}
+
+	i = 0;
+	damon_for_each_region(r, t) {
+		damon_update_region_access_rate(r, test_bit(i++, damon_pmu_hit),
+						&ctx->attrs);
+		max_nr_accesses = max(r->nr_accesses, max_nr_accesses);
+	}
+
+	return max_nr_accesses;
+}
+
+static int __init damon_pmu_initcall(void)
+{
+	struct damon_operations ops = {
+		.id = DAMON_OPS_PADDR_PMU,
+		.init = damon_pmu_init,
+		.update = NULL,
+		.prepare_access_checks = NULL,
+		.check_accesses = damon_pmu_check_accesses,
+		.reset_aggregated = NULL,
+		.target_valid = NULL,
+		.cleanup = damon_pmu_cleanup,
+		.apply_scheme = damon_pa_apply_scheme,
+		.get_scheme_score = damon_pa_scheme_score,
+	};
+
+	return damon_register_ops(&ops);
+};
+
+subsys_initcall(damon_pmu_initcall);
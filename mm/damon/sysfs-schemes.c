@@ -1472,6 +1472,8 @@ static const char * const damon_sysfs_damos_action_strs[] = {
 	"lru_deprio",
 	"migrate_hot",
 	"migrate_cold",
+	"collapse_hint",
+	"promote_hint",
 	"stat",
 };
 
@@ -627,6 +627,7 @@ static const char * const damon_sysfs_ops_strs[] = {
 	"vaddr",
 	"fvaddr",
 	"paddr",
+	"paddr_pmu",
 };
 
 struct damon_sysfs_context {
@@ -1168,7 +1169,8 @@ static int damon_sysfs_add_targets(struct damon_ctx *ctx,
 	int i, err;
 
 	/* Multiple physical address space monitoring targets makes no sense */
-	if (ctx->ops.id == DAMON_OPS_PADDR && sysfs_targets->nr > 1)
+	if ((ctx->ops.id == DAMON_OPS_PADDR ||
+	     ctx->ops.id == DAMON_OPS_PADDR_PMU) && sysfs_targets->nr > 1)
 		return -EINVAL;
 
 	for (i = 0; i < sysfs_targets->nr; i++) {
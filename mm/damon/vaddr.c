@@ -9,6 +9,7 @@
 
 #include <linux/highmem.h>
 #include <linux/hugetlb.h>
+#include <linux/khugepaged.h>
 #include <linux/mman.h>
 #include <linux/mmu_notifier.h>
 #include <linux/page_idle.h>
@@ -653,6 +654,25 @@ static unsigned long damos_madvise(struct damon_target *target,
 }
 #endif	/* CONFIG_ADVISE_SYSCALLS */
 
+static unsigned long damos_va_collapse_hint(struct damon_ctx *ctx,
+		struct damon_target *target, struct damon_region *r,
+		struct damos *scheme)
+{
+	struct mm_struct *mm;
+	unsigned long applied;
+
+	mm = damon_get_mm(target);
+	if (!mm)
+		return 0;
+
+	applied = khugepaged_add_hint(mm, r->ar.start, r->ar.end,
+			damon_hot_score(ctx, r, scheme)) ? 0 :
+		damon_sz_region(r);
+	mmput(mm);
+
+	return applied;
+}
+
 static unsigned long damon_va_apply_scheme(struct damon_ctx *ctx,
 		struct damon_target *t, struct damon_region *r,
 		struct damos *scheme, unsigned long *sz_filter_passed)
@@ -675,6 +695,8 @@ static unsigned long damon_va_apply_scheme(struct damon_ctx *ctx,
 	case DAMOS_NOHUGEPAGE:
 		madv_action = MADV_NOHUGEPAGE;
 		break;
+	case DAMOS_COLLAPSE_HINT:
+		return damos_va_collapse_hint(ctx, t, r, scheme);
 	case DAMOS_STAT:
 		return 0;
 	default:
@@ -695,6 +717,8 @@ static int damon_va_scheme_score(struct damon_ctx *context,
 	switch (scheme->action) {
 	case DAMOS_PAGEOUT:
 		return damon_cold_score(context, r, scheme);
+	case DAMOS_COLLAPSE_HINT:
+		return damon_hot_score(context, r, scheme);
 	default:
 		break;
 	}
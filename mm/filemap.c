@@ -2914,14 +2914,19 @@ size_t splice_folio_into_pipe(struct pipe_inode_info *pipe,
 {
 	struct page *page;
 	size_t spliced = 0, offset = offset_in_folio(folio, fpos);
+	size_t max_part = PAGE_SIZE;
 
 	page = folio_page(folio, offset / PAGE_SIZE);
 	size = min(size, folio_size(folio) - offset);
 	offset %= PAGE_SIZE;
 
+	/* Let one buffer cover as much of a large folio as pipes allow */
+	if (folio_test_large(folio))
+		max_part <<= min(folio_order(folio), pipe_folio_order());
+
 	while (spliced < size && !pipe_is_full(pipe)) {
 		struct pipe_buffer *buf = pipe_head_buf(pipe);
-		size_t part = min_t(size_t, PAGE_SIZE - offset, size - spliced);
+		size_t part = min_t(size_t, max_part - offset, size - spliced);
 
 		*buf = (struct pipe_buffer) {
 			.ops	= &page_cache_pipe_buf_ops,
@@ -2931,7 +2936,7 @@ size_t splice_folio_into_pipe(struct pipe_inode_info *pipe,
 		};
 		folio_get(folio);
 		pipe->head++;
-		page++;
+		page += (offset + part) / PAGE_SIZE;
 		spliced += part;
 		offset = 0;
 	}
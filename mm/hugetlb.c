@@ -3505,10 +3505,14 @@ static void __init hugetlb_hstate_alloc_pages(struct hstate *h)
 		return;
 
 	/* below will do all node balanced alloc */
-	if (hstate_is_gigantic(h))
+	if (hstate_is_gigantic(h)) {
 		allocated = hugetlb_gigantic_pages_alloc_boot(h);
-	else
+	} else {
+		u64 begin = ktime_get_ns();
+
 		allocated = hugetlb_pages_alloc_boot(h);
+		atomic64_add(ktime_get_ns() - begin, &h->alloc_time_ns);
+	}
 
 	hugetlb_hstate_alloc_pages_errcheck(allocated, h);
 }
@@ -3632,12 +3636,213 @@ static int adjust_pool_surplus(struct hstate *h, nodemask_t *nodes_allowed,
 }
 
 #define persistent_huge_pages(h) (h->nr_huge_pages - h->surplus_huge_pages)
+
+/*
+ * Growing the pool through nr_hugepages allocates one folio at a time,
+ * which for gigantic folios means one alloc_contig_range() after the
+ * other.  When several nodes are allowed, hand each of them a share of
+ * up to HUGETLB_GROW_BATCH folios, allocated by an unbound worker running
+ * on that node, and let the serial loop take care of what is left.
+ */
+#define HUGETLB_GROW_BATCH	16
+
+struct hugetlb_grow_work {
+	struct work_struct work;
+	struct hstate *h;
+	nodemask_t *nodes_allowed;
+	nodemask_t *node_alloc_noretry;
+	int nid;
+	unsigned long nr_wanted;
+	unsigned long nr_allocated;
+	struct list_head folio_list;
+};
+
+static void hugetlb_grow_workfn(struct work_struct *work)
+{
+	struct hugetlb_grow_work *hgw =
+		container_of(work, struct hugetlb_grow_work, work);
+	gfp_t gfp_mask = htlb_alloc_mask(hgw->h) | __GFP_THISNODE;
+	struct folio *folio;
+
+	while (hgw->nr_allocated < hgw->nr_wanted) {
+		folio = only_alloc_fresh_hugetlb_folio(hgw->h, gfp_mask,
+					hgw->nid, hgw->nodes_allowed,
+					hgw->node_alloc_noretry);
+		if (!folio) {
+			/* leave this node to the serial loop from now on */
+			node_set(hgw->nid, *hgw->node_alloc_noretry);
+			break;
+		}
+
+		list_add(&folio->lru, &hgw->folio_list);
+		hgw->nr_allocated++;
+		cond_resched();
+	}
+}
+
+/*
+ * Allocate up to @nr_wanted fresh folios spread over @nodes_allowed in
+ * parallel and put them on @folio_list.  Returns the number allocated,
+ * 0 if there is only one node to allocate from.
+ */
+static unsigned long hugetlb_grow_parallel(struct hstate *h,
+		unsigned long nr_wanted, nodemask_t *nodes_allowed,
+		nodemask_t *node_alloc_noretry, struct list_head *folio_list)
+{
+	struct hugetlb_grow_work *works;
+	unsigned long share, queued = 0, allocated = 0;
+	int nid, nr_nodes = 0, i = 0;
+
+	for_each_node_mask(nid, *nodes_allowed)
+		if (node_state(nid, N_MEMORY) &&
+		    !node_isset(nid, *node_alloc_noretry))
+			nr_nodes++;
+	if (nr_nodes < 2)
+		return 0;
+
+	works = kcalloc(nr_nodes, sizeof(*works), GFP_KERNEL);
+	if (!works)
+		return 0;
+
+	share = min(DIV_ROUND_UP(nr_wanted, nr_nodes),
+		    (unsigned long)HUGETLB_GROW_BATCH);
+	for_each_node_mask(nid, *nodes_allowed) {
+		struct hugetlb_grow_work *hgw;
+
+		if (!node_state(nid, N_MEMORY) ||
+		    node_isset(nid, *node_alloc_noretry))
+			continue;
+		if (i == nr_nodes || queued == nr_wanted)
+			break;
+
+		hgw = &works[i++];
+		INIT_WORK(&hgw->work, hugetlb_grow_workfn);
+		INIT_LIST_HEAD(&hgw->folio_list);
+		hgw->h = h;
+		hgw->nodes_allowed = nodes_allowed;
+		hgw->node_alloc_noretry = node_alloc_noretry;
+		hgw->nid = nid;
+		hgw->nr_wanted = min(share, nr_wanted - queued);
+		queued += hgw->nr_wanted;
+		queue_work_node(nid, system_unbound_wq, &hgw->work);
+	}
+
+	nr_nodes = i;
+	for (i = 0; i < nr_nodes; i++) {
+		flush_work(&works[i].work);
+		list_splice_tail(&works[i].folio_list, folio_list);
+		allocated += works[i].nr_allocated;
+	}
+	kfree(works);
+
+	return allocated;
+}
+
+/*
+ * Zeroing a gigantic folio on first touch is a long run of clear_page()
+ * on one CPU.  With vm.hugetlb_zero_threads > 1 it is split into that
+ * many chunks, all but one of which are cleared by unbound workers on the
+ * folio's node while the faulting task clears the remaining one.
+ */
+#define HUGETLB_ZERO_MAX_THREADS	16
+
+static int sysctl_hugetlb_zero_threads __read_mostly = 4;
+static const int hugetlb_zero_threads_max = HUGETLB_ZERO_MAX_THREADS;
+
+struct hugetlb_zero_work {
+	struct work_struct work;
+	struct folio *folio;
+	unsigned long addr;
+	long start;
+	long nr;
+};
+
+static void hugetlb_zero_chunk(struct folio *folio, unsigned long addr,
+			       long start, long nr)
+{
+	long i;
+
+	for (i = start; i < start + nr; i++) {
+		clear_user_highpage(folio_page(folio, i), addr + i * PAGE_SIZE);
+		cond_resched();
+	}
+}
+
+static void hugetlb_zero_workfn(struct work_struct *work)
+{
+	struct hugetlb_zero_work *hzw =
+		container_of(work, struct hugetlb_zero_work, work);
+
+	hugetlb_zero_chunk(hzw->folio, hzw->addr, hzw->start, hzw->nr);
+}
+
+/**
+ * hugetlb_zero_folio - Zero a hugetlb folio which will be mapped to userspace.
+ * @folio: The folio to zero.
+ * @addr_hint: The address will be accessed or the base address if unclear.
+ *
+ * Like folio_zero_user(), but gigantic folios are cleared by up to
+ * vm.hugetlb_zero_threads threads.  The time spent is accounted in the
+ * hstate's zero_time_us.
+ */
+void hugetlb_zero_folio(struct folio *folio, unsigned long addr_hint)
+{
+	struct hugetlb_zero_work *works = NULL;
+	int nr_threads = READ_ONCE(sysctl_hugetlb_zero_threads);
+	struct hstate *h = folio_hstate(folio);
+	long nr = folio_nr_pages(folio);
+	unsigned long addr;
+	long chunk, start = 0;
+	u64 begin;
+	int i;
+
+	if (!hstate_is_gigantic(h)) {
+		folio_zero_user(folio, addr_hint);
+		return;
+	}
+
+	begin = ktime_get_ns();
+	if (nr_threads > 1)
+		works = kmalloc_array(nr_threads - 1, sizeof(*works),
+				      GFP_KERNEL | __GFP_NOWARN);
+	if (!works) {
+		folio_zero_user(folio, addr_hint);
+		goto out;
+	}
+
+	addr = ALIGN_DOWN(addr_hint, folio_size(folio));
+	chunk = DIV_ROUND_UP(nr, nr_threads);
+	for (i = 0; i < nr_threads - 1; i++) {
+		struct hugetlb_zero_work *hzw = &works[i];
+
+		INIT_WORK(&hzw->work, hugetlb_zero_workfn);
+		hzw->folio = folio;
+		hzw->addr = addr;
+		hzw->start = start;
+		hzw->nr = min(chunk, nr - start);
+		start += hzw->nr;
+		queue_work_node(folio_nid(folio), system_unbound_wq,
+				&hzw->work);
+	}
+
+	might_sleep();
+	hugetlb_zero_chunk(folio, addr, start, nr - start);
+
+	for (i = 0; i < nr_threads - 1; i++)
+		flush_work(&works[i].work);
+	kfree(works);
+out:
+	atomic64_add(ktime_get_ns() - begin, &h->zero_time_ns);
+	atomic_long_inc(&h->nr_zeroed);
+}
+
 static int set_max_huge_pages(struct hstate *h, unsigned long count, int nid,
 			      nodemask_t *nodes_allowed)
 {
 	unsigned long min_count;
 	unsigned long allocated;
 	struct folio *folio;
+	u64 begin, grow_end = 0;
 	LIST_HEAD(page_list);
 	NODEMASK_ALLOC(nodemask_t, node_alloc_noretry, GFP_KERNEL);
 
@@ -3715,6 +3920,29 @@ static int set_max_huge_pages(struct hstate *h, unsigned long count, int nid,
 	}
 
 	allocated = 0;
+	begin = ktime_get_ns();
+	while (count > (persistent_huge_pages(h) + allocated + 1)) {
+		unsigned long nr_wanted, nr;
+
+		nr_wanted = count - (persistent_huge_pages(h) + allocated);
+		spin_unlock_irq(&hugetlb_lock);
+
+		nr = hugetlb_grow_parallel(h, nr_wanted, nodes_allowed,
+					   node_alloc_noretry, &page_list);
+		allocated += nr;
+
+		/* Bail for signals. Probably ctrl-c from user */
+		if (signal_pending(current)) {
+			prep_and_add_allocated_folios(h, &page_list);
+			spin_lock_irq(&hugetlb_lock);
+			goto out;
+		}
+
+		spin_lock_irq(&hugetlb_lock);
+		if (!nr)
+			break;
+	}
+
 	while (count > (persistent_huge_pages(h) + allocated)) {
 		/*
 		 * If this allocation races such that we no longer need the
@@ -3754,6 +3982,7 @@ static int set_max_huge_pages(struct hstate *h, unsigned long count, int nid,
 		prep_and_add_allocated_folios(h, &page_list);
 		spin_lock_irq(&hugetlb_lock);
 	}
+	grow_end = ktime_get_ns();
 
 	/*
 	 * Decrease the pool size
@@ -3795,6 +4024,9 @@ static int set_max_huge_pages(struct hstate *h, unsigned long count, int nid,
 			break;
 	}
 out:
+	if (allocated)
+		atomic64_add((grow_end ?: ktime_get_ns()) - begin,
+			     &h->alloc_time_ns);
 	h->max_huge_pages = persistent_huge_pages(h);
 	spin_unlock_irq(&hugetlb_lock);
 	mutex_unlock(&h->resize_lock);
@@ -4126,6 +4358,35 @@ static ssize_t surplus_hugepages_show(struct kobject *kobj,
 }
 HSTATE_ATTR_RO(surplus_hugepages);
 
+static ssize_t alloc_time_ms_show(struct kobject *kobj,
+					struct kobj_attribute *attr, char *buf)
+{
+	struct hstate *h = kobj_to_hstate(kobj, NULL);
+
+	return sysfs_emit(buf, "%llu\n",
+		div_u64(atomic64_read(&h->alloc_time_ns), NSEC_PER_MSEC));
+}
+HSTATE_ATTR_RO(alloc_time_ms);
+
+static ssize_t zero_time_us_show(struct kobject *kobj,
+					struct kobj_attribute *attr, char *buf)
+{
+	struct hstate *h = kobj_to_hstate(kobj, NULL);
+
+	return sysfs_emit(buf, "%llu\n",
+		div_u64(atomic64_read(&h->zero_time_ns), NSEC_PER_USEC));
+}
+HSTATE_ATTR_RO(zero_time_us);
+
+static ssize_t nr_zeroed_show(struct kobject *kobj,
+					struct kobj_attribute *attr, char *buf)
+{
+	struct hstate *h = kobj_to_hstate(kobj, NULL);
+
+	return sysfs_emit(buf, "%lu\n", atomic_long_read(&h->nr_zeroed));
+}
+HSTATE_ATTR_RO(nr_zeroed);
+
 static ssize_t demote_store(struct kobject *kobj,
 	       struct kobj_attribute *attr, const char *buf, size_t len)
 {
@@ -4231,6 +4492,9 @@ static struct attribute *hstate_attrs[] = {
 	&free_hugepages_attr.attr,
 	&resv_hugepages_attr.attr,
 	&surplus_hugepages_attr.attr,
+	&alloc_time_ms_attr.attr,
+	&zero_time_us_attr.attr,
+	&nr_zeroed_attr.attr,
 #ifdef CONFIG_NUMA
 	&nr_hugepages_mempolicy_attr.attr,
 #endif
@@ -4910,6 +5174,15 @@ static const struct ctl_table hugetlb_table[] = {
 		.mode		= 0644,
 		.proc_handler	= hugetlb_overcommit_handler,
 	},
+	{
+		.procname	= "hugetlb_zero_threads",
+		.data		= &sysctl_hugetlb_zero_threads,
+		.maxlen		= sizeof(sysctl_hugetlb_zero_threads),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= SYSCTL_ONE,
+		.extra2		= (void *)&hugetlb_zero_threads_max,
+	},
 };
 
 static void hugetlb_sysctl_init(void)
@@ -6193,7 +6466,7 @@ static vm_fault_t hugetlb_no_page(struct address_space *mapping,
 				ret = 0;
 			goto out;
 		}
-		folio_zero_user(folio, vmf->real_address);
+		hugetlb_zero_folio(folio, vmf->real_address);
 		__folio_mark_uptodate(folio);
 		new_folio = true;
 
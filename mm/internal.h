@@ -1464,6 +1464,8 @@ void __meminit __init_single_page(struct page *page, unsigned long pfn,
 /* shrinker related functions */
 unsigned long shrink_slab(gfp_t gfp_mask, int nid, struct mem_cgroup *memcg,
 			  int priority);
+bool shrink_slab_async(gfp_t gfp_mask, int nid, struct mem_cgroup *memcg,
+		       int priority);
 
 #ifdef CONFIG_SHRINKER_DEBUG
 static inline __printf(2, 0) int shrinker_debugfs_name_alloc(
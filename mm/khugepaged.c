@@ -130,6 +130,56 @@ static struct khugepaged_scan khugepaged_scan = {
 	.mm_head = LIST_HEAD_INIT(khugepaged_scan.mm_head),
 };
 
+/**
+ * struct khugepaged_hint - range to collapse ahead of the regular scan
+ * @mm: the mm, pinned with mmgrab()
+ * @start: PMD aligned start of the range
+ * @end: PMD aligned end of the range
+ * @score: priority of the range, higher is collapsed first
+ *
+ * Hints are queued by DAMOS_COLLAPSE_HINT schemes for regions DAMON found
+ * hot, so that khugepaged reaches them without waiting for a full sweep.
+ */
+struct khugepaged_hint {
+	struct mm_struct *mm;
+	unsigned long start;
+	unsigned long end;
+	unsigned int score;
+};
+
+#define KHUGEPAGED_MAX_HINTS 64
+
+static DEFINE_SPINLOCK(khugepaged_hint_lock);
+static struct khugepaged_hint khugepaged_hints[KHUGEPAGED_MAX_HINTS];
+static unsigned int khugepaged_nr_hints;
+/* A hint was queued since the last scan, don't wait for scan_sleep */
+static bool khugepaged_hint_kick;
+
+/* Forget the hints of an exiting mm, they would pin it until popped */
+static void khugepaged_drop_hints(struct mm_struct *mm)
+{
+	unsigned int i = 0, nr_drop = 0;
+
+	if (!READ_ONCE(khugepaged_nr_hints))
+		return;
+
+	spin_lock(&khugepaged_hint_lock);
+	while (i < khugepaged_nr_hints) {
+		if (khugepaged_hints[i].mm == mm) {
+			khugepaged_hints[i] =
+				khugepaged_hints[--khugepaged_nr_hints];
+			nr_drop++;
+		} else {
+			i++;
+		}
+	}
+	spin_unlock(&khugepaged_hint_lock);
+
+	/* The caller still holds its own reference */
+	while (nr_drop--)
+		mmdrop(mm);
+}
+
 #ifdef CONFIG_SYSFS
 static ssize_t scan_sleep_millisecs_show(struct kobject *kobj,
 					 struct kobj_attribute *attr,
@@ -486,6 +536,8 @@ void __khugepaged_exit(struct mm_struct *mm)
 	struct mm_slot *slot;
 	int free = 0;
 
+	khugepaged_drop_hints(mm);
+
 	spin_lock(&khugepaged_mm_lock);
 	slot = mm_slot_lookup(mm_slots_hash, mm);
 	mm_slot = mm_slot_entry(slot, struct khugepaged_mm_slot, slot);
@@ -1459,6 +1511,7 @@ static void collect_mm_slot(struct khugepaged_mm_slot *mm_slot)
 		 *
 		 * clear_bit(MMF_VM_HUGEPAGE, &mm->flags);
 		 */
+		khugepaged_drop_hints(mm);
 
 		/* khugepaged_mm_lock actually not necessary for the below */
 		mm_slot_free(mm_slot_cache, mm_slot);
@@ -2365,6 +2418,47 @@ static int hpage_collapse_scan_file(struct mm_struct *mm, unsigned long addr,
 }
 #endif
 
+/*
+ * Try to collapse the PMD range at @address.  Called with mmap_lock held for
+ * read; *@mmap_locked is cleared if the lock was dropped.
+ */
+static int khugepaged_collapse_pmd(struct mm_struct *mm,
+				   struct vm_area_struct *vma,
+				   unsigned long address, bool *mmap_locked,
+				   struct collapse_control *cc)
+{
+	int result;
+
+	if (IS_ENABLED(CONFIG_SHMEM) && !vma_is_anonymous(vma)) {
+		struct file *file = get_file(vma->vm_file);
+		pgoff_t pgoff = linear_page_index(vma, address);
+
+		mmap_read_unlock(mm);
+		*mmap_locked = false;
+		result = hpage_collapse_scan_file(mm, address, file, pgoff, cc);
+		fput(file);
+		if (result == SCAN_PTE_MAPPED_HUGEPAGE) {
+			mmap_read_lock(mm);
+			if (hpage_collapse_test_exit_or_disable(mm)) {
+				mmap_read_unlock(mm);
+				return SCAN_ANY_PROCESS;
+			}
+			result = collapse_pte_mapped_thp(mm, address, false);
+			if (result == SCAN_PMD_MAPPED)
+				result = SCAN_SUCCEED;
+			mmap_read_unlock(mm);
+		}
+	} else {
+		result = hpage_collapse_scan_pmd(mm, vma, address,
+						 mmap_locked, cc);
+	}
+
+	if (result == SCAN_SUCCEED)
+		++khugepaged_pages_collapsed;
+
+	return result;
+}
+
 static unsigned int khugepaged_scan_mm_slot(unsigned int pages, int *result,
 					    struct collapse_control *cc)
 	__releases(&khugepaged_mm_lock)
@@ -2439,33 +2533,8 @@ static unsigned int khugepaged_scan_mm_slot(unsigned int pages, int *result,
 			VM_BUG_ON(khugepaged_scan.address < hstart ||
 				  khugepaged_scan.address + HPAGE_PMD_SIZE >
 				  hend);
-			if (IS_ENABLED(CONFIG_SHMEM) && !vma_is_anonymous(vma)) {
-				struct file *file = get_file(vma->vm_file);
-				pgoff_t pgoff = linear_page_index(vma,
-						khugepaged_scan.address);
-
-				mmap_read_unlock(mm);
-				mmap_locked = false;
-				*result = hpage_collapse_scan_file(mm,
-					khugepaged_scan.address, file, pgoff, cc);
-				fput(file);
-				if (*result == SCAN_PTE_MAPPED_HUGEPAGE) {
-					mmap_read_lock(mm);
-					if (hpage_collapse_test_exit_or_disable(mm))
-						goto breakouterloop;
-					*result = collapse_pte_mapped_thp(mm,
-						khugepaged_scan.address, false);
-					if (*result == SCAN_PMD_MAPPED)
-						*result = SCAN_SUCCEED;
-					mmap_read_unlock(mm);
-				}
-			} else {
-				*result = hpage_collapse_scan_pmd(mm, vma,
+			*result = khugepaged_collapse_pmd(mm, vma,
 					khugepaged_scan.address, &mmap_locked, cc);
-			}
-
-			if (*result == SCAN_SUCCEED)
-				++khugepaged_pages_collapsed;
 
 			/* move to next address */
 			khugepaged_scan.address += HPAGE_PMD_SIZE;
@@ -2516,14 +2585,182 @@ static unsigned int khugepaged_scan_mm_slot(unsigned int pages, int *result,
 	return progress;
 }
 
+/**
+ * khugepaged_add_hint - ask khugepaged to collapse a range first
+ * @mm: the mm the range belongs to
+ * @start: start address of the range
+ * @end: end address of the range
+ * @score: priority of the range, higher is collapsed first
+ *
+ * The range is only a hint: it is collapsed by the regular khugepaged
+ * code, so sysfs settings such as max_ptes_none still apply.  When the
+ * queue is full, the hint with the lowest score is replaced.
+ *
+ * Return: 0 if the hint was queued, negative errno otherwise.
+ */
+int khugepaged_add_hint(struct mm_struct *mm, unsigned long start,
+			unsigned long end, unsigned int score)
+{
+	struct mm_struct *drop = NULL;
+	struct khugepaged_hint *hint = NULL;
+	int i, ret = 0;
+
+	start = ALIGN_DOWN(start, HPAGE_PMD_SIZE);
+	end = ALIGN(end, HPAGE_PMD_SIZE);
+	if (start >= end || !hugepage_pmd_enabled())
+		return -EINVAL;
+	/* Only registered mms drop their hints in __khugepaged_exit() */
+	if (!test_bit(MMF_VM_HUGEPAGE, &mm->flags))
+		return -EINVAL;
+
+	spin_lock(&khugepaged_hint_lock);
+	for (i = 0; i < khugepaged_nr_hints; i++) {
+		struct khugepaged_hint *h = &khugepaged_hints[i];
+
+		/* Merge with an overlapping or adjacent range */
+		if (h->mm == mm && start <= h->end && end >= h->start) {
+			h->start = min(h->start, start);
+			h->end = max(h->end, end);
+			h->score = max(h->score, score);
+			goto kick;
+		}
+		if (!hint || h->score < hint->score)
+			hint = h;
+	}
+
+	if (khugepaged_nr_hints < KHUGEPAGED_MAX_HINTS) {
+		hint = &khugepaged_hints[khugepaged_nr_hints++];
+	} else if (hint->score < score) {
+		drop = hint->mm;
+	} else {
+		ret = -EBUSY;
+		goto unlock;
+	}
+
+	mmgrab(mm);
+	hint->mm = mm;
+	hint->start = start;
+	hint->end = end;
+	hint->score = score;
+kick:
+	WRITE_ONCE(khugepaged_hint_kick, true);
+unlock:
+	spin_unlock(&khugepaged_hint_lock);
+
+	if (drop)
+		mmdrop(drop);
+	if (!ret)
+		wake_up_interruptible(&khugepaged_wait);
+	return ret;
+}
+
+/* Take the hint with the highest score off the queue */
+static bool khugepaged_pop_hint(struct khugepaged_hint *hint)
+{
+	unsigned int i, best = 0;
+
+	spin_lock(&khugepaged_hint_lock);
+	if (!khugepaged_nr_hints) {
+		spin_unlock(&khugepaged_hint_lock);
+		return false;
+	}
+	for (i = 1; i < khugepaged_nr_hints; i++)
+		if (khugepaged_hints[i].score > khugepaged_hints[best].score)
+			best = i;
+	*hint = khugepaged_hints[best];
+	khugepaged_hints[best] = khugepaged_hints[--khugepaged_nr_hints];
+	spin_unlock(&khugepaged_hint_lock);
+
+	return true;
+}
+
+/*
+ * Collapse the queued hints, highest score first, before the regular scan.
+ * A hint that cannot be finished within @pages is queued again with the
+ * remaining range.
+ */
+static unsigned int khugepaged_scan_hints(unsigned int pages, int *result,
+					  struct collapse_control *cc)
+{
+	struct khugepaged_hint hint;
+	unsigned int progress = 0;
+
+	while (progress < pages && khugepaged_pop_hint(&hint)) {
+		struct mm_struct *mm = hint.mm;
+		unsigned long address = hint.start;
+		bool mmap_locked = true;
+
+		if (!mmget_not_zero(mm))
+			goto drop;
+
+		/* Don't wait for the lock, retry the hint on the next scan */
+		if (unlikely(!mmap_read_trylock(mm))) {
+			khugepaged_add_hint(mm, address, hint.end, hint.score);
+			mmput(mm);
+			mmdrop(mm);
+			break;
+		}
+
+		progress++;
+		while (address < hint.end && progress < pages) {
+			struct vm_area_struct *vma;
+
+			cond_resched();
+			if (unlikely(hpage_collapse_test_exit_or_disable(mm))) {
+				address = hint.end;
+				break;
+			}
+
+			vma = vma_lookup(mm, address);
+			if (!vma ||
+			    address < round_up(vma->vm_start, HPAGE_PMD_SIZE) ||
+			    address + HPAGE_PMD_SIZE > vma->vm_end ||
+			    !thp_vma_allowable_order(vma, vma->vm_flags,
+					TVA_ENFORCE_SYSFS, PMD_ORDER)) {
+				address += HPAGE_PMD_SIZE;
+				progress++;
+				continue;
+			}
+
+			*result = khugepaged_collapse_pmd(mm, vma, address,
+							  &mmap_locked, cc);
+			address += HPAGE_PMD_SIZE;
+			progress += HPAGE_PMD_NR;
+			if (!mmap_locked)
+				break;
+		}
+		if (mmap_locked)
+			mmap_read_unlock(mm);
+		if (address < hint.end && !hpage_collapse_test_exit(mm))
+			khugepaged_add_hint(mm, address, hint.end, hint.score);
+		mmput(mm);
+drop:
+		mmdrop(mm);
+
+		if (*result == SCAN_ALLOC_HUGE_PAGE_FAIL)
+			break;
+	}
+
+	/* Requeued hints wait for the next scan like everything else */
+	WRITE_ONCE(khugepaged_hint_kick, false);
+
+	return progress;
+}
+
+static bool khugepaged_has_slots(void)
+{
+	return !list_empty(&khugepaged_scan.mm_head);
+}
+
 static int khugepaged_has_work(void)
 {
-	return !list_empty(&khugepaged_scan.mm_head) && hugepage_pmd_enabled();
+	return (khugepaged_has_slots() || READ_ONCE(khugepaged_nr_hints)) &&
+		hugepage_pmd_enabled();
 }
 
 static int khugepaged_wait_event(void)
 {
-	return !list_empty(&khugepaged_scan.mm_head) ||
+	return khugepaged_has_slots() || READ_ONCE(khugepaged_nr_hints) ||
 		kthread_should_stop();
 }
 
@@ -2536,6 +2773,10 @@ static void khugepaged_do_scan(struct collapse_control *cc)
 
 	lru_add_drain_all();
 
+	progress = khugepaged_scan_hints(pages, &result, cc);
+	if (progress >= pages)
+		return;
+
 	while (true) {
 		cond_resched();
 
@@ -2545,7 +2786,8 @@ static void khugepaged_do_scan(struct collapse_control *cc)
 		spin_lock(&khugepaged_mm_lock);
 		if (!khugepaged_scan.mm_slot)
 			pass_through_head++;
-		if (khugepaged_has_work() &&
+		/* Queued hints alone don't give the mm_slot walk anything */
+		if (khugepaged_has_slots() && hugepage_pmd_enabled() &&
 		    pass_through_head < 2)
 			progress += khugepaged_scan_mm_slot(pages - progress,
 							    &result, cc);
@@ -2571,7 +2813,7 @@ static void khugepaged_do_scan(struct collapse_control *cc)
 
 static bool khugepaged_should_wakeup(void)
 {
-	return kthread_should_stop() ||
+	return kthread_should_stop() || READ_ONCE(khugepaged_hint_kick) ||
 	       time_after_eq(jiffies, khugepaged_sleep_expire);
 }
 
@@ -2096,6 +2096,11 @@ static struct ksm_stable_node *stable_tree_insert(struct folio *kfolio)
  *
  * This function does both searching and inserting, because they share
  * the same walking algorithm in an rbtree.
+ *
+ * The tree is ordered by the checksum cmp_and_merge_page() has just verified
+ * for the page first, and by page content only among equal checksums: pages
+ * with different checksums cannot be identical, so there is no need to look
+ * up and compare their contents.
  */
 static
 struct ksm_rmap_item *unstable_tree_search_insert(struct ksm_rmap_item *rmap_item,
@@ -2118,6 +2123,15 @@ struct ksm_rmap_item *unstable_tree_search_insert(struct ksm_rmap_item *rmap_ite
 
 		cond_resched();
 		tree_rmap_item = rb_entry(*new, struct ksm_rmap_item, node);
+		if (rmap_item->oldchecksum != tree_rmap_item->oldchecksum) {
+			parent = *new;
+			if (rmap_item->oldchecksum < tree_rmap_item->oldchecksum)
+				new = &parent->rb_left;
+			else
+				new = &parent->rb_right;
+			continue;
+		}
+
 		tree_page = get_mergeable_page(tree_rmap_item);
 		if (!tree_page)
 			return NULL;
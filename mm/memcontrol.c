@@ -61,6 +61,7 @@
 #include <linux/resume_user_mode.h>
 #include <linux/psi.h>
 #include <linux/seq_buf.h>
+#include <linux/sysctl.h>
 #include <linux/sched/isolation.h>
 #include <linux/kmemleak.h>
 #include "internal.h"
@@ -488,6 +489,9 @@ struct memcg_vmstats_percpu {
 	/* Stats updates since the last flush */
 	unsigned int			stats_updates;
 
+	/* Updated on this CPU, here or below, since the last flush */
+	bool				dirty;
+
 	/* Cached pointers for fast iteration in memcg_rstat_updated() */
 	struct memcg_vmstats_percpu	*parent;
 	struct memcg_vmstats		*vmstats;
@@ -518,6 +522,11 @@ struct memcg_vmstats {
 
 	/* Stats updates since the last flush */
 	atomic64_t		stats_updates;
+
+	/* Completion time and count of subtree flushes, see flush_stats_reader */
+	u64			flush_time;
+	unsigned int		flush_seq;
+	atomic_t		flushers;
 };
 
 /*
@@ -534,6 +543,15 @@ struct memcg_vmstats {
  *    (MEMCG_CHARGE_BATCH * nr_cpus) update events. Though this optimization
  *    will let stats be out of sync by atmost (MEMCG_CHARGE_BATCH * nr_cpus) but
  *    only for 2 seconds due to (1).
+ *
+ * 3) Only fold the per-CPU counters of a cgroup on the CPUs it (or one of its
+ *    descendants) was updated on since the last flush. The rstat tree is
+ *    shared with the other controllers and may bring up idle ones.
+ *
+ * 4) Optionally let userspace readers of the stat files use a flush of their
+ *    subtree, or of one containing it, that completed no more than
+ *    vm.memcg_stats_staleness_ms ago, or wait for one in progress, rather than
+ *    queueing up on the global rstat lock behind reclaim.
  */
 static void flush_memcg_stats_dwork(struct work_struct *w);
 static DECLARE_DEFERRABLE_WORK(stats_flush_dwork, flush_memcg_stats_dwork);
@@ -541,6 +559,23 @@ static u64 flush_last_time;
 
 #define FLUSH_TIME (2UL*HZ)
 
+static int memcg_stats_staleness_ms __read_mostly;
+static const int memcg_stats_staleness_max = 2 * MSEC_PER_SEC;
+
+#ifdef CONFIG_SYSCTL
+static const struct ctl_table memcg_stats_sysctls[] = {
+	{
+		.procname	= "memcg_stats_staleness_ms",
+		.data		= &memcg_stats_staleness_ms,
+		.maxlen		= sizeof(memcg_stats_staleness_ms),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= SYSCTL_ZERO,
+		.extra2		= (void *)&memcg_stats_staleness_max,
+	},
+};
+#endif
+
 /*
  * Accessors to ensure that preemption is disabled on PREEMPT_RT because it can
  * not rely on this as part of an acquired spinlock_t lock. These functions are
@@ -579,9 +614,14 @@ static inline void memcg_rstat_updated(struct mem_cgroup *memcg, int val)
 	if (!val)
 		return;
 
-	cgroup_rstat_updated(memcg->css.cgroup, cpu);
 	statc = this_cpu_ptr(memcg->vmstats_percpu);
 	for (; statc; statc = statc->parent) {
+		/*
+		 * Publish the counter update before the flag, even if it is
+		 * already set: the flusher may be clearing it right now.
+		 * Pairs with the xchg() in mem_cgroup_css_rstat_flush().
+		 */
+		smp_store_release(&statc->dirty, true);
 		stats_updates = READ_ONCE(statc->stats_updates) + abs(val);
 		WRITE_ONCE(statc->stats_updates, stats_updates);
 		if (stats_updates < MEMCG_CHARGE_BATCH)
@@ -596,6 +636,8 @@ static inline void memcg_rstat_updated(struct mem_cgroup *memcg, int val)
 				     &statc->vmstats->stats_updates);
 		WRITE_ONCE(statc->stats_updates, 0);
 	}
+
+	cgroup_rstat_updated(memcg->css.cgroup, cpu);
 }
 
 static void __mem_cgroup_flush_stats(struct mem_cgroup *memcg, bool force)
@@ -611,7 +653,12 @@ static void __mem_cgroup_flush_stats(struct mem_cgroup *memcg, bool force)
 	if (mem_cgroup_is_root(memcg))
 		WRITE_ONCE(flush_last_time, jiffies_64);
 
+	atomic_inc(&memcg->vmstats->flushers);
 	cgroup_rstat_flush(memcg->css.cgroup);
+	WRITE_ONCE(memcg->vmstats->flush_time, get_jiffies_64());
+	WRITE_ONCE(memcg->vmstats->flush_seq, memcg->vmstats->flush_seq + 1);
+	atomic_dec(&memcg->vmstats->flushers);
+	wake_up_var(&memcg->vmstats->flush_seq);
 }
 
 /*
@@ -634,6 +681,53 @@ void mem_cgroup_flush_stats(struct mem_cgroup *memcg)
 	__mem_cgroup_flush_stats(memcg, false);
 }
 
+/**
+ * mem_cgroup_flush_stats_reader - flush stats for a userspace reader
+ * @memcg: root of the subtree to flush
+ *
+ * Like mem_cgroup_flush_stats(), but settle for a flush of @memcg or one of
+ * its ancestors that completed within vm.memcg_stats_staleness_ms, or that
+ * is in progress and completes within that time.
+ */
+void mem_cgroup_flush_stats_reader(struct mem_cgroup *memcg)
+{
+	unsigned long staleness;
+	struct mem_cgroup *iter;
+	u64 now;
+
+	if (mem_cgroup_disabled())
+		return;
+
+	if (!memcg)
+		memcg = root_mem_cgroup;
+
+	staleness = msecs_to_jiffies(READ_ONCE(memcg_stats_staleness_ms));
+	if (!staleness)
+		goto flush;
+
+	now = get_jiffies_64();
+	for (iter = memcg; iter; iter = parent_mem_cgroup(iter)) {
+		if (time_before64(now, READ_ONCE(iter->vmstats->flush_time) +
+				  staleness))
+			return;
+	}
+
+	for (iter = memcg; iter; iter = parent_mem_cgroup(iter)) {
+		struct memcg_vmstats *vmstats = iter->vmstats;
+		unsigned int seq = READ_ONCE(vmstats->flush_seq);
+
+		if (!atomic_read(&vmstats->flushers))
+			continue;
+		if (wait_var_event_timeout(&vmstats->flush_seq,
+				READ_ONCE(vmstats->flush_seq) != seq,
+				staleness))
+			return;
+		break;
+	}
+flush:
+	mem_cgroup_flush_stats(memcg);
+}
+
 void mem_cgroup_flush_stats_ratelimited(struct mem_cgroup *memcg)
 {
 	/* Only flush if the periodic flusher is one full cycle late */
@@ -1479,7 +1573,7 @@ static void memcg_stat_format(struct mem_cgroup *memcg, struct seq_buf *s)
 	 *
 	 * Current memory state:
 	 */
-	mem_cgroup_flush_stats(memcg);
+	mem_cgroup_flush_stats_reader(memcg);
 
 	for (i = 0; i < ARRAY_SIZE(memory_stats); i++) {
 		u64 size;
@@ -3833,6 +3927,15 @@ static void mem_cgroup_css_rstat_flush(struct cgroup_subsys_state *css, int cpu)
 
 	statc = per_cpu_ptr(memcg->vmstats_percpu, cpu);
 
+	/*
+	 * Updates below us mark us dirty as well, so there are no pending
+	 * child deltas to pick up on this CPU either.  Clear the flag before
+	 * reading the counters, so an update racing with us either is seen
+	 * below or sets it again for the next flush.
+	 */
+	if (!READ_ONCE(statc->dirty) || !xchg(&statc->dirty, false))
+		goto out;
+
 	ac = (struct aggregate_control) {
 		.aggregate = memcg->vmstats->state,
 		.local = memcg->vmstats->state_local,
@@ -3878,6 +3981,7 @@ static void mem_cgroup_css_rstat_flush(struct cgroup_subsys_state *css, int cpu)
 		mem_cgroup_stat_aggregate(&ac);
 
 	}
+out:
 	WRITE_ONCE(statc->stats_updates, 0);
 	/* We are in a per-cpu loop here, only do the atomic write once */
 	if (atomic64_read(&memcg->vmstats->stats_updates))
@@ -4263,7 +4367,7 @@ static int memory_numa_stat_show(struct seq_file *m, void *v)
 	int i;
 	struct mem_cgroup *memcg = mem_cgroup_from_seq(m);
 
-	mem_cgroup_flush_stats(memcg);
+	mem_cgroup_flush_stats_reader(memcg);
 
 	for (i = 0; i < ARRAY_SIZE(memory_stats); i++) {
 		int nid;
@@ -4961,6 +5065,9 @@ static int __init mem_cgroup_init(void)
 		INIT_WORK(&per_cpu_ptr(&memcg_stock, cpu)->work,
 			  drain_local_stock);
 
+#ifdef CONFIG_SYSCTL
+	register_sysctl_init("vm", memcg_stats_sysctls);
+#endif
 	return 0;
 }
 subsys_initcall(mem_cgroup_init);
@@ -5402,7 +5509,7 @@ static u64 zswap_current_read(struct cgroup_subsys_state *css,
 {
 	struct mem_cgroup *memcg = mem_cgroup_from_css(css);
 
-	mem_cgroup_flush_stats(memcg);
+	mem_cgroup_flush_stats_reader(memcg);
 	return memcg_page_state(memcg, MEMCG_ZSWAP_B);
 }
 
@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: GPL-2.0
 #include <linux/slab.h>
+#include <linux/hash.h>
 #include <linux/lockdep.h>
 #include <linux/sysfs.h>
 #include <linux/kobject.h>
@@ -7,6 +8,9 @@
 #include <linux/memory-tiers.h>
 #include <linux/notifier.h>
 #include <linux/sched/sysctl.h>
+#include <linux/migrate.h>
+#include <linux/mm_inline.h>
+#include <linux/workqueue.h>
 
 #include "internal.h"
 
@@ -507,8 +511,266 @@ static void establish_demotion_targets(void)
 	dump_demotion_targets();
 }
 
+
+/*
+ * Sampling-driven promotion.
+ *
+ * Producers of sampled accesses, such as DAMOS_PROMOTE_HINT schemes or PMU
+ * drivers, report the PFN of an accessed page with a weight through
+ * memtier_record_access().  Samples for nodes outside the top tier are kept
+ * in a small per-node buffer, and a per-node histogram of sample weights
+ * tells how hot a page has to be to fit into the promotion budget.  A worker
+ * promotes the buffered pages at least that hot to the nearest top tier
+ * node, at most promote_rate_limit_MBps for every source and target pair.
+ */
+#define MEMTIER_PROMOTE_SAMPLES		256
+#define MEMTIER_HOT_BUCKETS		8
+#define MEMTIER_PROMOTE_INTERVAL	(HZ / 10)
+
+struct memtier_sample {
+	unsigned long pfn;
+	unsigned int weight;
+};
+
+struct memtier_promote {
+	spinlock_t lock;
+	unsigned int nr;
+	struct memtier_sample samples[MEMTIER_PROMOTE_SAMPLES];
+	/* Decaying histogram of the weights sampled on this node */
+	unsigned long hist[MEMTIER_HOT_BUCKETS];
+	/* Pages promoted in the current one second window */
+	unsigned long window_start;
+	unsigned long window_pages;
+	/* Only touched by the worker */
+	struct memtier_sample batch[MEMTIER_PROMOTE_SAMPLES];
+};
+
+static unsigned int promote_rate_limit_mbps __read_mostly;
+static struct memtier_promote **node_promote;
+
+static void memtier_promote_workfn(struct work_struct *work);
+static DECLARE_DELAYED_WORK(memtier_promote_work, memtier_promote_workfn);
+
+static int memtier_hot_bucket(unsigned int weight)
+{
+	return min_t(int, fls(weight), MEMTIER_HOT_BUCKETS - 1);
+}
+
+/**
+ * memtier_record_access() - Report a sampled access for promotion.
+ * @pfn: The page frame that was accessed.
+ * @weight: How hot the sample indicates the page is, e.g. an access count.
+ *
+ * Does nothing unless promotion is enabled through promote_rate_limit_MBps,
+ * or if @pfn is on a top tier node already.  Must not be called from NMI
+ * context.
+ */
+void memtier_record_access(unsigned long pfn, unsigned int weight)
+{
+	struct memtier_promote *mp;
+	struct memtier_sample *s;
+	unsigned long flags;
+	int nid;
+
+	if (!READ_ONCE(promote_rate_limit_mbps) || !node_promote)
+		return;
+	if (!pfn_to_online_page(pfn))
+		return;
+
+	nid = pfn_to_nid(pfn);
+	mp = node_promote[nid];
+	if (!mp || node_is_toptier(nid))
+		return;
+
+	spin_lock_irqsave(&mp->lock, flags);
+	mp->hist[memtier_hot_bucket(weight)]++;
+	if (mp->nr < MEMTIER_PROMOTE_SAMPLES) {
+		s = &mp->samples[mp->nr++];
+	} else {
+		/* Buffer full: only displace a colder sample */
+		s = &mp->samples[hash_long(pfn, ilog2(MEMTIER_PROMOTE_SAMPLES))];
+		if (s->weight >= weight)
+			s = NULL;
+	}
+	if (s) {
+		s->pfn = pfn;
+		s->weight = weight;
+	}
+	spin_unlock_irqrestore(&mp->lock, flags);
+
+	if (!delayed_work_pending(&memtier_promote_work))
+		queue_delayed_work(system_unbound_wq, &memtier_promote_work,
+				   MEMTIER_PROMOTE_INTERVAL);
+}
+EXPORT_SYMBOL_GPL(memtier_record_access);
+
+/*
+ * Return the top tier node nearest to @nid, and all top tier nodes in
+ * @allowed so that the allocation cannot fall back to a slow tier.
+ */
+static int memtier_promote_target(int nid, nodemask_t *allowed)
+{
+	int target = NUMA_NO_NODE, node;
+
+	nodes_clear(*allowed);
+	for_each_node_state(node, N_MEMORY) {
+		if (!node_is_toptier(node))
+			continue;
+		node_set(node, *allowed);
+		if (target == NUMA_NO_NODE ||
+		    node_distance(nid, node) < node_distance(nid, target))
+			target = node;
+	}
+
+	return target;
+}
+
+/*
+ * Find the lowest weight bucket such that the samples at least that hot are
+ * expected to fit into @budget pages, and decay the histogram.
+ */
+static int memtier_hot_threshold(struct memtier_promote *mp,
+				 unsigned long budget)
+{
+	unsigned long sum = 0;
+	int bucket, threshold = MEMTIER_HOT_BUCKETS - 1;
+
+	for (bucket = MEMTIER_HOT_BUCKETS - 1; bucket >= 0; bucket--) {
+		sum += mp->hist[bucket];
+		if (sum > budget)
+			break;
+		threshold = bucket;
+	}
+
+	for (bucket = 0; bucket < MEMTIER_HOT_BUCKETS; bucket++)
+		mp->hist[bucket] /= 2;
+
+	return threshold;
+}
+
+static void memtier_promote_node(int nid, struct memtier_promote *mp,
+				 unsigned long limit)
+{
+	nodemask_t allowed;
+	struct migration_target_control mtc = {
+		/* Promotion is opportunistic: don't reclaim on the target */
+		.gfp_mask = (GFP_HIGHUSER_MOVABLE & ~__GFP_RECLAIM) |
+			__GFP_NOWARN | __GFP_NOMEMALLOC | GFP_NOWAIT,
+		.nid = memtier_promote_target(nid, &allowed),
+		.nmask = &allowed,
+	};
+	unsigned long budget, nr_isolated = 0;
+	unsigned int i, nr, nr_succeeded = 0;
+	int threshold;
+	LIST_HEAD(folios);
+
+	if (mtc.nid == NUMA_NO_NODE)
+		return;
+
+	spin_lock_irq(&mp->lock);
+	if (time_after(jiffies, mp->window_start + HZ)) {
+		mp->window_start = jiffies;
+		mp->window_pages = 0;
+	}
+	budget = limit > mp->window_pages ? limit - mp->window_pages : 0;
+	threshold = memtier_hot_threshold(mp, budget);
+	nr = mp->nr;
+	memcpy(mp->batch, mp->samples, nr * sizeof(*mp->samples));
+	mp->nr = 0;
+	spin_unlock_irq(&mp->lock);
+
+	for (i = 0; i < nr && nr_isolated < budget; i++) {
+		struct page *page = pfn_to_online_page(mp->batch[i].pfn);
+		struct folio *folio;
+
+		if (memtier_hot_bucket(mp->batch[i].weight) < threshold || !page)
+			continue;
+
+		folio = page_folio(page);
+		if (!folio_try_get(folio))
+			continue;
+		if (folio_nid(folio) == nid && folio_test_lru(folio) &&
+		    folio_isolate_lru(folio)) {
+			list_add(&folio->lru, &folios);
+			node_stat_mod_folio(folio,
+				NR_ISOLATED_ANON + folio_is_file_lru(folio),
+				folio_nr_pages(folio));
+			nr_isolated += folio_nr_pages(folio);
+		}
+		folio_put(folio);
+		cond_resched();
+	}
+
+	if (list_empty(&folios))
+		return;
+
+	migrate_pages(&folios, alloc_migrate_folio, NULL, (unsigned long)&mtc,
+		      MIGRATE_ASYNC, MR_NUMA_MISPLACED, &nr_succeeded);
+	if (!list_empty(&folios))
+		putback_movable_pages(&folios);
+
+	/*
+	 * The allocation is confined to @allowed, so every migrated folio
+	 * landed on a top tier node.  Failed migrations don't consume the
+	 * budget.
+	 */
+	count_vm_events(PGPROMOTE_SAMPLED_SUCCESS, nr_succeeded);
+
+	spin_lock_irq(&mp->lock);
+	mp->window_pages += nr_succeeded;
+	spin_unlock_irq(&mp->lock);
+}
+
+static void memtier_promote_workfn(struct work_struct *work)
+{
+	unsigned int rate = READ_ONCE(promote_rate_limit_mbps);
+	unsigned long limit;
+	bool pending = false;
+	int nid;
+
+	if (!rate)
+		return;
+
+	/* Pages per one second window */
+	limit = (unsigned long)rate << (20 - PAGE_SHIFT);
+
+	for_each_node_state(nid, N_MEMORY) {
+		struct memtier_promote *mp = node_promote[nid];
+
+		if (!mp || !READ_ONCE(mp->nr))
+			continue;
+		memtier_promote_node(nid, mp, limit);
+		pending |= READ_ONCE(mp->nr);
+	}
+
+	if (pending)
+		queue_delayed_work(system_unbound_wq, &memtier_promote_work,
+				   MEMTIER_PROMOTE_INTERVAL);
+}
+
+static void __init memtier_promote_init(void)
+{
+	int nid;
+
+	node_promote = kcalloc(nr_node_ids, sizeof(*node_promote), GFP_KERNEL);
+	if (WARN_ON(!node_promote))
+		return;
+
+	for_each_node(nid) {
+		struct memtier_promote *mp;
+
+		mp = kzalloc_node(sizeof(*mp), GFP_KERNEL,
+				  node_state(nid, N_MEMORY) ? nid : NUMA_NO_NODE);
+		if (!mp)
+			continue;
+		spin_lock_init(&mp->lock);
+		mp->window_start = jiffies;
+		node_promote[nid] = mp;
+	}
+}
 #else
 static inline void establish_demotion_targets(void) {}
+static inline void memtier_promote_init(void) {}
 #endif /* CONFIG_MIGRATION */
 
 static inline void __init_node_memory_type(int node, struct memory_dev_type *memtype)
@@ -913,6 +1175,7 @@ static int __init memory_tier_init(void)
 				GFP_KERNEL);
 	WARN_ON(!node_demotion);
 #endif
+	memtier_promote_init();
 
 	mutex_lock(&memory_tier_lock);
 	/*
@@ -960,8 +1223,34 @@ static ssize_t demotion_enabled_store(struct kobject *kobj,
 static struct kobj_attribute numa_demotion_enabled_attr =
 	__ATTR_RW(demotion_enabled);
 
+static ssize_t promote_rate_limit_MBps_show(struct kobject *kobj,
+					    struct kobj_attribute *attr,
+					    char *buf)
+{
+	return sysfs_emit(buf, "%u\n", READ_ONCE(promote_rate_limit_mbps));
+}
+
+static ssize_t promote_rate_limit_MBps_store(struct kobject *kobj,
+					     struct kobj_attribute *attr,
+					     const char *buf, size_t count)
+{
+	unsigned int rate;
+	ssize_t ret;
+
+	ret = kstrtouint(buf, 0, &rate);
+	if (ret)
+		return ret;
+
+	WRITE_ONCE(promote_rate_limit_mbps, rate);
+	return count;
+}
+
+static struct kobj_attribute numa_promote_rate_limit_attr =
+	__ATTR_RW(promote_rate_limit_MBps);
+
 static struct attribute *numa_attrs[] = {
 	&numa_demotion_enabled_attr.attr,
+	&numa_promote_rate_limit_attr.attr,
 	NULL,
 };
 
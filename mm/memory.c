@@ -1494,6 +1494,39 @@ zap_install_uffd_wp_if_needed(struct vm_area_struct *vma,
 	return was_installed;
 }
 
+/*
+ * Per-VMA fault-around state: the page-aligned address a sequential
+ * fault is expected at next, and the window order plus one in the low
+ * bits (0 means the VMA has not faulted around yet).
+ */
+#define FAULT_AROUND_ORDER_MASK		0xfUL
+#define FAULT_AROUND_ORDER(info)	(((info) & FAULT_AROUND_ORDER_MASK) - 1)
+#define FAULT_AROUND_ADDR(info)		((info) & PAGE_MASK)
+#define FAULT_AROUND_VAL(addr, order)	(((addr) & PAGE_MASK) | ((order) + 1))
+#define FAULT_AROUND_MAX_ORDER		min(PMD_SHIFT - PAGE_SHIFT, 14)
+
+/*
+ * A file PTE is being zapped without ever having been accessed; most
+ * likely it was mapped by fault-around and never used, so shrink the
+ * VMA's window.
+ */
+static inline void fault_around_unused(struct vm_area_struct *vma,
+				       unsigned int nr)
+{
+	unsigned long info = atomic_long_read(&vma->fault_around_info);
+
+	if (!(info & FAULT_AROUND_ORDER_MASK))
+		return;
+
+	count_vm_events(FAULT_AROUND_UNUSED, nr);
+	if (FAULT_AROUND_ORDER(info)) {
+		atomic_long_set(&vma->fault_around_info,
+				FAULT_AROUND_VAL(FAULT_AROUND_ADDR(info),
+						 FAULT_AROUND_ORDER(info) - 1));
+		count_vm_event(FAULT_AROUND_SHRINK);
+	}
+}
+
 static __always_inline void zap_present_folio_ptes(struct mmu_gather *tlb,
 		struct vm_area_struct *vma, struct folio *folio,
 		struct page *page, pte_t *pte, pte_t ptent, unsigned int nr,
@@ -1512,8 +1545,13 @@ static __always_inline void zap_present_folio_ptes(struct mmu_gather *tlb,
 				*force_flush = true;
 			}
 		}
-		if (pte_young(ptent) && likely(vma_has_recency(vma)))
-			folio_mark_accessed(folio);
+		if (pte_young(ptent)) {
+			if (likely(vma_has_recency(vma)))
+				folio_mark_accessed(folio);
+		} else if (!tlb->fullmm && vma->vm_ops &&
+			   vma->vm_ops->map_pages) {
+			fault_around_unused(vma, nr);
+		}
 		rss[mm_counter(folio)] -= nr;
 	} else {
 		/* We don't need up-to-date accessed/dirty bits. */
@@ -4197,7 +4235,11 @@ static inline unsigned long thp_swap_suitable_orders(pgoff_t swp_offset,
 	return orders;
 }
 
-static struct folio *alloc_swap_folio(struct vm_fault *vmf)
+/*
+ * Allocate and charge a large folio covering a naturally aligned run of
+ * contiguous swap entries around the fault, or return NULL.
+ */
+static struct folio *alloc_swap_folio_large(struct vm_fault *vmf)
 {
 	struct vm_area_struct *vma = vmf->vma;
 	unsigned long orders;
@@ -4214,7 +4256,7 @@ static struct folio *alloc_swap_folio(struct vm_fault *vmf)
 	 * maintain the uffd semantics.
 	 */
 	if (unlikely(userfaultfd_armed(vma)))
-		goto fallback;
+		return NULL;
 
 	/*
 	 * A large swapped out folio could be partially or fully in zswap. We
@@ -4222,7 +4264,7 @@ static struct folio *alloc_swap_folio(struct vm_fault *vmf)
 	 * folio.
 	 */
 	if (!zswap_never_enabled())
-		goto fallback;
+		return NULL;
 
 	entry = pte_to_swp_entry(vmf->orig_pte);
 	/*
@@ -4236,12 +4278,12 @@ static struct folio *alloc_swap_folio(struct vm_fault *vmf)
 					  vmf->address, orders);
 
 	if (!orders)
-		goto fallback;
+		return NULL;
 
 	pte = pte_offset_map_lock(vmf->vma->vm_mm, vmf->pmd,
 				  vmf->address & PMD_MASK, &ptl);
 	if (unlikely(!pte))
-		goto fallback;
+		return NULL;
 
 	/*
 	 * For do_swap_page, find the highest order where the aligned range is
@@ -4273,10 +4315,69 @@ static struct folio *alloc_swap_folio(struct vm_fault *vmf)
 		order = next_order(&orders, order);
 	}
 
+	return NULL;
+}
+
+/*
+ * Swap in a large folio through the swap cache, for swap devices that are
+ * read asynchronously: the whole run of entries is added to the swap cache
+ * and read with a single swap_read_folio().  Returns NULL if the caller
+ * should fall back to order-0 swapin readahead.
+ */
+static struct folio *swapin_large_folio(struct vm_fault *vmf,
+					swp_entry_t entry)
+{
+	struct folio *folio;
+	void *shadow = NULL;
+	int nr, order;
+
+	folio = alloc_swap_folio_large(vmf);
+	if (!folio)
+		return NULL;
+
+	nr = folio_nr_pages(folio);
+	order = folio_order(folio);
+	entry.val = ALIGN_DOWN(entry.val, nr);
+
+	__folio_set_locked(folio);
+	__folio_set_swapbacked(folio);
+
+	/* Somebody else is swapping in part of the range: let them */
+	if (swapcache_prepare(entry, nr))
+		goto fallback;
+
+	/* May fail (-ENOMEM) if XArray node allocation failed. */
+	if (add_to_swap_cache(folio, entry, GFP_KERNEL, &shadow)) {
+		put_swap_folio(folio, entry);
+		goto fallback;
+	}
+
+	mem_cgroup_swapin_uncharge_swap(entry, nr);
+	if (shadow)
+		workingset_refault(folio, shadow);
+
+	folio_add_lru(folio);
+	swap_read_folio(folio, NULL);
+	return folio;
+
 fallback:
-	return __alloc_swap_folio(vmf);
+	count_mthp_stat(order, MTHP_STAT_SWPIN_FALLBACK);
+	folio_unlock(folio);
+	folio_put(folio);
+	return NULL;
+}
+
+static struct folio *alloc_swap_folio(struct vm_fault *vmf)
+{
+	return alloc_swap_folio_large(vmf) ?: __alloc_swap_folio(vmf);
 }
 #else /* !CONFIG_TRANSPARENT_HUGEPAGE */
+static struct folio *swapin_large_folio(struct vm_fault *vmf,
+					swp_entry_t entry)
+{
+	return NULL;
+}
+
 static struct folio *alloc_swap_folio(struct vm_fault *vmf)
 {
 	return __alloc_swap_folio(vmf);
@@ -4422,8 +4523,10 @@ vm_fault_t do_swap_page(struct vm_fault *vmf)
 				folio->private = NULL;
 			}
 		} else {
-			folio = swapin_readahead(entry, GFP_HIGHUSER_MOVABLE,
-						vmf);
+			folio = swapin_large_folio(vmf, entry);
+			if (!folio)
+				folio = swapin_readahead(entry,
+						GFP_HIGHUSER_MOVABLE, vmf);
 			swapcache = folio;
 		}
 
@@ -5341,32 +5444,64 @@ late_initcall(fault_around_debugfs);
  * fault_around_pages * PAGE_SIZE rounded down to the machine page size
  * (and therefore to page order).  This way it's easier to guarantee
  * that we don't cross page table boundaries.
+ *
+ * fault_around_pages is only where each VMA starts: a fault right behind
+ * the previous window doubles the VMA's window, up to a whole page table,
+ * and maps forward from the fault address; any other fault halves it,
+ * down to a single page.  File PTEs zapped without having been accessed
+ * shrink it as well, see fault_around_unused().
  */
 static vm_fault_t do_fault_around(struct vm_fault *vmf)
 {
-	pgoff_t nr_pages = READ_ONCE(fault_around_pages);
+	struct vm_area_struct *vma = vmf->vma;
+	unsigned long info = atomic_long_read(&vma->fault_around_info);
+	unsigned long addr = vmf->address & PAGE_MASK, next;
+	unsigned int order = ilog2(READ_ONCE(fault_around_pages));
 	pgoff_t pte_off = pte_index(vmf->address);
 	/* The page offset of vmf->address within the VMA. */
-	pgoff_t vma_off = vmf->pgoff - vmf->vma->vm_pgoff;
-	pgoff_t from_pte, to_pte;
+	pgoff_t vma_off = vmf->pgoff - vma->vm_pgoff;
+	pgoff_t nr_pages, from_pte, to_pte;
+	bool sequential = false;
 	vm_fault_t ret;
 
+	if (info & FAULT_AROUND_ORDER_MASK) {
+		order = FAULT_AROUND_ORDER(info);
+		if (addr == FAULT_AROUND_ADDR(info)) {
+			sequential = true;
+			if (order < FAULT_AROUND_MAX_ORDER) {
+				order++;
+				count_vm_event(FAULT_AROUND_GROW);
+			}
+		} else if (order) {
+			order--;
+			count_vm_event(FAULT_AROUND_SHRINK);
+		}
+	}
+	nr_pages = 1UL << order;
+
 	/* The PTE offset of the start address, clamped to the VMA. */
-	from_pte = max(ALIGN_DOWN(pte_off, nr_pages),
-		       pte_off - min(pte_off, vma_off));
+	if (sequential)
+		from_pte = pte_off;
+	else
+		from_pte = max(ALIGN_DOWN(pte_off, nr_pages),
+			       pte_off - min(pte_off, vma_off));
 
 	/* The PTE offset of the end address, clamped to the VMA and PTE. */
 	to_pte = min3(from_pte + nr_pages, (pgoff_t)PTRS_PER_PTE,
-		      pte_off + vma_pages(vmf->vma) - vma_off) - 1;
+		      pte_off + vma_pages(vma) - vma_off) - 1;
+
+	/* A fault right behind this window is the next sequential one. */
+	next = addr + ((to_pte - pte_off + 1) << PAGE_SHIFT);
+	atomic_long_set(&vma->fault_around_info, FAULT_AROUND_VAL(next, order));
 
 	if (pmd_none(*vmf->pmd)) {
-		vmf->prealloc_pte = pte_alloc_one(vmf->vma->vm_mm);
+		vmf->prealloc_pte = pte_alloc_one(vma->vm_mm);
 		if (!vmf->prealloc_pte)
 			return VM_FAULT_OOM;
 	}
 
 	rcu_read_lock();
-	ret = vmf->vma->vm_ops->map_pages(vmf,
+	ret = vma->vm_ops->map_pages(vmf,
 			vmf->pgoff + from_pte - pte_off,
 			vmf->pgoff + to_pte - pte_off);
 	rcu_read_unlock();
@@ -42,6 +42,8 @@
 #include <linux/ptrace.h>
 #include <linux/memory.h>
 #include <linux/sched/sysctl.h>
+#include <linux/sysctl.h>
+#include <linux/workqueue.h>
 #include <linux/memory-tiers.h>
 #include <linux/pagewalk.h>
 
@@ -598,6 +600,123 @@ static int __folio_migrate_mapping(struct address_space *mapping,
 	return MIGRATEPAGE_SUCCESS;
 }
 
+/*
+ * Multi-threaded folio copy.
+ *
+ * Copying a large folio between memory tiers is bound by what one CPU can
+ * move.  With vm.migrate_copy_threads > 1, folios of at least
+ * MIGRATE_MT_COPY_MIN_NR pages are split into that many chunks, all but
+ * one of which are copied by unbound workers near the destination node
+ * while the migrating task copies the remaining one.  Reclaim always
+ * copies single-threaded.
+ */
+#define MIGRATE_MT_COPY_MIN_NR		(SZ_2M >> PAGE_SHIFT)
+#define MIGRATE_MT_COPY_MAX_THREADS	8
+
+static int sysctl_migrate_copy_threads __read_mostly = 1;
+static const int migrate_copy_threads_max = MIGRATE_MT_COPY_MAX_THREADS;
+
+struct migrate_copy_work {
+	struct work_struct work;
+	struct folio *dst;
+	struct folio *src;
+	long start;
+	long nr;
+	int rc;
+};
+
+static int migrate_copy_chunk(struct folio *dst, struct folio *src,
+			      long start, long nr)
+{
+	long i;
+
+	for (i = start; i < start + nr; i++) {
+		if (copy_mc_highpage(folio_page(dst, i), folio_page(src, i)))
+			return -EHWPOISON;
+		cond_resched();
+	}
+
+	return 0;
+}
+
+static void migrate_copy_workfn(struct work_struct *work)
+{
+	struct migrate_copy_work *mcw =
+		container_of(work, struct migrate_copy_work, work);
+
+	mcw->rc = migrate_copy_chunk(mcw->dst, mcw->src, mcw->start, mcw->nr);
+}
+
+static int migrate_folio_copy(struct folio *dst, struct folio *src)
+{
+	struct migrate_copy_work works[MIGRATE_MT_COPY_MAX_THREADS - 1];
+	int nr_threads = READ_ONCE(sysctl_migrate_copy_threads);
+	long nr = folio_nr_pages(src);
+	long chunk, start = 0;
+	int i, rc;
+
+	/*
+	 * system_unbound_wq is not WQ_MEM_RECLAIM: from reclaim, such as
+	 * kswapd demotion, waiting on it could stall behind worker creation.
+	 */
+	if (current_is_kswapd() || (current->flags & PF_MEMALLOC))
+		nr_threads = 1;
+
+	if (nr_threads <= 1 || nr < MIGRATE_MT_COPY_MIN_NR) {
+		rc = folio_mc_copy(dst, src);
+		if (!rc)
+			count_vm_events(PGMIGRATE_COPY_CPU, nr);
+		return rc;
+	}
+
+	chunk = DIV_ROUND_UP(nr, nr_threads);
+	for (i = 0; i < nr_threads - 1; i++) {
+		struct migrate_copy_work *mcw = &works[i];
+
+		INIT_WORK_ONSTACK(&mcw->work, migrate_copy_workfn);
+		mcw->dst = dst;
+		mcw->src = src;
+		mcw->start = start;
+		mcw->nr = min(chunk, nr - start);
+		start += mcw->nr;
+		queue_work_node(folio_nid(dst), system_unbound_wq, &mcw->work);
+	}
+
+	rc = migrate_copy_chunk(dst, src, start, nr - start);
+	if (!rc)
+		count_vm_events(PGMIGRATE_COPY_CPU, nr - start);
+
+	for (i = 0; i < nr_threads - 1; i++) {
+		flush_work(&works[i].work);
+		destroy_work_on_stack(&works[i].work);
+		if (works[i].rc)
+			rc = works[i].rc;
+		else
+			count_vm_events(PGMIGRATE_COPY_MT, works[i].nr);
+	}
+
+	return rc;
+}
+
+static const struct ctl_table migrate_sysctl_table[] = {
+	{
+		.procname	= "migrate_copy_threads",
+		.data		= &sysctl_migrate_copy_threads,
+		.maxlen		= sizeof(sysctl_migrate_copy_threads),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= SYSCTL_ONE,
+		.extra2		= (void *)&migrate_copy_threads_max,
+	},
+};
+
+static int __init migrate_sysctl_init(void)
+{
+	register_sysctl_init("vm", migrate_sysctl_table);
+	return 0;
+}
+late_initcall(migrate_sysctl_init);
+
 int folio_migrate_mapping(struct address_space *mapping,
 		struct folio *newfolio, struct folio *folio, int extra_count)
 {
@@ -623,7 +742,7 @@ int migrate_huge_page_move_mapping(struct address_space *mapping,
 	if (folio_ref_count(src) != expected_count)
 		return -EAGAIN;
 
-	rc = folio_mc_copy(dst, src);
+	rc = migrate_folio_copy(dst, src);
 	if (unlikely(rc))
 		return rc;
 
@@ -755,7 +874,7 @@ static int __migrate_folio(struct address_space *mapping, struct folio *dst,
 	if (folio_ref_count(src) != expected_count)
 		return -EAGAIN;
 
-	rc = folio_mc_copy(dst, src);
+	rc = migrate_folio_copy(dst, src);
 	if (unlikely(rc))
 		return rc;
 
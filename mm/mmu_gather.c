@@ -4,11 +4,16 @@
 #include <linux/mmdebug.h>
 #include <linux/mm_types.h>
 #include <linux/mm_inline.h>
+#include <linux/mmu_notifier.h>
 #include <linux/pagemap.h>
 #include <linux/rcupdate.h>
+#include <linux/sched/mm.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
 #include <linux/smp.h>
 #include <linux/swap.h>
 #include <linux/rmap.h>
+#include <linux/workqueue.h>
 
 #include <asm/pgalloc.h>
 #include <asm/tlb.h>
@@ -396,6 +401,235 @@ void tlb_flush_mmu(struct mmu_gather *tlb)
 	tlb_flush_mmu_free(tlb);
 }
 
+#if defined(tlb_flush_deferred) && defined(CONFIG_SMP) && \
+	!defined(CONFIG_MMU_GATHER_NO_GATHER)
+
+/*
+ * Deferred TLB shootdown (PR_SET_DEFERRED_TLB_FLUSH).
+ *
+ * Processes that munmap() or MADV_DONTNEED small ranges at a high rate pay
+ * for a remote flush per call.  Once opted in, tlb_finish_mmu() of the mm's
+ * own threads asks the arch to flush the gathered range.  As long as no
+ * other CPU is actively running the mm, only the local TLB is flushed, and
+ * the page batches are handed over to a delayed work item that issues a
+ * single flush_tlb_mm() for everything unmapped in the meantime, at most
+ * TLB_DEFER_DELAY later, and only then frees the pages.  The remaining CPUs
+ * in mm_cpumask() catch up on their next switch to the mm.  If another CPU
+ * does run the mm, the arch does a regular shootdown before returning and
+ * the pages are freed right away: a thread must never be able to write to
+ * a page through a stale entry once munmap() has returned.
+ *
+ * Anything that frees page tables, needs delayed rmap removal or has
+ * secondary TLBs attached is flushed synchronously as usual.
+ */
+struct tlb_defer {
+	spinlock_t lock;
+	bool enabled;
+	/* work is queued or running and holds a reference on @mm */
+	bool armed;
+	struct mm_struct *mm;
+	struct mmu_gather_batch *batches;
+	unsigned int nr_batches;
+	struct delayed_work work;
+	atomic_long_t nr_deferred;
+	atomic_long_t nr_shootdowns;
+};
+
+#define TLB_DEFER_DELAY		1
+#define TLB_DEFER_MAX_BATCHES	32
+
+static void tlb_defer_workfn(struct work_struct *work)
+{
+	struct tlb_defer *td = container_of(to_delayed_work(work),
+					    struct tlb_defer, work);
+	struct mm_struct *mm = td->mm;
+	struct mmu_gather_batch *batch, *next;
+
+	spin_lock(&td->lock);
+	batch = td->batches;
+	td->batches = NULL;
+	td->nr_batches = 0;
+	td->armed = false;
+	spin_unlock(&td->lock);
+
+	flush_tlb_mm(mm);
+	atomic_long_inc(&td->nr_shootdowns);
+
+	for (; batch; batch = next) {
+		next = batch->next;
+		__tlb_batch_free_encoded_pages(batch);
+		free_pages((unsigned long)batch, 0);
+	}
+
+	/* May free @td */
+	mmdrop(mm);
+}
+
+/*
+ * Try to replace the shootdown of tlb_finish_mmu() by a local flush plus a
+ * deferred one.  Returns false if the caller has to flush as usual.
+ */
+static bool tlb_defer_flush_mmu(struct mmu_gather *tlb)
+{
+	struct mm_struct *mm = tlb->mm;
+	struct tlb_defer *td = READ_ONCE(mm->tlb_defer);
+	struct mmu_gather_batch *head = NULL, *tail = NULL, *batch = NULL, *b;
+	unsigned int nr = 0;
+
+	if (!td || !READ_ONCE(td->enabled))
+		return false;
+	if (tlb->fullmm || tlb->freed_tables || tlb->need_flush_all ||
+	    tlb->delayed_rmap || !tlb->end)
+		return false;
+	if (mm != current->mm || mm_has_notifiers(mm))
+		return false;
+
+	/* The on-stack local batch cannot outlive the mmu_gather */
+	if (tlb->local.nr) {
+		batch = (void *)__get_free_page(GFP_NOWAIT | __GFP_NOWARN);
+		if (!batch)
+			return false;
+		batch->next = NULL;
+		batch->nr = tlb->local.nr;
+		batch->max = MAX_GATHER_BATCH;
+		memcpy(batch->encoded_pages, tlb->local.encoded_pages,
+		       tlb->local.nr * sizeof(tlb->local.encoded_pages[0]));
+	}
+
+	if (!tlb_flush_deferred(tlb)) {
+		/* Every CPU running the mm has been flushed already */
+		if (batch)
+			free_pages((unsigned long)batch, 0);
+		__tlb_reset_range(tlb);
+		tlb_flush_mmu_free(tlb);
+		return true;
+	}
+	__tlb_reset_range(tlb);
+
+	/* Steal the used batches, leave the spare ones to the caller */
+	if (tlb->active != &tlb->local) {
+		head = tlb->local.next;
+		tail = tlb->active;
+		tlb->local.next = tail->next;
+		tail->next = NULL;
+		for (b = head; b; b = b->next)
+			nr++;
+	}
+	if (batch) {
+		batch->next = head;
+		head = batch;
+		if (!tail)
+			tail = batch;
+		nr++;
+	}
+	tlb->local.nr = 0;
+	tlb->active = &tlb->local;
+
+	spin_lock(&td->lock);
+	if (head) {
+		tail->next = td->batches;
+		td->batches = head;
+		td->nr_batches += nr;
+	}
+	if (!td->armed) {
+		td->armed = true;
+		mmgrab(mm);
+		queue_delayed_work(system_wq, &td->work,
+				   td->nr_batches > TLB_DEFER_MAX_BATCHES ?
+				   0 : TLB_DEFER_DELAY);
+	} else if (td->nr_batches > TLB_DEFER_MAX_BATCHES) {
+		mod_delayed_work(system_wq, &td->work, 0);
+	}
+	spin_unlock(&td->lock);
+
+	atomic_long_inc(&td->nr_deferred);
+	return true;
+}
+
+int tlb_defer_set(struct mm_struct *mm, bool enable)
+{
+	struct tlb_defer *td = READ_ONCE(mm->tlb_defer);
+
+	if (!td) {
+		if (!enable)
+			return 0;
+
+		td = kzalloc(sizeof(*td), GFP_KERNEL_ACCOUNT);
+		if (!td)
+			return -ENOMEM;
+		spin_lock_init(&td->lock);
+		INIT_DELAYED_WORK(&td->work, tlb_defer_workfn);
+		td->mm = mm;
+
+		/* Installed once, freed together with the mm */
+		if (cmpxchg(&mm->tlb_defer, NULL, td)) {
+			kfree(td);
+			td = READ_ONCE(mm->tlb_defer);
+		}
+	}
+
+	WRITE_ONCE(td->enabled, enable);
+	if (!enable) {
+		spin_lock(&td->lock);
+		if (td->armed)
+			mod_delayed_work(system_wq, &td->work, 0);
+		spin_unlock(&td->lock);
+		flush_delayed_work(&td->work);
+	}
+	return 0;
+}
+
+bool tlb_defer_get(struct mm_struct *mm)
+{
+	struct tlb_defer *td = READ_ONCE(mm->tlb_defer);
+
+	return td && READ_ONCE(td->enabled);
+}
+
+/* Called from __mmdrop(), the work can no longer be armed */
+void tlb_defer_free(struct mm_struct *mm)
+{
+	kfree(mm->tlb_defer);
+}
+
+void tlb_defer_report(struct seq_file *m, struct mm_struct *mm)
+{
+	struct tlb_defer *td = READ_ONCE(mm->tlb_defer);
+
+	if (!td)
+		return;
+	seq_printf(m, "TlbDeferred:\t%lu\nTlbShootdowns:\t%lu\n",
+		   atomic_long_read(&td->nr_deferred),
+		   atomic_long_read(&td->nr_shootdowns));
+}
+
+#else /* !tlb_flush_deferred */
+
+static inline bool tlb_defer_flush_mmu(struct mmu_gather *tlb)
+{
+	return false;
+}
+
+int tlb_defer_set(struct mm_struct *mm, bool enable)
+{
+	return enable ? -EOPNOTSUPP : 0;
+}
+
+bool tlb_defer_get(struct mm_struct *mm)
+{
+	return false;
+}
+
+void tlb_defer_free(struct mm_struct *mm)
+{
+}
+
+void tlb_defer_report(struct seq_file *m, struct mm_struct *mm)
+{
+}
+
+#endif /* tlb_flush_deferred */
+
 static void __tlb_gather_mmu(struct mmu_gather *tlb, struct mm_struct *mm,
 			     bool fullmm)
 {
@@ -485,7 +719,8 @@ void tlb_finish_mmu(struct mmu_gather *tlb)
 		tlb->freed_tables = 1;
 	}
 
-	tlb_flush_mmu(tlb);
+	if (!tlb_defer_flush_mmu(tlb))
+		tlb_flush_mmu(tlb);
 
 #ifndef CONFIG_MMU_GATHER_NO_GATHER
 	tlb_batch_list_free(tlb);
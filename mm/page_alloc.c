@@ -515,11 +515,14 @@ static inline unsigned int order_to_pindex(int migratetype, int order)
 
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
 	if (order > PAGE_ALLOC_COSTLY_ORDER) {
-		VM_BUG_ON(order != HPAGE_PMD_ORDER);
-
 		movable = migratetype == MIGRATE_MOVABLE;
 
-		return NR_LOWORDER_PCP_LISTS + movable;
+		if (order == HPAGE_PMD_ORDER)
+			return NR_LOWORDER_PCP_LISTS + NR_PCP_MTHP + movable;
+
+		VM_BUG_ON(order > PCP_MAX_MTHP_ORDER);
+		return NR_LOWORDER_PCP_LISTS +
+			2 * (order - PAGE_ALLOC_COSTLY_ORDER - 1) + movable;
 	}
 #else
 	VM_BUG_ON(order > PAGE_ALLOC_COSTLY_ORDER);
@@ -533,8 +536,11 @@ static inline int pindex_to_order(unsigned int pindex)
 	int order = pindex / MIGRATE_PCPTYPES;
 
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
-	if (pindex >= NR_LOWORDER_PCP_LISTS)
+	if (pindex >= NR_LOWORDER_PCP_LISTS + NR_PCP_MTHP)
 		order = HPAGE_PMD_ORDER;
+	else if (pindex >= NR_LOWORDER_PCP_LISTS)
+		order = PAGE_ALLOC_COSTLY_ORDER + 1 +
+			(pindex - NR_LOWORDER_PCP_LISTS) / 2;
 #else
 	VM_BUG_ON(order > PAGE_ALLOC_COSTLY_ORDER);
 #endif
@@ -547,12 +553,27 @@ static inline bool pcp_allowed_order(unsigned int order)
 	if (order <= PAGE_ALLOC_COSTLY_ORDER)
 		return true;
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
-	if (order == HPAGE_PMD_ORDER)
+	if (order <= PCP_MAX_MTHP_ORDER || order == HPAGE_PMD_ORDER)
 		return true;
 #endif
 	return false;
 }
 
+/*
+ * High-order pages other than PMD-sized THPs can contribute to
+ * fragmentation when they pile up on the PCP lists.
+ */
+static inline bool pcp_limit_high_order(unsigned int order)
+{
+	if (!order)
+		return false;
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	if (order == HPAGE_PMD_ORDER)
+		return false;
+#endif
+	return true;
+}
+
 /*
  * Higher-order pages are called "compound pages".  They are structured thusly:
  *
@@ -2657,7 +2678,7 @@ static void free_frozen_page_commit(struct zone *zone,
 	 * freeing without allocation. The remainder after bulk freeing
 	 * stops will be drained from vmstat refresh context.
 	 */
-	if (order && order <= PAGE_ALLOC_COSTLY_ORDER) {
+	if (pcp_limit_high_order(order)) {
 		free_high = (pcp->free_count >= batch &&
 			     (pcp->flags & PCPF_PREV_FREE_HIGH_ORDER) &&
 			     (!(pcp->flags & PCPF_FREE_HIGH_BATCH) ||
@@ -3104,6 +3125,9 @@ static struct page *rmqueue_pcplist(struct zone *preferred_zone,
 	 */
 	pcp->free_count >>= 1;
 	list = &pcp->lists[order_to_pindex(migratetype, order)];
+	if (order)
+		count_mthp_stat(order, list_empty(list) ? MTHP_STAT_PCP_REFILL :
+							  MTHP_STAT_PCP_HIT);
 	page = __rmqueue_pcplist(zone, order, migratetype, alloc_flags, pcp, list);
 	pcp_spin_unlock(pcp);
 	pcp_trylock_finish(UP_flags);
@@ -108,6 +108,7 @@
 
 #define PCPU_EMPTY_POP_PAGES_LOW	2
 #define PCPU_EMPTY_POP_PAGES_HIGH	4
+#define PCPU_EMPTY_POP_PAGES_MAX	64
 
 #ifdef CONFIG_SMP
 /* default addr <-> pcpu_ptr mapping, override in asm/percpu.h if necessary */
@@ -179,6 +180,19 @@ struct list_head *pcpu_chunk_lists __ro_after_init; /* chunk list slots */
  */
 int pcpu_nr_empty_pop_pages;
 
+/*
+ * The number of empty populated pages the balance work tries to keep
+ * around.  It starts at PCPU_EMPTY_POP_PAGES_HIGH, doubles every time a
+ * sleepable allocation has to populate pages itself and decays back once
+ * such allocations stop, so that bursts of percpu allocations find their
+ * pages already populated.  Both are only changed under pcpu_lock.
+ * pcpu_balance_populated() drops the lock while populating and works from
+ * a snapshot of the target; a raise in the meantime is acted upon by its
+ * next run, which pcpu_alloc() schedules.
+ */
+static int pcpu_empty_pop_target = PCPU_EMPTY_POP_PAGES_HIGH;
+static bool pcpu_demand_populated;
+
 /*
  * The number of populated pages in use by the allocator, protected by
  * pcpu_lock.  This number is kept per a unit per chunk (i.e. when a page gets
@@ -1733,6 +1747,7 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 	gfp_t pcpu_gfp;
 	bool is_atomic;
 	bool do_warn;
+	bool fastpath;
 	struct obj_cgroup *objcg = NULL;
 	static int warn_limit = 10;
 	struct pcpu_chunk *chunk, *next;
@@ -1747,6 +1762,7 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 	pcpu_gfp = gfp & (GFP_KERNEL | __GFP_NORETRY | __GFP_NOWARN);
 	is_atomic = (gfp & GFP_KERNEL) != GFP_KERNEL;
 	do_warn = !(gfp & __GFP_NOWARN);
+	fastpath = false;
 
 	/*
 	 * There is now a minimum allocation size of PCPU_MIN_ALLOC_SIZE,
@@ -1771,6 +1787,37 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 	if (unlikely(!pcpu_memcg_pre_alloc_hook(size, gfp, &objcg)))
 		return NULL;
 
+	/*
+	 * Sleepable allocations first try the already populated pages
+	 * under pcpu_lock alone, exactly like atomic allocations do.  This
+	 * keeps the common case off pcpu_alloc_mutex, which the balance work
+	 * holds across page allocation and which serializes every chunk
+	 * creation.  Only if nothing populated fits do we take the mutex and
+	 * go through the regular path that may populate or create chunks.
+	 */
+	if (!is_atomic && !reserved) {
+		spin_lock_irqsave(&pcpu_lock, flags);
+		for (slot = pcpu_size_to_slot(size); slot <= pcpu_free_slot;
+		     slot++) {
+			list_for_each_entry(chunk, &pcpu_chunk_lists[slot],
+					    list) {
+				off = pcpu_find_block_fit(chunk, bits,
+							  bit_align, true);
+				if (off < 0)
+					continue;
+
+				off = pcpu_alloc_area(chunk, bits, bit_align,
+						      off);
+				if (off >= 0) {
+					pcpu_reintegrate_chunk(chunk);
+					fastpath = true;
+					goto area_found;
+				}
+			}
+		}
+		spin_unlock_irqrestore(&pcpu_lock, flags);
+	}
+
 	if (!is_atomic) {
 		/*
 		 * pcpu_balance_workfn() allocates memory under this mutex,
@@ -1852,14 +1899,16 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 area_found:
 	pcpu_stats_area_alloc(chunk, size);
 
-	if (pcpu_nr_empty_pop_pages < PCPU_EMPTY_POP_PAGES_LOW)
+	if (pcpu_nr_empty_pop_pages < max(PCPU_EMPTY_POP_PAGES_LOW,
+					  READ_ONCE(pcpu_empty_pop_target) / 2))
 		pcpu_schedule_balance_work();
 
 	spin_unlock_irqrestore(&pcpu_lock, flags);
 
 	/* populate if not all pages are already there */
-	if (!is_atomic) {
+	if (!is_atomic && !fastpath) {
 		unsigned int page_end, rs, re;
+		int target;
 
 		rs = PFN_DOWN(off);
 		page_end = PFN_UP(off + size);
@@ -1876,6 +1925,18 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 				goto fail_unlock;
 			}
 			pcpu_chunk_populated(chunk, rs, re);
+
+			/*
+			 * We had to populate on demand; have the balance
+			 * work populate further ahead for the next ones.
+			 */
+			WRITE_ONCE(pcpu_demand_populated, true);
+			target = READ_ONCE(pcpu_empty_pop_target);
+			if (target < PCPU_EMPTY_POP_PAGES_MAX)
+				WRITE_ONCE(pcpu_empty_pop_target,
+					   min(target * 2,
+					       PCPU_EMPTY_POP_PAGES_MAX));
+			pcpu_schedule_balance_work();
 			spin_unlock_irqrestore(&pcpu_lock, flags);
 		}
 
@@ -1997,7 +2058,7 @@ static void pcpu_balance_populated(void)
 	/* gfp flags passed to underlying allocators */
 	const gfp_t gfp = GFP_KERNEL | __GFP_NORETRY | __GFP_NOWARN;
 	struct pcpu_chunk *chunk;
-	int slot, nr_to_pop, ret;
+	int slot, nr_to_pop, target, ret;
 
 	lockdep_assert_held(&pcpu_lock);
 
@@ -2010,16 +2071,25 @@ static void pcpu_balance_populated(void)
 	 * failing indefinitely; however, large atomic allocs are not
 	 * something we support properly and can be highly unreliable and
 	 * inefficient.
+	 *
+	 * The target grows while sleepable allocations keep populating on
+	 * demand and halves on every run that saw no such allocation.
 	 */
+	target = READ_ONCE(pcpu_empty_pop_target);
+	if (!READ_ONCE(pcpu_demand_populated)) {
+		target = max(target / 2, PCPU_EMPTY_POP_PAGES_HIGH);
+		WRITE_ONCE(pcpu_empty_pop_target, target);
+	}
+	WRITE_ONCE(pcpu_demand_populated, false);
+
 retry_pop:
 	if (pcpu_atomic_alloc_failed) {
-		nr_to_pop = PCPU_EMPTY_POP_PAGES_HIGH;
+		nr_to_pop = target;
 		/* best effort anyway, don't worry about synchronization */
 		pcpu_atomic_alloc_failed = false;
 	} else {
-		nr_to_pop = clamp(PCPU_EMPTY_POP_PAGES_HIGH -
-				  pcpu_nr_empty_pop_pages,
-				  0, PCPU_EMPTY_POP_PAGES_HIGH);
+		nr_to_pop = clamp(target - pcpu_nr_empty_pop_pages,
+				  0, target);
 	}
 
 	for (slot = pcpu_size_to_slot(PAGE_SIZE); slot <= pcpu_free_slot; slot++) {
@@ -2119,7 +2189,8 @@ static void pcpu_reclaim_populated(void)
 				break;
 
 			/* reintegrate chunk to prevent atomic alloc failures */
-			if (pcpu_nr_empty_pop_pages < PCPU_EMPTY_POP_PAGES_HIGH) {
+			if (pcpu_nr_empty_pop_pages <
+			    READ_ONCE(pcpu_empty_pop_target)) {
 				reintegrate = true;
 				break;
 			}
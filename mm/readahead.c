@@ -128,6 +128,7 @@
 #include <linux/blk-cgroup.h>
 #include <linux/fadvise.h>
 #include <linux/sched/mm.h>
+#include <linux/slab.h>
 
 #include "internal.h"
 
@@ -143,6 +144,16 @@ file_ra_state_init(struct file_ra_state *ra, struct address_space *mapping)
 }
 EXPORT_SYMBOL_GPL(file_ra_state_init);
 
+/*
+ * Free the stream table of a file's f_ra.  Must be called once the last
+ * reference to the file is gone, before f_ra's space is reused.
+ */
+void file_ra_state_release(struct file_ra_state *ra)
+{
+	kfree(ra->streams);
+	ra->streams = NULL;
+}
+
 static void read_pages(struct readahead_control *rac)
 {
 	const struct address_space_operations *aops = rac->mapping->a_ops;
@@ -533,6 +544,187 @@ void page_cache_ra_order(struct readahead_control *ractl,
 				 ra->async_size);
 }
 
+/*
+ * Stream tracking.
+ *
+ * prev_pos only describes the most recent read, so interleaved sequential
+ * streams and reads with a constant stride look random to the heuristics
+ * below.  Each file_ra_state therefore also remembers the last few streams
+ * of reads that missed the page cache.  Once the same stride has been seen
+ * RA_STREAM_CONFIRM times in a row, the next reads of the stream are
+ * predicted and read ahead, with the first folio of every predicted read
+ * marked PG_readahead so that consuming it pushes the prediction one stride
+ * further.
+ */
+#define RA_STREAM_CONFIRM	2
+#define RA_STREAM_MAX_DEPTH	8
+
+static bool ra_stream_confirmed(struct file_ra_stream *stream)
+{
+	return stream->stride && stream->hits >= RA_STREAM_CONFIRM;
+}
+
+static void ra_stream_forget(struct file_ra_stream *stream)
+{
+	if (ra_stream_confirmed(stream) && stream->depth)
+		count_vm_events(RA_STREAM_WASTED, stream->depth * stream->nr);
+	memset(stream, 0, sizeof(*stream));
+}
+
+/*
+ * Most files are only ever read sequentially, so the stream table is only
+ * allocated on the first miss that does not continue prev_pos.  Only a
+ * file's own f_ra gets one: file_ra_state_release() frees it on the final
+ * fput(), while other file_ra_states have nobody to free it.
+ */
+static struct file_ra_stream *ra_streams_get(struct readahead_control *ractl)
+{
+	struct file_ra_state *ra = ractl->ra;
+	struct file_ra_stream *streams = READ_ONCE(ra->streams);
+
+	if (streams)
+		return streams;
+	if (!ractl->file || ra != &ractl->file->f_ra)
+		return NULL;
+
+	streams = kcalloc(RA_NR_STREAMS, sizeof(*streams),
+			  GFP_NOWAIT | __GFP_NOWARN);
+	if (!streams)
+		return NULL;
+
+	/* Readahead state is not locked, another reader may have won */
+	if (cmpxchg(&ra->streams, NULL, streams)) {
+		kfree(streams);
+		streams = READ_ONCE(ra->streams);
+	}
+	return streams;
+}
+
+/*
+ * Note a read of @nr pages at @index that missed the page cache, and return
+ * the stream it continues at the expected stride, if any.  @sequential
+ * tells that the read continues prev_pos.
+ */
+static struct file_ra_stream *ra_stream_update(struct readahead_control *ractl,
+		pgoff_t index, unsigned long nr, bool sequential)
+{
+	struct file_ra_stream *streams = READ_ONCE(ractl->ra->streams);
+	struct file_ra_stream *stream, *train = NULL, *victim = NULL;
+	int i;
+
+	if (!streams) {
+		if (sequential)
+			return NULL;
+		streams = ra_streams_get(ractl);
+		if (!streams)
+			return NULL;
+	}
+
+	nr = min_t(unsigned long, nr, USHRT_MAX);
+
+	for (i = 0; i < RA_NR_STREAMS; i++) {
+		stream = &streams[i];
+
+		if (stream->nr && stream->stride &&
+		    index == stream->index + stream->stride) {
+			stream->index = index;
+			stream->nr = nr;
+			if (stream->hits < U8_MAX)
+				stream->hits++;
+			if (stream->depth)
+				stream->depth--;
+			return stream;
+		}
+
+		/*
+		 * An unconfirmed stream just before @index may continue
+		 * with a new stride.
+		 */
+		if (stream->nr && !ra_stream_confirmed(stream) &&
+		    index > stream->index &&
+		    index - stream->index <= UINT_MAX &&
+		    (!train || stream->index > train->index))
+			train = stream;
+
+		if (!victim || stream->hits < victim->hits)
+			victim = stream;
+	}
+
+	if (train) {
+		train->stride = index - train->index;
+		train->index = index;
+		train->nr = nr;
+		train->hits = 1;
+		return train;
+	}
+
+	count_vm_event(RA_STREAM_MISS);
+
+	/* Age the confirmed streams so that dead ones get replaced */
+	for (i = 0; i < RA_NR_STREAMS; i++)
+		if (streams[i].hits)
+			streams[i].hits--;
+
+	ra_stream_forget(victim);
+	victim->index = index;
+	victim->nr = nr;
+	return NULL;
+}
+
+/*
+ * The first folio of a predicted read at @index was accessed: advance the
+ * stream that predicted it.
+ */
+static struct file_ra_stream *ra_stream_advance(struct file_ra_state *ra,
+		pgoff_t index)
+{
+	struct file_ra_stream *streams = READ_ONCE(ra->streams);
+	int i;
+
+	if (!streams)
+		return NULL;
+
+	for (i = 0; i < RA_NR_STREAMS; i++) {
+		struct file_ra_stream *stream = &streams[i];
+
+		if (ra_stream_confirmed(stream) &&
+		    index == stream->index + stream->stride) {
+			stream->index = index;
+			if (stream->hits < U8_MAX)
+				stream->hits++;
+			if (stream->depth)
+				stream->depth--;
+			return stream;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Read ahead the next reads of a confirmed stream, as many as fit into the
+ * readahead window.  Every read is issued on its own so that it can still
+ * use large folios.
+ */
+static void ra_stream_read(struct readahead_control *ractl,
+		struct file_ra_stream *stream, unsigned int order,
+		unsigned long max_pages)
+{
+	unsigned long depth = clamp_val(max_pages / stream->nr, 1,
+					RA_STREAM_MAX_DEPTH);
+	struct file_ra_state ra = {
+		.size = stream->nr,
+		.async_size = stream->nr,
+	};
+
+	count_vm_event(RA_STREAM_HIT);
+
+	while (stream->depth < depth) {
+		ractl->_index = stream->index + (stream->depth + 1) * stream->stride;
+		page_cache_ra_order(ractl, &ra, order);
+		stream->depth++;
+	}
+}
+
 static unsigned long ractl_max_pages(struct readahead_control *ractl,
 		unsigned long req_size)
 {
@@ -555,6 +747,7 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 	bool do_forced_ra = ractl->file && (ractl->file->f_mode & FMODE_RANDOM);
 	struct file_ra_state *ra = ractl->ra;
 	unsigned long max_pages, contig_count;
+	struct file_ra_stream *stream;
 	pgoff_t prev_index, miss;
 
 	/*
@@ -578,12 +771,16 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 
 	max_pages = ractl_max_pages(ractl, req_count);
 	prev_index = (unsigned long long)ra->prev_pos >> PAGE_SHIFT;
+	stream = ra_stream_update(ractl, index, req_count,
+				  !index || index - prev_index <= 1UL);
 	/*
 	 * A start of file, oversized read, or sequential cache miss:
 	 * trivial case: (index - prev_index) == 1
 	 * unaligned reads: (index - prev_index) == 0
+	 * interleaved reads: a tracked stream continues contiguously
 	 */
-	if (!index || req_count > max_pages || index - prev_index <= 1UL) {
+	if (!index || req_count > max_pages || index - prev_index <= 1UL ||
+	    (stream && stream->stride == stream->nr)) {
 		ra->start = index;
 		ra->size = get_init_ra_size(req_count, max_pages);
 		ra->async_size = ra->size > req_count ? ra->size - req_count :
@@ -591,6 +788,16 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 		goto readit;
 	}
 
+	/*
+	 * Strided reads: read the requested range, and what the stream is
+	 * expected to read next, without disturbing the readahead window.
+	 */
+	if (stream && ra_stream_confirmed(stream)) {
+		do_page_cache_ra(ractl, req_count, 0);
+		ra_stream_read(ractl, stream, 0, max_pages);
+		return;
+	}
+
 	/*
 	 * Query the page cache and look for the traces(cached history pages)
 	 * that a sequential stream would leave behind.
@@ -628,6 +835,7 @@ void page_cache_async_ra(struct readahead_control *ractl,
 	unsigned long max_pages;
 	struct file_ra_state *ra = ractl->ra;
 	pgoff_t index = readahead_index(ractl);
+	struct file_ra_stream *stream;
 	pgoff_t expected, start;
 	unsigned int order = folio_order(folio);
 
@@ -664,6 +872,13 @@ void page_cache_async_ra(struct readahead_control *ractl,
 		goto readit;
 	}
 
+	/* Hit the first folio of a predicted strided read */
+	stream = ra_stream_advance(ra, index);
+	if (stream) {
+		ra_stream_read(ractl, stream, order, max_pages);
+		return;
+	}
+
 	/*
 	 * Hit a marked folio without valid readahead state.
 	 * E.g. interleaved reads.
@@ -3,6 +3,9 @@
 #include <linux/rwsem.h>
 #include <linux/shrinker.h>
 #include <linux/rculist.h>
+#include <linux/sched/mm.h>
+#include <linux/sysctl.h>
+#include <linux/workqueue.h>
 #include <trace/events/vmscan.h>
 
 #include "internal.h"
@@ -368,6 +371,54 @@ static long add_nr_deferred(long nr, struct shrinker *shrinker,
 
 #define SHRINK_BATCH 128
 
+/*
+ * Every shrinker invocation that scans records how many objects it freed
+ * per millisecond, decayed over invocations, in shrinker->yield, and
+ * feeds the same into shrinker_yield_avg across all shrinkers.  Under
+ * light reclaim pressure, shrinkers yielding less than a quarter of the
+ * average are not scanned: their work is deferred into nr_deferred and
+ * carried over to the next invocation, by which point either pressure has
+ * risen or they have become worth it.  A skipped shrinker is scanned again
+ * once its yield sample is SHRINK_YIELD_RESAMPLE old, so that a single bad
+ * sample does not exclude it for good.  Pressure at or beyond
+ * SHRINK_COST_PRIORITY scans everything as before.
+ */
+#define SHRINK_COST_PRIORITY	(DEF_PRIORITY - 2)
+#define SHRINK_YIELD_RESAMPLE	HZ
+
+static unsigned long shrinker_yield_avg;
+
+static bool shrinker_low_yield(struct shrinker *shrinker)
+{
+	unsigned long avg = READ_ONCE(shrinker_yield_avg);
+
+	/* never scanned yet, nothing to go by */
+	if (!atomic64_read(&shrinker->scan_time_ns))
+		return false;
+
+	/* stale sample, take a new one */
+	if (time_after(jiffies, READ_ONCE(shrinker->yield_stamp) +
+			       SHRINK_YIELD_RESAMPLE))
+		return false;
+
+	return READ_ONCE(shrinker->yield) < avg / 4;
+}
+
+static void shrinker_account_cost(struct shrinker *shrinker,
+				  unsigned long freed, u64 ns)
+{
+	unsigned long sample;
+
+	atomic_long_add(freed, &shrinker->nr_freed);
+	atomic64_add(max_t(u64, ns, 1), &shrinker->scan_time_ns);
+
+	sample = div64_u64((u64)freed * NSEC_PER_MSEC, max_t(u64, ns, 1));
+	WRITE_ONCE(shrinker->yield, (3 * READ_ONCE(shrinker->yield) + sample) / 4);
+	WRITE_ONCE(shrinker->yield_stamp, jiffies);
+	WRITE_ONCE(shrinker_yield_avg,
+		   (7 * READ_ONCE(shrinker_yield_avg) + sample) / 8);
+}
+
 static unsigned long do_shrink_slab(struct shrink_control *shrinkctl,
 				    struct shrinker *shrinker, int priority)
 {
@@ -380,6 +431,7 @@ static unsigned long do_shrink_slab(struct shrink_control *shrinkctl,
 	long batch_size = shrinker->batch ? shrinker->batch
 					  : SHRINK_BATCH;
 	long scanned = 0, next_deferred;
+	u64 start;
 
 	freeable = shrinker->count_objects(shrinker, shrinkctl);
 	if (freeable == 0 || freeable == SHRINK_EMPTY)
@@ -409,6 +461,10 @@ static unsigned long do_shrink_slab(struct shrink_control *shrinkctl,
 	total_scan += delta;
 	total_scan = min(total_scan, (2 * freeable));
 
+	/* not worth it yet, see SHRINK_COST_PRIORITY */
+	if (priority > SHRINK_COST_PRIORITY && shrinker_low_yield(shrinker))
+		total_scan = 0;
+
 	trace_mm_shrink_slab_start(shrinker, shrinkctl, nr,
 				   freeable, delta, total_scan, priority);
 
@@ -427,6 +483,7 @@ static unsigned long do_shrink_slab(struct shrink_control *shrinkctl,
 	 * scanning at high prio and therefore should try to reclaim as much as
 	 * possible.
 	 */
+	start = ktime_get_ns();
 	while (total_scan >= batch_size ||
 	       total_scan >= freeable) {
 		unsigned long ret;
@@ -446,6 +503,9 @@ static unsigned long do_shrink_slab(struct shrink_control *shrinkctl,
 		cond_resched();
 	}
 
+	if (scanned)
+		shrinker_account_cost(shrinker, freed, ktime_get_ns() - start);
+
 	/*
 	 * The deferred work is increased by any new work (delta) that wasn't
 	 * done, decreased by old deferred work that was done now.
@@ -583,12 +643,120 @@ static unsigned long shrink_slab_memcg(gfp_t gfp_mask, int nid,
 	rcu_read_unlock();
 	return freed;
 }
+
+/*
+ * With many memcgs, kswapd spends much of a reclaim pass walking each
+ * memcg's shrinkers one after the other.  vm.shrink_slab_workers lets it
+ * queue up to that many memcg/node slab shrinks on an unbound workqueue
+ * instead and go on with the next memcg's LRUs.  The memcgs' list_lrus
+ * are separate per memcg and node, each under its own lock, so shrinking
+ * them concurrently is no different from concurrent direct reclaim.
+ */
+static int sysctl_shrink_slab_workers __read_mostly;
+static atomic_t shrink_slab_inflight = ATOMIC_INIT(0);
+static struct workqueue_struct *shrink_slab_wq;
+
+struct shrink_slab_work {
+	struct work_struct work;
+	struct mem_cgroup *memcg;
+	gfp_t gfp_mask;
+	int nid;
+	int priority;
+};
+
+static void shrink_slab_workfn(struct work_struct *work)
+{
+	struct shrink_slab_work *ssw =
+		container_of(work, struct shrink_slab_work, work);
+	unsigned int noreclaim_flag;
+
+	/* Like kswapd, don't let the shrinkers' allocations recurse */
+	noreclaim_flag = memalloc_noreclaim_save();
+	shrink_slab_memcg(ssw->gfp_mask, ssw->nid, ssw->memcg, ssw->priority);
+	memalloc_noreclaim_restore(noreclaim_flag);
+	mem_cgroup_put(ssw->memcg);
+	kfree(ssw);
+	atomic_dec(&shrink_slab_inflight);
+}
+
+/**
+ * shrink_slab_async - shrink a memcg's slab caches from a worker
+ * @gfp_mask: allocation context
+ * @nid: node whose slab caches to target
+ * @memcg: memory cgroup whose slab caches to target
+ * @priority: the reclaim priority
+ *
+ * Returns true if the shrink was queued; false if the caller has to call
+ * shrink_slab() itself, because workers are disabled or busy, or @memcg is
+ * the root cgroup, whose global shrinkers are never offloaded.
+ */
+bool shrink_slab_async(gfp_t gfp_mask, int nid, struct mem_cgroup *memcg,
+		       int priority)
+{
+	int max = READ_ONCE(sysctl_shrink_slab_workers);
+	struct shrink_slab_work *ssw;
+
+	if (!max || !shrink_slab_wq || mem_cgroup_disabled() ||
+	    mem_cgroup_is_root(memcg))
+		return false;
+
+	if (atomic_inc_return(&shrink_slab_inflight) > max)
+		goto out;
+
+	ssw = kmalloc(sizeof(*ssw),
+		      GFP_NOWAIT | __GFP_NOMEMALLOC | __GFP_NOWARN);
+	if (!ssw)
+		goto out;
+
+	if (!css_tryget_online(&memcg->css)) {
+		kfree(ssw);
+		goto out;
+	}
+
+	INIT_WORK(&ssw->work, shrink_slab_workfn);
+	ssw->memcg = memcg;
+	ssw->gfp_mask = gfp_mask;
+	ssw->nid = nid;
+	ssw->priority = priority;
+	queue_work_node(nid, shrink_slab_wq, &ssw->work);
+	return true;
+out:
+	atomic_dec(&shrink_slab_inflight);
+	return false;
+}
+
+static const struct ctl_table shrinker_sysctl_table[] = {
+	{
+		.procname	= "shrink_slab_workers",
+		.data		= &sysctl_shrink_slab_workers,
+		.maxlen		= sizeof(sysctl_shrink_slab_workers),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= SYSCTL_ZERO,
+		.extra2		= SYSCTL_ONE_THOUSAND,
+	},
+};
+
+static int __init shrinker_async_init(void)
+{
+	shrink_slab_wq = alloc_workqueue("shrink_slab",
+					 WQ_UNBOUND | WQ_MEM_RECLAIM, 0);
+	register_sysctl_init("vm", shrinker_sysctl_table);
+	return 0;
+}
+late_initcall(shrinker_async_init);
 #else /* !CONFIG_MEMCG */
 static unsigned long shrink_slab_memcg(gfp_t gfp_mask, int nid,
 			struct mem_cgroup *memcg, int priority)
 {
 	return 0;
 }
+
+bool shrink_slab_async(gfp_t gfp_mask, int nid, struct mem_cgroup *memcg,
+		       int priority)
+{
+	return false;
+}
 #endif /* CONFIG_MEMCG */
 
 /**
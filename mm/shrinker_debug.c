@@ -95,6 +95,19 @@ static int shrinker_debugfs_count_show(struct seq_file *m, void *v)
 }
 DEFINE_SHOW_ATTRIBUTE(shrinker_debugfs_count);
 
+static int shrinker_debugfs_cost_show(struct seq_file *m, void *v)
+{
+	struct shrinker *shrinker = m->private;
+
+	seq_printf(m, "freed %lu\nscan_time_us %llu\nyield_per_ms %lu\n",
+		   atomic_long_read(&shrinker->nr_freed),
+		   div_u64(atomic64_read(&shrinker->scan_time_ns),
+			   NSEC_PER_USEC),
+		   READ_ONCE(shrinker->yield));
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(shrinker_debugfs_cost);
+
 static int shrinker_debugfs_scan_open(struct inode *inode, struct file *file)
 {
 	file->private_data = inode->i_private;
@@ -190,6 +203,8 @@ int shrinker_debugfs_add(struct shrinker *shrinker)
 			    &shrinker_debugfs_count_fops);
 	debugfs_create_file("scan", 0220, entry, shrinker,
 			    &shrinker_debugfs_scan_fops);
+	debugfs_create_file("cost", 0440, entry, shrinker,
+			    &shrinker_debugfs_cost_fops);
 	return 0;
 }
 
@@ -372,6 +372,12 @@ enum stat_item {
 	CPU_PARTIAL_FREE,	/* Refill cpu partial on free */
 	CPU_PARTIAL_NODE,	/* Refill cpu partial from node partial */
 	CPU_PARTIAL_DRAIN,	/* Drain cpu partial to node partial */
+	ALLOC_PCS,		/* Allocation from percpu sheaf */
+	FREE_PCS,		/* Free to percpu sheaf */
+	SHEAF_REFILL,		/* Objects refilled to a sheaf */
+	SHEAF_FLUSH,		/* Objects flushed from a sheaf */
+	BARN_GET,		/* Got full sheaf from barn */
+	BARN_PUT,		/* Put full sheaf to barn */
 	NR_SLUB_STAT_ITEMS
 };
 
@@ -418,6 +424,20 @@ void stat_add(const struct kmem_cache *s, enum stat_item si, int v)
 #endif
 }
 
+#ifndef CONFIG_SLUB_TINY
+/*
+ * Per-node store of full and empty sheaves that did not fit on any cpu.
+ * Only used by caches with sheaves enabled.
+ */
+struct node_barn {
+	spinlock_t lock;
+	struct list_head sheaves_full;
+	struct list_head sheaves_empty;
+	unsigned int nr_full;
+	unsigned int nr_empty;
+};
+#endif
+
 /*
  * The slab lists for all objects.
  */
@@ -430,6 +450,9 @@ struct kmem_cache_node {
 	atomic_long_t total_objects;
 	struct list_head full;
 #endif
+#ifndef CONFIG_SLUB_TINY
+	struct node_barn barn;
+#endif
 };
 
 static inline struct kmem_cache_node *get_node(struct kmem_cache *s, int node)
@@ -3302,6 +3325,450 @@ static inline void __flush_cpu_slab(struct kmem_cache *s, int cpu)
 	put_partials_cpu(s, c);
 }
 
+/*
+ * Sheaves are an opt-in (see &kmem_cache_args.sheaf_capacity) per-cpu
+ * array cache of objects layered on top of the cpu slab. Each cpu owns a
+ * main sheaf that allocations are served from and frees are put to, and
+ * possibly a spare one. Sheaves are refilled and flushed in bulk, so the
+ * cost of the slow paths and of partial list locking is amortized over
+ * sheaf_capacity objects. Whole sheaves that do not fit on a cpu are
+ * exchanged through the per-node barn.
+ *
+ * Objects in sheaves are in the same state as objects on a cpu freelist:
+ * the alloc hooks run when they are handed out, the free hooks have run
+ * before they were put into a sheaf.
+ */
+struct slab_sheaf {
+	struct list_head barn_list;
+	unsigned int size;
+	void *objects[];
+};
+
+struct slub_percpu_sheaves {
+	local_lock_t lock;
+	struct slab_sheaf *main;	/* never NULL when sheaves are enabled */
+	struct slab_sheaf *spare;	/* empty or full, may be NULL */
+};
+
+#define MAX_FULL_SHEAVES	10
+#define MAX_EMPTY_SHEAVES	10
+
+static int __kmem_cache_alloc_bulk(struct kmem_cache *s, gfp_t flags,
+				   size_t size, void **p);
+static void __kmem_cache_free_bulk(struct kmem_cache *s, size_t size, void **p);
+
+static struct node_barn *get_barn(struct kmem_cache *s)
+{
+	struct kmem_cache_node *n = get_node(s, numa_mem_id());
+
+	return n ? &n->barn : NULL;
+}
+
+/*
+ * Sheaves come from kmalloc, which may itself have sheaves. Asking for a
+ * specific node makes the allocation bypass sheaves (see slab_alloc_node()),
+ * so refilling a cpu's sheaves never recurses into the pcs paths.
+ */
+static struct slab_sheaf *alloc_empty_sheaf(struct kmem_cache *s, gfp_t gfp)
+{
+	gfp &= ~(__GFP_ZERO | __GFP_THISNODE | __GFP_ACCOUNT);
+
+	return kzalloc_node(struct_size_t(struct slab_sheaf, objects,
+					  s->sheaf_capacity),
+			    gfp | __GFP_NOWARN, numa_mem_id());
+}
+
+static void free_empty_sheaf(struct slab_sheaf *sheaf)
+{
+	kfree(sheaf);
+}
+
+static void sheaf_flush(struct kmem_cache *s, struct slab_sheaf *sheaf)
+{
+	if (!sheaf->size)
+		return;
+
+	stat_add(s, SHEAF_FLUSH, sheaf->size);
+	__kmem_cache_free_bulk(s, sheaf->size, &sheaf->objects[0]);
+	sheaf->size = 0;
+}
+
+static struct slab_sheaf *barn_get_full(struct node_barn *barn)
+{
+	struct slab_sheaf *sheaf = NULL;
+	unsigned long flags;
+
+	spin_lock_irqsave(&barn->lock, flags);
+	if (barn->nr_full) {
+		sheaf = list_first_entry(&barn->sheaves_full,
+					 struct slab_sheaf, barn_list);
+		list_del(&sheaf->barn_list);
+		barn->nr_full--;
+	}
+	spin_unlock_irqrestore(&barn->lock, flags);
+
+	return sheaf;
+}
+
+static struct slab_sheaf *barn_get_empty(struct node_barn *barn)
+{
+	struct slab_sheaf *sheaf = NULL;
+	unsigned long flags;
+
+	spin_lock_irqsave(&barn->lock, flags);
+	if (barn->nr_empty) {
+		sheaf = list_first_entry(&barn->sheaves_empty,
+					 struct slab_sheaf, barn_list);
+		list_del(&sheaf->barn_list);
+		barn->nr_empty--;
+	}
+	spin_unlock_irqrestore(&barn->lock, flags);
+
+	return sheaf;
+}
+
+static bool barn_put_full(struct node_barn *barn, struct slab_sheaf *sheaf)
+{
+	unsigned long flags;
+	bool ret = false;
+
+	spin_lock_irqsave(&barn->lock, flags);
+	if (barn->nr_full < MAX_FULL_SHEAVES) {
+		list_add(&sheaf->barn_list, &barn->sheaves_full);
+		barn->nr_full++;
+		ret = true;
+	}
+	spin_unlock_irqrestore(&barn->lock, flags);
+
+	return ret;
+}
+
+/* Takes ownership of an empty @sheaf, freeing it if the barn is full */
+static void barn_put_empty(struct node_barn *barn, struct slab_sheaf *sheaf)
+{
+	unsigned long flags;
+
+	if (barn) {
+		spin_lock_irqsave(&barn->lock, flags);
+		if (barn->nr_empty < MAX_EMPTY_SHEAVES) {
+			list_add(&sheaf->barn_list, &barn->sheaves_empty);
+			barn->nr_empty++;
+			sheaf = NULL;
+		}
+		spin_unlock_irqrestore(&barn->lock, flags);
+	}
+
+	if (sheaf)
+		free_empty_sheaf(sheaf);
+}
+
+/* Release all sheaves in the barn, returning their objects to slabs */
+static void barn_shrink(struct kmem_cache *s, struct node_barn *barn)
+{
+	struct slab_sheaf *sheaf, *tmp;
+	unsigned long flags;
+	LIST_HEAD(full);
+	LIST_HEAD(empty);
+
+	spin_lock_irqsave(&barn->lock, flags);
+	list_splice_init(&barn->sheaves_full, &full);
+	list_splice_init(&barn->sheaves_empty, &empty);
+	barn->nr_full = 0;
+	barn->nr_empty = 0;
+	spin_unlock_irqrestore(&barn->lock, flags);
+
+	list_for_each_entry_safe(sheaf, tmp, &full, barn_list) {
+		sheaf_flush(s, sheaf);
+		free_empty_sheaf(sheaf);
+	}
+	list_for_each_entry_safe(sheaf, tmp, &empty, barn_list)
+		free_empty_sheaf(sheaf);
+}
+
+/*
+ * Try to replace the empty main sheaf with a full one, either the spare
+ * or one from the barn. Called with the pcs lock held.
+ */
+static bool __pcs_replace_empty_main(struct kmem_cache *s,
+				     struct slub_percpu_sheaves *pcs)
+{
+	struct node_barn *barn;
+	struct slab_sheaf *full;
+
+	if (pcs->spare && pcs->spare->size) {
+		swap(pcs->main, pcs->spare);
+		return true;
+	}
+
+	barn = get_barn(s);
+	if (!barn)
+		return false;
+
+	full = barn_get_full(barn);
+	if (!full)
+		return false;
+
+	stat(s, BARN_GET);
+	if (!pcs->spare)
+		pcs->spare = pcs->main;
+	else
+		barn_put_empty(barn, pcs->main);
+	pcs->main = full;
+	return true;
+}
+
+/*
+ * The slow path of alloc_from_pcs(): fill a new sheaf with the regular
+ * bulk allocation, without holding the pcs lock, and install it as main.
+ */
+static void *alloc_from_new_sheaf(struct kmem_cache *s, gfp_t gfp)
+{
+	struct slub_percpu_sheaves *pcs;
+	struct slab_sheaf *sheaf, *empty = NULL;
+	struct node_barn *barn;
+	unsigned long flags;
+	void *object;
+
+	barn = get_barn(s);
+	sheaf = barn ? barn_get_empty(barn) : NULL;
+	if (!sheaf) {
+		sheaf = alloc_empty_sheaf(s, gfp);
+		if (!sheaf)
+			return NULL;
+	}
+
+	if (!__kmem_cache_alloc_bulk(s, gfp, s->sheaf_capacity,
+				     &sheaf->objects[0])) {
+		barn_put_empty(barn, sheaf);
+		return NULL;
+	}
+	sheaf->size = s->sheaf_capacity;
+	stat_add(s, SHEAF_REFILL, sheaf->size);
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+
+	/*
+	 * We might have been migrated, or an irq might have refilled the main
+	 * sheaf meanwhile. Keep whichever sheaf has objects as main.
+	 */
+	if (!pcs->main->size) {
+		empty = pcs->main;
+		pcs->main = sheaf;
+		if (!pcs->spare) {
+			pcs->spare = empty;
+			empty = NULL;
+		}
+		sheaf = NULL;
+	}
+	object = pcs->main->objects[--pcs->main->size];
+
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+	if (empty)
+		barn_put_empty(get_barn(s), empty);
+	if (sheaf && !(barn && barn_put_full(barn, sheaf))) {
+		sheaf_flush(s, sheaf);
+		free_empty_sheaf(sheaf);
+	}
+
+	stat(s, ALLOC_PCS);
+	return object;
+}
+
+static __fastpath_inline void *alloc_from_pcs(struct kmem_cache *s, gfp_t gfp)
+{
+	struct slub_percpu_sheaves *pcs;
+	unsigned long flags;
+	void *object;
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+
+	if (unlikely(!pcs->main->size) && !__pcs_replace_empty_main(s, pcs)) {
+		local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+		return alloc_from_new_sheaf(s, gfp);
+	}
+
+	object = pcs->main->objects[--pcs->main->size];
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+	stat(s, ALLOC_PCS);
+	return object;
+}
+
+/*
+ * Try to replace the full main sheaf with an empty one, either the spare
+ * or one from the barn, or a newly allocated one. The full sheaf goes to
+ * the spare slot or to the barn. Called with the pcs lock held.
+ */
+static bool __pcs_replace_full_main(struct kmem_cache *s,
+				    struct slub_percpu_sheaves *pcs)
+{
+	struct node_barn *barn;
+	struct slab_sheaf *empty;
+
+	if (pcs->spare && !pcs->spare->size) {
+		swap(pcs->main, pcs->spare);
+		return true;
+	}
+
+	barn = get_barn(s);
+	if (!barn)
+		return false;
+
+	empty = barn_get_empty(barn);
+	if (!empty) {
+		empty = alloc_empty_sheaf(s, GFP_NOWAIT);
+		if (!empty)
+			return false;
+	}
+
+	if (!pcs->spare) {
+		pcs->spare = pcs->main;
+	} else if (barn_put_full(barn, pcs->main)) {
+		stat(s, BARN_PUT);
+	} else {
+		/*
+		 * The barn has enough full sheaves already, let the caller
+		 * free to the slab directly instead.
+		 */
+		barn_put_empty(barn, empty);
+		return false;
+	}
+	pcs->main = empty;
+	return true;
+}
+
+static __fastpath_inline bool free_to_pcs(struct kmem_cache *s, void *object)
+{
+	struct slub_percpu_sheaves *pcs;
+	unsigned long flags;
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+
+	if (unlikely(pcs->main->size == s->sheaf_capacity) &&
+	    !__pcs_replace_full_main(s, pcs)) {
+		local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+		return false;
+	}
+
+	pcs->main->objects[pcs->main->size++] = object;
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+	stat(s, FREE_PCS);
+	return true;
+}
+
+/* Flush the sheaves of the current cpu, called from the flush work */
+static void pcs_flush_all(struct kmem_cache *s)
+{
+	struct slub_percpu_sheaves *pcs;
+	unsigned long flags;
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+	sheaf_flush(s, pcs->main);
+	if (pcs->spare)
+		sheaf_flush(s, pcs->spare);
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+}
+
+/* Flush the sheaves of an offline cpu, no locking needed */
+static void __pcs_flush_all_cpu(struct kmem_cache *s, int cpu)
+{
+	struct slub_percpu_sheaves *pcs = per_cpu_ptr(s->cpu_sheaves, cpu);
+
+	sheaf_flush(s, pcs->main);
+	if (pcs->spare)
+		sheaf_flush(s, pcs->spare);
+}
+
+static bool pcs_has_objects(struct kmem_cache *s, int cpu)
+{
+	struct slub_percpu_sheaves *pcs = per_cpu_ptr(s->cpu_sheaves, cpu);
+
+	return pcs->main->size || (pcs->spare && pcs->spare->size);
+}
+
+static void barns_shrink(struct kmem_cache *s)
+{
+	struct kmem_cache_node *n;
+	int node;
+
+	if (!s->cpu_sheaves)
+		return;
+
+	for_each_kmem_cache_node(s, node, n)
+		barn_shrink(s, &n->barn);
+}
+
+static int init_percpu_sheaves(struct kmem_cache *s)
+{
+	int cpu;
+
+	s->cpu_sheaves = alloc_percpu(struct slub_percpu_sheaves);
+	if (!s->cpu_sheaves)
+		return -ENOMEM;
+
+	for_each_possible_cpu(cpu) {
+		struct slub_percpu_sheaves *pcs = per_cpu_ptr(s->cpu_sheaves, cpu);
+
+		local_lock_init(&pcs->lock);
+		pcs->main = alloc_empty_sheaf(s, GFP_KERNEL);
+		if (!pcs->main)
+			return -ENOMEM;
+	}
+
+	return 0;
+}
+
+/* Must only be called once the sheaves have been flushed */
+static void free_percpu_sheaves(struct kmem_cache *s)
+{
+	int cpu;
+
+	if (!s->cpu_sheaves)
+		return;
+
+	for_each_possible_cpu(cpu) {
+		struct slub_percpu_sheaves *pcs = per_cpu_ptr(s->cpu_sheaves, cpu);
+
+		free_empty_sheaf(pcs->main);
+		free_empty_sheaf(pcs->spare);
+	}
+	free_percpu(s->cpu_sheaves);
+	s->cpu_sheaves = NULL;
+}
+
+#define KMALLOC_SHEAF_CAPACITY	32
+
+/*
+ * The kmalloc caches cannot get sheaves when they are created, as the sheaves
+ * themselves are kmalloc'ed. Enable them on kmalloc-256 once the whole kmalloc
+ * array is usable. The sheaves must not come from the very cache they serve,
+ * or freeing one from under the pcs lock would take that lock again.
+ */
+void __init kmalloc_init_sheaves(void)
+{
+	struct kmem_cache *s = kmalloc_caches[KMALLOC_NORMAL][kmalloc_index(256)];
+	size_t size = struct_size_t(struct slab_sheaf, objects,
+				    KMALLOC_SHEAF_CAPACITY);
+
+	if (!s || s->sheaf_capacity || kmem_cache_debug(s))
+		return;
+
+	if (kmalloc_slab(size, NULL, GFP_KERNEL, 0) == s)
+		return;
+
+	s->sheaf_capacity = KMALLOC_SHEAF_CAPACITY;
+	if (init_percpu_sheaves(s)) {
+		free_percpu_sheaves(s);
+		s->sheaf_capacity = 0;
+	}
+}
+
 struct slub_flush_work {
 	struct work_struct work;
 	struct kmem_cache *s;
@@ -3322,6 +3789,10 @@ static void flush_cpu_slab(struct work_struct *w)
 	sfw = container_of(w, struct slub_flush_work, work);
 
 	s = sfw->s;
+
+	if (s->cpu_sheaves)
+		pcs_flush_all(s);
+
 	c = this_cpu_ptr(s->cpu_slab);
 
 	if (c->slab)
@@ -3334,6 +3805,9 @@ static bool has_cpu_slab(int cpu, struct kmem_cache *s)
 {
 	struct kmem_cache_cpu *c = per_cpu_ptr(s->cpu_slab, cpu);
 
+	if (s->cpu_sheaves && pcs_has_objects(s, cpu))
+		return true;
+
 	return c->slab || slub_percpu_partial(c);
 }
 
@@ -3386,8 +3860,11 @@ static int slub_cpu_dead(unsigned int cpu)
 	struct kmem_cache *s;
 
 	mutex_lock(&slab_mutex);
-	list_for_each_entry(s, &slab_caches, list)
+	list_for_each_entry(s, &slab_caches, list) {
+		if (s->cpu_sheaves)
+			__pcs_flush_all_cpu(s, cpu);
 		__flush_cpu_slab(s, cpu);
+	}
 	mutex_unlock(&slab_mutex);
 	return 0;
 }
@@ -3397,6 +3874,12 @@ static inline void flush_all_cpus_locked(struct kmem_cache *s) { }
 static inline void flush_all(struct kmem_cache *s) { }
 static inline void __flush_cpu_slab(struct kmem_cache *s, int cpu) { }
 static inline int slub_cpu_dead(unsigned int cpu) { return 0; }
+static inline void *alloc_from_pcs(struct kmem_cache *s, gfp_t gfp) { return NULL; }
+static inline bool free_to_pcs(struct kmem_cache *s, void *object) { return false; }
+static inline void barns_shrink(struct kmem_cache *s) { }
+static inline int init_percpu_sheaves(struct kmem_cache *s) { return 0; }
+static inline void free_percpu_sheaves(struct kmem_cache *s) { }
+void __init kmalloc_init_sheaves(void) { }
 #endif /* CONFIG_SLUB_TINY */
 
 /*
@@ -4172,7 +4655,11 @@ static __fastpath_inline void *slab_alloc_node(struct kmem_cache *s, struct list
 	if (unlikely(object))
 		goto out;
 
-	object = __slab_alloc_node(s, gfpflags, node, addr, orig_size);
+	if (s->sheaf_capacity && node == NUMA_NO_NODE)
+		object = alloc_from_pcs(s, gfpflags);
+
+	if (!object)
+		object = __slab_alloc_node(s, gfpflags, node, addr, orig_size);
 
 	maybe_wipe_obj_freeptr(s, object);
 	init = slab_want_init_on_alloc(gfpflags, s);
@@ -4630,8 +5117,18 @@ void slab_free(struct kmem_cache *s, struct slab *slab, void *object,
 	memcg_slab_free_hook(s, slab, &object, 1);
 	alloc_tagging_slab_free_hook(s, slab, &object, 1);
 
-	if (likely(slab_free_hook(s, object, slab_want_init_on_free(s), false)))
-		do_slab_free(s, slab, object, object, 1, addr);
+	if (unlikely(!slab_free_hook(s, object, slab_want_init_on_free(s), false)))
+		return;
+
+	/*
+	 * Only node-local objects go to the sheaves, so that allocations
+	 * served from them stay local too.
+	 */
+	if (s->sheaf_capacity && slab_nid(slab) == numa_mem_id() &&
+	    !is_kfence_address(object) && free_to_pcs(s, object))
+		return;
+
+	do_slab_free(s, slab, object, object, 1, addr);
 }
 
 #ifdef CONFIG_MEMCG
@@ -5506,6 +6003,13 @@ init_kmem_cache_node(struct kmem_cache_node *n)
 	n->nr_partial = 0;
 	spin_lock_init(&n->list_lock);
 	INIT_LIST_HEAD(&n->partial);
+#ifndef CONFIG_SLUB_TINY
+	spin_lock_init(&n->barn.lock);
+	INIT_LIST_HEAD(&n->barn.sheaves_full);
+	INIT_LIST_HEAD(&n->barn.sheaves_empty);
+	n->barn.nr_full = 0;
+	n->barn.nr_empty = 0;
+#endif
 #ifdef CONFIG_SLUB_DEBUG
 	atomic_long_set(&n->nr_slabs, 0);
 	atomic_long_set(&n->total_objects, 0);
@@ -5600,6 +6104,7 @@ static void free_kmem_cache_nodes(struct kmem_cache *s)
 void __kmem_cache_release(struct kmem_cache *s)
 {
 	cache_random_seq_destroy(s);
+	free_percpu_sheaves(s);
 #ifndef CONFIG_SLUB_TINY
 	free_percpu(s->cpu_slab);
 #endif
@@ -5880,6 +6385,7 @@ int __kmem_cache_shutdown(struct kmem_cache *s)
 	struct kmem_cache_node *n;
 
 	flush_all_cpus_locked(s);
+	barns_shrink(s);
 	/* Attempt to free all objects */
 	for_each_kmem_cache_node(s, node, n) {
 		free_partial(s, n);
@@ -6134,6 +6640,7 @@ static int __kmem_cache_do_shrink(struct kmem_cache *s)
 int __kmem_cache_shrink(struct kmem_cache *s)
 {
 	flush_all(s);
+	barns_shrink(s);
 	return __kmem_cache_do_shrink(s);
 }
 
@@ -6144,6 +6651,7 @@ static int slab_mem_going_offline_callback(void *arg)
 	mutex_lock(&slab_mutex);
 	list_for_each_entry(s, &slab_caches, list) {
 		flush_all_cpus_locked(s);
+		barns_shrink(s);
 		__kmem_cache_do_shrink(s);
 	}
 	mutex_unlock(&slab_mutex);
@@ -6448,6 +6956,19 @@ int do_kmem_cache_create(struct kmem_cache *s, const char *name,
 	if (!alloc_kmem_cache_cpus(s))
 		goto out;
 
+	/*
+	 * Sheaves are an opt-in performance feature, they would only get in
+	 * the way of debugging.
+	 */
+	if (!IS_ENABLED(CONFIG_SLUB_TINY) && args->sheaf_capacity &&
+	    !kmem_cache_debug(s)) {
+		s->sheaf_capacity = args->sheaf_capacity;
+		if (init_percpu_sheaves(s)) {
+			err = -ENOMEM;
+			goto out;
+		}
+	}
+
 	err = 0;
 
 	/* Mutex is not taken during early boot */
@@ -7273,6 +7794,12 @@ STAT_ATTR(CPU_PARTIAL_ALLOC, cpu_partial_alloc);
 STAT_ATTR(CPU_PARTIAL_FREE, cpu_partial_free);
 STAT_ATTR(CPU_PARTIAL_NODE, cpu_partial_node);
 STAT_ATTR(CPU_PARTIAL_DRAIN, cpu_partial_drain);
+STAT_ATTR(ALLOC_PCS, alloc_cpu_sheaf);
+STAT_ATTR(FREE_PCS, free_cpu_sheaf);
+STAT_ATTR(SHEAF_REFILL, sheaf_refill);
+STAT_ATTR(SHEAF_FLUSH, sheaf_flush);
+STAT_ATTR(BARN_GET, barn_get);
+STAT_ATTR(BARN_PUT, barn_put);
 #endif	/* CONFIG_SLUB_STATS */
 
 #ifdef CONFIG_KFENCE
@@ -7360,6 +7887,12 @@ static struct attribute *slab_attrs[] = {
 	&cpu_partial_free_attr.attr,
 	&cpu_partial_node_attr.attr,
 	&cpu_partial_drain_attr.attr,
+	&alloc_cpu_sheaf_attr.attr,
+	&free_cpu_sheaf_attr.attr,
+	&sheaf_refill_attr.attr,
+	&sheaf_flush_attr.attr,
+	&barn_get_attr.attr,
+	&barn_put_attr.attr,
 #endif
 #ifdef CONFIG_FAILSLAB
 	&failslab_attr.attr,
@@ -698,44 +698,26 @@ static __always_inline ssize_t mfill_atomic_pte(pmd_t *dst_pmd,
 	return err;
 }
 
-static __always_inline ssize_t mfill_atomic(struct userfaultfd_ctx *ctx,
-					    unsigned long dst_start,
-					    unsigned long src_start,
-					    unsigned long len,
-					    uffd_flags_t flags)
+/*
+ * Lock the vma for a fill of [dst_start, dst_start + len) and check that
+ * the fill is allowed in it.  On success the vma is returned locked, with
+ * ctx->map_changing_lock held for read.
+ */
+static struct vm_area_struct *mfill_atomic_lock(struct userfaultfd_ctx *ctx,
+						unsigned long dst_start,
+						unsigned long len,
+						uffd_flags_t flags)
 {
-	struct mm_struct *dst_mm = ctx->mm;
 	struct vm_area_struct *dst_vma;
-	ssize_t err;
-	pmd_t *dst_pmd;
-	unsigned long src_addr, dst_addr;
-	long copied;
-	struct folio *folio;
-
-	/*
-	 * Sanitize the command parameters:
-	 */
-	BUG_ON(dst_start & ~PAGE_MASK);
-	BUG_ON(len & ~PAGE_MASK);
-
-	/* Does the address range wrap, or is the span zero-sized? */
-	BUG_ON(src_start + len <= src_start);
-	BUG_ON(dst_start + len <= dst_start);
+	int err;
 
-	src_addr = src_start;
-	dst_addr = dst_start;
-	copied = 0;
-	folio = NULL;
-retry:
 	/*
 	 * Make sure the vma is not shared, that the dst range is
 	 * both valid and fully within a single existing vma.
 	 */
-	dst_vma = uffd_mfill_lock(dst_mm, dst_start, len);
-	if (IS_ERR(dst_vma)) {
-		err = PTR_ERR(dst_vma);
-		goto out;
-	}
+	dst_vma = uffd_mfill_lock(ctx->mm, dst_start, len);
+	if (IS_ERR(dst_vma))
+		return dst_vma;
 
 	/*
 	 * If memory mappings are changing because of non-cooperative
@@ -763,12 +745,9 @@ static __always_inline ssize_t mfill_atomic(struct userfaultfd_ctx *ctx,
 	if ((flags & MFILL_ATOMIC_WP) && !(dst_vma->vm_flags & VM_UFFD_WP))
 		goto out_unlock;
 
-	/*
-	 * If this is a HUGETLB vma, pass off to appropriate routine
-	 */
+	/* HUGETLB vmas are handled by mfill_atomic_hugetlb() */
 	if (is_vm_hugetlb_page(dst_vma))
-		return  mfill_atomic_hugetlb(ctx, dst_vma, dst_start,
-					     src_start, len, flags);
+		return dst_vma;
 
 	if (!vma_is_anonymous(dst_vma) && !vma_is_shmem(dst_vma))
 		goto out_unlock;
@@ -776,12 +755,41 @@ static __always_inline ssize_t mfill_atomic(struct userfaultfd_ctx *ctx,
 	    uffd_flags_mode_is(flags, MFILL_ATOMIC_CONTINUE))
 		goto out_unlock;
 
-	while (src_addr < src_start + len) {
-		pmd_t dst_pmdval;
+	return dst_vma;
 
-		BUG_ON(dst_addr >= dst_start + len);
+out_unlock:
+	up_read(&ctx->map_changing_lock);
+	uffd_mfill_unlock(dst_vma);
+	return ERR_PTR(err);
+}
+
+static void mfill_atomic_unlock(struct userfaultfd_ctx *ctx,
+				struct vm_area_struct *dst_vma)
+{
+	up_read(&ctx->map_changing_lock);
+	uffd_mfill_unlock(dst_vma);
+}
+
+/*
+ * Fill [*dst_addr, dst_end) of a locked, non-hugetlb dst_vma, advancing
+ * *dst_addr and *src_addr past what was filled.  -ENOENT means *foliop has
+ * to be filled from *src_addr with the locks dropped before retrying.
+ */
+static __always_inline ssize_t mfill_atomic_ptes(struct vm_area_struct *dst_vma,
+						 unsigned long *dst_addr,
+						 unsigned long *src_addr,
+						 unsigned long dst_end,
+						 uffd_flags_t flags,
+						 struct folio **foliop)
+{
+	struct mm_struct *dst_mm = dst_vma->vm_mm;
+	ssize_t err = 0;
+	pmd_t *dst_pmd;
 
-		dst_pmd = mm_alloc_pmd(dst_mm, dst_addr);
+	while (*dst_addr < dst_end) {
+		pmd_t dst_pmdval;
+
+		dst_pmd = mm_alloc_pmd(dst_mm, *dst_addr);
 		if (unlikely(!dst_pmd)) {
 			err = -ENOMEM;
 			break;
@@ -813,35 +821,19 @@ static __always_inline ssize_t mfill_atomic(struct userfaultfd_ctx *ctx,
 		 * tables under us; pte_offset_map_lock() will deal with that.
 		 */
 
-		err = mfill_atomic_pte(dst_pmd, dst_vma, dst_addr,
-				       src_addr, flags, &folio);
+		err = mfill_atomic_pte(dst_pmd, dst_vma, *dst_addr,
+				       *src_addr, flags, foliop);
 		cond_resched();
 
 		if (unlikely(err == -ENOENT)) {
-			void *kaddr;
-
-			up_read(&ctx->map_changing_lock);
-			uffd_mfill_unlock(dst_vma);
-			BUG_ON(!folio);
-
-			kaddr = kmap_local_folio(folio, 0);
-			err = copy_from_user(kaddr,
-					     (const void __user *) src_addr,
-					     PAGE_SIZE);
-			kunmap_local(kaddr);
-			if (unlikely(err)) {
-				err = -EFAULT;
-				goto out;
-			}
-			flush_dcache_folio(folio);
-			goto retry;
+			BUG_ON(!*foliop);
+			break;
 		} else
-			BUG_ON(folio);
+			BUG_ON(*foliop);
 
 		if (!err) {
-			dst_addr += PAGE_SIZE;
-			src_addr += PAGE_SIZE;
-			copied += PAGE_SIZE;
+			*dst_addr += PAGE_SIZE;
+			*src_addr += PAGE_SIZE;
 
 			if (fatal_signal_pending(current))
 				err = -EINTR;
@@ -850,9 +842,75 @@ static __always_inline ssize_t mfill_atomic(struct userfaultfd_ctx *ctx,
 			break;
 	}
 
-out_unlock:
-	up_read(&ctx->map_changing_lock);
-	uffd_mfill_unlock(dst_vma);
+	return err;
+}
+
+/* Fill @folio from @src_addr for a retry of mfill_atomic_pte() */
+static int mfill_atomic_copy_folio(struct folio *folio, unsigned long src_addr)
+{
+	void *kaddr;
+	int err;
+
+	kaddr = kmap_local_folio(folio, 0);
+	err = copy_from_user(kaddr, (const void __user *) src_addr,
+			     PAGE_SIZE);
+	kunmap_local(kaddr);
+	if (unlikely(err))
+		return -EFAULT;
+	flush_dcache_folio(folio);
+	return 0;
+}
+
+static __always_inline ssize_t mfill_atomic(struct userfaultfd_ctx *ctx,
+					    unsigned long dst_start,
+					    unsigned long src_start,
+					    unsigned long len,
+					    uffd_flags_t flags)
+{
+	struct vm_area_struct *dst_vma;
+	ssize_t err;
+	unsigned long src_addr, dst_addr;
+	long copied;
+	struct folio *folio;
+
+	/*
+	 * Sanitize the command parameters:
+	 */
+	BUG_ON(dst_start & ~PAGE_MASK);
+	BUG_ON(len & ~PAGE_MASK);
+
+	/* Does the address range wrap, or is the span zero-sized? */
+	BUG_ON(src_start + len <= src_start);
+	BUG_ON(dst_start + len <= dst_start);
+
+	src_addr = src_start;
+	dst_addr = dst_start;
+	copied = 0;
+	folio = NULL;
+retry:
+	dst_vma = mfill_atomic_lock(ctx, dst_start, len, flags);
+	if (IS_ERR(dst_vma)) {
+		err = PTR_ERR(dst_vma);
+		goto out;
+	}
+
+	/*
+	 * If this is a HUGETLB vma, pass off to appropriate routine
+	 */
+	if (is_vm_hugetlb_page(dst_vma))
+		return  mfill_atomic_hugetlb(ctx, dst_vma, dst_start,
+					     src_start, len, flags);
+
+	err = mfill_atomic_ptes(dst_vma, &dst_addr, &src_addr,
+				dst_start + len, flags, &folio);
+	copied = dst_addr - dst_start;
+	mfill_atomic_unlock(ctx, dst_vma);
+
+	if (unlikely(err == -ENOENT)) {
+		err = mfill_atomic_copy_folio(folio, src_addr);
+		if (!err)
+			goto retry;
+	}
 out:
 	if (folio)
 		folio_put(folio);
@@ -862,6 +920,97 @@ static __always_inline ssize_t mfill_atomic(struct userfaultfd_ctx *ctx,
 	return copied ? copied : err;
 }
 
+/**
+ * mfill_atomic_vec - resolve a batch of UFFDIO_COPY or UFFDIO_CONTINUE ranges
+ * @ctx: the userfaultfd context
+ * @iov: page aligned, validated ranges to fill
+ * @nr: number of entries in @iov
+ * @flags: the fill mode and flags
+ * @nr_done: incremented for each fully filled entry
+ * @mapped: incremented by the bytes filled, including a partial entry
+ *
+ * Like mfill_atomic() on each entry in turn, but keeps the vma locked as
+ * long as the following entries fall into it, so resolving many small
+ * discontiguous ranges costs one vma lookup per vma rather than per range.
+ * Stops at the first error.
+ *
+ * Return: 0 if all entries were filled, -errno otherwise.
+ */
+ssize_t mfill_atomic_vec(struct userfaultfd_ctx *ctx,
+			 const struct uffdio_iovec *iov, unsigned int nr,
+			 uffd_flags_t flags, __u64 *nr_done, __s64 *mapped)
+{
+	struct vm_area_struct *dst_vma = NULL;
+	struct folio *folio = NULL;
+	ssize_t err = 0;
+	unsigned int i;
+
+	if (uffd_flags_mode_is(flags, MFILL_ATOMIC_CONTINUE))
+		smp_wmb();	/* see mfill_atomic_continue() */
+
+	for (i = 0; i < nr; i++) {
+		unsigned long dst_addr = iov[i].dst;
+		unsigned long src_addr = iov[i].src;
+		unsigned long dst_end = dst_addr + iov[i].len;
+
+		while (dst_addr < dst_end) {
+			unsigned long start = dst_addr;
+
+			if (dst_vma && (dst_addr < dst_vma->vm_start ||
+					!validate_dst_vma(dst_vma, dst_end))) {
+				mfill_atomic_unlock(ctx, dst_vma);
+				dst_vma = NULL;
+			}
+
+			if (!dst_vma) {
+				dst_vma = mfill_atomic_lock(ctx, dst_addr,
+							    dst_end - dst_addr,
+							    flags);
+				if (IS_ERR(dst_vma)) {
+					err = PTR_ERR(dst_vma);
+					dst_vma = NULL;
+					goto out;
+				}
+			}
+
+			if (is_vm_hugetlb_page(dst_vma)) {
+				/* Drops the locks */
+				err = mfill_atomic_hugetlb(ctx, dst_vma,
+						dst_addr, src_addr,
+						dst_end - dst_addr, flags);
+				dst_vma = NULL;
+				if (err < 0)
+					goto out;
+				*mapped += err;
+				if (err != dst_end - dst_addr) {
+					err = -EAGAIN;
+					goto out;
+				}
+				err = 0;
+				break;
+			}
+
+			err = mfill_atomic_ptes(dst_vma, &dst_addr, &src_addr,
+						dst_end, flags, &folio);
+			*mapped += dst_addr - start;
+			if (unlikely(err == -ENOENT)) {
+				mfill_atomic_unlock(ctx, dst_vma);
+				dst_vma = NULL;
+				err = mfill_atomic_copy_folio(folio, src_addr);
+			}
+			if (err)
+				goto out;
+		}
+		(*nr_done)++;
+	}
+out:
+	if (dst_vma)
+		mfill_atomic_unlock(ctx, dst_vma);
+	if (folio)
+		folio_put(folio);
+	return err;
+}
+
 ssize_t mfill_atomic_copy(struct userfaultfd_ctx *ctx, unsigned long dst_start,
 			  unsigned long src_start, unsigned long len,
 			  uffd_flags_t flags)
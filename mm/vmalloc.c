@@ -1907,12 +1907,110 @@ node_pool_del_va(struct vmap_node *vn, unsigned long size,
 	return va;
 }
 
+/*
+ * Per-CPU magazines in front of the node pools for the smallest size
+ * classes.  A CPU only caches VAs of the node it allocates from, and an
+ * empty magazine is refilled with a batch of VAs under a single pool_lock
+ * round trip.
+ */
+#define VMAP_PCPU_NR_CLASSES	8
+#define VMAP_PCPU_MAG_SIZE	8
+
+struct vmap_pcpu_mag {
+	spinlock_t lock;
+	unsigned int nr[VMAP_PCPU_NR_CLASSES];
+	struct vmap_area *vas[VMAP_PCPU_NR_CLASSES][VMAP_PCPU_MAG_SIZE];
+};
+
+static DEFINE_PER_CPU(struct vmap_pcpu_mag, vmap_pcpu_mag);
+
+static void
+vmap_pcpu_mag_refill(struct vmap_node *vn, struct vmap_pcpu_mag *mag,
+		unsigned int idx)
+{
+	struct vmap_pool *vp = &vn->pool[idx];
+	struct vmap_area *va;
+
+	if (list_empty(&vp->head))
+		return;
+
+	spin_lock(&vn->pool_lock);
+	while (mag->nr[idx] < VMAP_PCPU_MAG_SIZE / 2 &&
+			!list_empty(&vp->head)) {
+		va = list_first_entry(&vp->head, struct vmap_area, list);
+		list_del_init(&va->list);
+		WRITE_ONCE(vp->len, vp->len - 1);
+		mag->vas[idx][mag->nr[idx]++] = va;
+	}
+	spin_unlock(&vn->pool_lock);
+}
+
+/*
+ * @cpu must be the CPU @vn was picked for, so that vmap_pcpu_mag_drain()
+ * finds the VAs.  The caller may have migrated since, mag->lock covers it.
+ */
+static struct vmap_area *
+vmap_pcpu_mag_get(struct vmap_node *vn, int cpu, unsigned long size,
+		unsigned long align)
+{
+	unsigned int idx = (size - 1) / PAGE_SIZE;
+	struct vmap_area *va = NULL;
+	struct vmap_pcpu_mag *mag;
+
+	if (idx >= VMAP_PCPU_NR_CLASSES)
+		return NULL;
+
+	mag = per_cpu_ptr(&vmap_pcpu_mag, cpu);
+	spin_lock(&mag->lock);
+	if (!mag->nr[idx])
+		vmap_pcpu_mag_refill(vn, mag, idx);
+
+	if (mag->nr[idx]) {
+		va = mag->vas[idx][mag->nr[idx] - 1];
+		if (IS_ALIGNED(va->va_start, align) &&
+				!WARN_ON_ONCE(va_size(va) != size))
+			mag->nr[idx]--;
+		else
+			va = NULL;
+	}
+	spin_unlock(&mag->lock);
+
+	return va;
+}
+
+/*
+ * Give the VAs cached by the CPUs allocating from @vn back to its pools.
+ */
+static void
+vmap_pcpu_mag_drain(struct vmap_node *vn)
+{
+	unsigned int vn_id = vn - vmap_nodes;
+	struct vmap_pcpu_mag *mag;
+	unsigned int idx;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		if (cpu % nr_vmap_nodes != vn_id)
+			continue;
+
+		mag = per_cpu_ptr(&vmap_pcpu_mag, cpu);
+		spin_lock(&mag->lock);
+		for (idx = 0; idx < VMAP_PCPU_NR_CLASSES; idx++) {
+			while (mag->nr[idx])
+				node_pool_add_va(vn,
+					mag->vas[idx][--mag->nr[idx]]);
+		}
+		spin_unlock(&mag->lock);
+	}
+}
+
 static struct vmap_area *
 node_alloc(unsigned long size, unsigned long align,
 		unsigned long vstart, unsigned long vend,
 		unsigned long *addr, unsigned int *vn_id)
 {
 	struct vmap_area *va;
+	int cpu;
 
 	*vn_id = 0;
 	*addr = vend;
@@ -1925,8 +2023,12 @@ node_alloc(unsigned long size, unsigned long align,
 			nr_vmap_nodes == 1)
 		return NULL;
 
-	*vn_id = raw_smp_processor_id() % nr_vmap_nodes;
-	va = node_pool_del_va(id_to_node(*vn_id), size, align, vstart, vend);
+	cpu = raw_smp_processor_id();
+	*vn_id = cpu % nr_vmap_nodes;
+	va = vmap_pcpu_mag_get(id_to_node(*vn_id), cpu, size, align);
+	if (!va)
+		va = node_pool_del_va(id_to_node(*vn_id), size, align,
+				vstart, vend);
 	*vn_id = encode_vn_id(*vn_id);
 
 	if (va)
@@ -2137,6 +2239,9 @@ decay_va_pool_node(struct vmap_node *vn, bool full_decay)
 	unsigned long n_decay;
 	int i;
 
+	if (full_decay)
+		vmap_pcpu_mag_drain(vn);
+
 	for (i = 0; i < MAX_VA_SIZE_PAGES; i++) {
 		LIST_HEAD(tmp_list);
 
@@ -5194,6 +5299,7 @@ void __init vmalloc_init(void)
 		init_llist_head(&p->list);
 		INIT_WORK(&p->wq, delayed_vfree_work);
 		xa_init(&vbq->vmap_blocks);
+		spin_lock_init(&per_cpu(vmap_pcpu_mag, i).lock);
 	}
 
 	/*
@@ -4865,7 +4865,10 @@ static int shrink_one(struct lruvec *lruvec, struct scan_control *sc)
 
 	success = try_to_shrink_lruvec(lruvec, sc);
 
-	shrink_slab(sc->gfp_mask, pgdat->node_id, memcg, sc->priority);
+	if (!current_is_kswapd() ||
+	    !shrink_slab_async(sc->gfp_mask, pgdat->node_id, memcg,
+			       sc->priority))
+		shrink_slab(sc->gfp_mask, pgdat->node_id, memcg, sc->priority);
 
 	if (!sc->proactive)
 		vmpressure(sc->gfp_mask, memcg, false, sc->nr_scanned - scanned,
@@ -5904,9 +5907,13 @@ static void shrink_node_memcgs(pg_data_t *pgdat, struct scan_control *sc)
 	 * fairness and allocation latency.
 	 *
 	 * For kswapd, reliable forward progress is more important
-	 * than a quick return to idle. Always do full walks.
+	 * than a quick return to idle. Always do full walks, unless
+	 * kswapd helpers are reclaiming the node as well: then all
+	 * kswapd threads share the iterator, so that each memcg is
+	 * claimed by only one of them in every round of the walk.
 	 */
-	if (current_is_kswapd() || sc->memcg_full_walk)
+	if ((current_is_kswapd() && !READ_ONCE(pgdat->kswapd_helpers_active)) ||
+	    sc->memcg_full_walk)
 		partial = NULL;
 
 	memcg = mem_cgroup_iter(target_memcg, NULL, partial);
@@ -5950,8 +5957,15 @@ static void shrink_node_memcgs(pg_data_t *pgdat, struct scan_control *sc)
 
 		shrink_lruvec(lruvec, sc);
 
-		shrink_slab(sc->gfp_mask, pgdat->node_id, memcg,
-			    sc->priority);
+		/*
+		 * kswapd may hand the memcg's slab caches to the shrinker
+		 * workers and move on to the next memcg's LRUs.
+		 */
+		if (!current_is_kswapd() ||
+		    !shrink_slab_async(sc->gfp_mask, pgdat->node_id, memcg,
+				       sc->priority))
+			shrink_slab(sc->gfp_mask, pgdat->node_id, memcg,
+				    sc->priority);
 
 		/* Record the group's reclaim efficiency */
 		if (!sc->proactive)
@@ -5960,7 +5974,8 @@ static void shrink_node_memcgs(pg_data_t *pgdat, struct scan_control *sc)
 				   sc->nr_reclaimed - reclaimed);
 
 		/* If partial walks are allowed, bail once goal is reached */
-		if (partial && sc->nr_reclaimed >= sc->nr_to_reclaim) {
+		if (partial && !current_is_kswapd() &&
+		    sc->nr_reclaimed >= sc->nr_to_reclaim) {
 			mem_cgroup_iter_break(target_memcg, memcg);
 			break;
 		}
@@ -6234,6 +6249,11 @@ static void shrink_zones(struct zonelist *zonelist, struct scan_control *sc)
 		if (zone->zone_pgdat == last_pgdat)
 			continue;
 		last_pgdat = zone->zone_pgdat;
+
+		/* Tell kswapd that allocations are outpacing it */
+		if (!cgroup_reclaim(sc))
+			atomic_long_inc(&zone->zone_pgdat->nr_direct_reclaims);
+
 		shrink_node(zone->zone_pgdat, sc);
 	}
 
@@ -6852,6 +6872,55 @@ clear_reclaim_active(pg_data_t *pgdat, int highest_zoneidx)
 	update_reclaim_active(pgdat, highest_zoneidx, false);
 }
 
+/*
+ * vm.kswapd_threads: maximum number of threads, kswapd included, that may
+ * reclaim a node in the background.
+ */
+static int kswapd_threads = 1;
+
+/*
+ * Called by kswapd after every pass over the node. Direct reclaim on the
+ * node since the last pass means that allocations are outpacing kswapd,
+ * so one more helper is activated. A pass without direct reclaim retires
+ * one helper again.
+ */
+static void kswapd_scale_helpers(pg_data_t *pgdat, struct scan_control *sc,
+				 unsigned long *nr_direct_seen)
+{
+	unsigned long nr_direct = atomic_long_read(&pgdat->nr_direct_reclaims);
+	int active = READ_ONCE(pgdat->kswapd_helpers_active);
+	int nr = READ_ONCE(pgdat->nr_kswapd_helpers);
+	int new = active;
+
+	if (nr_direct != *nr_direct_seen)
+		new = min(active + 1, nr);
+	else if (active)
+		new = active - 1;
+	*nr_direct_seen = nr_direct;
+
+	WRITE_ONCE(pgdat->kswapd_helper_priority, sc->priority);
+	WRITE_ONCE(pgdat->kswapd_helper_zoneidx, sc->reclaim_idx);
+
+	if (new == active)
+		return;
+
+	WRITE_ONCE(pgdat->kswapd_helpers_active, new);
+	mod_node_page_state(pgdat, NR_KSWAPD_HELPERS, new - active);
+	if (new > active)
+		wake_up_interruptible_all(&pgdat->kswapd_helper_wait);
+}
+
+static void kswapd_stop_helpers(pg_data_t *pgdat)
+{
+	int active = READ_ONCE(pgdat->kswapd_helpers_active);
+
+	if (!active)
+		return;
+
+	WRITE_ONCE(pgdat->kswapd_helpers_active, 0);
+	mod_node_page_state(pgdat, NR_KSWAPD_HELPERS, -active);
+}
+
 /*
  * For kswapd, balance_pgdat() will reclaim pages across a node from zones
  * that are eligible for use by the caller until at least one zone is
@@ -6868,6 +6937,7 @@ clear_reclaim_active(pg_data_t *pgdat, int highest_zoneidx)
 static int balance_pgdat(pg_data_t *pgdat, int order, int highest_zoneidx)
 {
 	int i;
+	unsigned long nr_direct_seen;
 	unsigned long nr_soft_reclaimed;
 	unsigned long nr_soft_scanned;
 	unsigned long pflags;
@@ -6902,6 +6972,7 @@ static int balance_pgdat(pg_data_t *pgdat, int order, int highest_zoneidx)
 		zone_boosts[i] = zone->watermark_boost;
 	}
 	boosted = nr_boost_reclaim;
+	nr_direct_seen = atomic_long_read(&pgdat->nr_direct_reclaims);
 
 restart:
 	set_reclaim_active(pgdat, highest_zoneidx);
@@ -6999,6 +7070,10 @@ static int balance_pgdat(pg_data_t *pgdat, int order, int highest_zoneidx)
 		if (kswapd_shrink_node(pgdat, &sc))
 			raise_priority = false;
 
+		/* Boosted reclaim is not urgent enough to need helpers */
+		if (!nr_boost_reclaim)
+			kswapd_scale_helpers(pgdat, &sc, &nr_direct_seen);
+
 		/*
 		 * If the low watermark is met there is no need for processes
 		 * to be throttled on pfmemalloc_wait as they should not be
@@ -7048,6 +7123,7 @@ static int balance_pgdat(pg_data_t *pgdat, int order, int highest_zoneidx)
 		pgdat->kswapd_failures++;
 
 out:
+	kswapd_stop_helpers(pgdat);
 	clear_reclaim_active(pgdat, highest_zoneidx);
 
 	/* If reclaim was boosted, account for the reclaim done in this pass */
@@ -7272,6 +7348,124 @@ static int kswapd(void *p)
 	return 0;
 }
 
+static bool kswapd_helper_should_run(pg_data_t *pgdat, int id)
+{
+	return READ_ONCE(pgdat->kswapd_helpers_active) > id;
+}
+
+/*
+ * Reclaim alongside kswapd for as long as kswapd keeps this helper active,
+ * using the priority and zone index of kswapd's current pass.
+ */
+static void kswapd_helper_reclaim(pg_data_t *pgdat, int id)
+{
+	struct scan_control sc = {
+		.gfp_mask = GFP_KERNEL,
+		.may_writepage = !laptop_mode,
+		.may_unmap = 1,
+		.may_swap = 1,
+	};
+	unsigned long pflags;
+
+	set_task_reclaim_state(current, &sc.reclaim_state);
+	psi_memstall_enter(&pflags);
+	__fs_reclaim_acquire(_THIS_IP_);
+
+	while (kswapd_helper_should_run(pgdat, id) && !kthread_should_stop()) {
+		sc.priority = READ_ONCE(pgdat->kswapd_helper_priority);
+		sc.reclaim_idx = READ_ONCE(pgdat->kswapd_helper_zoneidx);
+		if (pgdat_balanced(pgdat, 0, sc.reclaim_idx))
+			break;
+
+		if (sc.priority < DEF_PRIORITY - 2)
+			sc.may_writepage = 1;
+
+		sc.nr_scanned = 0;
+		sc.nr_reclaimed = 0;
+		sc.nr_to_reclaim = SWAP_CLUSTER_MAX;
+		shrink_node(pgdat, &sc);
+
+		__fs_reclaim_release(_THIS_IP_);
+		cond_resched();
+		__fs_reclaim_acquire(_THIS_IP_);
+	}
+
+	__fs_reclaim_release(_THIS_IP_);
+	psi_memstall_leave(&pflags);
+	set_task_reclaim_state(current, NULL);
+}
+
+static int kswapd_helper(void *p)
+{
+	pg_data_t *pgdat = (pg_data_t *)p;
+	struct task_struct *tsk = current;
+	int id;
+
+	/* The helper was added to the array before it was woken */
+	for (id = 0; id < KSWAPD_MAX_HELPERS; id++)
+		if (READ_ONCE(pgdat->kswapd_helpers[id]) == tsk)
+			break;
+	if (WARN_ON_ONCE(id == KSWAPD_MAX_HELPERS))
+		return -EINVAL;
+
+	/* See kswapd() */
+	tsk->flags |= PF_MEMALLOC | PF_KSWAPD;
+	set_freezable();
+
+	while (!kthread_should_stop()) {
+		wait_event_freezable(pgdat->kswapd_helper_wait,
+				     kswapd_helper_should_run(pgdat, id) ||
+				     kthread_should_stop());
+		if (kthread_should_stop())
+			break;
+
+		kswapd_helper_reclaim(pgdat, id);
+
+		/* Don't spin if kswapd still wants us but the node is balanced */
+		if (kswapd_helper_should_run(pgdat, id))
+			schedule_timeout_interruptible(HZ / 10);
+	}
+
+	tsk->flags &= ~(PF_MEMALLOC | PF_KSWAPD);
+
+	return 0;
+}
+
+/*
+ * Start or stop helper threads so that the node has vm.kswapd_threads
+ * reclaim threads in total. Called with the kswapd lock held.
+ */
+static void kswapd_update_helpers(pg_data_t *pgdat)
+{
+	int nr = pgdat->kswapd ? READ_ONCE(kswapd_threads) - 1 : 0;
+	struct task_struct *tsk;
+
+	while (pgdat->nr_kswapd_helpers > nr) {
+		int id = pgdat->nr_kswapd_helpers - 1;
+
+		/* Make sure kswapd does not activate the helper meanwhile */
+		WRITE_ONCE(pgdat->nr_kswapd_helpers, id);
+		kthread_stop(pgdat->kswapd_helpers[id]);
+		WRITE_ONCE(pgdat->kswapd_helpers[id], NULL);
+	}
+
+	while (pgdat->nr_kswapd_helpers < nr) {
+		int id = pgdat->nr_kswapd_helpers;
+
+		tsk = kthread_create_on_node(kswapd_helper, pgdat,
+					     pgdat->node_id, "kswapd%d:%d",
+					     pgdat->node_id, id + 1);
+		if (IS_ERR(tsk)) {
+			pr_warn("Failed to start kswapd helper on node %d, ret=%ld\n",
+				pgdat->node_id, PTR_ERR(tsk));
+			break;
+		}
+		WRITE_ONCE(pgdat->kswapd_helpers[id], tsk);
+		WRITE_ONCE(pgdat->nr_kswapd_helpers, id + 1);
+		wake_up_process(tsk);
+	}
+}
+
 /*
  * A zone is low on free memory or too fragmented for high-order memory.  If
  * kswapd should reclaim (direct reclaim is deferred), wake it up for the zone's
@@ -7383,6 +7577,7 @@ void __meminit kswapd_run(int nid)
 			wake_up_process(pgdat->kswapd);
 		}
 	}
+	kswapd_update_helpers(pgdat);
 	pgdat_kswapd_unlock(pgdat);
 }
 
@@ -7401,9 +7596,38 @@ void __meminit kswapd_stop(int nid)
 		kthread_stop(kswapd);
 		pgdat->kswapd = NULL;
 	}
+	kswapd_update_helpers(pgdat);
 	pgdat_kswapd_unlock(pgdat);
 }
 
+static int kswapd_threads_sysctl_handler(const struct ctl_table *table,
+					 int write, void *buffer,
+					 size_t *length, loff_t *ppos)
+{
+	static DEFINE_MUTEX(kswapd_threads_lock);
+	int ret, nid;
+
+	mutex_lock(&kswapd_threads_lock);
+	ret = proc_dointvec_minmax(table, write, buffer, length, ppos);
+	if (ret || !write)
+		goto out;
+
+	mem_hotplug_begin();
+	for_each_node_state(nid, N_MEMORY) {
+		pg_data_t *pgdat = NODE_DATA(nid);
+
+		pgdat_kswapd_lock(pgdat);
+		kswapd_update_helpers(pgdat);
+		pgdat_kswapd_unlock(pgdat);
+	}
+	mem_hotplug_done();
+out:
+	mutex_unlock(&kswapd_threads_lock);
+	return ret;
+}
+
+static const int kswapd_threads_max = KSWAPD_MAX_HELPERS + 1;
+
 static const struct ctl_table vmscan_sysctl_table[] = {
 	{
 		.procname	= "swappiness",
@@ -7414,6 +7638,15 @@ static const struct ctl_table vmscan_sysctl_table[] = {
 		.extra1		= SYSCTL_ZERO,
 		.extra2		= SYSCTL_TWO_HUNDRED,
 	},
+	{
+		.procname	= "kswapd_threads",
+		.data		= &kswapd_threads,
+		.maxlen		= sizeof(kswapd_threads),
+		.mode		= 0644,
+		.proc_handler	= kswapd_threads_sysctl_handler,
+		.extra1		= SYSCTL_ONE,
+		.extra2		= (void *)&kswapd_threads_max,
+	},
 #ifdef CONFIG_NUMA
 	{
 		.procname	= "zone_reclaim_mode",
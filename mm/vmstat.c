@@ -1276,6 +1276,7 @@ const char * const vmstat_text[] = {
 	"pgdemote_kswapd",
 	"pgdemote_direct",
 	"pgdemote_khugepaged",
+	"nr_kswapd_helpers",
 #ifdef CONFIG_HUGETLB_PAGE
 	"nr_hugetlb",
 #endif
@@ -1349,6 +1350,11 @@ const char * const vmstat_text[] = {
 	"thp_migration_success",
 	"thp_migration_fail",
 	"thp_migration_split",
+	"pgmigrate_copy_cpu",
+	"pgmigrate_copy_mt",
+#ifdef CONFIG_NUMA
+	"pgpromote_sampled_success",
+#endif
 #endif
 #ifdef CONFIG_COMPACTION
 	"compact_migrate_scanned",
@@ -1418,6 +1424,13 @@ const char * const vmstat_text[] = {
 	"nr_tlb_local_flush_one",
 #endif /* CONFIG_DEBUG_TLBFLUSH */
 
+	"ra_stream_hit",
+	"ra_stream_miss",
+	"ra_stream_wasted",
+	"fault_around_grow",
+	"fault_around_shrink",
+	"fault_around_unused",
+
 #ifdef CONFIG_SWAP
 	"swap_ra",
 	"swap_ra_hit",
@@ -167,6 +167,25 @@ static struct dentry *zs_stat_root;
 
 static size_t huge_class_size;
 
+/*
+ * Number of objects a per-CPU magazine can hold, and how many of them are
+ * moved to or from the size class at once when it runs empty or full.
+ */
+#define ZS_MAGAZINE_SIZE	16
+#define ZS_MAGAZINE_BATCH	(ZS_MAGAZINE_SIZE / 2)
+
+/*
+ * Per-CPU cache of objects that are allocated in the size class (and thus
+ * counted as in use there) but not owned by any user. zs_malloc() and
+ * zs_free() go through it so that most operations do not need class->lock.
+ * The lock is only ever contended by a remote flush.
+ */
+struct zs_magazine {
+	spinlock_t lock;
+	unsigned int nr;
+	unsigned long handles[ZS_MAGAZINE_SIZE];
+};
+
 struct size_class {
 	spinlock_t lock;
 	struct list_head fullness_list[NR_FULLNESS_GROUPS];
@@ -181,6 +200,8 @@ struct size_class {
 
 	unsigned int index;
 	struct zs_size_stat stats;
+	/* NULL for huge classes, or if the allocation failed */
+	struct zs_magazine __percpu *magazines;
 };
 
 /*
@@ -1341,6 +1362,170 @@ static unsigned long obj_malloc(struct zs_pool *pool,
 	return obj;
 }
 
+static void obj_free(int class_size, unsigned long obj)
+{
+	struct link_free *link;
+	struct zspage *zspage;
+	struct zpdesc *f_zpdesc;
+	unsigned long f_offset;
+	unsigned int f_objidx;
+	void *vaddr;
+
+
+	obj_to_location(obj, &f_zpdesc, &f_objidx);
+	f_offset = offset_in_page(class_size * f_objidx);
+	zspage = get_zspage(f_zpdesc);
+
+	vaddr = kmap_local_zpdesc(f_zpdesc);
+	link = (struct link_free *)(vaddr + f_offset);
+
+	/* Insert this object in containing zspage's freelist */
+	if (likely(!ZsHugePage(zspage)))
+		link->next = get_freeobj(zspage) << OBJ_TAG_BITS;
+	else
+		f_zpdesc->handle = 0;
+	set_freeobj(zspage, f_objidx);
+
+	kunmap_local(vaddr);
+	mod_zspage_inuse(zspage, -1);
+}
+
+/*
+ * Hand up to ZS_MAGAZINE_BATCH free objects of @class to @mag. Only zspages
+ * that already exist are used; allocating a new zspage is left to the
+ * regular zs_malloc() path. Called with mag->lock held.
+ */
+static void zs_magazine_refill(struct zs_pool *pool, struct size_class *class,
+			       struct zs_magazine *mag, gfp_t gfp)
+{
+	unsigned long *handles = mag->handles;
+	struct zspage *zspage;
+	int nr, i;
+
+	/* We are under a spinlock and only want to dip into slab caches */
+	gfp &= ~(__GFP_HIGHMEM | __GFP_MOVABLE | __GFP_DIRECT_RECLAIM);
+	nr = kmem_cache_alloc_bulk(pool->handle_cachep, gfp | __GFP_NOWARN,
+				   ZS_MAGAZINE_BATCH, (void **)handles);
+	if (!nr)
+		return;
+
+	spin_lock(&class->lock);
+	for (i = 0; i < nr; i++) {
+		zspage = find_get_zspage(class);
+		if (!zspage)
+			break;
+		obj_malloc(pool, zspage, handles[i]);
+		fix_fullness_group(class, zspage);
+		class_stat_add(class, ZS_OBJS_INUSE, 1);
+	}
+	spin_unlock(&class->lock);
+
+	if (i < nr)
+		kmem_cache_free_bulk(pool->handle_cachep, nr - i,
+				     (void **)&handles[i]);
+	mag->nr = i;
+}
+
+/*
+ * Return up to @nr objects from the top of @mag to @class. Called with
+ * mag->lock held. class->lock keeps the objects from being migrated, so
+ * pool->migrate_lock is not needed to resolve them.
+ */
+static void zs_magazine_drain(struct zs_pool *pool, struct size_class *class,
+			      struct zs_magazine *mag, unsigned int nr)
+{
+	unsigned int start = mag->nr - min(nr, mag->nr);
+	struct zpdesc *f_zpdesc;
+	struct zspage *zspage;
+	unsigned long obj;
+	unsigned int i;
+
+	if (start == mag->nr)
+		return;
+
+	spin_lock(&class->lock);
+	for (i = start; i < mag->nr; i++) {
+		obj = handle_to_obj(mag->handles[i]);
+		obj_to_zpdesc(obj, &f_zpdesc);
+		zspage = get_zspage(f_zpdesc);
+
+		class_stat_sub(class, ZS_OBJS_INUSE, 1);
+		obj_free(class->size, obj);
+		if (fix_fullness_group(class, zspage) == ZS_INUSE_RATIO_0)
+			free_zspage(pool, class, zspage);
+	}
+	spin_unlock(&class->lock);
+
+	kmem_cache_free_bulk(pool->handle_cachep, mag->nr - start,
+			     (void **)&mag->handles[start]);
+	mag->nr = start;
+}
+
+static unsigned long zs_magazine_alloc(struct zs_pool *pool,
+				       struct size_class *class, gfp_t gfp)
+{
+	struct zs_magazine *mag;
+	unsigned long handle = 0;
+
+	if (!class->magazines)
+		return 0;
+
+	/*
+	 * Being migrated after picking the magazine is fine, mag->lock is
+	 * what protects it.
+	 */
+	mag = raw_cpu_ptr(class->magazines);
+	spin_lock(&mag->lock);
+	if (!mag->nr)
+		zs_magazine_refill(pool, class, mag, gfp);
+	if (mag->nr)
+		handle = mag->handles[--mag->nr];
+	spin_unlock(&mag->lock);
+
+	return handle;
+}
+
+static bool zs_magazine_free(struct zs_pool *pool, struct size_class *class,
+			     unsigned long handle)
+{
+	struct zs_magazine *mag;
+
+	if (!class->magazines)
+		return false;
+
+	mag = raw_cpu_ptr(class->magazines);
+	spin_lock(&mag->lock);
+	if (mag->nr == ZS_MAGAZINE_SIZE)
+		zs_magazine_drain(pool, class, mag, ZS_MAGAZINE_BATCH);
+	mag->handles[mag->nr++] = handle;
+	spin_unlock(&mag->lock);
+
+	return true;
+}
+
+/*
+ * Give all objects cached in the per-CPU magazines back to their size
+ * classes, so that compaction can empty and release their zspages.
+ */
+static void zs_flush_magazines(struct zs_pool *pool)
+{
+	struct size_class *class;
+	struct zs_magazine *mag;
+	int i, cpu;
+
+	for (i = ZS_SIZE_CLASSES - 1; i >= 0; i--) {
+		class = pool->size_class[i];
+		if (!class || class->index != i || !class->magazines)
+			continue;
+
+		for_each_possible_cpu(cpu) {
+			mag = per_cpu_ptr(class->magazines, cpu);
+			spin_lock(&mag->lock);
+			zs_magazine_drain(pool, class, mag, mag->nr);
+			spin_unlock(&mag->lock);
+		}
+	}
+}
 
 /**
  * zs_malloc - Allocate block of given size from pool.
@@ -1365,14 +1550,18 @@ unsigned long zs_malloc(struct zs_pool *pool, size_t size, gfp_t gfp)
 	if (unlikely(size > ZS_MAX_ALLOC_SIZE))
 		return (unsigned long)ERR_PTR(-ENOSPC);
 
-	handle = cache_alloc_handle(pool, gfp);
-	if (!handle)
-		return (unsigned long)ERR_PTR(-ENOMEM);
-
 	/* extra space in chunk to keep the handle */
 	size += ZS_HANDLE_SIZE;
 	class = pool->size_class[get_size_class_index(size)];
 
+	handle = zs_magazine_alloc(pool, class, gfp);
+	if (handle)
+		return handle;
+
+	handle = cache_alloc_handle(pool, gfp);
+	if (!handle)
+		return (unsigned long)ERR_PTR(-ENOMEM);
+
 	/* class->lock effectively protects the zpage migration */
 	spin_lock(&class->lock);
 	zspage = find_get_zspage(class);
@@ -1410,34 +1599,6 @@ unsigned long zs_malloc(struct zs_pool *pool, size_t size, gfp_t gfp)
 }
 EXPORT_SYMBOL_GPL(zs_malloc);
 
-static void obj_free(int class_size, unsigned long obj)
-{
-	struct link_free *link;
-	struct zspage *zspage;
-	struct zpdesc *f_zpdesc;
-	unsigned long f_offset;
-	unsigned int f_objidx;
-	void *vaddr;
-
-
-	obj_to_location(obj, &f_zpdesc, &f_objidx);
-	f_offset = offset_in_page(class_size * f_objidx);
-	zspage = get_zspage(f_zpdesc);
-
-	vaddr = kmap_local_zpdesc(f_zpdesc);
-	link = (struct link_free *)(vaddr + f_offset);
-
-	/* Insert this object in containing zspage's freelist */
-	if (likely(!ZsHugePage(zspage)))
-		link->next = get_freeobj(zspage) << OBJ_TAG_BITS;
-	else
-		f_zpdesc->handle = 0;
-	set_freeobj(zspage, f_objidx);
-
-	kunmap_local(vaddr);
-	mod_zspage_inuse(zspage, -1);
-}
-
 void zs_free(struct zs_pool *pool, unsigned long handle)
 {
 	struct zspage *zspage;
@@ -1458,6 +1619,10 @@ void zs_free(struct zs_pool *pool, unsigned long handle)
 	obj_to_zpdesc(obj, &f_zpdesc);
 	zspage = get_zspage(f_zpdesc);
 	class = zspage_class(pool, zspage);
+	if (zs_magazine_free(pool, class, handle)) {
+		read_unlock(&pool->migrate_lock);
+		return;
+	}
 	spin_lock(&class->lock);
 	read_unlock(&pool->migrate_lock);
 
@@ -2022,6 +2187,8 @@ unsigned long zs_compact(struct zs_pool *pool)
 	if (atomic_xchg(&pool->compaction_in_progress, 1))
 		return 0;
 
+	zs_flush_magazines(pool);
+
 	for (i = ZS_SIZE_CLASSES - 1; i >= 0; i--) {
 		class = pool->size_class[i];
 		if (class->index != i)
@@ -2214,6 +2381,21 @@ struct zs_pool *zs_create_pool(const char *name)
 		spin_lock_init(&class->lock);
 		pool->size_class[i] = class;
 
+		/*
+		 * Magazines are not worth it for huge classes, every cached
+		 * object would pin a whole page.
+		 */
+		if (objs_per_zspage > 1) {
+			class->magazines = alloc_percpu(struct zs_magazine);
+			if (class->magazines) {
+				int cpu;
+
+				for_each_possible_cpu(cpu)
+					spin_lock_init(&per_cpu_ptr(class->magazines,
+								    cpu)->lock);
+			}
+		}
+
 		fullness = ZS_INUSE_RATIO_0;
 		while (fullness < NR_FULLNESS_GROUPS) {
 			INIT_LIST_HEAD(&class->fullness_list[fullness]);
@@ -2247,6 +2429,7 @@ void zs_destroy_pool(struct zs_pool *pool)
 	int i;
 
 	zs_unregister_shrinker(pool);
+	zs_flush_magazines(pool);
 	zs_flush_migration(pool);
 	zs_pool_stat_destroy(pool);
 
@@ -2267,6 +2450,7 @@ void zs_destroy_pool(struct zs_pool *pool)
 			pr_err("Class-%d fullness group %d is not empty\n",
 			       class->size, fg);
 		}
+		free_percpu(class->magazines);
 		kfree(class);
 	}
 
@@ -141,11 +141,19 @@ bool zswap_never_enabled(void)
 * data structures
 **********************************/
 
+/*
+ * Maximum number of pages of a large folio that are compressed with one
+ * round of acomp requests. Asynchronous compressors get this many requests
+ * in flight per CPU; synchronous ones only ever use the first slot.
+ */
+#define ZSWAP_MAX_BATCH_SIZE 8U
+
 struct crypto_acomp_ctx {
 	struct crypto_acomp *acomp;
-	struct acomp_req *req;
-	struct crypto_wait wait;
-	u8 *buffer;
+	struct acomp_req *reqs[ZSWAP_MAX_BATCH_SIZE];
+	struct crypto_wait waits[ZSWAP_MAX_BATCH_SIZE];
+	u8 *buffers[ZSWAP_MAX_BATCH_SIZE];
+	unsigned int nr_reqs;
 	struct mutex mutex;
 	bool is_sleepable;
 };
@@ -820,31 +828,44 @@ static int zswap_cpu_comp_prepare(unsigned int cpu, struct hlist_node *node)
 {
 	struct zswap_pool *pool = hlist_entry(node, struct zswap_pool, node);
 	struct crypto_acomp_ctx *acomp_ctx = per_cpu_ptr(pool->acomp_ctx, cpu);
+	struct acomp_req *reqs[ZSWAP_MAX_BATCH_SIZE] = { };
+	u8 *buffers[ZSWAP_MAX_BATCH_SIZE] = { };
 	struct crypto_acomp *acomp = NULL;
-	struct acomp_req *req = NULL;
-	u8 *buffer = NULL;
+	unsigned int nr_reqs, i;
 	int ret;
 
-	buffer = kmalloc_node(PAGE_SIZE * 2, GFP_KERNEL, cpu_to_node(cpu));
-	if (!buffer) {
-		ret = -ENOMEM;
-		goto fail;
-	}
-
 	acomp = crypto_alloc_acomp_node(pool->tfm_name, 0, 0, cpu_to_node(cpu));
 	if (IS_ERR(acomp)) {
 		pr_err("could not alloc crypto acomp %s : %ld\n",
 				pool->tfm_name, PTR_ERR(acomp));
 		ret = PTR_ERR(acomp);
+		acomp = NULL;
 		goto fail;
 	}
 
-	req = acomp_request_alloc(acomp);
-	if (!req) {
-		pr_err("could not alloc crypto acomp_request %s\n",
-		       pool->tfm_name);
-		ret = -ENOMEM;
-		goto fail;
+	/*
+	 * A synchronous compressor completes each request before returning,
+	 * so there is nothing to gain from more than one request per CPU.
+	 * Asynchronous (hardware) compressors get a full batch so that all
+	 * subpages of a large folio can be in flight at the same time.
+	 */
+	nr_reqs = acomp_is_async(acomp) ? ZSWAP_MAX_BATCH_SIZE : 1;
+
+	for (i = 0; i < nr_reqs; i++) {
+		buffers[i] = kmalloc_node(PAGE_SIZE * 2, GFP_KERNEL,
+					  cpu_to_node(cpu));
+		if (!buffers[i]) {
+			ret = -ENOMEM;
+			goto fail;
+		}
+
+		reqs[i] = acomp_request_alloc(acomp);
+		if (!reqs[i]) {
+			pr_err("could not alloc crypto acomp_request %s\n",
+			       pool->tfm_name);
+			ret = -ENOMEM;
+			goto fail;
+		}
 	}
 
 	/*
@@ -853,27 +874,35 @@ static int zswap_cpu_comp_prepare(unsigned int cpu, struct hlist_node *node)
 	 * again resulting in a deadlock.
 	 */
 	mutex_lock(&acomp_ctx->mutex);
-	crypto_init_wait(&acomp_ctx->wait);
+	for (i = 0; i < nr_reqs; i++) {
+		crypto_init_wait(&acomp_ctx->waits[i]);
 
-	/*
-	 * if the backend of acomp is async zip, crypto_req_done() will wakeup
-	 * crypto_wait_req(); if the backend of acomp is scomp, the callback
-	 * won't be called, crypto_wait_req() will return without blocking.
-	 */
-	acomp_request_set_callback(req, CRYPTO_TFM_REQ_MAY_BACKLOG,
-				   crypto_req_done, &acomp_ctx->wait);
+		/*
+		 * if the backend of acomp is async zip, crypto_req_done() will
+		 * wakeup crypto_wait_req(); if the backend of acomp is scomp,
+		 * the callback won't be called, crypto_wait_req() will return
+		 * without blocking.
+		 */
+		acomp_request_set_callback(reqs[i], CRYPTO_TFM_REQ_MAY_BACKLOG,
+					   crypto_req_done, &acomp_ctx->waits[i]);
 
-	acomp_ctx->buffer = buffer;
+		acomp_ctx->buffers[i] = buffers[i];
+		acomp_ctx->reqs[i] = reqs[i];
+	}
 	acomp_ctx->acomp = acomp;
 	acomp_ctx->is_sleepable = acomp_is_async(acomp);
-	acomp_ctx->req = req;
+	acomp_ctx->nr_reqs = nr_reqs;
 	mutex_unlock(&acomp_ctx->mutex);
 	return 0;
 
 fail:
+	for (i = 0; i < ZSWAP_MAX_BATCH_SIZE; i++) {
+		if (reqs[i])
+			acomp_request_free(reqs[i]);
+		kfree(buffers[i]);
+	}
 	if (acomp)
 		crypto_free_acomp(acomp);
-	kfree(buffer);
 	return ret;
 }
 
@@ -881,15 +910,20 @@ static int zswap_cpu_comp_dead(unsigned int cpu, struct hlist_node *node)
 {
 	struct zswap_pool *pool = hlist_entry(node, struct zswap_pool, node);
 	struct crypto_acomp_ctx *acomp_ctx = per_cpu_ptr(pool->acomp_ctx, cpu);
+	unsigned int i;
 
 	mutex_lock(&acomp_ctx->mutex);
 	if (!IS_ERR_OR_NULL(acomp_ctx)) {
-		if (!IS_ERR_OR_NULL(acomp_ctx->req))
-			acomp_request_free(acomp_ctx->req);
-		acomp_ctx->req = NULL;
+		for (i = 0; i < acomp_ctx->nr_reqs; i++) {
+			if (!IS_ERR_OR_NULL(acomp_ctx->reqs[i]))
+				acomp_request_free(acomp_ctx->reqs[i]);
+			acomp_ctx->reqs[i] = NULL;
+			kfree(acomp_ctx->buffers[i]);
+			acomp_ctx->buffers[i] = NULL;
+		}
+		acomp_ctx->nr_reqs = 0;
 		if (!IS_ERR_OR_NULL(acomp_ctx->acomp))
 			crypto_free_acomp(acomp_ctx->acomp);
-		kfree(acomp_ctx->buffer);
 	}
 	mutex_unlock(&acomp_ctx->mutex);
 
@@ -903,13 +937,13 @@ static struct crypto_acomp_ctx *acomp_ctx_get_cpu_lock(struct zswap_pool *pool)
 	for (;;) {
 		acomp_ctx = raw_cpu_ptr(pool->acomp_ctx);
 		mutex_lock(&acomp_ctx->mutex);
-		if (likely(acomp_ctx->req))
+		if (likely(acomp_ctx->reqs[0]))
 			return acomp_ctx;
 		/*
 		 * It is possible that we were migrated to a different CPU after
 		 * getting the per-CPU ctx but before the mutex was acquired. If
 		 * the old CPU got offlined, zswap_cpu_comp_dead() could have
-		 * already freed ctx->req (among other things) and set it to
+		 * already freed ctx->reqs (among other things) and set them to
 		 * NULL. Just try again on the new CPU that we ended up on.
 		 */
 		mutex_unlock(&acomp_ctx->mutex);
@@ -921,63 +955,89 @@ static void acomp_ctx_put_unlock(struct crypto_acomp_ctx *acomp_ctx)
 	mutex_unlock(&acomp_ctx->mutex);
 }
 
-static bool zswap_compress(struct page *page, struct zswap_entry *entry,
+/*
+ * Compress @nr consecutive pages of @folio starting at @index into the
+ * corresponding @entries. The pages are handed to the compressor in rounds
+ * of up to acomp_ctx->nr_reqs requests: all requests of a round are
+ * submitted before the first one is waited for, so an asynchronous
+ * compressor can work on the whole round in parallel. On failure, no
+ * zpool memory remains allocated for any of the entries.
+ */
+static bool zswap_compress(struct folio *folio, long index, unsigned int nr,
+			   struct zswap_entry *entries[],
 			   struct zswap_pool *pool)
 {
+	struct scatterlist inputs[ZSWAP_MAX_BATCH_SIZE];
+	struct scatterlist outputs[ZSWAP_MAX_BATCH_SIZE];
+	int errs[ZSWAP_MAX_BATCH_SIZE];
 	struct crypto_acomp_ctx *acomp_ctx;
-	struct scatterlist input, output;
 	int comp_ret = 0, alloc_ret = 0;
-	unsigned int dlen = PAGE_SIZE;
+	unsigned int i, j = 0, nr_batch, nr_stored;
+	unsigned int dlen;
 	unsigned long handle;
 	struct zpool *zpool;
 	char *buf;
 	gfp_t gfp;
 	u8 *dst;
 
-	acomp_ctx = acomp_ctx_get_cpu_lock(pool);
-	dst = acomp_ctx->buffer;
-	sg_init_table(&input, 1);
-	sg_set_page(&input, page, PAGE_SIZE, 0);
-
-	/*
-	 * We need PAGE_SIZE * 2 here since there maybe over-compression case,
-	 * and hardware-accelerators may won't check the dst buffer size, so
-	 * giving the dst buffer with enough length to avoid buffer overflow.
-	 */
-	sg_init_one(&output, dst, PAGE_SIZE * 2);
-	acomp_request_set_params(acomp_ctx->req, &input, &output, PAGE_SIZE, dlen);
-
-	/*
-	 * it maybe looks a little bit silly that we send an asynchronous request,
-	 * then wait for its completion synchronously. This makes the process look
-	 * synchronous in fact.
-	 * Theoretically, acomp supports users send multiple acomp requests in one
-	 * acomp instance, then get those requests done simultaneously. but in this
-	 * case, zswap actually does store and load page by page, there is no
-	 * existing method to send the second page before the first page is done
-	 * in one thread doing zwap.
-	 * but in different threads running on different cpu, we have different
-	 * acomp instance, so multiple threads can do (de)compression in parallel.
-	 */
-	comp_ret = crypto_wait_req(crypto_acomp_compress(acomp_ctx->req), &acomp_ctx->wait);
-	dlen = acomp_ctx->req->dlen;
-	if (comp_ret)
-		goto unlock;
-
 	zpool = pool->zpool;
 	gfp = __GFP_NORETRY | __GFP_NOWARN | __GFP_KSWAPD_RECLAIM;
 	if (zpool_malloc_support_movable(zpool))
 		gfp |= __GFP_HIGHMEM | __GFP_MOVABLE;
-	alloc_ret = zpool_malloc(zpool, dlen, gfp, &handle);
-	if (alloc_ret)
-		goto unlock;
 
-	buf = zpool_map_handle(zpool, handle, ZPOOL_MM_WO);
-	memcpy(buf, dst, dlen);
-	zpool_unmap_handle(zpool, handle);
+	acomp_ctx = acomp_ctx_get_cpu_lock(pool);
+	for (i = 0; i < nr; i += nr_batch) {
+		nr_batch = min(nr - i, acomp_ctx->nr_reqs);
+
+		for (j = 0; j < nr_batch; j++) {
+			struct acomp_req *req = acomp_ctx->reqs[j];
+
+			sg_init_table(&inputs[j], 1);
+			sg_set_page(&inputs[j], folio_page(folio, index + i + j),
+				    PAGE_SIZE, 0);
+
+			/*
+			 * We need PAGE_SIZE * 2 here since there maybe
+			 * over-compression case, and hardware-accelerators may
+			 * won't check the dst buffer size, so giving the dst
+			 * buffer with enough length to avoid buffer overflow.
+			 */
+			sg_init_one(&outputs[j], acomp_ctx->buffers[j],
+				    PAGE_SIZE * 2);
+			acomp_request_set_params(req, &inputs[j], &outputs[j],
+						 PAGE_SIZE, PAGE_SIZE);
+
+			/*
+			 * For an asynchronous compressor this only queues the
+			 * request; we collect the results below once the whole
+			 * round has been submitted. A synchronous compressor
+			 * has already finished when this returns.
+			 */
+			errs[j] = crypto_acomp_compress(req);
+		}
+
+		for (j = 0; j < nr_batch; j++)
+			errs[j] = crypto_wait_req(errs[j], &acomp_ctx->waits[j]);
+
+		for (j = 0; j < nr_batch; j++) {
+			comp_ret = errs[j];
+			if (comp_ret)
+				goto unlock;
 
-	entry->handle = handle;
-	entry->length = dlen;
+			dst = acomp_ctx->buffers[j];
+			dlen = acomp_ctx->reqs[j]->dlen;
+			alloc_ret = zpool_malloc(zpool, dlen, gfp, &handle);
+			if (alloc_ret)
+				goto unlock;
+
+			buf = zpool_map_handle(zpool, handle, ZPOOL_MM_WO);
+			memcpy(buf, dst, dlen);
+			zpool_unmap_handle(zpool, handle);
+
+			entries[i + j]->handle = handle;
+			entries[i + j]->length = dlen;
+		}
+	}
 
 unlock:
 	if (comp_ret == -ENOSPC || alloc_ret == -ENOSPC)
@@ -988,7 +1048,15 @@ static bool zswap_compress(struct page *page, struct zswap_entry *entry,
 		zswap_reject_alloc_fail++;
 
 	acomp_ctx_put_unlock(acomp_ctx);
-	return comp_ret == 0 && alloc_ret == 0;
+
+	if (comp_ret || alloc_ret) {
+		/* Free whatever was stored before the failing page */
+		nr_stored = i + j;
+		while (nr_stored--)
+			zpool_free(zpool, entries[nr_stored]->handle);
+		return false;
+	}
+	return true;
 }
 
 static void zswap_decompress(struct zswap_entry *entry, struct folio *folio)
@@ -1011,19 +1079,21 @@ static void zswap_decompress(struct zswap_entry *entry, struct folio *folio)
 	 */
 	if ((acomp_ctx->is_sleepable && !zpool_can_sleep_mapped(zpool)) ||
 	    !virt_addr_valid(src)) {
-		memcpy(acomp_ctx->buffer, src, entry->length);
-		src = acomp_ctx->buffer;
+		memcpy(acomp_ctx->buffers[0], src, entry->length);
+		src = acomp_ctx->buffers[0];
 		zpool_unmap_handle(zpool, entry->handle);
 	}
 
 	sg_init_one(&input, src, entry->length);
 	sg_init_table(&output, 1);
 	sg_set_folio(&output, folio, PAGE_SIZE, 0);
-	acomp_request_set_params(acomp_ctx->req, &input, &output, entry->length, PAGE_SIZE);
-	BUG_ON(crypto_wait_req(crypto_acomp_decompress(acomp_ctx->req), &acomp_ctx->wait));
-	BUG_ON(acomp_ctx->req->dlen != PAGE_SIZE);
+	acomp_request_set_params(acomp_ctx->reqs[0], &input, &output,
+				 entry->length, PAGE_SIZE);
+	BUG_ON(crypto_wait_req(crypto_acomp_decompress(acomp_ctx->reqs[0]),
+			       &acomp_ctx->waits[0]));
+	BUG_ON(acomp_ctx->reqs[0]->dlen != PAGE_SIZE);
 
-	if (src != acomp_ctx->buffer)
+	if (src != acomp_ctx->buffers[0])
 		zpool_unmap_handle(zpool, entry->handle);
 	acomp_ctx_put_unlock(acomp_ctx);
 }
@@ -1445,81 +1515,107 @@ static void shrink_worker(struct work_struct *w)
 * main API
 **********************************/
 
-static bool zswap_store_page(struct page *page,
-			     struct obj_cgroup *objcg,
-			     struct zswap_pool *pool)
+/*
+ * Store @nr consecutive pages of @folio starting at @index. All pages are
+ * compressed before any of them is published in the tree, so a compression
+ * or allocation failure leaves nothing behind for this range.
+ */
+static bool zswap_store_pages(struct folio *folio, long index,
+			      unsigned int nr, struct obj_cgroup *objcg,
+			      struct zswap_pool *pool)
 {
-	swp_entry_t page_swpentry = page_swap_entry(page);
-	struct zswap_entry *entry, *old;
-
-	/* allocate entry */
-	entry = zswap_entry_cache_alloc(GFP_KERNEL, page_to_nid(page));
-	if (!entry) {
-		zswap_reject_kmemcache_fail++;
-		return false;
+	struct zswap_entry *entries[ZSWAP_MAX_BATCH_SIZE];
+	int nid = folio_nid(folio);
+	unsigned int i, nr_entries;
+
+	/* allocate entries */
+	for (nr_entries = 0; nr_entries < nr; nr_entries++) {
+		entries[nr_entries] = zswap_entry_cache_alloc(GFP_KERNEL, nid);
+		if (!entries[nr_entries]) {
+			zswap_reject_kmemcache_fail++;
+			goto free_entries;
+		}
 	}
 
-	if (!zswap_compress(page, entry, pool))
-		goto compress_failed;
+	if (!zswap_compress(folio, index, nr, entries, pool))
+		goto free_entries;
 
-	old = xa_store(swap_zswap_tree(page_swpentry),
-		       swp_offset(page_swpentry),
-		       entry, GFP_KERNEL);
-	if (xa_is_err(old)) {
-		int err = xa_err(old);
+	for (i = 0; i < nr; i++) {
+		struct page *page = folio_page(folio, index + i);
+		swp_entry_t page_swpentry = page_swap_entry(page);
+		struct zswap_entry *entry = entries[i], *old;
 
-		WARN_ONCE(err != -ENOMEM, "unexpected xarray error: %d\n", err);
-		zswap_reject_alloc_fail++;
-		goto store_failed;
-	}
+		old = xa_store(swap_zswap_tree(page_swpentry),
+			       swp_offset(page_swpentry),
+			       entry, GFP_KERNEL);
+		if (xa_is_err(old)) {
+			int err = xa_err(old);
 
-	/*
-	 * We may have had an existing entry that became stale when
-	 * the folio was redirtied and now the new version is being
-	 * swapped out. Get rid of the old.
-	 */
-	if (old)
-		zswap_entry_free(old);
+			WARN_ONCE(err != -ENOMEM, "unexpected xarray error: %d\n", err);
+			zswap_reject_alloc_fail++;
+			goto store_failed;
+		}
 
-	/*
-	 * The entry is successfully compressed and stored in the tree, there is
-	 * no further possibility of failure. Grab refs to the pool and objcg,
-	 * charge zswap memory, and increment zswap_stored_pages.
-	 * The opposite actions will be performed by zswap_entry_free()
-	 * when the entry is removed from the tree.
-	 */
-	zswap_pool_get(pool);
-	if (objcg) {
-		obj_cgroup_get(objcg);
-		obj_cgroup_charge_zswap(objcg, entry->length);
-	}
-	atomic_long_inc(&zswap_stored_pages);
+		/*
+		 * We may have had an existing entry that became stale when
+		 * the folio was redirtied and now the new version is being
+		 * swapped out. Get rid of the old.
+		 */
+		if (old)
+			zswap_entry_free(old);
 
-	/*
-	 * We finish initializing the entry while it's already in xarray.
-	 * This is safe because:
-	 *
-	 * 1. Concurrent stores and invalidations are excluded by folio lock.
-	 *
-	 * 2. Writeback is excluded by the entry not being on the LRU yet.
-	 *    The publishing order matters to prevent writeback from seeing
-	 *    an incoherent entry.
-	 */
-	entry->pool = pool;
-	entry->swpentry = page_swpentry;
-	entry->objcg = objcg;
-	entry->referenced = true;
-	if (entry->length) {
-		INIT_LIST_HEAD(&entry->lru);
-		zswap_lru_add(&zswap_list_lru, entry);
+		/*
+		 * The entry is successfully compressed and stored in the tree,
+		 * there is no further possibility of failure. Grab refs to the
+		 * pool and objcg, charge zswap memory, and increment
+		 * zswap_stored_pages. The opposite actions will be performed
+		 * by zswap_entry_free() when the entry is removed from the
+		 * tree.
+		 */
+		zswap_pool_get(pool);
+		if (objcg) {
+			obj_cgroup_get(objcg);
+			obj_cgroup_charge_zswap(objcg, entry->length);
+		}
+		atomic_long_inc(&zswap_stored_pages);
+
+		/*
+		 * We finish initializing the entry while it's already in
+		 * xarray. This is safe because:
+		 *
+		 * 1. Concurrent stores and invalidations are excluded by
+		 *    folio lock.
+		 *
+		 * 2. Writeback is excluded by the entry not being on the LRU
+		 *    yet. The publishing order matters to prevent writeback
+		 *    from seeing an incoherent entry.
+		 */
+		entry->pool = pool;
+		entry->swpentry = page_swpentry;
+		entry->objcg = objcg;
+		entry->referenced = true;
+		if (entry->length) {
+			INIT_LIST_HEAD(&entry->lru);
+			zswap_lru_add(&zswap_list_lru, entry);
+		}
 	}
 
 	return true;
 
 store_failed:
-	zpool_free(pool->zpool, entry->handle);
-compress_failed:
-	zswap_entry_cache_free(entry);
+	/*
+	 * Entries before i are in the tree and will be invalidated by the
+	 * caller; the remaining ones were never published.
+	 */
+	for (; i < nr; i++) {
+		zpool_free(pool->zpool, entries[i]->handle);
+		zswap_entry_cache_free(entries[i]);
+	}
+	return false;
+
+free_entries:
+	for (i = 0; i < nr_entries; i++)
+		zswap_entry_cache_free(entries[i]);
 	return false;
 }
 
@@ -1565,10 +1661,11 @@ bool zswap_store(struct folio *folio)
 		mem_cgroup_put(memcg);
 	}
 
-	for (index = 0; index < nr_pages; ++index) {
-		struct page *page = folio_page(folio, index);
+	for (index = 0; index < nr_pages; index += ZSWAP_MAX_BATCH_SIZE) {
+		unsigned int nr = min_t(long, nr_pages - index,
+					ZSWAP_MAX_BATCH_SIZE);
 
-		if (!zswap_store_page(page, objcg, pool))
+		if (!zswap_store_pages(folio, index, nr, objcg, pool))
 			goto put_pool;
 	}
 
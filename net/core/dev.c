@@ -3996,8 +3996,9 @@ static inline int __dev_xmit_skb(struct sk_buff *skb, struct Qdisc *q,
 				 struct netdev_queue *txq)
 {
 	spinlock_t *root_lock = qdisc_lock(q);
-	struct sk_buff *to_free = NULL;
-	bool contended;
+	struct llist_node *ll_list, *first_n;
+	struct sk_buff *next, *to_free = NULL;
+	unsigned long defer_count = 0;
 	int rc;
 
 	qdisc_calculate_pkt_len(skb, q);
@@ -4041,53 +4042,82 @@ static inline int __dev_xmit_skb(struct sk_buff *skb, struct Qdisc *q,
 		kfree_skb_reason(skb, SKB_DROP_REASON_TC_RECLASSIFY_LOOP);
 		return NET_XMIT_DROP;
 	}
-	/*
-	 * Heuristic to force contended enqueues to serialize on a
-	 * separate lock before trying to get qdisc main lock.
-	 * This permits qdisc->running owner to get the lock more
-	 * often and dequeue packets faster.
-	 * On PREEMPT_RT it is possible to preempt the qdisc owner during xmit
-	 * and then other tasks will only enqueue packets. The packets will be
-	 * sent after the qdisc owner is scheduled again. To prevent this
-	 * scenario the task always serialize on the lock.
+	/* Stage the skb on q->defer_list.  Only the CPU that finds the list
+	 * empty takes the root lock, and it enqueues everything staged up to
+	 * that point in one go.  Other producers return right away instead
+	 * of all spinning on the root lock, which permits the qdisc->running
+	 * owner to get the lock more often and dequeue packets faster.
+	 *
+	 * This open codes llist_add() in order to bound the list: defer_count
+	 * is bumped at most once per skb, and only when the list is not
+	 * empty, as atomic_long_inc_return() is slow on some arches.  Many
+	 * classful qdiscs leave q->limit at 0, so also allow tx_queue_len.
 	 */
-	contended = qdisc_is_running(q) || IS_ENABLED(CONFIG_PREEMPT_RT);
-	if (unlikely(contended))
-		spin_lock(&q->busylock);
+	first_n = READ_ONCE(q->defer_list.first);
+	do {
+		if (first_n && !defer_count) {
+			defer_count = atomic_long_inc_return(&q->defer_count);
+			if (unlikely(defer_count > READ_ONCE(q->limit) &&
+				     defer_count > READ_ONCE(dev->tx_queue_len))) {
+				kfree_skb_reason(skb, SKB_DROP_REASON_QDISC_DROP);
+				return NET_XMIT_DROP;
+			}
+		}
+		skb->ll_node.next = first_n;
+	} while (!try_cmpxchg(&q->defer_list.first, &first_n, &skb->ll_node));
+
+	/* The CPU that queued the first skb will process ours as well. */
+	if (first_n)
+		return NET_XMIT_SUCCESS;
 
 	spin_lock(root_lock);
+
+	ll_list = llist_del_all(&q->defer_list);
+	/* Not atomic with llist_del_all(), so the list may briefly grow a
+	 * little over q->limit.
+	 */
+	atomic_long_set(&q->defer_count, 0);
+
+	ll_list = llist_reverse_order(ll_list);
+
 	if (unlikely(test_bit(__QDISC_STATE_DEACTIVATED, &q->state))) {
-		__qdisc_drop(skb, &to_free);
+		llist_for_each_entry_safe(skb, next, ll_list, ll_node)
+			__qdisc_drop(skb, &to_free);
 		rc = NET_XMIT_DROP;
 	} else if ((q->flags & TCQ_F_CAN_BYPASS) && !qdisc_qlen(q) &&
-		   qdisc_run_begin(q)) {
+		   !llist_next(ll_list) && qdisc_run_begin(q)) {
 		/*
 		 * This is a work-conserving queue; there are no old skbs
 		 * waiting to be sent out; and the qdisc is not running -
 		 * xmit the skb directly.
 		 */
-
+		DEBUG_NET_WARN_ON_ONCE(skb != llist_entry(ll_list,
+							  struct sk_buff,
+							  ll_node));
 		qdisc_bstats_update(q, skb);
 
-		if (sch_direct_xmit(skb, q, dev, txq, root_lock, true)) {
-			if (unlikely(contended)) {
-				spin_unlock(&q->busylock);
-				contended = false;
-			}
+		if (sch_direct_xmit(skb, q, dev, txq, root_lock, true))
 			__qdisc_run(q);
-		}
 
 		qdisc_run_end(q);
 		rc = NET_XMIT_SUCCESS;
 	} else {
+		int count = 0;
+
 		WRITE_ONCE(q->owner, smp_processor_id());
-		rc = dev_qdisc_enqueue(skb, q, &to_free, txq);
+		llist_for_each_entry_safe(skb, next, ll_list, ll_node) {
+			if (next) {
+				prefetch(next);
+				skb_mark_not_on_list(skb);
+			}
+			rc = dev_qdisc_enqueue(skb, q, &to_free, txq);
+			count++;
+		}
 		WRITE_ONCE(q->owner, -1);
+		/* Enqueue results of deferred skbs are not reported back. */
+		if (count != 1)
+			rc = NET_XMIT_SUCCESS;
 		if (qdisc_run_begin(q)) {
-			if (unlikely(contended)) {
-				spin_unlock(&q->busylock);
-				contended = false;
-			}
 			__qdisc_run(q);
 			qdisc_run_end(q);
 		}
@@ -4096,8 +4126,6 @@ static inline int __dev_xmit_skb(struct sk_buff *skb, struct Qdisc *q,
 	if (unlikely(to_free))
 		kfree_skb_list_reason(to_free,
 				      tcf_get_drop_reason(to_free));
-	if (unlikely(contended))
-		spin_unlock(&q->busylock);
 	return rc;
 }
 
@@ -7082,6 +7110,7 @@ static void napi_restore_config(struct napi_struct *n)
 	n->defer_hard_irqs = n->config->defer_hard_irqs;
 	n->gro_flush_timeout = n->config->gro_flush_timeout;
 	n->irq_suspend_timeout = n->config->irq_suspend_timeout;
+	n->threaded_busy_poll_timeout = n->config->threaded_busy_poll_timeout;
 
 	if (n->dev->irq_affinity_auto &&
 	    test_bit(NAPI_STATE_HAS_NOTIFIER, &n->state))
@@ -7103,6 +7132,7 @@ static void napi_save_config(struct napi_struct *n)
 	n->config->defer_hard_irqs = n->defer_hard_irqs;
 	n->config->gro_flush_timeout = n->gro_flush_timeout;
 	n->config->irq_suspend_timeout = n->irq_suspend_timeout;
+	n->config->threaded_busy_poll_timeout = n->threaded_busy_poll_timeout;
 	napi_hash_del(n);
 }
 
@@ -7423,11 +7453,12 @@ static int napi_thread_wait(struct napi_struct *napi)
 	return -1;
 }
 
-static void napi_threaded_poll_loop(struct napi_struct *napi)
+static int napi_threaded_poll_loop(struct napi_struct *napi, bool busy_poll)
 {
 	struct bpf_net_context __bpf_net_ctx, *bpf_net_ctx;
 	struct softnet_data *sd;
 	unsigned long last_qs = jiffies;
+	int work = 0;
 
 	for (;;) {
 		bool repoll = false;
@@ -7440,7 +7471,12 @@ static void napi_threaded_poll_loop(struct napi_struct *napi)
 		sd->in_napi_threaded_poll = true;
 
 		have = netpoll_poll_lock(napi);
-		__napi_poll(napi, &repoll);
+		work += __napi_poll(napi, &repoll);
+		/* napi_complete_done() skipped the flush, do what it would */
+		if (busy_poll && !repoll) {
+			gro_flush(&napi->gro, HZ >= 1000);
+			gro_normal_list(&napi->gro);
+		}
 		netpoll_poll_unlock(have);
 
 		sd->in_napi_threaded_poll = false;
@@ -7454,20 +7490,54 @@ static void napi_threaded_poll_loop(struct napi_struct *napi)
 		bpf_net_ctx_clear(bpf_net_ctx);
 		local_bh_enable();
 
-		if (!repoll)
+		/* When busy polling, the driver's napi_complete_done() did not
+		 * release the NAPI and we are called again right away, so
+		 * report a quiescent state on every pass.
+		 */
+		if (!repoll && !busy_poll)
 			break;
 
 		rcu_softirq_qs_periodic(last_qs);
 		cond_resched();
+
+		if (!repoll)
+			break;
 	}
+
+	return work;
 }
 
 static int napi_threaded_poll(void *data)
 {
 	struct napi_struct *napi = data;
+	u64 last_work = 0;
+
+	while (!napi_thread_wait(napi)) {
+		unsigned long timeout = napi_get_threaded_busy_poll_timeout(napi);
+		unsigned long val = READ_ONCE(napi->state);
+		bool busy_poll = false;
+
+		/* Keep the NAPI scheduled, and thus its IRQ masked, while
+		 * there was work within the last @timeout ns.  Owning
+		 * NAPI_STATE_IN_BUSY_POLL makes napi_complete_done() leave
+		 * the NAPI alone, much like sk_busy_loop() does.
+		 */
+		if (timeout && (val & NAPIF_STATE_THREADED) &&
+		    !(val & NAPIF_STATE_DISABLE)) {
+			u64 now = local_clock();
 
-	while (!napi_thread_wait(napi))
-		napi_threaded_poll_loop(napi);
+			if (!(val & NAPIF_STATE_IN_BUSY_POLL))
+				last_work = now;
+			busy_poll = now - last_work < timeout;
+		}
+
+		if (busy_poll != !!(val & NAPIF_STATE_IN_BUSY_POLL))
+			assign_bit(NAPI_STATE_IN_BUSY_POLL, &napi->state,
+				   busy_poll);
+
+		if (napi_threaded_poll_loop(napi, busy_poll) && busy_poll)
+			last_work = local_clock();
+	}
 
 	return 0;
 }
@@ -12635,7 +12705,7 @@ static void run_backlog_napi(unsigned int cpu)
 {
 	struct softnet_data *sd = per_cpu_ptr(&softnet_data, cpu);
 
-	napi_threaded_poll_loop(&sd->backlog);
+	napi_threaded_poll_loop(&sd->backlog, false);
 }
 
 static void backlog_napi_setup(unsigned int cpu)
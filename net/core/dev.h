@@ -299,6 +299,34 @@ static inline void napi_set_irq_suspend_timeout(struct napi_struct *n,
 	WRITE_ONCE(n->irq_suspend_timeout, timeout);
 }
 
+/**
+ * napi_get_threaded_busy_poll_timeout - get the threaded_busy_poll_timeout
+ * @n: napi struct to get the threaded_busy_poll_timeout from
+ *
+ * Return: the per-NAPI value of the threaded_busy_poll_timeout field.
+ */
+static inline unsigned long
+napi_get_threaded_busy_poll_timeout(const struct napi_struct *n)
+{
+	return READ_ONCE(n->threaded_busy_poll_timeout);
+}
+
+/**
+ * napi_set_threaded_busy_poll_timeout - set the threaded_busy_poll_timeout
+ * @n: napi struct to set the threaded_busy_poll_timeout
+ * @timeout: timeout value to set
+ *
+ * A non-zero value makes the NAPI kthread of a threaded NAPI keep polling
+ * with device interrupts masked, until it has found no work for @timeout
+ * nanoseconds.
+ */
+static inline void
+napi_set_threaded_busy_poll_timeout(struct napi_struct *n,
+				    unsigned long timeout)
+{
+	WRITE_ONCE(n->threaded_busy_poll_timeout, timeout);
+}
+
 int rps_cpumask_housekeeping(struct cpumask *mask);
 
 #if defined(CONFIG_DEBUG_NET) && defined(CONFIG_BPF_SYSCALL)
@@ -5,8 +5,6 @@
 #include <trace/events/net.h>
 #include <linux/skbuff_ref.h>
 
-#define MAX_GRO_SKBS 8
-
 static DEFINE_SPINLOCK(offload_lock);
 
 /**
@@ -444,7 +442,7 @@ static void gro_flush_oldest(struct gro_node *gro, struct list_head *head)
 
 	oldest = list_last_entry(head, struct sk_buff, list);
 
-	/* We are called with head length >= MAX_GRO_SKBS, so this is
+	/* We are called with head length >= gro_flow_limit, so this is
 	 * impossible.
 	 */
 	if (WARN_ON_ONCE(!oldest))
@@ -536,7 +534,10 @@ static enum gro_result dev_gro_receive(struct gro_node *gro,
 	if (NAPI_GRO_CB(skb)->flush)
 		goto normal;
 
-	if (unlikely(gro_list->count >= MAX_GRO_SKBS))
+	/* Hosts with many concurrent flows per RX queue may raise the per
+	 * bucket limit, at the cost of a longer gro_list_prepare() walk.
+	 */
+	if (unlikely(gro_list->count >= READ_ONCE(net_hotdata.gro_flow_limit)))
 		gro_flush_oldest(gro, &gro_list->list);
 	else
 		gro_list->count++;
@@ -49,6 +49,9 @@ do {						\
 
 #define PNEIGH_HASHMASK		0xF
 
+/* Hash buckets neigh_periodic_work() scans per tbl->lock hold */
+#define NEIGH_GC_BATCH		64
+
 static void neigh_timer_handler(struct timer_list *t);
 static void __neigh_notify(struct neighbour *n, int type, int flags,
 			   u32 pid);
@@ -959,6 +962,14 @@ static void neigh_periodic_work(struct work_struct *work)
 			}
 			write_unlock(&n->lock);
 		}
+		/*
+		 * Walk a batch of buckets per lock hold, so that scanning
+		 * a large table does not bounce the lock once per bucket,
+		 * but step aside as soon as someone else wants it.
+		 */
+		if ((i + 1) % NEIGH_GC_BATCH && !need_resched() &&
+		    !rwlock_needbreak(&tbl->lock))
+			continue;
 		/*
 		 * It's fine to release lock here, even if hash table
 		 * grows while we are preempted.
@@ -164,6 +164,7 @@ static int
 netdev_nl_napi_fill_one(struct sk_buff *rsp, struct napi_struct *napi,
 			const struct genl_info *info)
 {
+	unsigned long threaded_busy_poll_timeout;
 	unsigned long irq_suspend_timeout;
 	unsigned long gro_flush_timeout;
 	u32 napi_defer_hard_irqs;
@@ -207,6 +208,11 @@ netdev_nl_napi_fill_one(struct sk_buff *rsp, struct napi_struct *napi,
 			 gro_flush_timeout))
 		goto nla_put_failure;
 
+	threaded_busy_poll_timeout = napi_get_threaded_busy_poll_timeout(napi);
+	if (nla_put_uint(rsp, NETDEV_A_NAPI_THREADED_BUSY_POLL_TIMEOUT,
+			 threaded_busy_poll_timeout))
+		goto nla_put_failure;
+
 	genlmsg_end(rsp, hdr);
 
 	return 0;
@@ -322,6 +328,7 @@ int netdev_nl_napi_get_dumpit(struct sk_buff *skb, struct netlink_callback *cb)
 static int
 netdev_nl_napi_set_config(struct napi_struct *napi, struct genl_info *info)
 {
+	u64 threaded_busy_poll_timeout = 0;
 	u64 irq_suspend_timeout = 0;
 	u64 gro_flush_timeout = 0;
 	u32 defer = 0;
@@ -341,6 +348,11 @@ netdev_nl_napi_set_config(struct napi_struct *napi, struct genl_info *info)
 		napi_set_gro_flush_timeout(napi, gro_flush_timeout);
 	}
 
+	if (info->attrs[NETDEV_A_NAPI_THREADED_BUSY_POLL_TIMEOUT]) {
+		threaded_busy_poll_timeout = nla_get_uint(info->attrs[NETDEV_A_NAPI_THREADED_BUSY_POLL_TIMEOUT]);
+		napi_set_threaded_busy_poll_timeout(napi, threaded_busy_poll_timeout);
+	}
+
 	return 0;
 }
 
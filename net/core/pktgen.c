@@ -199,6 +199,7 @@
 	pf(SVID_RND)		/* Random SVLAN ID */			\
 	pf(NODE)		/* Node memory alloc*/			\
 	pf(SHARED)		/* Shared SKB */			\
+	pf(FLOW_ZIPF)		/* Skewed random flows */		\
 
 #define pf(flag)		flag##_SHIFT,
 enum pkt_flags {
@@ -2382,7 +2383,14 @@ static inline int f_pick(struct pktgen_dev *pkt_dev)
 				pkt_dev->curfl = 0; /*reset */
 		}
 	} else {
-		flow = get_random_u32_below(pkt_dev->cflows);
+		if (pkt_dev->flags & F_FLOW_ZIPF)
+			/* Flow k (from 1) is picked with a probability of
+			 * about 1/(k(k+1)), a Zipf-like law with exponent 2.
+			 */
+			flow = pkt_dev->cflows /
+			       (get_random_u32_below(pkt_dev->cflows) + 1) - 1;
+		else
+			flow = get_random_u32_below(pkt_dev->cflows);
 		pkt_dev->curfl = flow;
 
 		if (pkt_dev->flows[flow].count > pkt_dev->lflow) {
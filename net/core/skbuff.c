@@ -1816,7 +1816,12 @@ static void __msg_zerocopy_callback(struct ubuf_info_msgzc *uarg)
 	}
 	spin_unlock_irqrestore(&q->lock, flags);
 
-	sk_error_report(sk);
+	/* A range merged into the queued tail notification was already
+	 * reported and will be read together with it, do not wake the
+	 * reader once more for every completed send.
+	 */
+	if (!skb)
+		sk_error_report(sk);
 
 release:
 	consume_skb(skb);
@@ -5073,14 +5078,18 @@ static void skb_extensions_init(void) {}
 
 void __init skb_init(void)
 {
-	net_hotdata.skbuff_cache = kmem_cache_create_usercopy("skbuff_head_cache",
+	struct kmem_cache_args skbuff_args = {
+		.useroffset	= offsetof(struct sk_buff, cb),
+		.usersize	= sizeof_field(struct sk_buff, cb),
+		/* skb heads are allocated and freed in bursts on every cpu */
+		.sheaf_capacity	= 32,
+	};
+
+	net_hotdata.skbuff_cache = kmem_cache_create("skbuff_head_cache",
 					      sizeof(struct sk_buff),
-					      0,
+					      &skbuff_args,
 					      SLAB_HWCACHE_ALIGN|SLAB_PANIC|
-						FLAG_SKB_NO_MERGE,
-					      offsetof(struct sk_buff, cb),
-					      sizeof_field(struct sk_buff, cb),
-					      NULL);
+						FLAG_SKB_NO_MERGE);
 	net_hotdata.skbuff_fclone_cache = kmem_cache_create("skbuff_fclone_cache",
 						sizeof(struct sk_buff_fclones),
 						0,
@@ -524,15 +524,23 @@ static struct sock *run_bpf_filter(struct sock_reuseport *reuse, u16 socks,
 	return reuse->socks[index];
 }
 
+/* A listener whose accept queue is full would only drop the connection. */
+static bool reuseport_sk_overloaded(const struct sock *sk)
+{
+	return sk->sk_state == TCP_LISTEN && sk_acceptq_is_full(sk);
+}
+
 static struct sock *reuseport_select_sock_by_hash(struct sock_reuseport *reuse,
 						  u32 hash, u16 num_socks)
 {
-	struct sock *first_valid_sk = NULL;
+	struct sock *first_valid_sk = NULL, *first_node_sk = NULL;
+	int cpu = raw_smp_processor_id();
 	int i, j;
 
 	i = j = reciprocal_scale(hash, num_socks);
 	do {
 		struct sock *sk = reuse->socks[i];
+		int incoming_cpu;
 
 		if (sk->sk_state != TCP_ESTABLISHED) {
 			/* Paired with WRITE_ONCE() in __reuseport_(get|put)_incoming_cpu(). */
@@ -540,9 +548,17 @@ static struct sock *reuseport_select_sock_by_hash(struct sock_reuseport *reuse,
 				return sk;
 
 			/* Paired with WRITE_ONCE() in reuseport_update_incoming_cpu(). */
-			if (READ_ONCE(sk->sk_incoming_cpu) == raw_smp_processor_id())
+			incoming_cpu = READ_ONCE(sk->sk_incoming_cpu);
+			if (incoming_cpu == cpu && !reuseport_sk_overloaded(sk))
 				return sk;
 
+			/* Otherwise prefer a socket served on the same node. */
+			if (!first_node_sk &&
+			    (unsigned int)incoming_cpu < nr_cpu_ids &&
+			    cpu_to_node(incoming_cpu) == cpu_to_node(cpu) &&
+			    !reuseport_sk_overloaded(sk))
+				first_node_sk = sk;
+
 			if (!first_valid_sk)
 				first_valid_sk = sk;
 		}
@@ -552,7 +568,7 @@ static struct sock *reuseport_select_sock_by_hash(struct sock_reuseport *reuse,
 			i = 0;
 	} while (i != j);
 
-	return first_valid_sk;
+	return first_node_sk ? : first_valid_sk;
 }
 
 /**
@@ -30,6 +30,7 @@
 #include "dev.h"
 
 static int int_3600 = 3600;
+static int max_gro_flow_limit = 256;
 static int min_sndbuf = SOCK_MIN_SNDBUF;
 static int min_rcvbuf = SOCK_MIN_RCVBUF;
 static int max_skb_frags = MAX_SKB_FRAGS;
@@ -623,6 +624,15 @@ static struct ctl_table net_core_table[] = {
 		.proc_handler	= proc_dointvec_minmax,
 		.extra1		= SYSCTL_ONE,
 	},
+	{
+		.procname	= "gro_flow_limit",
+		.data		= &net_hotdata.gro_flow_limit,
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= SYSCTL_ONE,
+		.extra2		= &max_gro_flow_limit,
+	},
 	{
 		.procname	= "netdev_unregister_timeout_secs",
 		.data		= &netdev_unregister_timeout_secs,
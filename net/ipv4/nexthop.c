@@ -1826,9 +1826,18 @@ static bool nh_res_bucket_migrate(struct nh_res_table *res_table,
 
 #define NH_RES_UPKEEP_DW_MINIMUM_INTERVAL (HZ / 2)
 
+/* At most 1 / 2^shift of the buckets are moved per upkeep run because they
+ * went idle.  A large weight change thus shifts flows over a few runs rather
+ * than all at once, bounding both the number of flows moved and the driver
+ * and netlink notifications sent per run.  Forced migrations are exempt.
+ */
+#define NH_RES_UPKEEP_MIGRATE_SHIFT 3
+
 static void nh_res_table_upkeep(struct nh_res_table *res_table,
 				bool notify, bool notify_nl)
 {
+	u16 budget = max(res_table->num_nh_buckets >>
+			 NH_RES_UPKEEP_MIGRATE_SHIFT, 1);
 	unsigned long now = jiffies;
 	unsigned long deadline;
 	u16 i;
@@ -1847,12 +1856,25 @@ static void nh_res_table_upkeep(struct nh_res_table *res_table,
 
 	for (i = 0; i < res_table->num_nh_buckets; i++) {
 		struct nh_res_bucket *bucket = &res_table->nh_buckets[i];
-		bool force;
+		bool force, limited;
 
 		if (nh_res_bucket_should_migrate(res_table, bucket,
 						 &deadline, &force)) {
-			if (!nh_res_bucket_migrate(res_table, i, notify,
-						   notify_nl, force)) {
+			/* Forced migrations are not limited: buckets without
+			 * a valid nexthop must move now, and unbalanced_timer
+			 * bounds how long the group stays unbalanced.  A zero
+			 * idle_timer asks for immediate rebalancing as well.
+			 */
+			limited = !force && res_table->idle_timer;
+			if (limited && !budget) {
+				deadline = now;
+				continue;
+			}
+			if (nh_res_bucket_migrate(res_table, i, notify,
+						  notify_nl, force)) {
+				if (limited)
+					budget--;
+			} else {
 				unsigned long idle_point;
 
 				/* A driver can override the migration
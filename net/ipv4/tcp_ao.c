@@ -565,12 +565,9 @@ int tcp_ao_hash_hdr(unsigned short int family, char *ao_hash,
 {
 	int tkey_len = tcp_ao_digest_size(key);
 	int hash_offset = ao_hash - (char *)th;
+	/* sigpool hashes are synchronous, the digest may live on stack */
+	u8 hash_buf[HASH_MAX_DIGESTSIZE];
 	struct tcp_sigpool hp;
-	void *hash_buf = NULL;
-
-	hash_buf = kmalloc(tkey_len, GFP_ATOMIC);
-	if (!hash_buf)
-		goto clear_hash_noput;
 
 	if (tcp_sigpool_start(key->tcp_sigpool_id, &hp))
 		goto clear_hash_noput;
@@ -607,14 +604,12 @@ int tcp_ao_hash_hdr(unsigned short int family, char *ao_hash,
 
 	memcpy(ao_hash, hash_buf, tcp_ao_maclen(key));
 	tcp_sigpool_end(&hp);
-	kfree(hash_buf);
 	return 0;
 
 clear_hash:
 	tcp_sigpool_end(&hp);
 clear_hash_noput:
 	memset(ao_hash, 0, tcp_ao_maclen(key));
-	kfree(hash_buf);
 	return 1;
 }
 
@@ -625,12 +620,8 @@ int tcp_ao_hash_skb(unsigned short int family,
 {
 	const struct tcphdr *th = tcp_hdr(skb);
 	int tkey_len = tcp_ao_digest_size(key);
+	u8 hash_buf[HASH_MAX_DIGESTSIZE];
 	struct tcp_sigpool hp;
-	void *hash_buf = NULL;
-
-	hash_buf = kmalloc(tkey_len, GFP_ATOMIC);
-	if (!hash_buf)
-		goto clear_hash_noput;
 
 	if (tcp_sigpool_start(key->tcp_sigpool_id, &hp))
 		goto clear_hash_noput;
@@ -658,14 +649,12 @@ int tcp_ao_hash_skb(unsigned short int family,
 
 	memcpy(ao_hash, hash_buf, tcp_ao_maclen(key));
 	tcp_sigpool_end(&hp);
-	kfree(hash_buf);
 	return 0;
 
 clear_hash:
 	tcp_sigpool_end(&hp);
 clear_hash_noput:
 	memset(ao_hash, 0, tcp_ao_maclen(key));
-	kfree(hash_buf);
 	return 1;
 }
 
@@ -11,19 +11,29 @@
 #include <linux/init.h>
 #include <linux/module.h>
 #include <net/netfilter/nf_flow_table.h>
+#include <net/netfilter/nf_conntrack_acct.h>
 #include <linux/bpf.h>
 #include <linux/btf.h>
 #include <net/xdp.h>
 
 /* bpf_flowtable_opts - options for bpf flowtable helpers
  * @error: out parameter, set for any encountered error
+ * @flags: input parameter, BPF_FLOWTABLE_F_* flags
  */
 struct bpf_flowtable_opts {
 	s32 error;
+	u32 flags;
 };
 
 enum {
-	NF_BPF_FLOWTABLE_OPTS_SZ = 4,
+	NF_BPF_FLOWTABLE_OPTS_SZ = 8,
+	NF_BPF_FLOWTABLE_OPTS_OLD_SZ = 4,
+};
+
+/* The program forwards the packet itself, count it against the flow */
+enum {
+	BPF_FLOWTABLE_F_ACCOUNT = (1U << 0),
+	BPF_FLOWTABLE_F_MASK = BPF_FLOWTABLE_F_ACCOUNT,
 };
 
 __diag_push();
@@ -32,15 +42,31 @@ __diag_ignore_all("-Wmissing-prototypes",
 
 __bpf_kfunc_start_defs();
 
+static void bpf_xdp_flow_account(struct xdp_buff *xdp,
+				 struct flow_offload *nf_flow,
+				 enum flow_offload_tuple_dir dir)
+{
+	struct net_device *dev = xdp->rxq->dev;
+	unsigned int len;
+
+	/* The ingress hook sees the packet without its link-layer header */
+	len = xdp_get_buff_len(xdp);
+	if (len <= dev->hard_header_len)
+		return;
+
+	nf_ct_acct_update(nf_flow->ct, dir, len - dev->hard_header_len);
+}
+
 static struct flow_offload_tuple_rhash *
-bpf_xdp_flow_tuple_lookup(struct net_device *dev,
-			  struct flow_offload_tuple *tuple, __be16 proto)
+bpf_xdp_flow_tuple_lookup(struct xdp_buff *xdp,
+			  struct flow_offload_tuple *tuple, __be16 proto,
+			  u32 flags)
 {
 	struct flow_offload_tuple_rhash *tuplehash;
 	struct nf_flowtable *nf_flow_table;
 	struct flow_offload *nf_flow;
 
-	nf_flow_table = nf_flowtable_by_dev(dev);
+	nf_flow_table = nf_flowtable_by_dev(xdp->rxq->dev);
 	if (!nf_flow_table)
 		return ERR_PTR(-ENOENT);
 
@@ -52,6 +78,10 @@ bpf_xdp_flow_tuple_lookup(struct net_device *dev,
 			       tuplehash[tuplehash->tuple.dir]);
 	flow_offload_refresh(nf_flow_table, nf_flow, false);
 
+	if ((flags & BPF_FLOWTABLE_F_ACCOUNT) &&
+	    (nf_flow_table->flags & NF_FLOWTABLE_COUNTER))
+		bpf_xdp_flow_account(xdp, nf_flow, tuplehash->tuple.dir);
+
 	return tuplehash;
 }
 
@@ -68,13 +98,23 @@ bpf_xdp_flow_lookup(struct xdp_md *ctx, struct bpf_fib_lookup *fib_tuple,
 		.dst_port = fib_tuple->dport,
 	};
 	struct flow_offload_tuple_rhash *tuplehash;
+	u32 flags = 0;
 	__be16 proto;
 
-	if (opts_len != NF_BPF_FLOWTABLE_OPTS_SZ) {
+	if (opts_len != NF_BPF_FLOWTABLE_OPTS_SZ &&
+	    opts_len != NF_BPF_FLOWTABLE_OPTS_OLD_SZ) {
 		opts->error = -EINVAL;
 		return NULL;
 	}
 
+	if (opts_len == NF_BPF_FLOWTABLE_OPTS_SZ) {
+		flags = opts->flags;
+		if (flags & ~BPF_FLOWTABLE_F_MASK) {
+			opts->error = -EINVAL;
+			return NULL;
+		}
+	}
+
 	switch (fib_tuple->family) {
 	case AF_INET:
 		tuple.src_v4.s_addr = fib_tuple->ipv4_src;
@@ -91,7 +131,7 @@ bpf_xdp_flow_lookup(struct xdp_md *ctx, struct bpf_fib_lookup *fib_tuple,
 		return NULL;
 	}
 
-	tuplehash = bpf_xdp_flow_tuple_lookup(xdp->rxq->dev, &tuple, proto);
+	tuplehash = bpf_xdp_flow_tuple_lookup(xdp, &tuple, proto, flags);
 	if (IS_ERR(tuplehash)) {
 		opts->error = PTR_ERR(tuplehash);
 		return NULL;
@@ -113,10 +113,23 @@ struct fl_flow_tmplt {
 	struct tcf_chain *chain;
 };
 
+/* Union of the dissectors and key ranges of all masks of a classifier, so
+ * that fl_classify() dissects each packet once rather than once per mask.
+ * Key offsets are fixed by struct fl_flow_key, so they agree between masks.
+ * A reader may find masks on the list that were added after it loaded the
+ * union; fl_dissector_covers() makes it skip those.
+ */
+struct fl_flow_dissector {
+	struct flow_dissector dissector;
+	struct fl_flow_mask_range range;
+	struct rcu_head rcu;
+};
+
 struct cls_fl_head {
 	struct rhashtable ht;
 	spinlock_t masks_lock; /* Protect masks list */
 	struct list_head masks;
+	struct fl_flow_dissector __rcu *dissector;
 	struct list_head hw_filters;
 	struct rcu_work rwork;
 	struct idr handle_idr;
@@ -216,9 +229,17 @@ static bool fl_mask_fits_tmplt(struct fl_flow_tmplt *tmplt,
 }
 
 static void fl_clear_masked_range(struct fl_flow_key *key,
-				  struct fl_flow_mask *mask)
+				  const struct fl_flow_mask_range *range)
 {
-	memset(fl_key_get_start(key, mask), 0, fl_mask_range(mask));
+	memset((u8 *)key + range->start, 0, range->end - range->start);
+}
+
+static bool fl_dissector_covers(const struct fl_flow_dissector *fd,
+				const struct fl_flow_mask *mask)
+{
+	return mask->range.start >= fd->range.start &&
+	       mask->range.end <= fd->range.end &&
+	       !(mask->dissector.used_keys & ~fd->dissector.used_keys);
 }
 
 static bool fl_range_port_dst_cmp(struct cls_fl_filter *filter,
@@ -328,27 +349,36 @@ TC_INDIRECT_SCOPE int fl_classify(struct sk_buff *skb,
 	struct cls_fl_head *head = rcu_dereference_bh(tp->root);
 	bool post_ct = tc_skb_cb(skb)->post_ct;
 	u16 zone = tc_skb_cb(skb)->zone;
+	struct fl_flow_dissector *fd;
 	struct fl_flow_key skb_key;
 	struct fl_flow_mask *mask;
 	struct cls_fl_filter *f;
 
-	list_for_each_entry_rcu(mask, &head->masks, list) {
-		flow_dissector_init_keys(&skb_key.control, &skb_key.basic);
-		fl_clear_masked_range(&skb_key, mask);
+	fd = rcu_dereference_bh(head->dissector);
+	if (!fd)
+		return -1;
 
-		skb_flow_dissect_meta(skb, &mask->dissector, &skb_key);
-		/* skb_flow_dissect() does not set n_proto in case an unknown
-		 * protocol, so do it rather here.
-		 */
-		skb_key.basic.n_proto = skb_protocol(skb, false);
-		skb_flow_dissect_tunnel_info(skb, &mask->dissector, &skb_key);
-		skb_flow_dissect_ct(skb, &mask->dissector, &skb_key,
-				    fl_ct_info_to_flower_map,
-				    ARRAY_SIZE(fl_ct_info_to_flower_map),
-				    post_ct, zone);
-		skb_flow_dissect_hash(skb, &mask->dissector, &skb_key);
-		skb_flow_dissect(skb, &mask->dissector, &skb_key,
-				 FLOW_DISSECTOR_F_STOP_BEFORE_ENCAP);
+	flow_dissector_init_keys(&skb_key.control, &skb_key.basic);
+	fl_clear_masked_range(&skb_key, &fd->range);
+
+	skb_flow_dissect_meta(skb, &fd->dissector, &skb_key);
+	/* skb_flow_dissect() does not set n_proto in case an unknown
+	 * protocol, so do it rather here.
+	 */
+	skb_key.basic.n_proto = skb_protocol(skb, false);
+	skb_flow_dissect_tunnel_info(skb, &fd->dissector, &skb_key);
+	skb_flow_dissect_ct(skb, &fd->dissector, &skb_key,
+			    fl_ct_info_to_flower_map,
+			    ARRAY_SIZE(fl_ct_info_to_flower_map),
+			    post_ct, zone);
+	skb_flow_dissect_hash(skb, &fd->dissector, &skb_key);
+	skb_flow_dissect(skb, &fd->dissector, &skb_key,
+			 FLOW_DISSECTOR_F_STOP_BEFORE_ENCAP);
+
+	list_for_each_entry_rcu(mask, &head->masks, list) {
+		/* Added after @fd was loaded, its keys were never dissected */
+		if (!fl_dissector_covers(fd, mask))
+			continue;
 
 		f = fl_mask_lookup(mask, &skb_key);
 		if (f && !tc_skip_sw(f->flags)) {
@@ -402,15 +432,58 @@ static void fl_uninit_mask_free_work(struct work_struct *work)
 	fl_mask_free(mask, false);
 }
 
+/* Rebuild head->dissector from the masks list, consuming @new.  With @new
+ * NULL the old, wider, union is kept, as dissecting too much is harmless.
+ */
+static void fl_update_dissector(struct cls_fl_head *head,
+				struct fl_flow_dissector *new)
+{
+	struct fl_flow_dissector *old;
+	struct fl_flow_mask *mask;
+	int key;
+
+	lockdep_assert_held(&head->masks_lock);
+
+	if (list_empty(&head->masks)) {
+		kfree(new);
+		new = NULL;
+	} else if (!new) {
+		return;
+	} else {
+		new->range.start = USHRT_MAX;
+		list_for_each_entry(mask, &head->masks, list) {
+			for (key = 0; key < FLOW_DISSECTOR_KEY_MAX; key++) {
+				if (!dissector_uses_key(&mask->dissector, key))
+					continue;
+				new->dissector.used_keys |= BIT_ULL(key);
+				new->dissector.offset[key] =
+					mask->dissector.offset[key];
+			}
+			new->range.start = min(new->range.start,
+					       mask->range.start);
+			new->range.end = max(new->range.end, mask->range.end);
+		}
+	}
+
+	old = rcu_replace_pointer(head->dissector, new,
+				  lockdep_is_held(&head->masks_lock));
+	if (old)
+		kfree_rcu(old, rcu);
+}
+
 static bool fl_mask_put(struct cls_fl_head *head, struct fl_flow_mask *mask)
 {
+	struct fl_flow_dissector *fd;
+
 	if (!refcount_dec_and_test(&mask->refcnt))
 		return false;
 
 	rhashtable_remove_fast(&head->ht, &mask->ht_node, mask_ht_params);
 
+	fd = kzalloc(sizeof(*fd), GFP_KERNEL);
 	spin_lock(&head->masks_lock);
 	list_del_rcu(&mask->list);
+	fl_update_dissector(head, fd);
 	spin_unlock(&head->masks_lock);
 
 	tcf_queue_work(&mask->rwork, fl_mask_free_work);
@@ -592,6 +665,7 @@ static void fl_destroy_sleepable(struct work_struct *work)
 						rwork);
 
 	rhashtable_destroy(&head->ht);
+	kfree(rcu_dereference_protected(head->dissector, 1));
 	kfree(head);
 	module_put(THIS_MODULE);
 }
@@ -2234,6 +2308,7 @@ static void fl_init_dissector(struct flow_dissector *dissector,
 static struct fl_flow_mask *fl_create_new_mask(struct cls_fl_head *head,
 					       struct fl_flow_mask *mask)
 {
+	struct fl_flow_dissector *fd;
 	struct fl_flow_mask *newmask;
 	int err;
 
@@ -2241,6 +2316,12 @@ static struct fl_flow_mask *fl_create_new_mask(struct cls_fl_head *head,
 	if (!newmask)
 		return ERR_PTR(-ENOMEM);
 
+	fd = kzalloc(sizeof(*fd), GFP_KERNEL);
+	if (!fd) {
+		err = -ENOMEM;
+		goto errout_free;
+	}
+
 	fl_mask_copy(newmask, mask);
 
 	if ((newmask->key.tp_range.tp_min.dst &&
@@ -2265,6 +2346,7 @@ static struct fl_flow_mask *fl_create_new_mask(struct cls_fl_head *head,
 
 	spin_lock(&head->masks_lock);
 	list_add_tail_rcu(&newmask->list, &head->masks);
+	fl_update_dissector(head, fd);
 	spin_unlock(&head->masks_lock);
 
 	return newmask;
@@ -2272,6 +2354,7 @@ static struct fl_flow_mask *fl_create_new_mask(struct cls_fl_head *head,
 errout_destroy:
 	rhashtable_destroy(&newmask->ht);
 errout_free:
+	kfree(fd);
 	kfree(newmask);
 
 	return ERR_PTR(err);
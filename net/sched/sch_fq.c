@@ -539,6 +539,57 @@ static bool fq_packet_beyond_horizon(const struct sk_buff *skb,
 
 #define FQDR(reason) SKB_DROP_REASON_FQ_##reason
 
+/* UDP GSO packets of a paced socket (SO_MAX_PACING_RATE) would leave as
+ * one line rate burst of up to 64 segments.  Unlike TCP, UDP does not size
+ * its GSO packets to the pacing rate, so split them here and let dequeue
+ * pace every segment.
+ */
+static bool fq_should_segment(const struct fq_sched_data *q,
+			      const struct sk_buff *skb)
+{
+	const struct sock *sk = skb->sk;
+
+	return skb_is_gso(skb) && !skb->tstamp && q->rate_enable &&
+	       sk && sk_fullsock(sk) && sk_is_udp(sk) &&
+	       READ_ONCE(sk->sk_pacing_rate) != ~0UL;
+}
+
+static int fq_enqueue(struct sk_buff *skb, struct Qdisc *sch,
+		      struct sk_buff **to_free);
+
+static int fq_segment(struct sk_buff *skb, struct Qdisc *sch,
+		      struct sk_buff **to_free)
+{
+	netdev_features_t features = netif_skb_features(skb);
+	unsigned int len = 0, prev_len = qdisc_pkt_len(skb);
+	struct sk_buff *segs, *nskb;
+	int nb = 0;
+
+	segs = skb_gso_segment(skb, features & ~NETIF_F_GSO_MASK);
+	if (IS_ERR_OR_NULL(segs))
+		return qdisc_drop(skb, sch, to_free);
+
+	skb_list_walk_safe(segs, segs, nskb) {
+		unsigned int seg_len = segs->len;
+
+		skb_mark_not_on_list(segs);
+		qdisc_skb_cb(segs)->pkt_len = seg_len;
+		if (fq_enqueue(segs, sch, to_free) == NET_XMIT_SUCCESS) {
+			nb++;
+			len += seg_len;
+		}
+	}
+
+	if (nb > 0) {
+		qdisc_tree_reduce_backlog(sch, 1 - nb, prev_len - len);
+		consume_skb(skb);
+		return NET_XMIT_SUCCESS;
+	}
+
+	kfree_skb(skb);
+	return NET_XMIT_DROP;
+}
+
 static int fq_enqueue(struct sk_buff *skb, struct Qdisc *sch,
 		      struct sk_buff **to_free)
 {
@@ -547,6 +598,9 @@ static int fq_enqueue(struct sk_buff *skb, struct Qdisc *sch,
 	u64 now;
 	u8 band;
 
+	if (unlikely(fq_should_segment(q, skb)))
+		return fq_segment(skb, sch, to_free);
+
 	band = fq_prio2band(q->prio2band, skb->priority & TC_PRIO_MAX);
 	if (unlikely(q->band_pkt_count[band] >= sch->limit)) {
 		q->stat_band_drops[band]++;
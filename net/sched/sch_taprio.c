@@ -104,6 +104,7 @@ struct taprio_sched {
 	u32 max_sdu[TC_MAX_QUEUE]; /* save info from the user */
 	u32 fp[TC_QOPT_MAX_QUEUE]; /* only for dump and offloading */
 	u32 txtime_delay;
+	u64 window_drops; /* software mode, under the root lock */
 };
 
 struct __tc_taprio_qopt_offload {
@@ -561,17 +562,21 @@ static int taprio_enqueue_one(struct sk_buff *skb, struct Qdisc *sch,
 	/* sk_flags are only safe to use on full sockets. */
 	if (skb->sk && sk_fullsock(skb->sk) && sock_flag(skb->sk, SOCK_TXTIME)) {
 		if (!is_valid_interval(skb, sch))
-			return qdisc_drop(skb, sch, to_free);
+			goto window_drop;
 	} else if (TXTIME_ASSIST_IS_ENABLED(q->flags)) {
 		skb->tstamp = get_packet_txtime(skb, sch);
 		if (!skb->tstamp)
-			return qdisc_drop(skb, sch, to_free);
+			goto window_drop;
 	}
 
 	qdisc_qstats_backlog_inc(sch, skb);
 	sch->q.qlen++;
 
 	return qdisc_enqueue(skb, child, to_free);
+
+window_drop:
+	WRITE_ONCE(q->window_drops, q->window_drops + 1);
+	return qdisc_drop(skb, sch, to_free);
 }
 
 static int taprio_enqueue_segmented(struct sk_buff *skb, struct Qdisc *sch,
@@ -2355,12 +2360,40 @@ static int taprio_dump_xstats(struct Qdisc *sch, struct gnet_dump *d,
 	return -EMSGSIZE;
 }
 
+/* Without full offload, only the frames we failed to fit in a gate window
+ * are known.
+ */
+static int taprio_dump_sw_xstats(struct Qdisc *sch, struct gnet_dump *d)
+{
+	struct taprio_sched *q = qdisc_priv(sch);
+	struct sk_buff *skb = d->skb;
+	struct nlattr *xstats;
+
+	xstats = nla_nest_start(skb, TCA_STATS_APP);
+	if (!xstats)
+		return -EMSGSIZE;
+
+	if (taprio_put_stat(skb, READ_ONCE(q->window_drops),
+			    TCA_TAPRIO_OFFLOAD_STATS_WINDOW_DROPS)) {
+		nla_nest_cancel(skb, xstats);
+		return -EMSGSIZE;
+	}
+
+	nla_nest_end(skb, xstats);
+
+	return 0;
+}
+
 static int taprio_dump_stats(struct Qdisc *sch, struct gnet_dump *d)
 {
+	struct taprio_sched *q = qdisc_priv(sch);
 	struct tc_taprio_qopt_offload offload = {
 		.cmd = TAPRIO_CMD_STATS,
 	};
 
+	if (!FULL_OFFLOAD_IS_ENABLED(q->flags))
+		return taprio_dump_sw_xstats(sch, d);
+
 	return taprio_dump_xstats(sch, d, &offload, &offload.stats);
 }
 
@@ -27,6 +27,8 @@ static const struct snmp_mib tls_mib_list[] = {
 	SNMP_MIB_ITEM("TlsTxRekeyOk", LINUX_MIB_TLSTXREKEYOK),
 	SNMP_MIB_ITEM("TlsTxRekeyError", LINUX_MIB_TLSTXREKEYERROR),
 	SNMP_MIB_ITEM("TlsRxRekeyReceived", LINUX_MIB_TLSRXREKEYRECEIVED),
+	SNMP_MIB_ITEM("TlsTxAsyncEncrypt", LINUX_MIB_TLSTXASYNCENCRYPT),
+	SNMP_MIB_ITEM("TlsRxStrpCopy", LINUX_MIB_TLSRXSTRPCOPY),
 	SNMP_MIB_SENTINEL
 };
 
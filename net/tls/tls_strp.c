@@ -414,6 +414,7 @@ static int tls_strp_read_copy(struct tls_strparser *strp, bool qshort)
 
 	strp->copy_mode = 1;
 	strp->stm.offset = 0;
+	TLS_INC_STATS(sock_net(strp->sk), LINUX_MIB_TLSRXSTRPCOPY);
 
 	strp->anchor->len = 0;
 	strp->anchor->data_len = 0;
@@ -580,6 +580,8 @@ static int tls_do_encryption(struct sock *sk,
 	atomic_inc(&ctx->encrypt_pending);
 
 	rc = crypto_aead_encrypt(aead_req);
+	if (rc == -EINPROGRESS)
+		TLS_INC_STATS(sock_net(sk), LINUX_MIB_TLSTXASYNCENCRYPT);
 	if (rc == -EBUSY) {
 		rc = tls_encrypt_async_wait(ctx);
 		rc = rc ?: -EINPROGRESS;
@@ -224,7 +224,39 @@ static u32 xsk_copy_xdp(void *to, void **from, u32 to_len,
 	}
 }
 
-static int __xsk_rcv(struct xdp_sock *xs, struct xdp_buff *xdp, u32 len)
+static struct xdp_buff *xsk_rx_cache_alloc(struct xdp_sock *xs)
+{
+	struct xdp_buff *xdp;
+
+	if (!xs->rx_cache_cnt) {
+		u32 nb = xskq_prod_nb_free(xs->rx, XSK_RX_CACHE_SIZE);
+
+		xs->rx_cache_cnt = xsk_buff_alloc_batch(xs->pool, xs->rx_cache,
+							nb ?: 1);
+		if (!xs->rx_cache_cnt)
+			return NULL;
+	}
+
+	xdp = xs->rx_cache[--xs->rx_cache_cnt];
+	xdp->data = xdp->data_hard_start + XDP_PACKET_HEADROOM;
+	xdp->data_meta = xdp->data;
+	xdp->flags = 0;
+	return xdp;
+}
+
+static void xsk_rx_cache_release(struct xdp_sock *xs)
+{
+	struct xdp_buff_xsk *xskb;
+
+	while (xs->rx_cache_cnt) {
+		xskb = container_of(xs->rx_cache[--xs->rx_cache_cnt],
+				    struct xdp_buff_xsk, xdp);
+		xp_free(xskb);
+	}
+}
+
+static int __xsk_rcv(struct xdp_sock *xs, struct xdp_buff *xdp, u32 len,
+		     bool batch)
 {
 	u32 frame_size = xsk_pool_get_rx_frame_size(xs->pool);
 	void *copy_from = xsk_copy_xdp_start(xdp), *copy_to;
@@ -240,7 +272,8 @@ static int __xsk_rcv(struct xdp_sock *xs, struct xdp_buff *xdp, u32 len)
 	if (len <= frame_size && !xdp_buff_has_frags(xdp)) {
 		int err;
 
-		xsk_xdp = xsk_buff_alloc(xs->pool);
+		xsk_xdp = batch ? xsk_rx_cache_alloc(xs) :
+				  xsk_buff_alloc(xs->pool);
 		if (!xsk_xdp) {
 			xs->rx_dropped++;
 			return -ENOMEM;
@@ -258,6 +291,9 @@ static int __xsk_rcv(struct xdp_sock *xs, struct xdp_buff *xdp, u32 len)
 
 	num_desc = (len - 1) / frame_size + 1;
 
+	/* Multi-buffer frames size their allocation up front */
+	xsk_rx_cache_release(xs);
+
 	if (!xsk_buff_can_alloc(xs->pool, num_desc)) {
 		xs->rx_dropped++;
 		return -ENOMEM;
@@ -328,6 +364,7 @@ static int xsk_rcv_check(struct xdp_sock *xs, struct xdp_buff *xdp, u32 len)
 
 static void xsk_flush(struct xdp_sock *xs)
 {
+	xsk_rx_cache_release(xs);
 	xskq_prod_submit(xs->rx);
 	__xskq_cons_release(xs->pool->fq);
 	sock_def_readable(&xs->sk);
@@ -341,7 +378,7 @@ int xsk_generic_rcv(struct xdp_sock *xs, struct xdp_buff *xdp)
 	spin_lock_bh(&xs->rx_lock);
 	err = xsk_rcv_check(xs, xdp, len);
 	if (!err) {
-		err = __xsk_rcv(xs, xdp, len);
+		err = __xsk_rcv(xs, xdp, len, false);
 		xsk_flush(xs);
 	}
 	spin_unlock_bh(&xs->rx_lock);
@@ -362,7 +399,7 @@ static int xsk_rcv(struct xdp_sock *xs, struct xdp_buff *xdp)
 		return xsk_rcv_zc(xs, xdp, len);
 	}
 
-	err = __xsk_rcv(xs, xdp, len);
+	err = __xsk_rcv(xs, xdp, len, true);
 	if (!err)
 		xdp_return_buff(xdp);
 	return err;
@@ -373,7 +410,8 @@ int __xsk_map_redirect(struct xdp_sock *xs, struct xdp_buff *xdp)
 	int err;
 
 	err = xsk_rcv(xs, xdp);
-	if (err)
+	/* Cached buffers are only given back on flush */
+	if (err && !xs->rx_cache_cnt)
 		return err;
 
 	if (!xs->flush_node.prev) {
@@ -382,7 +420,7 @@ int __xsk_map_redirect(struct xdp_sock *xs, struct xdp_buff *xdp)
 		list_add(&xs->flush_node, flush_list);
 	}
 
-	return 0;
+	return err;
 }
 
 void __xsk_map_flush(struct list_head *flush_list)
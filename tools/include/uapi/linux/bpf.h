@@ -141,6 +141,12 @@ union bpf_iter_link_info {
 		__u32	tid;
 		__u32	pid;
 		__u32	pid_fd;
+		/* Without tid, pid or pid_fd, only walk tasks whose tid is
+		 * in [tid_min, tid_max], e.g. to split a walk across readers.
+		 * A zero tid_max means no upper bound.
+		 */
+		__u32	tid_min;
+		__u32	tid_max;
 	} task;
 };
 
@@ -1419,6 +1425,14 @@ enum {
 	BPF_F_NO_USER_CONV	= (1U << 18),
 };
 
+/* Flags for BPF_MAP_TYPE_BLOOM_FILTER map_extra, above the number of hash
+ * functions in the lowest 4 bits.
+ */
+enum {
+	/* Keep all the bits of a value within one cache line */
+	BPF_F_BLOOM_BLOCKED	= (1U << 4),
+};
+
 /* Flags for BPF_PROG_QUERY. */
 
 /* Query effective (directly attached + inherited from ancestor cgroups)
@@ -1489,7 +1503,9 @@ union bpf_attr {
 		 *
 		 * BPF_MAP_TYPE_BLOOM_FILTER - the lowest 4 bits indicate the
 		 * number of hash functions (if 0, the bloom filter will default
-		 * to using 5 hash functions).
+		 * to using 5 hash functions). If BPF_F_BLOOM_BLOCKED is set, all
+		 * the bits of a value are kept within one cache line of the
+		 * bit array.
 		 *
 		 * BPF_MAP_TYPE_ARENA - contains the address where user space
 		 * is going to mmap() the arena. It has to be page aligned.
@@ -6675,6 +6691,8 @@ struct bpf_link_info {
 				struct {
 					__u32 tid;
 					__u32 pid;
+					__u32 tid_min;
+					__u32 tid_max;
 				} task;
 			};
 		} iter;
@@ -150,6 +150,96 @@ static void test_inner_map(struct bloom_filter_map *skel, const __u32 *rand_vals
 	close(inner_map_fd);
 }
 
+static __u64 map_memlock(int fd)
+{
+	char path[64], line[128];
+	__u64 memlock = 0;
+	FILE *f;
+
+	snprintf(path, sizeof(path), "/proc/self/fdinfo/%d", fd);
+	f = fopen(path, "r");
+	if (!f)
+		return 0;
+	while (fgets(line, sizeof(line), f))
+		if (sscanf(line, "memlock: %llu", &memlock) == 1)
+			break;
+	fclose(f);
+	return memlock;
+}
+
+static void test_blocked(const __u32 *rand_vals, __u32 nr_rand_vals)
+{
+	LIBBPF_OPTS(bpf_map_create_opts, opts);
+	int fd, err, i;
+
+	/* Bits above BPF_F_BLOOM_BLOCKED are still reserved */
+	opts.map_extra = BPF_F_BLOOM_BLOCKED << 1;
+	fd = bpf_map_create(BPF_MAP_TYPE_BLOOM_FILTER, NULL, 0, sizeof(*rand_vals),
+			    nr_rand_vals, &opts);
+	if (!ASSERT_LT(fd, 0, "bpf_map_create bloom filter invalid map_extra"))
+		close(fd);
+
+	/* Every value added must be found again, whatever line it went to */
+	opts.map_extra = BPF_F_BLOOM_BLOCKED | 3;
+	fd = bpf_map_create(BPF_MAP_TYPE_BLOOM_FILTER, NULL, 0, sizeof(*rand_vals),
+			    nr_rand_vals, &opts);
+	if (!ASSERT_GE(fd, 0, "bpf_map_create blocked bloom filter"))
+		return;
+
+	for (i = 0; i < nr_rand_vals; i++) {
+		err = bpf_map_update_elem(fd, NULL, &rand_vals[i], BPF_ANY);
+		if (!ASSERT_OK(err, "blocked bloom filter update"))
+			goto done;
+	}
+
+	for (i = 0; i < nr_rand_vals; i++) {
+		err = bpf_map_lookup_elem(fd, NULL, &rand_vals[i]);
+		if (!ASSERT_OK(err, "blocked bloom filter lookup"))
+			goto done;
+	}
+
+done:
+	close(fd);
+}
+
+static void test_blocked_min_size(void)
+{
+	LIBBPF_OPTS(bpf_map_create_opts, opts);
+	int fd, plain_fd, err;
+	__u32 value = 0xcafe;
+	__u64 memlock;
+
+	/*
+	 * A single entry would fit in one long. A blocked filter still gets
+	 * a whole cache line, since the probes of a value span one.
+	 */
+	opts.map_extra = 1;
+	plain_fd = bpf_map_create(BPF_MAP_TYPE_BLOOM_FILTER, NULL, 0, sizeof(value),
+				  1, &opts);
+	if (!ASSERT_GE(plain_fd, 0, "bpf_map_create one entry bloom filter"))
+		return;
+
+	opts.map_extra = BPF_F_BLOOM_BLOCKED | 1;
+	fd = bpf_map_create(BPF_MAP_TYPE_BLOOM_FILTER, NULL, 0, sizeof(value),
+			    1, &opts);
+	if (!ASSERT_GE(fd, 0, "bpf_map_create one entry blocked bloom filter"))
+		goto close_plain;
+
+	memlock = map_memlock(plain_fd);
+	ASSERT_GT(memlock, 0, "one entry bloom filter memlock");
+	ASSERT_GT(map_memlock(fd), memlock, "blocked bloom filter holds a line");
+
+	err = bpf_map_update_elem(fd, NULL, &value, BPF_ANY);
+	if (ASSERT_OK(err, "one entry blocked bloom filter update")) {
+		err = bpf_map_lookup_elem(fd, NULL, &value);
+		ASSERT_OK(err, "one entry blocked bloom filter lookup");
+	}
+
+	close(fd);
+close_plain:
+	close(plain_fd);
+}
+
 static int setup_progs(struct bloom_filter_map **out_skel, __u32 **out_rand_vals,
 		       __u32 *out_nr_rand_vals)
 {
@@ -210,12 +300,14 @@ void test_bloom_filter_map(void)
 
 	test_fail_cases();
 	test_success_cases();
+	test_blocked_min_size();
 
 	err = setup_progs(&skel, &rand_vals, &nr_rand_vals);
 	if (err)
 		return;
 
 	test_inner_map(skel, rand_vals, nr_rand_vals);
+	test_blocked(rand_vals, nr_rand_vals);
 	free(rand_vals);
 
 	check_bloom(skel);
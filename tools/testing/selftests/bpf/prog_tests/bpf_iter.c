@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0
 /* Copyright (c) 2020 Facebook */
 #include <test_progs.h>
+#include <dirent.h>
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <task_local_storage_helpers.h>
@@ -320,6 +321,110 @@ static void test_task_pidfd(void)
 	close(pidfd);
 }
 
+#define TID_LIMIT	(4 * 1024 * 1024)	/* PID_MAX_LIMIT */
+
+/* Walk the tasks in [tid_min, tid_max] and count each tid in @seen */
+static void read_task_range(struct bpf_program *prog, __u32 tid_min,
+			    __u32 tid_max, __u8 *seen)
+{
+	LIBBPF_OPTS(bpf_iter_attach_opts, opts);
+	union bpf_iter_link_info linfo;
+	struct bpf_link_info info = {};
+	struct bpf_link *link;
+	int iter_fd, tgid, tid, err;
+	__u32 info_len;
+	char line[64];
+	FILE *f;
+
+	memset(&linfo, 0, sizeof(linfo));
+	linfo.task.tid_min = tid_min;
+	linfo.task.tid_max = tid_max;
+	opts.link_info = &linfo;
+	opts.link_info_len = sizeof(linfo);
+
+	link = bpf_program__attach_iter(prog, &opts);
+	if (!ASSERT_OK_PTR(link, "attach_iter"))
+		return;
+
+	info_len = sizeof(info);
+	err = bpf_link_get_info_by_fd(bpf_link__fd(link), &info, &info_len);
+	ASSERT_OK(err, "bpf_link_get_info_by_fd");
+	ASSERT_EQ(info.iter.task.tid_min, tid_min, "check_task_tid_min");
+	ASSERT_EQ(info.iter.task.tid_max, tid_max, "check_task_tid_max");
+
+	iter_fd = bpf_iter_create(bpf_link__fd(link));
+	if (!ASSERT_GE(iter_fd, 0, "create_iter"))
+		goto free_link;
+
+	f = fdopen(iter_fd, "r");
+	if (!ASSERT_OK_PTR(f, "fdopen")) {
+		close(iter_fd);
+		goto free_link;
+	}
+
+	/* dump_task prints a "tgid tid" line per task */
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "%d %d", &tgid, &tid) != 2)
+			continue;
+		if (!ASSERT_GE((__u32)tid, tid_min, "check_tid_min") ||
+		    (tid_max && !ASSERT_LE((__u32)tid, tid_max, "check_tid_max")) ||
+		    !ASSERT_LT(tid, TID_LIMIT, "check_tid_limit"))
+			break;
+		ASSERT_EQ(seen[tid], 0, "check_tid_once");
+		seen[tid]++;
+	}
+	fclose(f);
+
+free_link:
+	bpf_link__destroy(link);
+}
+
+static void test_task_tid_range(void)
+{
+	struct bpf_iter_tasks *skel;
+	struct dirent *ent;
+	pthread_t thread_id;
+	__u8 *seen;
+	void *ret;
+	DIR *dir;
+	int tid;
+
+	skel = bpf_iter_tasks__open_and_load();
+	if (!ASSERT_OK_PTR(skel, "bpf_iter_tasks__open_and_load"))
+		return;
+
+	seen = calloc(TID_LIMIT, sizeof(*seen));
+	if (!ASSERT_OK_PTR(seen, "calloc"))
+		goto out;
+
+	/* Have a thread of ours on the upper side of the split too */
+	ASSERT_OK(pthread_mutex_lock(&do_nothing_mutex), "pthread_mutex_lock");
+	ASSERT_OK(pthread_create(&thread_id, NULL, &do_nothing_wait, NULL),
+		  "pthread_create");
+
+	/* Split the walk at our own tid, which ends the lower range */
+	read_task_range(skel->progs.dump_task, 1, sys_gettid(), seen);
+	read_task_range(skel->progs.dump_task, sys_gettid() + 1, 0, seen);
+
+	/* None of our threads can have come or gone meanwhile */
+	dir = opendir("/proc/self/task");
+	if (ASSERT_OK_PTR(dir, "opendir")) {
+		while ((ent = readdir(dir))) {
+			tid = atoi(ent->d_name);
+			if (tid > 0 && tid < TID_LIMIT)
+				ASSERT_EQ(seen[tid], 1, "check_own_tid_seen");
+		}
+		closedir(dir);
+	}
+
+	ASSERT_OK(pthread_mutex_unlock(&do_nothing_mutex), "pthread_mutex_unlock");
+	ASSERT_FALSE(pthread_join(thread_id, &ret) || ret != NULL,
+		     "pthread_join");
+	free(seen);
+out:
+	bpf_iter_tasks__destroy(skel);
+}
+
 static void test_task_sleepable(void)
 {
 	struct bpf_iter_tasks *skel;
@@ -1731,6 +1836,8 @@ void test_bpf_iter(void)
 		test_task_pid();
 	if (test__start_subtest("task_pidfd"))
 		test_task_pidfd();
+	if (test__start_subtest("task_tid_range"))
+		test_task_tid_range();
 	if (test__start_subtest("task_sleepable"))
 		test_task_sleepable();
 	if (test__start_subtest("task_stack"))
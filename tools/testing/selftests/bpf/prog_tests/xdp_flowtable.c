@@ -100,7 +100,7 @@ void test_xdp_flowtable(void)
 	SYS(out, "nft add table ip filter");
 	SYS(out,
 	    "nft add flowtable ip filter f { hook ingress priority 0\\; "
-	    "devices = { " FORWARD_NAME ", " RX_NAME " }\\; }");
+	    "devices = { " FORWARD_NAME ", " RX_NAME " }\\; counter\\; }");
 	SYS(out,
 	    "nft add chain ip filter forward "
 	    "{ type filter hook forward priority 0\\; }");
@@ -159,6 +159,20 @@ void test_xdp_flowtable(void)
 		goto out;
 
 	ASSERT_GE(value, N_PACKETS - 2, "bpf_xdp_flow_lookup failed");
+	ASSERT_OK(skel->bss->lookup_error, "lookup with BPF_FLOWTABLE_F_ACCOUNT");
+
+	/* Unknown flags are rejected */
+	skel->bss->lookup_flags = 1U << 31;
+
+	close_netns(tok);
+	tok = open_netns(TX_NETNS_NAME);
+	if (!ASSERT_OK_PTR(tok, "setns"))
+		goto out;
+
+	if (!ASSERT_OK(send_udp_traffic(), "send udp"))
+		goto out;
+
+	ASSERT_EQ(skel->bss->lookup_error, -EINVAL, "lookup with unknown flags");
 out:
 	xdp_flowtable__destroy(skel);
 	if (tok)
@@ -10,9 +10,13 @@
 #define IP_OFFSET	0x1fff	/* "Fragment Offset" */
 #define AF_INET		2
 #define AF_INET6	10
+#define ENOENT		2
+
+#define BPF_FLOWTABLE_F_ACCOUNT	(1U << 0)
 
 struct bpf_flowtable_opts___local {
 	s32 error;
+	u32 flags;
 };
 
 struct flow_offload_tuple_rhash *
@@ -26,6 +30,9 @@ struct {
 	__uint(max_entries, 1);
 } stats SEC(".maps");
 
+__u32 lookup_flags = BPF_FLOWTABLE_F_ACCOUNT;
+int lookup_error;
+
 static bool xdp_flowtable_offload_check_iphdr(struct iphdr *iph)
 {
 	/* ip fragmented traffic */
@@ -66,7 +73,9 @@ SEC("xdp.frags")
 int xdp_flowtable_do_lookup(struct xdp_md *ctx)
 {
 	void *data_end = (void *)(long)ctx->data_end;
-	struct bpf_flowtable_opts___local opts = {};
+	struct bpf_flowtable_opts___local opts = {
+		.flags = lookup_flags,
+	};
 	struct flow_offload_tuple_rhash *tuplehash;
 	struct bpf_fib_lookup tuple = {
 		.ifindex = ctx->ingress_ifindex,
@@ -135,8 +144,11 @@ int xdp_flowtable_do_lookup(struct xdp_md *ctx)
 	}
 
 	tuplehash = bpf_xdp_flow_lookup(ctx, &tuple, &opts, sizeof(opts));
-	if (!tuplehash)
+	if (!tuplehash) {
+		if (opts.error != -ENOENT)
+			lookup_error = opts.error;
 		return XDP_PASS;
+	}
 
 	val = bpf_map_lookup_elem(&stats, &key);
 	if (val)
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * User Events DIAG_IOCSBATCH test program
+ */
+
+#include <errno.h>
+#include <linux/user_events.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "../kselftest_harness.h"
+
+const char *data_file = "/sys/kernel/tracing/user_events_data";
+
+struct batch_record {
+	__u32 len;
+	__u32 write_index;
+	__u32 value;
+} __attribute__((__packed__));
+
+FIXTURE(user) {
+	int data_fd;
+	int enable;
+	__u32 write_index;
+};
+
+FIXTURE_SETUP(user) {
+	struct user_reg reg = {0};
+
+	self->data_fd = open(data_file, O_RDWR);
+
+	if (self->data_fd == -1)
+		SKIP(return, "Cannot open %s: %s", data_file, strerror(errno));
+
+	reg.size = sizeof(reg);
+	reg.name_args = (__u64)"__test_batch u32 value";
+	reg.enable_bit = 31;
+	reg.enable_addr = (__u64)&self->enable;
+	reg.enable_size = sizeof(self->enable);
+
+	ASSERT_EQ(0, ioctl(self->data_fd, DIAG_IOCSREG, &reg));
+	self->write_index = reg.write_index;
+}
+
+FIXTURE_TEARDOWN(user) {
+	struct user_unreg unreg = {0};
+
+	if (self->data_fd == -1)
+		return;
+
+	unreg.size = sizeof(unreg);
+	unreg.disable_bit = 31;
+	unreg.disable_addr = (__u64)&self->enable;
+
+	ioctl(self->data_fd, DIAG_IOCSUNREG, &unreg);
+	close(self->data_fd);
+
+	/* The event can only be deleted once no fd references it */
+	self->data_fd = open(data_file, O_RDWR);
+	if (self->data_fd == -1)
+		return;
+
+	ioctl(self->data_fd, DIAG_IOCSDEL, "__test_batch");
+	close(self->data_fd);
+}
+
+static void fill_batch(struct batch_record *records, int count,
+		       __u32 write_index, struct user_batch *batch)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		records[i].len = sizeof(records[i]) - sizeof(records[i].len);
+		records[i].write_index = write_index;
+		records[i].value = i;
+	}
+
+	memset(batch, 0, sizeof(*batch));
+	batch->size = sizeof(*batch);
+	batch->count = count;
+	batch->events = (__u64)records;
+}
+
+TEST_F(user, batch_write) {
+	struct batch_record records[4];
+	struct user_batch batch;
+
+	fill_batch(records, 4, self->write_index, &batch);
+
+	/* Disabled events are skipped, but still consumed */
+	ASSERT_EQ(4, ioctl(self->data_fd, DIAG_IOCSBATCH, &batch));
+}
+
+TEST_F(user, batch_needs_write_access) {
+	struct batch_record records[2];
+	struct user_batch batch;
+	int ro_fd;
+
+	fill_batch(records, 2, self->write_index, &batch);
+
+	ro_fd = open(data_file, O_RDONLY);
+	ASSERT_NE(-1, ro_fd);
+
+	/* write() is refused on an O_RDONLY fd, so is a batch */
+	ASSERT_EQ(-1, write(ro_fd, &records[0].write_index,
+			    records[0].len));
+	ASSERT_EQ(EBADF, errno);
+
+	ASSERT_EQ(-1, ioctl(ro_fd, DIAG_IOCSBATCH, &batch));
+	ASSERT_EQ(EBADF, errno);
+
+	close(ro_fd);
+}
+
+int main(int argc, char **argv)
+{
+	return test_harness_run(argc, argv);
+}